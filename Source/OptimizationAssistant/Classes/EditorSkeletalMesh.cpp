@@ -2,6 +2,7 @@
 #include "PlatformInfo.h"
 #include "Rendering/SkeletalMeshRenderData.h"
 #include "SkeletalMeshUtilitiesCommon/Public/LODUtilities.h"
+#include "AssetMetricsStore.h"
 
 FEditorSkeletalMesh::FEditorSkeletalMesh()
 	: Mesh(nullptr)
@@ -338,6 +339,40 @@ bool FEditorSkeletalMesh::HasVertexColors() const
 	return Mesh->bHasVertexColors;
 }
 
+void FEditorSkeletalMesh::GetMetricsRecord(FAssetMetricsRecord& OutRecord) const
+{
+	OutRecord.ObjectPath = Mesh->GetPathName();
+	OutRecord.AssetType = EAssetMetricsType::SkeletalMesh;
+	OutRecord.NumLODs = FMath::Min(GetNumLODs(), OA_METRICS_MAX_LODS);
+	OutRecord.NumMaterials = 0;
+	for (const FSkeletalMaterial& SkeletalMaterial : Mesh->Materials)
+	{
+		if (!SkeletalMaterial.MaterialSlotName.ToString().Contains(TEXT("LOD"), ESearchCase::CaseSensitive))
+		{
+			++OutRecord.NumMaterials;
+		}
+	}
+
+	const FSkeletalMeshRenderData* RenderData = Mesh->GetResourceForRendering();
+	for (int32 LODIndex = 0; LODIndex < OutRecord.NumLODs; ++LODIndex)
+	{
+		OutRecord.NumTriangles[LODIndex]  = GetNumTriangles(LODIndex);
+		OutRecord.NumVertices[LODIndex]   = GetNumVertices(LODIndex);
+		OutRecord.NumUVChannels[LODIndex] = GetNumUVChannels(LODIndex);
+		OutRecord.NumSections[LODIndex]   = GetNumMaterials(LODIndex);
+		if (RenderData && RenderData->LODRenderData.IsValidIndex(LODIndex))
+		{
+			FResourceSizeEx ResourceSize(EResourceSizeMode::Exclusive);
+			RenderData->LODRenderData[LODIndex].GetResourceSizeEx(ResourceSize);
+			OutRecord.ResidentBytes[LODIndex] = (int32)FMath::Min<SIZE_T>(ResourceSize.GetTotalMemoryBytes(), MAX_int32);
+		}
+		if (const FSkeletalMeshLODInfo* LODInfo = Mesh->GetLODInfo(LODIndex))
+		{
+			OutRecord.LODScreenSizes[LODIndex] = LODInfo->ScreenSize;
+		}
+	}
+}
+
 void FEditorSkeletalMesh::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	Collector.AddReferencedObject(Mesh);
@@ -5,6 +5,8 @@
 #include "Engine/SkeletalMesh.h"
 #include "RecommendMeshSettings.h"
 
+struct FAssetMetricsRecord;
+
 class FEditorSkeletalMesh : public FGCObject
 {
 public:
@@ -29,6 +31,7 @@ public:
 	float GetTrianglesPercent(int32 LODIndex = 0)const;
 	float GetLODScreenSize(FName PlatformGroupName, int32 LODIndex = 0)const;
 	bool  HasVertexColors()const;
+	void  GetMetricsRecord(FAssetMetricsRecord& OutRecord)const;
 public:
 	//~ Begin FGCObject Interface
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
@@ -2,6 +2,11 @@
 #include "PlatformInfo.h"
 #include "StaticMeshAttributes.h"
 #include "StaticMeshOperations.h"
+#include "AssetMetricsStore.h"
+#include "DistanceFieldAtlas.h"
+#include "Mesh/MeshAttributeStatistics.h"
+#include "Mesh/LODGeometricError.h"
+#include "CameraProfileTable.h"
 
 FEditorStaticMesh::FEditorStaticMesh()
  : Mesh(nullptr)
@@ -41,6 +46,9 @@ void FEditorStaticMesh::UpdateMeshStats()
 	NumMaterials.Empty(ArraySize);
 	NumMaterials.AddZeroed(ArraySize);
 
+	LODMemory.Empty(ArraySize);
+	LODMemory.AddDefaulted(ArraySize);
+
 	LODScreenSizes.Empty(ArraySize);
 	LODScreenSizes.AddZeroed(ArraySize);
 
@@ -63,6 +71,7 @@ void FEditorStaticMesh::UpdateLODStats(int32 LODIndex)
 	NumVertices[LODIndex] = 0; //-V781
 	NumUVChannels[LODIndex] = 0; //-V781
 	NumMaterials[LODIndex] = 0; //-V781
+	LODMemory[LODIndex] = FStaticMeshLODMemory();
 
 	if (Mesh->RenderData && Mesh->RenderData->LODResources.IsValidIndex(LODIndex))
 	{
@@ -71,6 +80,7 @@ void FEditorStaticMesh::UpdateLODStats(int32 LODIndex)
 		NumVertices[LODIndex]                  = LODModel.GetNumVertices();
 		NumUVChannels[LODIndex]                = LODModel.VertexBuffers.StaticMeshVertexBuffer.GetNumTexCoords();
 		NumMaterials[LODIndex]                 = Mesh->GetNumSections(LODIndex);
+		FStaticMeshLODMemory::Compute(Mesh, LODIndex, LODMemory[LODIndex]);
 		FStaticMeshSourceModel& SrcModel       = Mesh->GetSourceModel(LODIndex);
 		LODScreenSizes[LODIndex]               = SrcModel.ScreenSize;
 		EditableLODBuildSettings[LODIndex]     = SrcModel.BuildSettings;
@@ -78,6 +88,57 @@ void FEditorStaticMesh::UpdateLODStats(int32 LODIndex)
 	}
 }
 
+void FStaticMeshLODMemory::Compute(const UStaticMesh* StaticMesh, int32 LODIndex, FStaticMeshLODMemory& OutMemory)
+{
+	OutMemory = FStaticMeshLODMemory();
+	const FStaticMeshRenderData* RenderData = StaticMesh->RenderData.Get();
+	if (!RenderData || !RenderData->LODResources.IsValidIndex(LODIndex))
+	{
+		return;
+	}
+
+	const FStaticMeshLODResources& LODModel = RenderData->LODResources[LODIndex];
+	const FStaticMeshVertexBuffers& VertexBuffers = LODModel.VertexBuffers;
+	OutMemory.PositionBytes = (int64)VertexBuffers.PositionVertexBuffer.GetNumVertices() * VertexBuffers.PositionVertexBuffer.GetStride();
+	OutMemory.TangentBytes  = VertexBuffers.StaticMeshVertexBuffer.GetTangentSize();
+	OutMemory.TexCoordBytes = VertexBuffers.StaticMeshVertexBuffer.GetTexCoordSize();
+	OutMemory.ColorBytes    = (int64)VertexBuffers.ColorVertexBuffer.GetNumVertices() * VertexBuffers.ColorVertexBuffer.GetStride();
+	OutMemory.IndexBytes    = LODModel.IndexBuffer.GetIndexDataSize() + LODModel.DepthOnlyIndexBuffer.GetIndexDataSize();
+	if (LODModel.AdditionalIndexBuffers)
+	{
+		OutMemory.IndexBytes += LODModel.AdditionalIndexBuffers->ReversedIndexBuffer.GetIndexDataSize()
+			+ LODModel.AdditionalIndexBuffers->ReversedDepthOnlyIndexBuffer.GetIndexDataSize()
+			+ LODModel.AdditionalIndexBuffers->WireframeIndexBuffer.GetIndexDataSize();
+	}
+
+	// 距离场只在LOD0上生成
+	const FDistanceFieldVolumeData* DistanceFieldData = LODModel.DistanceFieldData;
+	if (LODIndex == 0 && DistanceFieldData)
+	{
+		const FIntVector& Size = DistanceFieldData->Size;
+		OutMemory.DistanceFieldBytes = (int64)Size.X * Size.Y * Size.Z * GPixelFormats[DistanceField::DistanceFieldFormat].BlockBytes;
+	}
+
+	// 允许CPU访问时顶点和索引数据会在内存中保留一份
+	if (StaticMesh->bAllowCPUAccess)
+	{
+		OutMemory.CPUAccessBytes = OutMemory.PositionBytes + OutMemory.TangentBytes + OutMemory.TexCoordBytes + OutMemory.ColorBytes + LODModel.IndexBuffer.GetIndexDataSize();
+	}
+}
+
+int64 FStaticMeshLODMemory::ComputeResidentBytes(const UStaticMesh* StaticMesh)
+{
+	int64 ResidentBytes = 0;
+	const int32 NumLODs = StaticMesh->RenderData ? StaticMesh->RenderData->LODResources.Num() : 0;
+	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
+	{
+		FStaticMeshLODMemory LODMemory;
+		Compute(StaticMesh, LODIndex, LODMemory);
+		ResidentBytes += LODMemory.GetTotalBytes();
+	}
+	return ResidentBytes;
+}
+
 void FEditorStaticMesh::SetLODCount(int32 LODCount)
 {
 	EditableLODCount = LODCount;
@@ -87,11 +148,8 @@ void FEditorStaticMesh::SetLODScreenSize(float ScreenSize, FName PlatformGroupNa
 {
 	if (!Mesh->bAutoComputeLODScreenSize)
 	{
-		// First propagate any changes from the source models to our local scratch.
-		for (int32 i = 0; i < Mesh->GetNumSourceModels(); ++i)
-		{
-			LODScreenSizes[i] = Mesh->GetSourceModel(i).ScreenSize;
-		}
+		// The local scratch is filled from the source models by UpdateLODStats, refreshing it here would drop
+		// the screen sizes set for other LODs before the next ApplyChanges.
 
 		// Update Display factors for further LODs
 		const float MinimumDifferenceInScreenSize = KINDA_SMALL_NUMBER;
@@ -103,11 +161,7 @@ void FEditorStaticMesh::SetLODScreenSize(float ScreenSize, FName PlatformGroupNa
 		else
 		{
 			// Per-platform overrides don't have any restrictions
-			float* PlatformScreenSize = LODScreenSizes[LODIndex].PerPlatform.Find(PlatformGroupName);
-			if (PlatformScreenSize != nullptr)
-			{
-				*PlatformScreenSize = ScreenSize;
-			}
+			LODScreenSizes[LODIndex].PerPlatform.FindOrAdd(PlatformGroupName) = ScreenSize;
 		}
 
 		// Make sure we aren't trying to overlap or have more than one LOD for a value
@@ -153,40 +207,6 @@ void FEditorStaticMesh::ApplyChanges()
 
 void FEditorStaticMesh::ApplyRecommendMeshSettings(URecommendMeshSettings* RecommendMeshSettings, FOutputDevice& Ar)
 {
-	bool bIsApplyNeeded = false;
-	int32 TempMaxNumTriangles = GetNumTriangles();
-	// Check MaxTriangles and fixed.
-	if (GetNumTriangles() > RecommendMeshSettings->MaxTriangles)
-	{
-		float TrianglesPercent = RecommendMeshSettings->MaxTriangles / GetNumTriangles();
-		EditableLODReductionSettings[0].PercentTriangles = TrianglesPercent;
-		TempMaxNumTriangles = RecommendMeshSettings->MaxTriangles;
-		bIsApplyNeeded = true;
-	}
-
-	// Check LOD Count and fixed.
-	int32 TempLODCount = EditableLODCount;
-	for (int32 Index = RecommendMeshSettings->MaxTrianglesForLODNum.Num()-1; Index >= 0; --Index)
-	{
-		if (TempMaxNumTriangles > RecommendMeshSettings->MaxTrianglesForLODNum[Index].Triangles)
-		{
-			TempLODCount = RecommendMeshSettings->MaxTrianglesForLODNum[Index].LODCount;
-			break;
-		}
-	}
-	if (TempLODCount > EditableLODCount)
-	{
-		EditableLODCount = TempLODCount;
-		bIsApplyNeeded = true;
-	}
-
-	if (bIsApplyNeeded)
-	{
-		ApplyChanges();
-		UpdateMeshStats();
-		bIsApplyNeeded = false;
-	}
-
 	FString ErrorMessage;
 	int32 LODIndex = 0;
 	// Check UVChannels but not fixed, need artists determine.
@@ -213,41 +233,199 @@ void FEditorStaticMesh::ApplyRecommendMeshSettings(URecommendMeshSettings* Recom
 		}
 	}
 
-	// Check LOD PercentTriangles and fixed.
-	for (LODIndex = 1; LODIndex < GetNumLODs(); ++LODIndex)
+	if (!ErrorMessage.IsEmpty())
 	{
-		float RecommendPercentTriangles = RecommendMeshSettings->GetRecommendLODTrianglesPercent(LODIndex, EditableLODReductionSettings[0].PercentTriangles);
-		if (EditableLODReductionSettings[LODIndex].PercentTriangles > RecommendPercentTriangles)
+		FString MeshName = Mesh->GetFullName();
+		Ar.Logf(TEXT("%s"), *MeshName);
+		Ar.Logf(TEXT("%s"), *ErrorMessage);
+	}
+
+	// Check MaxTriangles, LOD count, LOD PercentTriangles and ScreenSize and fixed, with a single rebuild.
+	FStaticMeshLODSettingsChange Change;
+	if (GatherRecommendLODSettings(RecommendMeshSettings, Change))
+	{
+		FlushRenderingCommands();
+		ApplyLODSettingsChange(Mesh, Change);
+		Mesh->PostEditChange();
+		UpdateMeshStats();
+	}
+}
+
+bool FEditorStaticMesh::GatherRecommendLODSettings(URecommendMeshSettings* RecommendMeshSettings, FStaticMeshLODSettingsChange& OutChange) const
+{
+	OutChange = FStaticMeshLODSettingsChange();
+	OutChange.MeshPath = FSoftObjectPath(Mesh);
+	OutChange.OldLODCount = Mesh->GetNumSourceModels();
+	for (int32 LODIndex = 0; LODIndex < OutChange.OldLODCount; ++LODIndex)
+	{
+		const FStaticMeshSourceModel& SrcModel = Mesh->GetSourceModel(LODIndex);
+		OutChange.OldPercentTriangles.Add(SrcModel.ReductionSettings.PercentTriangles);
+		OutChange.OldScreenSizes.Add(SrcModel.ScreenSize);
+	}
+	OutChange.NewLODCount = OutChange.OldLODCount;
+	OutChange.NewPercentTriangles = OutChange.OldPercentTriangles;
+	OutChange.NewScreenSizes = OutChange.OldScreenSizes;
+	if (OutChange.OldLODCount == 0)
+	{
+		return false;
+	}
+
+	// LODs whose geometry changes with these settings, their render data can not be measured yet.
+	uint32 ReducedLODs = 0;
+
+	// Check MaxTriangles.
+	int32 LOD0Triangles = GetNumTriangles();
+	if (LOD0Triangles > RecommendMeshSettings->MaxTriangles)
+	{
+		OutChange.NewPercentTriangles[0] = OutChange.OldPercentTriangles[0] * RecommendMeshSettings->MaxTriangles / (float)LOD0Triangles;
+		LOD0Triangles = RecommendMeshSettings->MaxTriangles;
+		ReducedLODs = ~0u;
+	}
+
+	// Check LOD Count.
+	for (int32 Index = RecommendMeshSettings->MaxTrianglesForLODNum.Num() - 1; Index >= 0; --Index)
+	{
+		if (LOD0Triangles > RecommendMeshSettings->MaxTrianglesForLODNum[Index].Triangles)
 		{
-			EditableLODReductionSettings[LODIndex].PercentTriangles = RecommendPercentTriangles;
-			bIsApplyNeeded = true;
+			OutChange.NewLODCount = FMath::Clamp(RecommendMeshSettings->MaxTrianglesForLODNum[Index].LODCount, OutChange.OldLODCount, (int32)MAX_STATIC_MESH_LODS);
+			break;
 		}
 	}
+	for (int32 LODIndex = OutChange.OldLODCount; LODIndex < OutChange.NewLODCount; ++LODIndex)
+	{
+		OutChange.NewPercentTriangles.Add(1.f);
+		OutChange.NewScreenSizes.Add(FPerPlatformFloat(0.f));
+		ReducedLODs |= 1u << LODIndex;
+	}
 
-	// Check LOD ScreenSize and fixed.
-	for (LODIndex = 0; LODIndex < GetNumLODs(); ++LODIndex)
+	// Check LOD PercentTriangles, new LODs always take the recommended value.
+	for (int32 LODIndex = 1; LODIndex < OutChange.NewLODCount; ++LODIndex)
+	{
+		float RecommendPercentTriangles = RecommendMeshSettings->GetRecommendLODTrianglesPercent(LODIndex, OutChange.NewPercentTriangles[0]);
+		if (LODIndex >= OutChange.OldLODCount || OutChange.NewPercentTriangles[LODIndex] > RecommendPercentTriangles)
+		{
+			OutChange.NewPercentTriangles[LODIndex] = RecommendPercentTriangles;
+			ReducedLODs |= 1u << LODIndex;
+		}
+	}
+
+	// Check LOD ScreenSize, ignored by the engine while the screen sizes are computed automatically. LODs already
+	// built are measured against LOD0, LODs whose geometry changes fall back to the fixed table.
+	if (!Mesh->bAutoComputeLODScreenSize)
 	{
-		float RecommendScreenSize = RecommendMeshSettings->GetRecommendLODScreenSize(NAME_None,LODIndex);
-		if (GetLODScreenSize(NAME_None, LODIndex) < RecommendScreenSize)
+		TArray<FLODGeometricError> LODErrors;
+		TArray<FPerPlatformFloat> ErrorScreenSizes;
+		if (Mesh->RenderData)
 		{
-			SetLODScreenSize(RecommendScreenSize, NAME_None, LODIndex);
-			bIsApplyNeeded = true;
+			FLODGeometricErrorAnalysis::MeasureLODs(Mesh, RecommendMeshSettings->LODErrorSamples, LODErrors);
+			FLODGeometricErrorAnalysis::ComputeScreenSizes(LODErrors, Mesh->RenderData->Bounds.SphereRadius, FCameraProfileTable::CreateForTargetPlatforms(), RecommendMeshSettings->MaxLODPixelError, ErrorScreenSizes);
 		}
 
+		const float MinimumDifferenceInScreenSize = 0.01f;
+		const float ScreenSizeTolerance = 0.001f;
+		for (int32 LODIndex = 1; LODIndex < OutChange.NewLODCount; ++LODIndex)
+		{
+			FPerPlatformFloat& ScreenSize = OutChange.NewScreenSizes[LODIndex];
+			if (ErrorScreenSizes.IsValidIndex(LODIndex) && (ReducedLODs & (1u << LODIndex)) == 0)
+			{
+				const FPerPlatformFloat& RecommendScreenSize = ErrorScreenSizes[LODIndex];
+				if (!FMath::IsNearlyEqual(ScreenSize.Default, RecommendScreenSize.Default, ScreenSizeTolerance))
+				{
+					ScreenSize.Default = RecommendScreenSize.Default;
+				}
+				for (const TPair<FName, float>& PlatformScreenSize : RecommendScreenSize.PerPlatform)
+				{
+					const float* CurrentScreenSize = ScreenSize.PerPlatform.Find(PlatformScreenSize.Key);
+					if (!CurrentScreenSize || !FMath::IsNearlyEqual(*CurrentScreenSize, PlatformScreenSize.Value, ScreenSizeTolerance))
+					{
+						ScreenSize.PerPlatform.Add(PlatformScreenSize.Key, PlatformScreenSize.Value);
+					}
+				}
+			}
+			else
+			{
+				float RecommendScreenSize = RecommendMeshSettings->GetRecommendLODScreenSize(NAME_None, LODIndex);
+				if (LODIndex >= OutChange.OldLODCount || ScreenSize.Default < RecommendScreenSize)
+				{
+					ScreenSize.Default = RecommendScreenSize;
+				}
+			}
+
+			// Make sure we aren't trying to overlap or have more than one LOD for a value
+			const float MaxValue = FMath::Max(OutChange.NewScreenSizes[LODIndex - 1].Default - MinimumDifferenceInScreenSize, 0.0f);
+			ScreenSize.Default = FMath::Min(ScreenSize.Default, MaxValue);
+		}
 	}
 
-	if (!ErrorMessage.IsEmpty())
+	return OutChange.HasChanges();
+}
+
+void FEditorStaticMesh::ApplyLODSettingsChange(UStaticMesh* StaticMesh, const FStaticMeshLODSettingsChange& Change)
+{
+	StaticMesh->Modify();
+	StaticMesh->SetNumSourceModels(Change.NewLODCount);
+	for (int32 LODIndex = 0; LODIndex < Change.NewLODCount; ++LODIndex)
 	{
-		FString MeshName = Mesh->GetFullName();
-		Ar.Logf(TEXT("%s"), *MeshName);
-		Ar.Logf(TEXT("%s"), *ErrorMessage);
+		FStaticMeshSourceModel& SrcModel = StaticMesh->GetSourceModel(LODIndex);
+		SrcModel.ReductionSettings.PercentTriangles = Change.NewPercentTriangles[LODIndex];
+		if (!StaticMesh->bAutoComputeLODScreenSize)
+		{
+			SrcModel.ScreenSize = Change.NewScreenSizes[LODIndex];
+		}
 	}
+}
 
-	if (bIsApplyNeeded)
+bool FStaticMeshLODSettingsChange::HasChanges() const
+{
+	if (NewLODCount != OldLODCount)
 	{
-		ApplyChanges();
-		UpdateMeshStats();
-		bIsApplyNeeded = false;
+		return true;
+	}
+
+	for (int32 LODIndex = 0; LODIndex < NewLODCount; ++LODIndex)
+	{
+		if (NewPercentTriangles[LODIndex] != OldPercentTriangles[LODIndex] ||
+			NewScreenSizes[LODIndex].Default != OldScreenSizes[LODIndex].Default ||
+			!NewScreenSizes[LODIndex].PerPlatform.OrderIndependentCompareEqual(OldScreenSizes[LODIndex].PerPlatform))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FStaticMeshLODSettingsChange::PrintDiff(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("%s"), *MeshPath.ToString());
+	if (NewLODCount != OldLODCount)
+	{
+		Ar.Logf(TEXT("    LOD数量: %d -> %d"), OldLODCount, NewLODCount);
+	}
+
+	for (int32 LODIndex = 0; LODIndex < NewLODCount; ++LODIndex)
+	{
+		const bool bNewLOD = LODIndex >= OldLODCount;
+		const FString OldPercent = bNewLOD ? TEXT("新增") : FString::Printf(TEXT("%.3f"), OldPercentTriangles[LODIndex]);
+		if (bNewLOD || NewPercentTriangles[LODIndex] != OldPercentTriangles[LODIndex])
+		{
+			Ar.Logf(TEXT("    LOD[%d] PercentTriangles: %s -> %.3f"), LODIndex, *OldPercent, NewPercentTriangles[LODIndex]);
+		}
+
+		const FPerPlatformFloat& NewScreenSize = NewScreenSizes[LODIndex];
+		if (bNewLOD || NewScreenSize.Default != OldScreenSizes[LODIndex].Default)
+		{
+			const FString OldScreenSize = bNewLOD ? TEXT("新增") : FString::Printf(TEXT("%.3f"), OldScreenSizes[LODIndex].Default);
+			Ar.Logf(TEXT("    LOD[%d] ScreenSize: %s -> %.3f"), LODIndex, *OldScreenSize, NewScreenSize.Default);
+		}
+		for (const TPair<FName, float>& PlatformScreenSize : NewScreenSize.PerPlatform)
+		{
+			const float* OldPlatformScreenSize = bNewLOD ? nullptr : OldScreenSizes[LODIndex].PerPlatform.Find(PlatformScreenSize.Key);
+			if (!OldPlatformScreenSize || *OldPlatformScreenSize != PlatformScreenSize.Value)
+			{
+				const FString OldScreenSize = OldPlatformScreenSize ? FString::Printf(TEXT("%.3f"), *OldPlatformScreenSize) : TEXT("未设置");
+				Ar.Logf(TEXT("    LOD[%d] ScreenSize[%s]: %s -> %.3f"), LODIndex, *PlatformScreenSize.Key.ToString(), *OldScreenSize, PlatformScreenSize.Value);
+			}
+		}
 	}
 }
 
@@ -320,28 +498,128 @@ float FEditorStaticMesh::GetLODScreenSize(FName PlatformGroupName, int32 LODInde
 	return ScreenSize;
 }
 
+const FStaticMeshLODMemory& FEditorStaticMesh::GetLODMemory(int32 LODIndex /*= 0*/) const
+{
+	static const FStaticMeshLODMemory EmptyMemory;
+	return LODMemory.IsValidIndex(LODIndex) ? LODMemory[LODIndex] : EmptyMemory;
+}
+
+int64 FEditorStaticMesh::GetResidentBytes() const
+{
+	int64 ResidentBytes = 0;
+	for (const FStaticMeshLODMemory& Memory : LODMemory)
+	{
+		ResidentBytes += Memory.GetTotalBytes();
+	}
+	return ResidentBytes;
+}
+
 bool  FEditorStaticMesh::HasVertexColors()const
 {
 	for (int32 LODIndex = 0; LODIndex < Mesh->GetNumSourceModels(); ++LODIndex)
 	{
-		const FMeshDescription* MeshDescription = Mesh->GetMeshDescription(LODIndex);
-		FStaticMeshConstAttributes Attributes(*MeshDescription);
-		TVertexInstanceAttributesConstRef<FVector4> VertexInstanceColors = Attributes.GetVertexInstanceColors();
-		if (!VertexInstanceColors.IsValid())
+		const FMeshAttributeStatistics* Statistics = FMeshAttributeStatisticsCache::Get().Find(Mesh, LODIndex);
+		if (Statistics && Statistics->bHasVertexColors)
 		{
-			continue;
+			return true;
 		}
+	}
+	return false;
+}
+
+void FEditorStaticMesh::GetVertexFormatSavings(int32 LODIndex, float MaxHalfPrecisionUVError, bool bHighPrecisionTangents, FVertexFormatSavings& OutSavings) const
+{
+	OutSavings = FVertexFormatSavings();
+	if (!Mesh->RenderData || !Mesh->RenderData->LODResources.IsValidIndex(LODIndex))
+	{
+		return;
+	}
+
+	const FStaticMeshLODResources& LODModel = Mesh->RenderData->LODResources[LODIndex];
+	const FStaticMeshVertexBuffer& VertexBuffer = LODModel.VertexBuffers.StaticMeshVertexBuffer;
+	const int64 NumLODVertices = VertexBuffer.GetNumVertices();
+	const int32 NumTexCoords = VertexBuffer.GetNumTexCoords();
 
-		for (const FVertexInstanceID VertexInstanceID : MeshDescription->VertexInstances().GetElementIDs())
+	// UV数据已释放时(没有CPU访问)无法判断误差, 不做检查
+	if (VertexBuffer.GetUseFullPrecisionUVs() && NumTexCoords > 0 && VertexBuffer.GetTexCoordData())
+	{
+		float MaxError = 0.f;
+		for (int32 VertexIndex = 0; VertexIndex < NumLODVertices && MaxError <= MaxHalfPrecisionUVError; ++VertexIndex)
 		{
-			FLinearColor VertexInstanceColor(VertexInstanceColors[VertexInstanceID]);
-			if (VertexInstanceColor != FLinearColor::White)
+			for (int32 UVIndex = 0; UVIndex < NumTexCoords; ++UVIndex)
 			{
-				return true;
+				const FVector2D UV = VertexBuffer.GetVertexUV(VertexIndex, UVIndex);
+				MaxError = FMath::Max(MaxError, FMath::Abs(FFloat16(UV.X).GetFloat() - UV.X));
+				MaxError = FMath::Max(MaxError, FMath::Abs(FFloat16(UV.Y).GetFloat() - UV.Y));
 			}
 		}
+		OutSavings.HalfPrecisionUVError = MaxError;
+		if (MaxError <= MaxHalfPrecisionUVError)
+		{
+			OutSavings.UVBytes = NumLODVertices * NumTexCoords * (sizeof(FVector2D) - sizeof(FVector2DHalf));
+		}
+	}
+
+	if (VertexBuffer.GetUseHighPrecisionTangentBasis() && !bHighPrecisionTangents)
+	{
+		// TangentX 和 TangentZ 从 FPackedRGBA16N 降为 FPackedNormal
+		OutSavings.TangentBytes = NumLODVertices * 2 * (sizeof(FPackedRGBA16N) - sizeof(FPackedNormal));
+	}
+
+	if (NumLODVertices <= (int64)MAX_uint16 + 1)
+	{
+		auto Get32BitSavings = [](const FRawStaticIndexBuffer& IndexBuffer) -> int64
+		{
+			return IndexBuffer.Is32Bit() ? (int64)IndexBuffer.GetNumIndices() * (sizeof(uint32) - sizeof(uint16)) : 0;
+		};
+		OutSavings.IndexBytes = Get32BitSavings(LODModel.IndexBuffer) + Get32BitSavings(LODModel.DepthOnlyIndexBuffer);
+		if (LODModel.AdditionalIndexBuffers)
+		{
+			OutSavings.IndexBytes += Get32BitSavings(LODModel.AdditionalIndexBuffers->ReversedIndexBuffer)
+				+ Get32BitSavings(LODModel.AdditionalIndexBuffers->ReversedDepthOnlyIndexBuffer)
+				+ Get32BitSavings(LODModel.AdditionalIndexBuffers->WireframeIndexBuffer);
+		}
+	}
+
+	// 与 FStaticMeshLODMemory 一致, 允许CPU访问时内存中还有一份顶点和索引数据
+	if (Mesh->bAllowCPUAccess)
+	{
+		OutSavings.UVBytes *= 2;
+		OutSavings.TangentBytes *= 2;
+		OutSavings.IndexBytes += LODModel.IndexBuffer.Is32Bit() && NumLODVertices <= (int64)MAX_uint16 + 1 ? (int64)LODModel.IndexBuffer.GetNumIndices() * (sizeof(uint32) - sizeof(uint16)) : 0;
+	}
+}
+
+void FEditorStaticMesh::GetMetricsRecord(FAssetMetricsRecord& OutRecord) const
+{
+	OutRecord.ObjectPath = Mesh->GetPathName();
+	OutRecord.AssetType = EAssetMetricsType::StaticMesh;
+	OutRecord.NumLODs = FMath::Min(GetNumLODs(), OA_METRICS_MAX_LODS);
+	OutRecord.NumMaterials = 0;
+	for (const FStaticMaterial& StaticMaterial : Mesh->StaticMaterials)
+	{
+		if (!StaticMaterial.MaterialSlotName.ToString().Contains(TEXT("LOD"), ESearchCase::CaseSensitive))
+		{
+			++OutRecord.NumMaterials;
+		}
+	}
+
+	for (int32 LODIndex = 0; LODIndex < OutRecord.NumLODs; ++LODIndex)
+	{
+		OutRecord.NumTriangles[LODIndex]  = GetNumTriangles(LODIndex);
+		OutRecord.NumVertices[LODIndex]   = GetNumVertices(LODIndex);
+		OutRecord.NumUVChannels[LODIndex] = GetNumUVChannels(LODIndex);
+		OutRecord.NumSections[LODIndex]   = GetNumMaterials(LODIndex);
+		OutRecord.ResidentBytes[LODIndex] = (int32)FMath::Min<int64>(GetLODMemory(LODIndex).GetTotalBytes(), MAX_int32);
+		if (Mesh->bAutoComputeLODScreenSize)
+		{
+			OutRecord.LODScreenSizes[LODIndex] = Mesh->RenderData->ScreenSize[LODIndex];
+		}
+		else if (Mesh->IsSourceModelValid(LODIndex))
+		{
+			OutRecord.LODScreenSizes[LODIndex] = Mesh->GetSourceModel(LODIndex).ScreenSize;
+		}
 	}
-	return false;
 }
 
 void FEditorStaticMesh::AddReferencedObjects(FReferenceCollector& Collector)
@@ -2,9 +2,102 @@
 
 #include "CoreMinimal.h"
 #include "UObject/GCObject.h"
+#include "UObject/SoftObjectPath.h"
 #include "Engine/StaticMesh.h"
 #include "RecommendMeshSettings.h"
 
+struct FAssetMetricsRecord;
+
+/** Estimated resident memory of one static mesh LOD, read from the render resources. */
+struct FStaticMeshLODMemory
+{
+	FStaticMeshLODMemory()
+		: PositionBytes(0)
+		, TangentBytes(0)
+		, TexCoordBytes(0)
+		, ColorBytes(0)
+		, IndexBytes(0)
+		, DistanceFieldBytes(0)
+		, CPUAccessBytes(0)
+	{
+	}
+
+	int64 PositionBytes;
+	int64 TangentBytes;
+	int64 TexCoordBytes;
+	int64 ColorBytes;
+
+	/** Index buffer plus the depth only, reversed and wireframe index buffers when they are built. */
+	int64 IndexBytes;
+
+	/** Distance field volume texture, only counted on LOD0. */
+	int64 DistanceFieldBytes;
+
+	/** Vertex and index data kept in system memory when bAllowCPUAccess is set. */
+	int64 CPUAccessBytes;
+
+	int64 GetGPUBytes() const { return PositionBytes + TangentBytes + TexCoordBytes + ColorBytes + IndexBytes + DistanceFieldBytes; }
+	int64 GetTotalBytes() const { return GetGPUBytes() + CPUAccessBytes; }
+
+	static void Compute(const UStaticMesh* StaticMesh, int32 LODIndex, FStaticMeshLODMemory& OutMemory);
+
+	/** Sum of all LODs, the same total as FEditorStaticMesh::GetResidentBytes. */
+	static int64 ComputeResidentBytes(const UStaticMesh* StaticMesh);
+};
+
+/** Bytes one static mesh LOD would save with lower precision vertex and index formats. */
+struct FVertexFormatSavings
+{
+	FVertexFormatSavings()
+		: UVBytes(0)
+		, TangentBytes(0)
+		, IndexBytes(0)
+		, HalfPrecisionUVError(0.f)
+	{
+	}
+
+	/** Full precision UVs that fit in half precision. */
+	int64 UVBytes;
+
+	/** High precision tangent basis. */
+	int64 TangentBytes;
+
+	/** 32 bit index buffers of a LOD with less than 65536 vertices. */
+	int64 IndexBytes;
+
+	/** Largest error of the UVs after a round trip through half precision. */
+	float HalfPrecisionUVError;
+
+	int64 GetTotalBytes() const { return UVBytes + TangentBytes + IndexBytes; }
+};
+
+/** LOD settings the recommended mesh settings would write to a mesh, gathered without touching it. */
+struct FStaticMeshLODSettingsChange
+{
+	FStaticMeshLODSettingsChange()
+		: OldLODCount(0)
+		, NewLODCount(0)
+	{
+	}
+
+	FSoftObjectPath MeshPath;
+
+	int32 OldLODCount;
+	int32 NewLODCount;
+
+	/** ReductionSettings.PercentTriangles of each source model. */
+	TArray<float> OldPercentTriangles;
+	TArray<float> NewPercentTriangles;
+
+	TArray<FPerPlatformFloat> OldScreenSizes;
+	TArray<FPerPlatformFloat> NewScreenSizes;
+
+	bool HasChanges() const;
+
+	/** One line per changed value, the dry run report of the LOD settings fix. */
+	void PrintDiff(FOutputDevice& Ar) const;
+};
+
 class FEditorStaticMesh : public FGCObject
 {
 public:
@@ -19,6 +112,15 @@ public:
 	void ApplyChanges();
 	void ApplyRecommendMeshSettings(URecommendMeshSettings* RecommendMeshSettings, FOutputDevice& Ar);
 
+	/** Computes the LOD count, reduction and screen sizes ApplyRecommendMeshSettings would set, returns true if any differs. */
+	bool GatherRecommendLODSettings(URecommendMeshSettings* RecommendMeshSettings, FStaticMeshLODSettingsChange& OutChange) const;
+
+	/**
+	 * Writes the new LOD settings to the source models. Does not flush rendering commands or rebuild, so a
+	 * batch of meshes can be changed first and built together.
+	 */
+	static void ApplyLODSettingsChange(UStaticMesh* StaticMesh, const FStaticMeshLODSettingsChange& Change);
+
 	UStaticMesh* GetMesh() { return Mesh; };
 	TArray<FStaticMaterial> GetMaterials();
 	int32 GetNumTriangles(int32 LODIndex = 0) const;
@@ -28,7 +130,13 @@ public:
 	int32 GetNumLODs()const;
 	float GetTrianglesPercent(int32 LODIndex = 0)const;
 	float GetLODScreenSize(FName PlatformGroupName, int32 LODIndex = 0)const;
+	const FStaticMeshLODMemory& GetLODMemory(int32 LODIndex = 0) const;
+	int64 GetResidentBytes() const;
 	bool  HasVertexColors()const;
+
+	/** Counts the CPU access copies too, bHighPrecisionTangents keeps the tangent basis of hero assets. */
+	void  GetVertexFormatSavings(int32 LODIndex, float MaxHalfPrecisionUVError, bool bHighPrecisionTangents, FVertexFormatSavings& OutSavings)const;
+	void  GetMetricsRecord(FAssetMetricsRecord& OutRecord)const;
 public:
 	//~ Begin FGCObject Interface
 	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
@@ -49,6 +157,9 @@ private:
 
 	TArray<int32> NumMaterials;
 
+	/** Estimated resident memory of the static mesh LOD. */
+	TArray<FStaticMeshLODMemory> LODMemory;
+
 	/** The display factors at which LODs swap */
 	TArray<FPerPlatformFloat> LODScreenSizes;
 
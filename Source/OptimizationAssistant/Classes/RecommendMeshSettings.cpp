@@ -5,7 +5,10 @@ URecommendMeshSettings::URecommendMeshSettings()
 	, MaxUVChannels(4)
 	, MaxMaterials(16)
 	, LODMaxMaterials(8)
+	, MaxResidentMemoryMB(8.f)
 	, LODTrianglesPercentDownScale(0.5f)
+	, MaxLODPixelError(1.f)
+	, LODErrorSamples(4096)
 {
 	LODScreenSizes.Add(1.f);
 	LODScreenSizes.Add(0.3f);
@@ -44,12 +44,25 @@ public:
 	UPROPERTY(EditAnywhere, config, meta = (UIMin = "1", UIMax = "16", ClampMin = "1", ClampMax = "16", DisplayName = "LOD Max Materials"))
 	int32 LODMaxMaterials;
 
+	// Mesh所有LOD常驻内存(顶点、索引、距离场及CPU访问副本)的上限(MB)
+	UPROPERTY(EditAnywhere, config, meta = (UIMin = "0.5", UIMax = "64", ClampMin = "0.1", DisplayName = "Max Resident Memory (MB)"))
+	float MaxResidentMemoryMB;
+
 	UPROPERTY(EditAnywhere, config, meta = (UIMin = "0.1", UIMax = "1", ClampMin = "0.1", ClampMax = "1"))
 	float LODTrianglesPercentDownScale;
 
+	// 无法测量LOD几何误差时(如骨骼模型)使用的ScreenSize
 	UPROPERTY(EditAnywhere, config, EditFixedSize)
 	TArray<FPerPlatformFloat> LODScreenSizes;
 
+	// 按LOD与LOD0的几何误差推荐ScreenSize时，误差投影到屏幕上允许的最大像素数
+	UPROPERTY(EditAnywhere, config, meta = (UIMin = "0.25", UIMax = "8", ClampMin = "0.1", DisplayName = "Max LOD Pixel Error"))
+	float MaxLODPixelError;
+
+	// 测量LOD几何误差时每个方向的采样点数
+	UPROPERTY(EditAnywhere, config, meta = (UIMin = "256", UIMax = "65536", ClampMin = "16", DisplayName = "LOD Error Samples"))
+	int32 LODErrorSamples;
+
 	UPROPERTY(EditAnywhere, config, EditFixedSize)
 	TArray<FTriangleLODThresholds> MaxTrianglesForLODNum;
 
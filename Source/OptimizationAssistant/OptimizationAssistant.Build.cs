@@ -56,6 +56,12 @@ public class OptimizationAssistant : ModuleRules
                 "MeshDescription",
                 "StaticMeshDescription",
                 "SkeletalMeshUtilitiesCommon",
+                "Landscape",
+                "MeshMergeUtilities",
+                "MeshReductionInterface",
+                "MeshUtilitiesCommon",
+                "SourceControl",
+                "AssetTools",
 
 				// Project Module
                 "HottaFramework",
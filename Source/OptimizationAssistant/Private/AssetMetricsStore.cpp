@@ -0,0 +1,465 @@
+#include "AssetMetricsStore.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Paths.h"
+#include "OptimizationAssistantHelpers.h"
+
+namespace AssetMetricsFile
+{
+	static const uint32 Magic = 0x534D414F; // "OAMS"
+	static const uint32 Version = 3;
+	static const int64 ColumnAlignment = 64;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 NumRecords;
+		int32 NumColumns;
+	};
+
+	struct FColumnEntry
+	{
+		uint32 Column;
+		uint32 Reserved;
+		int64 Offset;
+		int64 Size;
+	};
+
+	struct FColumnWriteBlock
+	{
+		FColumnWriteBlock(EAssetMetricsColumn InColumn)
+			: Column(InColumn)
+			, Offset(0)
+			, Size(0)
+		{
+		}
+
+		template<typename T>
+		void AddChunk(const TArray<T>& Data)
+		{
+			Chunks.Emplace(Data.GetData(), Data.Num() * (int64)sizeof(T));
+			Size += Data.Num() * (int64)sizeof(T);
+		}
+
+		EAssetMetricsColumn Column;
+		TArray<TPair<const void*, int64>, TInlineAllocator<OA_METRICS_MAX_LODS>> Chunks;
+		int64 Offset;
+		int64 Size;
+	};
+}
+
+FAssetMetricsRecord::FAssetMetricsRecord()
+	: AssetType(EAssetMetricsType::StaticMesh)
+	, NumLODs(0)
+	, NumMaterials(0)
+{
+	FMemory::Memzero(NumTriangles);
+	FMemory::Memzero(NumVertices);
+	FMemory::Memzero(NumUVChannels);
+	FMemory::Memzero(NumSections);
+	FMemory::Memzero(ResidentBytes);
+}
+
+float FAssetMetricsRecord::GetLODScreenSize(FName PlatformGroupName, int32 LODIndex) const
+{
+	const FPerPlatformFloat& LODScreenSize = LODScreenSizes[FMath::Clamp(LODIndex, 0, OA_METRICS_MAX_LODS - 1)];
+	float ScreenSize = LODScreenSize.Default;
+	if (PlatformGroupName != NAME_None)
+	{
+		const float* PlatformScreenSize = LODScreenSize.PerPlatform.Find(PlatformGroupName);
+		if (PlatformScreenSize != nullptr)
+		{
+			ScreenSize = *PlatformScreenSize;
+		}
+	}
+	return ScreenSize;
+}
+
+int64 FAssetMetricsRecord::GetResidentBytes() const
+{
+	int64 TotalBytes = 0;
+	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
+	{
+		TotalBytes += ResidentBytes[LODIndex];
+	}
+	return TotalBytes;
+}
+
+FAssetMetricsStore& FAssetMetricsStore::Get()
+{
+	static FAssetMetricsStore Store;
+	return Store;
+}
+
+FString FAssetMetricsStore::GetDefaultFilePath()
+{
+	return FPaths::Combine(FPaths::ProfilingDir(), TEXT("OptimizationAssistant"), TEXT("AssetMetrics.oam"));
+}
+
+void FAssetMetricsStore::Reset()
+{
+	ObjectPaths.Reset();
+	AssetTypes.Reset();
+	NumLODs.Reset();
+	NumMaterials.Reset();
+	for (int32 LODIndex = 0; LODIndex < OA_METRICS_MAX_LODS; ++LODIndex)
+	{
+		LODTriangles[LODIndex].Reset();
+		LODVertices[LODIndex].Reset();
+		LODUVChannels[LODIndex].Reset();
+		LODSections[LODIndex].Reset();
+		LODResidentBytes[LODIndex].Reset();
+		LODScreenSizes[LODIndex].Reset();
+	}
+	PlatformScreenSizes.Reset();
+}
+
+void FAssetMetricsStore::AddRecord(const FAssetMetricsRecord& Record)
+{
+	ObjectPaths.Add(Record.ObjectPath);
+	AssetTypes.Add((uint8)Record.AssetType);
+	NumLODs.Add(Record.NumLODs);
+	NumMaterials.Add(Record.NumMaterials);
+	for (int32 LODIndex = 0; LODIndex < OA_METRICS_MAX_LODS; ++LODIndex)
+	{
+		const bool bValidLOD = LODIndex < Record.NumLODs;
+		LODTriangles[LODIndex].Add(bValidLOD ? Record.NumTriangles[LODIndex] : 0);
+		LODVertices[LODIndex].Add(bValidLOD ? Record.NumVertices[LODIndex] : 0);
+		LODUVChannels[LODIndex].Add(bValidLOD ? Record.NumUVChannels[LODIndex] : 0);
+		LODSections[LODIndex].Add(bValidLOD ? Record.NumSections[LODIndex] : 0);
+		LODResidentBytes[LODIndex].Add(bValidLOD ? Record.ResidentBytes[LODIndex] : 0);
+		LODScreenSizes[LODIndex].Add(bValidLOD ? Record.LODScreenSizes[LODIndex].Default : 0.0f);
+		if (bValidLOD)
+		{
+			for (const TPair<FName, float>& PlatformScreenSize : Record.LODScreenSizes[LODIndex].PerPlatform)
+			{
+				PlatformScreenSizes.Add({ ObjectPaths.Num() - 1, LODIndex, PlatformScreenSize.Key, PlatformScreenSize.Value });
+			}
+		}
+	}
+}
+
+bool FAssetMetricsStore::Save(const FString& Filename) const
+{
+	using namespace AssetMetricsFile;
+
+	const int32 NumRecords = Num();
+
+	TArray<int32> PathOffsets;
+	TArray<ANSICHAR> PathChars;
+	PathOffsets.Reserve(NumRecords + 1);
+	for (const FString& ObjectPath : ObjectPaths)
+	{
+		PathOffsets.Add(PathChars.Num());
+		FTCHARToUTF8 Converter(*ObjectPath);
+		PathChars.Append(Converter.Get(), Converter.Length());
+	}
+	PathOffsets.Add(PathChars.Num());
+
+	// 平台覆盖值展开成每个平台一组完整的列, 没有覆盖的记录使用默认值
+	TArray<FName> PlatformNames;
+	for (const FPlatformScreenSize& PlatformScreenSize : PlatformScreenSizes)
+	{
+		PlatformNames.AddUnique(PlatformScreenSize.PlatformGroupName);
+	}
+	PlatformNames.Sort(FNameLexicalLess());
+
+	TArray<ANSICHAR> PlatformNameChars;
+	TArray<TArray<float>> PlatformLODScreenSizes;
+	for (const FName PlatformName : PlatformNames)
+	{
+		FTCHARToUTF8 Converter(*PlatformName.ToString());
+		PlatformNameChars.Append(Converter.Get(), Converter.Length());
+		PlatformNameChars.Add('\0');
+		for (int32 LODIndex = 0; LODIndex < OA_METRICS_MAX_LODS; ++LODIndex)
+		{
+			PlatformLODScreenSizes.Add(LODScreenSizes[LODIndex]);
+		}
+	}
+	for (const FPlatformScreenSize& PlatformScreenSize : PlatformScreenSizes)
+	{
+		const int32 PlatformIndex = PlatformNames.IndexOfByKey(PlatformScreenSize.PlatformGroupName);
+		PlatformLODScreenSizes[PlatformIndex * OA_METRICS_MAX_LODS + PlatformScreenSize.LODIndex][PlatformScreenSize.RecordIndex] = PlatformScreenSize.ScreenSize;
+	}
+
+	TArray<FColumnWriteBlock> Blocks;
+	Blocks.Reserve((int32)EAssetMetricsColumn::Max);
+	Blocks.Emplace_GetRef(EAssetMetricsColumn::AssetType).AddChunk(AssetTypes);
+	Blocks.Emplace_GetRef(EAssetMetricsColumn::NumLODs).AddChunk(NumLODs);
+	Blocks.Emplace_GetRef(EAssetMetricsColumn::NumMaterials).AddChunk(NumMaterials);
+	FColumnWriteBlock& TrianglesBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::LODTriangles);
+	FColumnWriteBlock& VerticesBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::LODVertices);
+	FColumnWriteBlock& UVChannelsBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::LODUVChannels);
+	FColumnWriteBlock& SectionsBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::LODSections);
+	FColumnWriteBlock& ResidentBytesBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::LODResidentBytes);
+	FColumnWriteBlock& ScreenSizeBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::LODScreenSize);
+	for (int32 LODIndex = 0; LODIndex < OA_METRICS_MAX_LODS; ++LODIndex)
+	{
+		TrianglesBlock.AddChunk(LODTriangles[LODIndex]);
+		VerticesBlock.AddChunk(LODVertices[LODIndex]);
+		UVChannelsBlock.AddChunk(LODUVChannels[LODIndex]);
+		SectionsBlock.AddChunk(LODSections[LODIndex]);
+		ResidentBytesBlock.AddChunk(LODResidentBytes[LODIndex]);
+		ScreenSizeBlock.AddChunk(LODScreenSizes[LODIndex]);
+	}
+	Blocks.Emplace_GetRef(EAssetMetricsColumn::PathOffsets).AddChunk(PathOffsets);
+	Blocks.Emplace_GetRef(EAssetMetricsColumn::PathChars).AddChunk(PathChars);
+	Blocks.Emplace_GetRef(EAssetMetricsColumn::PlatformNames).AddChunk(PlatformNameChars);
+	FColumnWriteBlock& PlatformScreenSizeBlock = Blocks.Emplace_GetRef(EAssetMetricsColumn::PlatformLODScreenSize);
+	for (const TArray<float>& PlatformLODScreenSize : PlatformLODScreenSizes)
+	{
+		PlatformScreenSizeBlock.AddChunk(PlatformLODScreenSize);
+	}
+
+	int64 Cursor = sizeof(FHeader) + Blocks.Num() * sizeof(FColumnEntry);
+	for (FColumnWriteBlock& Block : Blocks)
+	{
+		Block.Offset = Align(Cursor, ColumnAlignment);
+		Cursor = Block.Offset + Block.Size;
+	}
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!FileWriter.IsValid())
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Unable to write asset metrics to %s."), *Filename);
+		return false;
+	}
+
+	FHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumRecords = NumRecords;
+	Header.NumColumns = Blocks.Num();
+	FileWriter->Serialize(&Header, sizeof(Header));
+
+	for (const FColumnWriteBlock& Block : Blocks)
+	{
+		FColumnEntry Entry;
+		Entry.Column = (uint32)Block.Column;
+		Entry.Reserved = 0;
+		Entry.Offset = Block.Offset;
+		Entry.Size = Block.Size;
+		FileWriter->Serialize(&Entry, sizeof(Entry));
+	}
+
+	uint8 Padding[ColumnAlignment] = { 0 };
+	for (const FColumnWriteBlock& Block : Blocks)
+	{
+		const int64 PaddingSize = Block.Offset - FileWriter->Tell();
+		check(PaddingSize >= 0 && PaddingSize < ColumnAlignment);
+		FileWriter->Serialize(Padding, PaddingSize);
+		for (const TPair<const void*, int64>& Chunk : Block.Chunks)
+		{
+			FileWriter->Serialize(const_cast<void*>(Chunk.Key), Chunk.Value);
+		}
+	}
+
+	const bool bSucceeded = FileWriter->Close() && !FileWriter->IsError();
+	if (bSucceeded)
+	{
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("Wrote metrics of %d assets to %s."), NumRecords, *Filename);
+	}
+	else
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Failed to write asset metrics to %s."), *Filename);
+	}
+	return bSucceeded;
+}
+
+FMappedAssetMetrics::FMappedAssetMetrics()
+	: MappedHandle(nullptr)
+	, MappedRegion(nullptr)
+	, NumRecords(0)
+{
+	FMemory::Memset(ColumnOffsets, 0xFF);
+	FMemory::Memzero(ColumnSizes);
+}
+
+FMappedAssetMetrics::~FMappedAssetMetrics()
+{
+	Close();
+}
+
+bool FMappedAssetMetrics::Open(const FString& Filename)
+{
+	using namespace AssetMetricsFile;
+
+	Close();
+
+	MappedHandle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename);
+	if (!MappedHandle)
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Unable to open asset metrics file %s."), *Filename);
+		return false;
+	}
+
+	const int64 FileSize = MappedHandle->GetFileSize();
+	if (FileSize < (int64)sizeof(FHeader))
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Asset metrics file %s is truncated."), *Filename);
+		Close();
+		return false;
+	}
+
+	MappedRegion = MappedHandle->MapRegion(0, FileSize);
+	if (!MappedRegion)
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Unable to map asset metrics file %s."), *Filename);
+		Close();
+		return false;
+	}
+
+	const uint8* FileData = MappedRegion->GetMappedPtr();
+	const FHeader& Header = *reinterpret_cast<const FHeader*>(FileData);
+	if (Header.Magic != Magic || Header.Version != Version || Header.NumRecords < 0 || Header.NumColumns < 0 ||
+		(int64)sizeof(FHeader) + Header.NumColumns * (int64)sizeof(FColumnEntry) > FileSize)
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Asset metrics file %s is invalid or was written by another version."), *Filename);
+		Close();
+		return false;
+	}
+
+	NumRecords = Header.NumRecords;
+	const FColumnEntry* Entries = reinterpret_cast<const FColumnEntry*>(FileData + sizeof(FHeader));
+	for (int32 EntryIndex = 0; EntryIndex < Header.NumColumns; ++EntryIndex)
+	{
+		const FColumnEntry& Entry = Entries[EntryIndex];
+		if (Entry.Column < (uint32)EAssetMetricsColumn::Max && Entry.Offset >= 0 && Entry.Size >= 0 && Entry.Offset + Entry.Size <= FileSize)
+		{
+			ColumnOffsets[Entry.Column] = Entry.Offset;
+			ColumnSizes[Entry.Column] = Entry.Size;
+		}
+	}
+
+	for (int32 ColumnIndex = 0; ColumnIndex < (int32)EAssetMetricsColumn::Max; ++ColumnIndex)
+	{
+		if (ColumnOffsets[ColumnIndex] < 0)
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Asset metrics file %s is missing column %d."), *Filename, ColumnIndex);
+			Close();
+			return false;
+		}
+	}
+
+	if (!ValidateColumns(Filename))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool FMappedAssetMetrics::ValidateColumns(const FString& Filename)
+{
+	auto GetMinSize = [this](EAssetMetricsColumn Column) -> int64
+	{
+		switch (Column)
+		{
+		case EAssetMetricsColumn::AssetType:				return (int64)NumRecords * sizeof(uint8);
+		case EAssetMetricsColumn::NumLODs:
+		case EAssetMetricsColumn::NumMaterials:				return (int64)NumRecords * sizeof(int32);
+		case EAssetMetricsColumn::LODTriangles:
+		case EAssetMetricsColumn::LODVertices:
+		case EAssetMetricsColumn::LODUVChannels:
+		case EAssetMetricsColumn::LODSections:
+		case EAssetMetricsColumn::LODResidentBytes:			return (int64)NumRecords * OA_METRICS_MAX_LODS * sizeof(int32);
+		case EAssetMetricsColumn::LODScreenSize:			return (int64)NumRecords * OA_METRICS_MAX_LODS * sizeof(float);
+		case EAssetMetricsColumn::PathOffsets:				return ((int64)NumRecords + 1) * sizeof(int32);
+		case EAssetMetricsColumn::PlatformLODScreenSize:	return (int64)NumRecords * OA_METRICS_MAX_LODS * sizeof(float) * PlatformNames.Num();
+		default:											return 0;
+		}
+	};
+
+	// 平台名决定平台屏幕尺寸列的大小, 需要先于列大小检查读取
+	const ANSICHAR* PlatformNameChars = GetColumn<ANSICHAR>(EAssetMetricsColumn::PlatformNames);
+	const int64 PlatformNamesSize = ColumnSizes[(uint32)EAssetMetricsColumn::PlatformNames];
+	if (PlatformNamesSize > 0 && PlatformNameChars[PlatformNamesSize - 1] != '\0')
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Asset metrics file %s has corrupted platform names."), *Filename);
+		return false;
+	}
+	for (int64 NameStart = 0; NameStart < PlatformNamesSize; )
+	{
+		const int32 NameLength = FCStringAnsi::Strlen(PlatformNameChars + NameStart);
+		PlatformNames.Add(FName(FUTF8ToTCHAR(PlatformNameChars + NameStart, NameLength).Get()));
+		NameStart += NameLength + 1;
+	}
+
+	for (int32 ColumnIndex = 0; ColumnIndex < (int32)EAssetMetricsColumn::Max; ++ColumnIndex)
+	{
+		if (ColumnSizes[ColumnIndex] < GetMinSize((EAssetMetricsColumn)ColumnIndex))
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Asset metrics file %s is truncated, column %d has %lld bytes for %d assets."), *Filename, ColumnIndex, ColumnSizes[ColumnIndex], NumRecords);
+			return false;
+		}
+	}
+
+	const int32* PathOffsets = GetColumn<int32>(EAssetMetricsColumn::PathOffsets);
+	const int64 PathCharsSize = ColumnSizes[(uint32)EAssetMetricsColumn::PathChars];
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		if (PathOffsets[Index] < 0 || PathOffsets[Index] > PathOffsets[Index + 1] || PathOffsets[Index + 1] > PathCharsSize)
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Asset metrics file %s has an object path outside of the path column."), *Filename);
+			return false;
+		}
+	}
+	return true;
+}
+
+void FMappedAssetMetrics::Close()
+{
+	delete MappedRegion;
+	MappedRegion = nullptr;
+	delete MappedHandle;
+	MappedHandle = nullptr;
+	NumRecords = 0;
+	FMemory::Memset(ColumnOffsets, 0xFF);
+	FMemory::Memzero(ColumnSizes);
+	PlatformNames.Reset();
+}
+
+const uint8* FMappedAssetMetrics::GetColumnData(EAssetMetricsColumn Column) const
+{
+	const int64 Offset = ColumnOffsets[(uint32)Column];
+	return MappedRegion && Offset >= 0 ? MappedRegion->GetMappedPtr() + Offset : nullptr;
+}
+
+const float* FMappedAssetMetrics::GetLODScreenSizes(int32 LODIndex, FName PlatformGroupName) const
+{
+	const int32 PlatformIndex = PlatformGroupName != NAME_None ? PlatformNames.IndexOfByKey(PlatformGroupName) : INDEX_NONE;
+	if (PlatformIndex == INDEX_NONE)
+	{
+		return GetLODScreenSizes(LODIndex);
+	}
+	const float* PlatformData = GetLODColumn<float>(EAssetMetricsColumn::PlatformLODScreenSize, LODIndex);
+	return PlatformData ? PlatformData + (int64)PlatformIndex * OA_METRICS_MAX_LODS * NumRecords : nullptr;
+}
+
+const ANSICHAR* FMappedAssetMetrics::GetObjectPathChars(int32 Index, int32& OutLength) const
+{
+	const int32* PathOffsets = GetColumn<int32>(EAssetMetricsColumn::PathOffsets);
+	const ANSICHAR* PathChars = GetColumn<ANSICHAR>(EAssetMetricsColumn::PathChars);
+	if (!PathOffsets || !PathChars || Index < 0 || Index >= NumRecords)
+	{
+		OutLength = 0;
+		return nullptr;
+	}
+	OutLength = PathOffsets[Index + 1] - PathOffsets[Index];
+	return PathChars + PathOffsets[Index];
+}
+
+FString FMappedAssetMetrics::GetObjectPath(int32 Index) const
+{
+	int32 Length = 0;
+	const ANSICHAR* PathChars = GetObjectPathChars(Index, Length);
+	if (!PathChars)
+	{
+		return FString();
+	}
+	FUTF8ToTCHAR Converter(PathChars, Length);
+	return FString(Converter.Length(), Converter.Get());
+}
@@ -0,0 +1,83 @@
+#include "CameraProfileTable.h"
+#include "SceneManagement.h"
+#include "OptimizationAssistantGlobalSettings.h"
+#include "OptimizationAssistantHelpers.h"
+
+FCameraProfileTable FCameraProfileTable::Create(const TArray<FCameraProfile>& CameraProfiles, const TArray<FName>& PlatformGroupNames)
+{
+	FCameraProfileTable Table;
+	for (const FCameraProfile& CameraProfile : CameraProfiles)
+	{
+		if (CameraProfile.PlatformGroupName == NAME_None || PlatformGroupNames.Contains(CameraProfile.PlatformGroupName))
+		{
+			Table.AddProfile(CameraProfile.Name, CameraProfile.PlatformGroupName, CameraProfile.FOV, CameraProfile.ResolutionX, CameraProfile.ResolutionY);
+		}
+	}
+
+	if (Table.Num() == 0)
+	{
+		Table.AddProfile(TEXT("Default"), NAME_None, 90.0f, 1920, 1080);
+	}
+	return Table;
+}
+
+FCameraProfileTable FCameraProfileTable::CreateForTargetPlatforms()
+{
+	return Create(GetDefault<UGlobalCheckSettings>()->CameraProfiles, FOptimizationAssistantHelpers::GetTargetPlatformGroupNames());
+}
+
+void FCameraProfileTable::AddProfile(const FString& Name, FName PlatformGroupName, float FOV, int32 ResolutionX, int32 ResolutionY)
+{
+	FCameraProfileEntry& Entry = Profiles.AddDefaulted_GetRef();
+	Entry.Name = Name;
+	Entry.PlatformGroupName = PlatformGroupName;
+	Entry.FOV = FMath::Clamp(FOV, 1.0f, 170.0f);
+	Entry.ResolutionX = FMath::Max(ResolutionX, 1);
+	Entry.ResolutionY = FMath::Max(ResolutionY, 1);
+
+	const float HalfFOVRad = Entry.FOV * (float)PI / 360.0f;
+	Entry.ProjectionMatrix = FPerspectiveMatrix(HalfFOVRad, (float)Entry.ResolutionX, (float)Entry.ResolutionY, 0.01f);
+	Entry.ScreenMultiple = FMath::Max(0.5f * Entry.ProjectionMatrix.M[0][0], 0.5f * Entry.ProjectionMatrix.M[1][1]);
+
+	ScreenMultiples.SetNumZeroed(Align(Profiles.Num(), 4));
+	ScreenMultiples[Profiles.Num() - 1] = Entry.ScreenMultiple;
+}
+
+FString FCameraProfileTable::GetProfileSuffix(int32 ProfileIndex) const
+{
+	if (Profiles.Num() <= 1)
+	{
+		return FString();
+	}
+	return FString::Printf(TEXT(" [镜头:%s]"), *Profiles[ProfileIndex].Name);
+}
+
+void FCameraProfileTable::ComputeDrawDistances(float SphereRadius, float ScreenSize, FCameraDrawDistances& OutDrawDistances) const
+{
+	// 与 ComputeBoundsDrawDistance 相同: Distance = ScreenMultiple * SphereRadius / ScreenRadius
+	const float ScreenRadius = FMath::Max(SMALL_NUMBER, ScreenSize * 0.5f);
+	const VectorRegister Scale = VectorSetFloat1(SphereRadius / ScreenRadius);
+
+	const int32 NumPadded = ScreenMultiples.Num();
+	OutDrawDistances.SetNumUninitialized(NumPadded, false);
+
+	const float* RESTRICT Src = ScreenMultiples.GetData();
+	float* RESTRICT Dst = OutDrawDistances.GetData();
+	for (int32 Index = 0; Index < NumPadded; Index += 4)
+	{
+		VectorStoreAligned(VectorMultiply(VectorLoadAligned(Src + Index), Scale), Dst + Index);
+	}
+}
+
+float FCameraProfileTable::ComputeMaxScreenSize(int32 ProfileIndex, float SphereRadius, float WorldError, float MaxPixelError) const
+{
+	if (WorldError <= SMALL_NUMBER)
+	{
+		return MAX_flt;
+	}
+
+	// 距离 D 处长度为 L 的线段占 L * M[0][0] * ResolutionX / (2 * D) 个像素, 而 ScreenSize = 2 * ScreenMultiple * SphereRadius / D,
+	// 消去 D 后横屏时 FOV 也被消去, 只剩下分辨率
+	const FCameraProfileEntry& Entry = Profiles[ProfileIndex];
+	return MaxPixelError * 4.0f * Entry.ScreenMultiple * SphereRadius / (WorldError * Entry.ProjectionMatrix.M[0][0] * Entry.ResolutionX);
+}
@@ -0,0 +1,26 @@
+#include "AssetMetricsQueryCommandlet.h"
+#include "Metrics/AssetMetricsQuery.h"
+#include "OptimizationAssistantHelpers.h"
+
+UAssetMetricsQueryCommandlet::UAssetMetricsQueryCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UAssetMetricsQueryCommandlet::Main(const FString& Params)
+{
+	FString QueryString;
+	if (!FParse::Value(*Params, TEXT("-Query="), QueryString, false))
+	{
+		UE_LOG(LogOptimizationAssistant, Error, TEXT("Missing -Query=\"...\", e.g. -Query=\"Type=StaticMesh LOD0.Triangles>50000 Sort=-LOD0.Triangles\""));
+		return 1;
+	}
+
+	FString Filename;
+	FParse::Value(*Params, TEXT("-File="), Filename);
+
+	return FAssetMetricsQuery::Run(QueryString, Filename, *GLog) ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AssetMetricsQueryCommandlet.generated.h"
+
+/**
+ * Runs a query over the asset metrics file without opening the editor UI, e.g.
+ *   UE4Editor-Cmd.exe Project.uproject -run=AssetMetricsQuery -Query="Type=SkeletalMesh LOD0.Triangles>50000 NumLODs<3" [-File=Path/To/AssetMetrics.oam]
+ */
+UCLASS()
+class UAssetMetricsQueryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAssetMetricsQueryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,379 @@
+#include "Mesh/DuplicateMeshAnalysis.h"
+#include "Async/ParallelFor.h"
+#include "Hash/CityHash.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "AssetRegistryModule.h"
+#include "ObjectTools.h"
+#include "Misc/PackageName.h"
+#include "Classes/EditorStaticMesh.h"
+#include "OptimizationAssistantHelpers.h"
+
+namespace DuplicateMeshAnalysis
+{
+	/** UVs are quantized to 1/4096 of a texture, normals and tangents are stored with 8 or 16 bits anyway. */
+	static const float UVTolerance = 1.f / 4096.f;
+	static const float TangentTolerance = 1.f / 1024.f;
+
+	template<typename T>
+	FORCEINLINE uint64 HashArray(const TArray<T>& Data, uint64 Seed)
+	{
+		return CityHash64WithSeed(reinterpret_cast<const char*>(Data.GetData()), Data.Num() * sizeof(T), Seed);
+	}
+
+	/** Slot names may differ between copies, only the assigned materials matter. */
+	static bool HasSameMaterials(const UStaticMesh* A, const UStaticMesh* B)
+	{
+		if (A->StaticMaterials.Num() != B->StaticMaterials.Num())
+		{
+			return false;
+		}
+		for (int32 MaterialIndex = 0; MaterialIndex < A->StaticMaterials.Num(); ++MaterialIndex)
+		{
+			if (A->StaticMaterials[MaterialIndex].MaterialInterface != B->StaticMaterials[MaterialIndex].MaterialInterface)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Engine and plugin content is only reported, consolidation never deletes or redirects to it. */
+	static bool IsGameContent(const UStaticMesh* StaticMesh)
+	{
+		return StaticMesh->GetOutermost()->GetName().StartsWith(TEXT("/Game/"));
+	}
+
+	FORCEINLINE void QuantizeVector(const FVector& Value, float InvTolerance, TArray<int32>& OutValues)
+	{
+		OutValues.Add(FMath::RoundToInt(Value.X * InvTolerance));
+		OutValues.Add(FMath::RoundToInt(Value.Y * InvTolerance));
+		OutValues.Add(FMath::RoundToInt(Value.Z * InvTolerance));
+	}
+
+	/** Texture coordinates, tangent basis and colors of one LOD, quantized like the positions. */
+	static void QuantizeVertexAttributes(const FStaticMeshLODResources& LODModel, TArray<int32>& OutValues)
+	{
+		const FStaticMeshVertexBuffer& VertexBuffer = LODModel.VertexBuffers.StaticMeshVertexBuffer;
+		const FColorVertexBuffer& ColorBuffer = LODModel.VertexBuffers.ColorVertexBuffer;
+		const uint32 NumTexCoords = VertexBuffer.GetNumTexCoords();
+		const bool bHasColors = ColorBuffer.GetNumVertices() == VertexBuffer.GetNumVertices();
+		OutValues.Reset(VertexBuffer.GetNumVertices() * (NumTexCoords * 2 + 7 + (bHasColors ? 1 : 0)) + 2);
+		OutValues.Add((int32)NumTexCoords);
+		OutValues.Add(bHasColors ? 1 : 0);
+		for (uint32 VertexIndex = 0; VertexIndex < VertexBuffer.GetNumVertices(); ++VertexIndex)
+		{
+			for (uint32 UVIndex = 0; UVIndex < NumTexCoords; ++UVIndex)
+			{
+				const FVector2D UV = VertexBuffer.GetVertexUV(VertexIndex, UVIndex);
+				OutValues.Add(FMath::RoundToInt(UV.X / UVTolerance));
+				OutValues.Add(FMath::RoundToInt(UV.Y / UVTolerance));
+			}
+
+			const FVector4 TangentZ = VertexBuffer.VertexTangentZ(VertexIndex);
+			QuantizeVector(VertexBuffer.VertexTangentX(VertexIndex), 1.f / TangentTolerance, OutValues);
+			QuantizeVector(FVector(TangentZ), 1.f / TangentTolerance, OutValues);
+			OutValues.Add(TangentZ.W < 0.f ? -1 : 1);
+
+			if (bHasColors)
+			{
+				OutValues.Add((int32)ColorBuffer.VertexColor(VertexIndex).DWColor());
+			}
+		}
+	}
+}
+
+uint64 FDuplicateMeshAnalysis::ComputeGeometryHash(const UStaticMesh* StaticMesh, float PositionTolerance)
+{
+	using namespace DuplicateMeshAnalysis;
+
+	const FStaticMeshRenderData* RenderData = StaticMesh->RenderData.Get();
+	if (!RenderData || RenderData->LODResources.Num() == 0)
+	{
+		return 0;
+	}
+
+	const float InvTolerance = 1.f / FMath::Max(PositionTolerance, KINDA_SMALL_NUMBER);
+	uint64 Hash = HashCombine(RenderData->LODResources.Num(), StaticMesh->LightMapCoordinateIndex);
+	TArray<int32> QuantizedPositions;
+	TArray<int32> QuantizedAttributes;
+	TArray<uint32> Indices;
+	TArray<int32> SectionLayout;
+	for (const FStaticMeshLODResources& LODModel : RenderData->LODResources)
+	{
+		// 量化后浮点误差不影响结果
+		const FPositionVertexBuffer& PositionBuffer = LODModel.VertexBuffers.PositionVertexBuffer;
+		QuantizedPositions.Reset(PositionBuffer.GetNumVertices() * 3);
+		for (uint32 VertexIndex = 0; VertexIndex < PositionBuffer.GetNumVertices(); ++VertexIndex)
+		{
+			QuantizeVector(PositionBuffer.VertexPosition(VertexIndex), InvTolerance, QuantizedPositions);
+		}
+
+		// UV、法线和顶点色不同的副本渲染结果不同, 不能合并
+		QuantizeVertexAttributes(LODModel, QuantizedAttributes);
+
+		LODModel.IndexBuffer.GetCopy(Indices);
+
+		SectionLayout.Reset(LODModel.Sections.Num() * 3);
+		for (const FStaticMeshSection& Section : LODModel.Sections)
+		{
+			SectionLayout.Add(Section.MaterialIndex);
+			SectionLayout.Add((int32)Section.FirstIndex);
+			SectionLayout.Add((int32)Section.NumTriangles);
+		}
+
+		Hash = HashArray(QuantizedPositions, Hash);
+		Hash = HashArray(QuantizedAttributes, Hash);
+		Hash = HashArray(Indices, Hash);
+		Hash = HashArray(SectionLayout, Hash);
+	}
+	return Hash;
+}
+
+bool FDuplicateMeshAnalysis::HasSameGeometry(const UStaticMesh* A, const UStaticMesh* B, float PositionTolerance)
+{
+	using namespace DuplicateMeshAnalysis;
+
+	const FStaticMeshRenderData* RenderDataA = A->RenderData.Get();
+	const FStaticMeshRenderData* RenderDataB = B->RenderData.Get();
+	if (!RenderDataA || !RenderDataB || RenderDataA->LODResources.Num() != RenderDataB->LODResources.Num() || A->LightMapCoordinateIndex != B->LightMapCoordinateIndex)
+	{
+		return false;
+	}
+
+	TArray<int32> AttributesA, AttributesB;
+	TArray<uint32> IndicesA, IndicesB;
+	for (int32 LODIndex = 0; LODIndex < RenderDataA->LODResources.Num(); ++LODIndex)
+	{
+		const FStaticMeshLODResources& LODA = RenderDataA->LODResources[LODIndex];
+		const FStaticMeshLODResources& LODB = RenderDataB->LODResources[LODIndex];
+		const FPositionVertexBuffer& PositionsA = LODA.VertexBuffers.PositionVertexBuffer;
+		const FPositionVertexBuffer& PositionsB = LODB.VertexBuffers.PositionVertexBuffer;
+		if (PositionsA.GetNumVertices() != PositionsB.GetNumVertices() || LODA.Sections.Num() != LODB.Sections.Num())
+		{
+			return false;
+		}
+
+		for (int32 SectionIndex = 0; SectionIndex < LODA.Sections.Num(); ++SectionIndex)
+		{
+			const FStaticMeshSection& SectionA = LODA.Sections[SectionIndex];
+			const FStaticMeshSection& SectionB = LODB.Sections[SectionIndex];
+			if (SectionA.MaterialIndex != SectionB.MaterialIndex || SectionA.FirstIndex != SectionB.FirstIndex || SectionA.NumTriangles != SectionB.NumTriangles)
+			{
+				return false;
+			}
+		}
+
+		LODA.IndexBuffer.GetCopy(IndicesA);
+		LODB.IndexBuffer.GetCopy(IndicesB);
+		if (IndicesA != IndicesB)
+		{
+			return false;
+		}
+
+		for (uint32 VertexIndex = 0; VertexIndex < PositionsA.GetNumVertices(); ++VertexIndex)
+		{
+			if (!PositionsA.VertexPosition(VertexIndex).Equals(PositionsB.VertexPosition(VertexIndex), PositionTolerance))
+			{
+				return false;
+			}
+		}
+
+		QuantizeVertexAttributes(LODA, AttributesA);
+		QuantizeVertexAttributes(LODB, AttributesB);
+		if (AttributesA != AttributesB)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FDuplicateMeshAnalysis::Run(const TArray<UStaticMesh*>& Meshes, float PositionTolerance)
+{
+	Clusters.Reset();
+	Tolerance = PositionTolerance;
+
+	TArray<UStaticMesh*> ValidMeshes;
+	for (UStaticMesh* StaticMesh : Meshes)
+	{
+		if (StaticMesh && StaticMesh->RenderData)
+		{
+			ValidMeshes.Add(StaticMesh);
+		}
+	}
+
+	TArray<uint64> Hashes;
+	Hashes.SetNumZeroed(ValidMeshes.Num());
+	ParallelFor(ValidMeshes.Num(), [&ValidMeshes, &Hashes, PositionTolerance](int32 MeshIndex)
+	{
+		Hashes[MeshIndex] = ComputeGeometryHash(ValidMeshes[MeshIndex], PositionTolerance);
+	});
+
+	TMap<uint64, TArray<UStaticMesh*>> MeshesByHash;
+	for (int32 MeshIndex = 0; MeshIndex < ValidMeshes.Num(); ++MeshIndex)
+	{
+		if (Hashes[MeshIndex] != 0)
+		{
+			MeshesByHash.FindOrAdd(Hashes[MeshIndex]).Add(ValidMeshes[MeshIndex]);
+		}
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	for (TPair<uint64, TArray<UStaticMesh*>>& HashMeshes : MeshesByHash)
+	{
+		if (HashMeshes.Value.Num() < 2)
+		{
+			continue;
+		}
+
+		FDuplicateMeshCluster& Cluster = Clusters.AddDefaulted_GetRef();
+		Cluster.GeometryHash = HashMeshes.Key;
+		Cluster.Meshes = MoveTemp(HashMeshes.Value);
+		Cluster.KeeperIndex = 0;
+		Cluster.WastedBytes = 0;
+		for (int32 MeshIndex = 0; MeshIndex < Cluster.Meshes.Num(); ++MeshIndex)
+		{
+			TArray<FName> Referencers;
+			AssetRegistry.GetReferencers(Cluster.Meshes[MeshIndex]->GetOutermost()->GetFName(), Referencers);
+			Cluster.NumReferencers.Add(Referencers.Num());
+		}
+
+		// 保留被引用最多的项目资源, 引擎和插件资源只有在没有项目资源时才作为保留项
+		for (int32 MeshIndex = 1; MeshIndex < Cluster.Meshes.Num(); ++MeshIndex)
+		{
+			const bool bGameContent = IsGameContent(Cluster.Meshes[MeshIndex]);
+			const bool bKeeperGameContent = IsGameContent(Cluster.Meshes[Cluster.KeeperIndex]);
+			if (bGameContent != bKeeperGameContent ? bGameContent : Cluster.NumReferencers[MeshIndex] > Cluster.NumReferencers[Cluster.KeeperIndex])
+			{
+				Cluster.KeeperIndex = MeshIndex;
+			}
+		}
+
+		for (int32 MeshIndex = 0; MeshIndex < Cluster.Meshes.Num(); ++MeshIndex)
+		{
+			if (MeshIndex != Cluster.KeeperIndex)
+			{
+				Cluster.WastedBytes += FStaticMeshLODMemory::ComputeResidentBytes(Cluster.Meshes[MeshIndex]);
+			}
+		}
+	}
+
+	// 报告中的组序号用于选择要合并的组, 排序要稳定
+	Clusters.Sort([](const FDuplicateMeshCluster& A, const FDuplicateMeshCluster& B)
+	{
+		return A.WastedBytes != B.WastedBytes ? A.WastedBytes > B.WastedBytes : A.GeometryHash < B.GeometryHash;
+	});
+}
+
+void FDuplicateMeshAnalysis::PrintReport(FOutputDevice& Ar) const
+{
+	int64 TotalWastedBytes = 0;
+	int32 NumDuplicates = 0;
+	for (const FDuplicateMeshCluster& Cluster : Clusters)
+	{
+		TotalWastedBytes += Cluster.WastedBytes;
+		NumDuplicates += Cluster.Meshes.Num() - 1;
+	}
+
+	Ar.Logf(TEXT("重复的Mesh: [%d]组, 可删除[%d]个, 浪费内存[%.2f]MB"), Clusters.Num(), NumDuplicates, TotalWastedBytes / (1024.f * 1024.f));
+	for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ++ClusterIndex)
+	{
+		const FDuplicateMeshCluster& Cluster = Clusters[ClusterIndex];
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== [%d] Hash[%016llx] [%d]个相同的Mesh, 浪费内存[%.2f]MB ===="), ClusterIndex, Cluster.GeometryHash, Cluster.Meshes.Num(), Cluster.WastedBytes / (1024.f * 1024.f));
+		for (int32 MeshIndex = 0; MeshIndex < Cluster.Meshes.Num(); ++MeshIndex)
+		{
+			Ar.Logf(TEXT("    %s %-120s 被引用[%d]次"), MeshIndex == Cluster.KeeperIndex ? TEXT("[保留]") : TEXT("      "), *Cluster.Meshes[MeshIndex]->GetPathName(), Cluster.NumReferencers[MeshIndex]);
+		}
+	}
+}
+
+void FDuplicateMeshAnalysis::GatherConsolidations(const TArray<int32>& ClusterIndices, TArray<FDuplicateMeshConsolidation>& OutConsolidations) const
+{
+	using namespace DuplicateMeshAnalysis;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TSet<int32> GatheredClusters;
+	for (int32 ClusterIndex : ClusterIndices)
+	{
+		if (!Clusters.IsValidIndex(ClusterIndex))
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Duplicate mesh cluster %d does not exist, the report has %d clusters."), ClusterIndex, Clusters.Num());
+			continue;
+		}
+
+		bool bAlreadyGathered = false;
+		GatheredClusters.Add(ClusterIndex, &bAlreadyGathered);
+		if (bAlreadyGathered)
+		{
+			continue;
+		}
+
+		const FDuplicateMeshCluster& Cluster = Clusters[ClusterIndex];
+		UStaticMesh* Keeper = Cluster.Meshes[Cluster.KeeperIndex];
+		if (!IsGameContent(Keeper))
+		{
+			continue;
+		}
+
+		FDuplicateMeshConsolidation Consolidation;
+		Consolidation.KeeperPath = FSoftObjectPath(Keeper);
+		for (int32 MeshIndex = 0; MeshIndex < Cluster.Meshes.Num(); ++MeshIndex)
+		{
+			// 材质不同时合并引用会改变外观, 哈希相同也要逐个比较数据后才删除
+			UStaticMesh* StaticMesh = Cluster.Meshes[MeshIndex];
+			if (MeshIndex == Cluster.KeeperIndex || !IsGameContent(StaticMesh) || !HasSameMaterials(StaticMesh, Keeper))
+			{
+				continue;
+			}
+
+			if (!HasSameGeometry(StaticMesh, Keeper, Tolerance))
+			{
+				UE_LOG(LogOptimizationAssistant, Warning, TEXT("%s has the same geometry hash as %s but different data, not consolidated."), *StaticMesh->GetPathName(), *Keeper->GetPathName());
+				continue;
+			}
+
+			// 删除的Mesh留下重定向器, 引用它的资源和关卡会被重新保存
+			const FName PackageName = StaticMesh->GetOutermost()->GetFName();
+			TArray<FName> Referencers;
+			AssetRegistry.GetReferencers(PackageName, Referencers);
+			Consolidation.DuplicatePaths.Add(FSoftObjectPath(StaticMesh));
+			Consolidation.PackageNames.AddUnique(PackageName);
+			for (const FName Referencer : Referencers)
+			{
+				Consolidation.PackageNames.AddUnique(Referencer);
+			}
+		}
+
+		if (Consolidation.DuplicatePaths.Num() > 0)
+		{
+			OutConsolidations.Add(MoveTemp(Consolidation));
+		}
+	}
+}
+
+int32 FDuplicateMeshAnalysis::Consolidate(const TArray<FDuplicateMeshConsolidation>& Consolidations)
+{
+	int32 NumConsolidated = 0;
+	for (const FDuplicateMeshConsolidation& Consolidation : Consolidations)
+	{
+		UObject* Keeper = Consolidation.KeeperPath.TryLoad();
+		TArray<UObject*> ObjectsToConsolidate;
+		for (const FSoftObjectPath& DuplicatePath : Consolidation.DuplicatePaths)
+		{
+			if (UObject* Duplicate = DuplicatePath.TryLoad())
+			{
+				ObjectsToConsolidate.Add(Duplicate);
+			}
+		}
+
+		if (Keeper && ObjectsToConsolidate.Num() > 0)
+		{
+			ObjectTools::FConsolidationResults Results = ObjectTools::ConsolidateObjects(Keeper, ObjectsToConsolidate, false);
+			NumConsolidated += ObjectsToConsolidate.Num() - Results.FailedConsolidationObjs.Num();
+		}
+	}
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Consolidated %d duplicate static meshes."), NumConsolidated);
+	return NumConsolidated;
+}
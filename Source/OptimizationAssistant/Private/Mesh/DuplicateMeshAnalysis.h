@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+class UStaticMesh;
+
+/** Static meshes whose quantized geometry hashes to the same value. */
+struct FDuplicateMeshCluster
+{
+	uint64 GeometryHash;
+
+	TArray<UStaticMesh*> Meshes;
+
+	/** Packages referencing each mesh, from the asset registry. */
+	TArray<int32> NumReferencers;
+
+	/** The mesh the others are consolidated onto, the /Game mesh with the most referencers. */
+	int32 KeeperIndex;
+
+	/** Resident memory of every mesh but the keeper. */
+	int64 WastedBytes;
+};
+
+/** The duplicates of one cluster that pass every check, and the packages consolidating them modifies. */
+struct FDuplicateMeshConsolidation
+{
+	FSoftObjectPath KeeperPath;
+
+	TArray<FSoftObjectPath> DuplicatePaths;
+
+	/** The duplicate packages, deleted and left as redirectors, and the packages referencing them. */
+	TArray<FName> PackageNames;
+};
+
+/**
+ * Finds byte identical or near identical static meshes imported more than once. Every LOD's vertex
+ * positions (quantized to PositionTolerance), texture coordinates, tangent basis, colors, indices and
+ * section layout are hashed in parallel.
+ */
+class FDuplicateMeshAnalysis
+{
+public:
+	FDuplicateMeshAnalysis()
+		: Tolerance(0.f)
+	{
+	}
+
+	/** Reads the CPU copies of the render data, safe to call from worker threads. */
+	static uint64 ComputeGeometryHash(const UStaticMesh* StaticMesh, float PositionTolerance);
+
+	/** Compares the render data of two meshes vertex by vertex, with the same tolerances as the hash. */
+	static bool HasSameGeometry(const UStaticMesh* A, const UStaticMesh* B, float PositionTolerance);
+
+	void Run(const TArray<UStaticMesh*>& Meshes, float PositionTolerance);
+
+	void PrintReport(FOutputDevice& Ar) const;
+
+	/**
+	 * Picks the duplicates of the clusters at ClusterIndices that can be consolidated onto their keeper. Only /Game
+	 * meshes are consolidated, and only once HasSameGeometry confirms the hash match. Meshes with different
+	 * materials than the keeper are left alone.
+	 */
+	void GatherConsolidations(const TArray<int32>& ClusterIndices, TArray<FDuplicateMeshConsolidation>& OutConsolidations) const;
+
+	/**
+	 * Replaces the references to every duplicate with its keeper and deletes the duplicates. Deleting runs a
+	 * garbage collection, so nothing may hold raw pointers to the duplicates. Returns the number of consolidated meshes.
+	 */
+	static int32 Consolidate(const TArray<FDuplicateMeshConsolidation>& Consolidations);
+
+	int32 NumClusters() const { return Clusters.Num(); }
+
+private:
+	TArray<FDuplicateMeshCluster> Clusters;
+	float Tolerance;
+};
@@ -0,0 +1,316 @@
+#include "Mesh/LODGeometricError.h"
+#include "Async/ParallelFor.h"
+#include "Algo/BinarySearch.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "CameraProfileTable.h"
+
+namespace LODGeometricError
+{
+	enum { MaxCellsPerAxis = 64, SamplesPerTask = 256 };
+
+	/** The triangles of one LOD bucketed into a uniform grid, a triangle is added to every cell its box overlaps. */
+	class FTriangleGrid
+	{
+	public:
+		explicit FTriangleGrid(const FStaticMeshLODResources& LODModel)
+		{
+			const FPositionVertexBuffer& PositionBuffer = LODModel.VertexBuffers.PositionVertexBuffer;
+			Vertices.SetNumUninitialized(PositionBuffer.GetNumVertices());
+			for (uint32 VertexIndex = 0; VertexIndex < PositionBuffer.GetNumVertices(); ++VertexIndex)
+			{
+				Vertices[VertexIndex] = PositionBuffer.VertexPosition(VertexIndex);
+			}
+
+			TArray<uint32> Indices;
+			LODModel.IndexBuffer.GetCopy(Indices);
+			Corners.Reserve(Indices.Num());
+			for (uint32 Index : Indices)
+			{
+				Corners.Add(Vertices[Index]);
+			}
+
+			const int32 NumTriangles = Corners.Num() / 3;
+			if (NumTriangles == 0)
+			{
+				return;
+			}
+
+			// 每个格子平均约一个三角形, 扁平的Mesh按最长边划分
+			Bounds = FBox(Corners).ExpandBy(KINDA_SMALL_NUMBER);
+			const FVector Extent = Bounds.GetSize();
+			const float CellLength = FMath::Max3(FMath::Pow(Extent.X * Extent.Y * Extent.Z / NumTriangles, 1.f / 3.f), Extent.GetMax() / MaxCellsPerAxis, KINDA_SMALL_NUMBER);
+			NumCells = FIntVector(
+				FMath::Clamp(FMath::CeilToInt(Extent.X / CellLength), 1, (int32)MaxCellsPerAxis),
+				FMath::Clamp(FMath::CeilToInt(Extent.Y / CellLength), 1, (int32)MaxCellsPerAxis),
+				FMath::Clamp(FMath::CeilToInt(Extent.Z / CellLength), 1, (int32)MaxCellsPerAxis));
+			CellSize = FVector(Extent.X / NumCells.X, Extent.Y / NumCells.Y, Extent.Z / NumCells.Z);
+			MinCellSize = CellSize.GetMin();
+
+			// 两遍: 先统计每个格子的三角形数, 再填入连续的数组
+			TArray<FIntVector> TriangleMinCells;
+			TArray<FIntVector> TriangleMaxCells;
+			TriangleMinCells.SetNumUninitialized(NumTriangles);
+			TriangleMaxCells.SetNumUninitialized(NumTriangles);
+			CellStarts.SetNumZeroed(NumCells.X * NumCells.Y * NumCells.Z + 1);
+			for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+			{
+				const FVector* Triangle = &Corners[TriangleIndex * 3];
+				const FBox TriangleBounds(Triangle, 3);
+				TriangleMinCells[TriangleIndex] = GetCell(TriangleBounds.Min);
+				TriangleMaxCells[TriangleIndex] = GetCell(TriangleBounds.Max);
+				ForEachCell(TriangleMinCells[TriangleIndex], TriangleMaxCells[TriangleIndex], [this](int32 CellIndex) { ++CellStarts[CellIndex + 1]; });
+			}
+			for (int32 CellIndex = 1; CellIndex < CellStarts.Num(); ++CellIndex)
+			{
+				CellStarts[CellIndex] += CellStarts[CellIndex - 1];
+			}
+
+			TArray<int32> CellFill(CellStarts.GetData(), CellStarts.Num() - 1);
+			CellTriangles.SetNumUninitialized(CellStarts.Last());
+			for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+			{
+				ForEachCell(TriangleMinCells[TriangleIndex], TriangleMaxCells[TriangleIndex], [this, &CellFill, TriangleIndex](int32 CellIndex) { CellTriangles[CellFill[CellIndex]++] = TriangleIndex; });
+			}
+		}
+
+		int32 NumTriangles() const { return Corners.Num() / 3; }
+
+		/**
+		 * Squared distance to the closest triangle. The search walks shells of cells around the point and stops
+		 * once every unvisited cell is further away than the best triangle found so far.
+		 */
+		float DistanceSquaredTo(const FVector& Point) const
+		{
+			if (CellTriangles.Num() == 0)
+			{
+				return 0.f;
+			}
+
+			const FIntVector Center = GetCell(Point);
+			const int32 MaxRing = NumCells.GetMax();
+			float BestDistanceSquared = MAX_flt;
+			for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+			{
+				const FIntVector RingMin(FMath::Max(Center.X - Ring, 0), FMath::Max(Center.Y - Ring, 0), FMath::Max(Center.Z - Ring, 0));
+				const FIntVector RingMax(FMath::Min(Center.X + Ring, NumCells.X - 1), FMath::Min(Center.Y + Ring, NumCells.Y - 1), FMath::Min(Center.Z + Ring, NumCells.Z - 1));
+				for (int32 Z = RingMin.Z; Z <= RingMax.Z; ++Z)
+				{
+					for (int32 Y = RingMin.Y; Y <= RingMax.Y; ++Y)
+					{
+						for (int32 X = RingMin.X; X <= RingMax.X; ++X)
+						{
+							if (FMath::Max3(FMath::Abs(X - Center.X), FMath::Abs(Y - Center.Y), FMath::Abs(Z - Center.Z)) != Ring)
+							{
+								continue;
+							}
+
+							const int32 CellIndex = GetCellIndex(X, Y, Z);
+							for (int32 Slot = CellStarts[CellIndex]; Slot < CellStarts[CellIndex + 1]; ++Slot)
+							{
+								const FVector* Triangle = &Corners[CellTriangles[Slot] * 3];
+								const FVector Closest = FMath::ClosestPointOnTriangleToPoint(Point, Triangle[0], Triangle[1], Triangle[2]);
+								BestDistanceSquared = FMath::Min(BestDistanceSquared, FVector::DistSquared(Closest, Point));
+							}
+						}
+					}
+				}
+
+				const float Reach = Ring * MinCellSize;
+				if (BestDistanceSquared <= Reach * Reach)
+				{
+					break;
+				}
+			}
+			return BestDistanceSquared;
+		}
+
+		TArray<FVector> Vertices;
+
+		/** Three corners per triangle. */
+		TArray<FVector> Corners;
+
+	private:
+		FIntVector GetCell(const FVector& Point) const
+		{
+			const FVector Local = Point - Bounds.Min;
+			return FIntVector(
+				FMath::Clamp(FMath::FloorToInt(Local.X / CellSize.X), 0, NumCells.X - 1),
+				FMath::Clamp(FMath::FloorToInt(Local.Y / CellSize.Y), 0, NumCells.Y - 1),
+				FMath::Clamp(FMath::FloorToInt(Local.Z / CellSize.Z), 0, NumCells.Z - 1));
+		}
+
+		int32 GetCellIndex(int32 X, int32 Y, int32 Z) const
+		{
+			return (Z * NumCells.Y + Y) * NumCells.X + X;
+		}
+
+		template<typename FunctionType>
+		void ForEachCell(const FIntVector& MinCell, const FIntVector& MaxCell, FunctionType Function) const
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+				{
+					for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+					{
+						Function(GetCellIndex(X, Y, Z));
+					}
+				}
+			}
+		}
+
+		FBox Bounds;
+		FIntVector NumCells;
+		FVector CellSize;
+		float MinCellSize;
+
+		/** Prefix sums, the triangles of cell i are CellTriangles[CellStarts[i], CellStarts[i + 1]). */
+		TArray<int32> CellStarts;
+		TArray<int32> CellTriangles;
+	};
+
+	/** Samples the surface of Source and measures their distance to Target, accumulates into OutError. */
+	static void MeasureOneSided(const FTriangleGrid& Source, const FTriangleGrid& Target, int32 NumSamples, FLODGeometricError& OutError)
+	{
+		const int32 NumTriangles = Source.NumTriangles();
+		if (NumTriangles == 0 || Target.NumTriangles() == 0)
+		{
+			return;
+		}
+
+		TArray<float> CumulativeAreas;
+		CumulativeAreas.SetNumUninitialized(NumTriangles);
+		float TotalArea = 0.f;
+		for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; ++TriangleIndex)
+		{
+			const FVector* Triangle = &Source.Corners[TriangleIndex * 3];
+			TotalArea += 0.5f * ((Triangle[1] - Triangle[0]) ^ (Triangle[2] - Triangle[0])).Size();
+			CumulativeAreas[TriangleIndex] = TotalArea;
+		}
+
+		// 面积加权的采样点之后是按步长抽取的顶点, 误差最大的地方通常在轮廓的顶点上
+		const int32 NumSurfaceSamples = TotalArea > 0.f ? NumSamples : 0;
+		const int32 VertexStride = FMath::Max(1, FMath::DivideAndRoundUp(Source.Vertices.Num(), NumSamples));
+		const int32 NumVertexSamples = FMath::DivideAndRoundUp(Source.Vertices.Num(), VertexStride);
+		const int32 TotalSamples = NumSurfaceSamples + NumVertexSamples;
+
+		const int32 NumTasks = FMath::DivideAndRoundUp(TotalSamples, (int32)SamplesPerTask);
+		TArray<float> TaskMax;
+		TArray<double> TaskSum;
+		TaskMax.SetNumZeroed(NumTasks);
+		TaskSum.SetNumZeroed(NumTasks);
+		ParallelFor(NumTasks, [&](int32 TaskIndex)
+		{
+			const int32 SampleEnd = FMath::Min((TaskIndex + 1) * (int32)SamplesPerTask, TotalSamples);
+			for (int32 SampleIndex = TaskIndex * SamplesPerTask; SampleIndex < SampleEnd; ++SampleIndex)
+			{
+				FVector Point;
+				if (SampleIndex < NumSurfaceSamples)
+				{
+					// 分层采样, 结果在多次检查之间保持一致
+					const float AreaPosition = (SampleIndex + 0.5f) / NumSurfaceSamples * TotalArea;
+					const int32 TriangleIndex = FMath::Min(Algo::LowerBound(CumulativeAreas, AreaPosition), NumTriangles - 1);
+					FRandomStream RandomStream(SampleIndex);
+					const float R1 = FMath::Sqrt(RandomStream.FRand());
+					const float R2 = RandomStream.FRand();
+					const FVector* Triangle = &Source.Corners[TriangleIndex * 3];
+					Point = Triangle[0] * (1.f - R1) + Triangle[1] * (R1 * (1.f - R2)) + Triangle[2] * (R1 * R2);
+				}
+				else
+				{
+					Point = Source.Vertices[(SampleIndex - NumSurfaceSamples) * VertexStride];
+				}
+
+				const float Distance = FMath::Sqrt(Target.DistanceSquaredTo(Point));
+				TaskMax[TaskIndex] = FMath::Max(TaskMax[TaskIndex], Distance);
+				TaskSum[TaskIndex] += Distance;
+			}
+		});
+
+		double SumDeviation = (double)OutError.MeanDeviation * OutError.NumSamples;
+		for (int32 TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+		{
+			OutError.MaxDeviation = FMath::Max(OutError.MaxDeviation, TaskMax[TaskIndex]);
+			SumDeviation += TaskSum[TaskIndex];
+		}
+		OutError.NumSamples += TotalSamples;
+		OutError.MeanDeviation = OutError.NumSamples > 0 ? (float)(SumDeviation / OutError.NumSamples) : 0.f;
+	}
+}
+
+void FLODGeometricErrorAnalysis::Measure(const FStaticMeshLODResources& Reference, const FStaticMeshLODResources& LODModel, int32 NumSamples, FLODGeometricError& OutError)
+{
+	using namespace LODGeometricError;
+
+	OutError = FLODGeometricError();
+	NumSamples = FMath::Max(NumSamples, 1);
+	const FTriangleGrid ReferenceGrid(Reference);
+	const FTriangleGrid LODGrid(LODModel);
+
+	// 单向的距离会漏掉被减面删除的细节, 两个方向都要测
+	MeasureOneSided(LODGrid, ReferenceGrid, NumSamples, OutError);
+	MeasureOneSided(ReferenceGrid, LODGrid, NumSamples, OutError);
+}
+
+void FLODGeometricErrorAnalysis::MeasureLODs(const UStaticMesh* StaticMesh, int32 NumSamples, TArray<FLODGeometricError>& OutErrors)
+{
+	OutErrors.Reset();
+	const FStaticMeshRenderData* RenderData = StaticMesh->RenderData.Get();
+	if (!RenderData || RenderData->LODResources.Num() == 0)
+	{
+		return;
+	}
+
+	OutErrors.SetNum(RenderData->LODResources.Num());
+	for (int32 LODIndex = 1; LODIndex < RenderData->LODResources.Num(); ++LODIndex)
+	{
+		Measure(RenderData->LODResources[0], RenderData->LODResources[LODIndex], NumSamples, OutErrors[LODIndex]);
+	}
+}
+
+void FLODGeometricErrorAnalysis::ComputeScreenSizes(const TArray<FLODGeometricError>& Errors, float SphereRadius, const FCameraProfileTable& CameraProfiles, float MaxPixelError, TArray<FPerPlatformFloat>& OutScreenSizes)
+{
+	const float MinimumDifferenceInScreenSize = 0.01f;
+
+	OutScreenSizes.Reset();
+	for (int32 LODIndex = 0; LODIndex < Errors.Num(); ++LODIndex)
+	{
+		FPerPlatformFloat& ScreenSize = OutScreenSizes.Emplace_GetRef(1.f);
+		if (LODIndex == 0)
+		{
+			continue;
+		}
+
+		// 适用于所有平台的镜头同时约束默认值和每个平台的值
+		float DefaultScreenSize = MAX_flt;
+		float AnyScreenSize = MAX_flt;
+		TMap<FName, float> PlatformScreenSizes;
+		for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
+		{
+			const FName PlatformGroupName = CameraProfiles.GetProfile(ProfileIndex).PlatformGroupName;
+			const float ProfileScreenSize = CameraProfiles.ComputeMaxScreenSize(ProfileIndex, SphereRadius, Errors[LODIndex].MaxDeviation, MaxPixelError);
+			AnyScreenSize = FMath::Min(AnyScreenSize, ProfileScreenSize);
+			if (PlatformGroupName == NAME_None)
+			{
+				DefaultScreenSize = FMath::Min(DefaultScreenSize, ProfileScreenSize);
+			}
+			else
+			{
+				float* PlatformScreenSize = PlatformScreenSizes.Find(PlatformGroupName);
+				PlatformScreenSizes.Add(PlatformGroupName, PlatformScreenSize ? FMath::Min(*PlatformScreenSize, ProfileScreenSize) : ProfileScreenSize);
+			}
+		}
+
+		const FPerPlatformFloat& PrevScreenSize = OutScreenSizes[LODIndex - 1];
+		const float MaxDefault = DefaultScreenSize < MAX_flt ? DefaultScreenSize : AnyScreenSize;
+		ScreenSize.Default = FMath::Max(FMath::Min(MaxDefault, PrevScreenSize.Default - MinimumDifferenceInScreenSize), 0.f);
+		for (const TPair<FName, float>& PlatformScreenSize : PlatformScreenSizes)
+		{
+			const float* PrevPlatformScreenSize = PrevScreenSize.PerPlatform.Find(PlatformScreenSize.Key);
+			const float PrevValue = PrevPlatformScreenSize ? *PrevPlatformScreenSize : PrevScreenSize.Default;
+			const float Value = FMath::Min(PlatformScreenSize.Value, DefaultScreenSize);
+			ScreenSize.PerPlatform.Add(PlatformScreenSize.Key, FMath::Max(FMath::Min(Value, PrevValue - MinimumDifferenceInScreenSize), 0.f));
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PerPlatformProperties.h"
+
+class UStaticMesh;
+class FCameraProfileTable;
+struct FStaticMeshLODResources;
+
+/** Deviation of one LOD from LOD0, in world units of the mesh. */
+struct FLODGeometricError
+{
+	FLODGeometricError()
+		: MaxDeviation(0.f)
+		, MeanDeviation(0.f)
+		, NumSamples(0)
+	{
+	}
+
+	/** Symmetric sampled Hausdorff distance, the larger of LOD->LOD0 and LOD0->LOD. */
+	float MaxDeviation;
+
+	float MeanDeviation;
+
+	int32 NumSamples;
+};
+
+/**
+ * Measures how far the built LODs of a static mesh deviate from LOD0 by sampling points on the
+ * surface of one LOD and searching the closest point on the other through a uniform triangle grid.
+ * The samples are spread over worker threads, the render data is only read.
+ */
+class FLODGeometricErrorAnalysis
+{
+public:
+	/** NumSamples area weighted points plus up to NumSamples vertices are taken on each side. */
+	static void Measure(const FStaticMeshLODResources& Reference, const FStaticMeshLODResources& LODModel, int32 NumSamples, FLODGeometricError& OutError);
+
+	/** OutErrors[i] is the error of LOD i, LOD0 is always zero. */
+	static void MeasureLODs(const UStaticMesh* StaticMesh, int32 NumSamples, TArray<FLODGeometricError>& OutErrors);
+
+	/**
+	 * Screen sizes at which each LOD's error stays within MaxPixelError for every camera profile, clamped so
+	 * each LOD starts below the previous one. Profiles without a platform group write the default value,
+	 * the others a per platform override, several profiles of one platform keep the smallest screen size.
+	 */
+	static void ComputeScreenSizes(const TArray<FLODGeometricError>& Errors, float SphereRadius, const FCameraProfileTable& CameraProfiles, float MaxPixelError, TArray<FPerPlatformFloat>& OutScreenSizes);
+};
@@ -0,0 +1,135 @@
+#include "Mesh/LODReductionPreview.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshOperations.h"
+#include "OverlappingCorners.h"
+#include "IMeshReductionInterfaces.h"
+#include "IMeshReductionManagerModule.h"
+#include "Modules/ModuleManager.h"
+#include "CameraProfileTable.h"
+#include "OptimizationAssistantHelpers.h"
+
+FLODReductionPreview::FLODReductionPreview(UStaticMesh* InStaticMesh, const TArray<float>& PercentTriangles, int32 InSourceLODIndex)
+	: StaticMesh(InStaticMesh)
+	, SourceLODIndex(InSourceLODIndex)
+	, SourceTriangles(0)
+{
+	for (float Percent : PercentTriangles)
+	{
+		FLODReductionCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+		Candidate.PercentTriangles = FMath::Clamp(Percent, 0.f, 1.f);
+	}
+}
+
+void FLODReductionPreview::Run(TArray<FLODReductionPreview>& Previews)
+{
+	IMeshReduction* MeshReduction = FModuleManager::Get().LoadModuleChecked<IMeshReductionManagerModule>("MeshReductionInterface").GetStaticMeshReductionInterface();
+	if (!MeshReduction || !MeshReduction->IsSupported())
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("No static mesh reduction interface is available, LOD reduction preview skipped."));
+		return;
+	}
+
+	// MeshDescription 需要在主线程加载, 之后工作线程只读取
+	TArray<const FMeshDescription*> SourceMeshes;
+	TArray<FMeshReductionSettings> BaseSettings;
+	TArray<bool> WasLoaded;
+	for (FLODReductionPreview& Preview : Previews)
+	{
+		const bool bIsSourceModelValid = Preview.StaticMesh->IsSourceModelValid(Preview.SourceLODIndex);
+		WasLoaded.Add(bIsSourceModelValid && Preview.StaticMesh->GetSourceModel(Preview.SourceLODIndex).MeshDescription.IsValid());
+
+		const FMeshDescription* SourceMesh = Preview.StaticMesh->IsMeshDescriptionValid(Preview.SourceLODIndex) ? Preview.StaticMesh->GetMeshDescription(Preview.SourceLODIndex) : nullptr;
+		SourceMeshes.Add(SourceMesh);
+		Preview.SourceTriangles = SourceMesh ? SourceMesh->Triangles().Num() : 0;
+
+		const int32 SettingsLODIndex = Preview.SourceLODIndex + 1;
+		BaseSettings.Add(Preview.StaticMesh->IsSourceModelValid(SettingsLODIndex) ? Preview.StaticMesh->GetSourceModel(SettingsLODIndex).ReductionSettings : FMeshReductionSettings());
+	}
+
+	TArray<FOverlappingCorners> OverlappingCorners;
+	OverlappingCorners.SetNum(Previews.Num());
+	ParallelFor(Previews.Num(), [&SourceMeshes, &OverlappingCorners](int32 PreviewIndex)
+	{
+		if (SourceMeshes[PreviewIndex])
+		{
+			FStaticMeshOperations::FindOverlappingCorners(OverlappingCorners[PreviewIndex], *SourceMeshes[PreviewIndex], THRESH_POINTS_ARE_SAME);
+		}
+	});
+
+	// 所有Mesh的所有候选值展开成一个任务列表, 小Mesh不会让线程空等大Mesh
+	TArray<TPair<int32, int32>> Tasks;
+	for (int32 PreviewIndex = 0; PreviewIndex < Previews.Num(); ++PreviewIndex)
+	{
+		if (SourceMeshes[PreviewIndex])
+		{
+			for (int32 CandidateIndex = 0; CandidateIndex < Previews[PreviewIndex].Candidates.Num(); ++CandidateIndex)
+			{
+				Tasks.Emplace(PreviewIndex, CandidateIndex);
+			}
+		}
+	}
+
+	ParallelFor(Tasks.Num(), [&Previews, &Tasks, &SourceMeshes, &OverlappingCorners, &BaseSettings, MeshReduction](int32 TaskIndex)
+	{
+		const int32 PreviewIndex = Tasks[TaskIndex].Key;
+		FLODReductionCandidate& Candidate = Previews[PreviewIndex].Candidates[Tasks[TaskIndex].Value];
+
+		FMeshReductionSettings ReductionSettings = BaseSettings[PreviewIndex];
+		ReductionSettings.PercentTriangles = Candidate.PercentTriangles;
+
+		FMeshDescription ReducedMesh;
+		FStaticMeshAttributes(ReducedMesh).Register();
+
+		const double StartTime = FPlatformTime::Seconds();
+		MeshReduction->ReduceMeshDescription(ReducedMesh, Candidate.MaxDeviation, *SourceMeshes[PreviewIndex], OverlappingCorners[PreviewIndex], ReductionSettings);
+		Candidate.BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+		Candidate.NumTriangles = ReducedMesh.Triangles().Num();
+		Candidate.NumVertices = ReducedMesh.Vertices().Num();
+		Candidate.bSucceeded = Candidate.NumTriangles > 0;
+	});
+
+	// GetMeshDescription 会把解压的MeshDescription留在资源上, 只释放这一批新加载的
+	for (int32 PreviewIndex = 0; PreviewIndex < Previews.Num(); ++PreviewIndex)
+	{
+		if (SourceMeshes[PreviewIndex] && !WasLoaded[PreviewIndex])
+		{
+			Previews[PreviewIndex].StaticMesh->ClearMeshDescription(Previews[PreviewIndex].SourceLODIndex);
+		}
+	}
+}
+
+void FLODReductionPreview::ComputeScreenSizes(const FCameraProfileTable& CameraProfiles, float MaxPixelError)
+{
+	const float SphereRadius = StaticMesh->GetBounds().SphereRadius;
+	for (FLODReductionCandidate& Candidate : Candidates)
+	{
+		Candidate.MaxScreenSize = MAX_flt;
+		for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
+		{
+			Candidate.MaxScreenSize = FMath::Min(Candidate.MaxScreenSize, CameraProfiles.ComputeMaxScreenSize(ProfileIndex, SphereRadius, Candidate.MaxDeviation, MaxPixelError));
+		}
+		Candidate.MaxScreenSize = FMath::Min(Candidate.MaxScreenSize, 1.f);
+	}
+}
+
+void FLODReductionPreview::PrintReport(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("%s LOD[%d] Triangles[%d]"), *StaticMesh->GetFullName(), SourceLODIndex, SourceTriangles);
+	Ar.Logf(TEXT("    %16s %10s %10s %14s %12s %10s"), TEXT("PercentTriangles"), TEXT("Triangles"), TEXT("Vertices"), TEXT("MaxDeviation"), TEXT("ScreenSize"), TEXT("Time(ms)"));
+	for (const FLODReductionCandidate& Candidate : Candidates)
+	{
+		if (Candidate.bSucceeded)
+		{
+			Ar.Logf(TEXT("    %16.3f %10d %10d %14.4f %12.4f %10.1f"), Candidate.PercentTriangles, Candidate.NumTriangles, Candidate.NumVertices, Candidate.MaxDeviation, Candidate.MaxScreenSize, Candidate.BuildSeconds * 1000.0);
+		}
+		else
+		{
+			Ar.Logf(TEXT("    %16.3f 减面失败"), Candidate.PercentTriangles);
+		}
+	}
+	Ar.Logf(TEXT(""));
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStaticMesh;
+class FCameraProfileTable;
+
+/** Result of reducing the source LOD to one PercentTriangles value. */
+struct FLODReductionCandidate
+{
+	FLODReductionCandidate()
+		: PercentTriangles(1.f)
+		, NumTriangles(0)
+		, NumVertices(0)
+		, MaxDeviation(0.f)
+		, MaxScreenSize(0.f)
+		, BuildSeconds(0.0)
+		, bSucceeded(false)
+	{
+	}
+
+	float PercentTriangles;
+	int32 NumTriangles;
+	int32 NumVertices;
+
+	/** Largest deviation from the source LOD reported by the reduction, in world units. */
+	float MaxDeviation;
+
+	/** Largest screen size at which the deviation stays within the pixel threshold on every camera profile. */
+	float MaxScreenSize;
+
+	double BuildSeconds;
+	bool bSucceeded;
+};
+
+/**
+ * Reduces the source LOD of a static mesh to a set of candidate PercentTriangles values without touching
+ * the asset: the reduction interface writes into new mesh descriptions that are dropped once they are
+ * measured, so artists can compare settings before committing one with a full rebuild.
+ */
+class FLODReductionPreview
+{
+public:
+	FLODReductionPreview(UStaticMesh* InStaticMesh, const TArray<float>& PercentTriangles, int32 InSourceLODIndex = 0);
+
+	/**
+	 * Loads the source mesh descriptions on the calling thread, then runs every candidate of every preview
+	 * on worker threads. The reduction settings of LOD1, if any, are used for everything but PercentTriangles.
+	 * Descriptions that were not loaded before the call are cleared from their meshes again when it returns.
+	 */
+	static void Run(TArray<FLODReductionPreview>& Previews);
+
+	void ComputeScreenSizes(const FCameraProfileTable& CameraProfiles, float MaxPixelError);
+
+	void PrintReport(FOutputDevice& Ar) const;
+
+	UStaticMesh* GetMesh() const { return StaticMesh; }
+
+	const TArray<FLODReductionCandidate>& GetCandidates() const { return Candidates; }
+
+private:
+	UStaticMesh* StaticMesh;
+	int32 SourceLODIndex;
+	int32 SourceTriangles;
+	TArray<FLODReductionCandidate> Candidates;
+};
@@ -0,0 +1,176 @@
+#include "Mesh/MeshAttributeStatistics.h"
+#include "Engine/StaticMesh.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+
+namespace MeshAttributeStatistics
+{
+	/** Folds the two float2 halves of a register, lanes hold X Y X Y. */
+	FORCEINLINE FVector2D FoldMin2(VectorRegister Value)
+	{
+		MS_ALIGN(16) float Lanes[4] GCC_ALIGN(16);
+		VectorStoreAligned(Value, Lanes);
+		return FVector2D(FMath::Min(Lanes[0], Lanes[2]), FMath::Min(Lanes[1], Lanes[3]));
+	}
+
+	FORCEINLINE FVector2D FoldMax2(VectorRegister Value)
+	{
+		MS_ALIGN(16) float Lanes[4] GCC_ALIGN(16);
+		VectorStoreAligned(Value, Lanes);
+		return FVector2D(FMath::Max(Lanes[0], Lanes[2]), FMath::Max(Lanes[1], Lanes[3]));
+	}
+
+	/** The values of live vertex instances. RawValues is returned as is when the description has no deleted slots. */
+	template <typename T>
+	TArrayView<const T> GetValidValues(const FMeshDescription& MeshDescription, bool bCompact, TArrayView<const T> RawValues, TArray<T>& OutValues)
+	{
+		if (bCompact)
+		{
+			return RawValues;
+		}
+
+		OutValues.Reset(MeshDescription.VertexInstances().Num());
+		for (const FVertexInstanceID VertexInstanceID : MeshDescription.VertexInstances().GetElementIDs())
+		{
+			OutValues.Add(RawValues[VertexInstanceID.GetValue()]);
+		}
+		return OutValues;
+	}
+}
+
+FMeshAttributeStatisticsCache& FMeshAttributeStatisticsCache::Get()
+{
+	static FMeshAttributeStatisticsCache Cache;
+	return Cache;
+}
+
+const FMeshAttributeStatistics* FMeshAttributeStatisticsCache::Find(UStaticMesh* StaticMesh, int32 LODIndex)
+{
+	if (!StaticMesh->IsMeshDescriptionValid(LODIndex))
+	{
+		return nullptr;
+	}
+
+	// 提交MeshDescription后BulkData的Id会变化, 可以作为内容的哈希
+	const FStaticMeshSourceModel& SourceModel = StaticMesh->GetSourceModel(LODIndex);
+	const bool bHasBulkDataId = SourceModel.MeshDescriptionBulkData.IsValid() && !SourceModel.MeshDescriptionBulkData->IsEmpty();
+	const FString Key = bHasBulkDataId ? SourceModel.MeshDescriptionBulkData->GetIdString() : FString::Printf(TEXT("%s_LOD%d"), *StaticMesh->GetPathName(), LODIndex);
+	if (bHasBulkDataId)
+	{
+		FScopeLock ScopeLock(&CriticalSection);
+		if (const TUniquePtr<FMeshAttributeStatistics>* CachedStatistics = Statistics.Find(Key))
+		{
+			return CachedStatistics->Get();
+		}
+	}
+
+	const FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(LODIndex);
+	if (!MeshDescription)
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FMeshAttributeStatistics> NewStatistics = MakeUnique<FMeshAttributeStatistics>();
+	Compute(*MeshDescription, *NewStatistics);
+
+	FScopeLock ScopeLock(&CriticalSection);
+	TUniquePtr<FMeshAttributeStatistics>& CachedStatistics = Statistics.FindOrAdd(Key);
+	CachedStatistics = MoveTemp(NewStatistics);
+	return CachedStatistics.Get();
+}
+
+void FMeshAttributeStatisticsCache::Compute(const FMeshDescription& MeshDescription, FMeshAttributeStatistics& OutStatistics)
+{
+	using namespace MeshAttributeStatistics;
+
+	OutStatistics = FMeshAttributeStatistics();
+	FStaticMeshConstAttributes Attributes(MeshDescription);
+	OutStatistics.NumVertexInstances = MeshDescription.VertexInstances().Num();
+	if (OutStatistics.NumVertexInstances == 0)
+	{
+		return;
+	}
+
+	// 未压缩的MeshDescription中已删除元素的位置保存的是默认值, 这时先把有效元素复制成连续数组
+	const bool bCompact = MeshDescription.VertexInstances().GetArraySize() == OutStatistics.NumVertexInstances;
+
+	// 颜色: 每个元素正好是一个寄存器
+	TVertexInstanceAttributesConstRef<FVector4> VertexInstanceColors = Attributes.GetVertexInstanceColors();
+	if (VertexInstanceColors.IsValid())
+	{
+		TArray<FVector4> ValidColors;
+		const TArrayView<const FVector4> Colors = GetValidValues(MeshDescription, bCompact, VertexInstanceColors.GetRawArray(), ValidColors);
+		const VectorRegister White = VectorOne();
+		VectorRegister Min = VectorSetFloat1(MAX_flt);
+		VectorRegister Max = VectorSetFloat1(-MAX_flt);
+		VectorRegister NotWhite = VectorZero();
+		for (const FVector4& Color : Colors)
+		{
+			const VectorRegister Value = VectorLoad(&Color.X);
+			Min = VectorMin(Min, Value);
+			Max = VectorMax(Max, Value);
+			NotWhite = VectorBitwiseOr(NotWhite, VectorCompareNE(Value, White));
+		}
+		VectorStore(Min, &OutStatistics.ColorMin.X);
+		VectorStore(Max, &OutStatistics.ColorMax.X);
+		OutStatistics.bHasVertexColors = VectorMaskBits(NotWhite) != 0;
+	}
+
+	// UV: 每个寄存器装两个UV, 最后折叠两半
+	TVertexInstanceAttributesConstRef<FVector2D> VertexInstanceUVs = Attributes.GetVertexInstanceUVs();
+	if (VertexInstanceUVs.IsValid())
+	{
+		TArray<FVector2D> ValidUVs;
+		for (int32 UVIndex = 0; UVIndex < VertexInstanceUVs.GetNumIndices(); ++UVIndex)
+		{
+			const TArrayView<const FVector2D> UVs = GetValidValues(MeshDescription, bCompact, VertexInstanceUVs.GetRawArray(UVIndex), ValidUVs);
+			VectorRegister Min = VectorSetFloat1(MAX_flt);
+			VectorRegister Max = VectorSetFloat1(-MAX_flt);
+			int32 Index = 0;
+			for (; Index + 1 < UVs.Num(); Index += 2)
+			{
+				const VectorRegister Value = VectorLoad(&UVs[Index].X);
+				Min = VectorMin(Min, Value);
+				Max = VectorMax(Max, Value);
+			}
+			if (Index < UVs.Num())
+			{
+				const VectorRegister Value = VectorLoadFloat2(&UVs[Index].X);
+				Min = VectorMin(Min, Value);
+				Max = VectorMax(Max, Value);
+			}
+			OutStatistics.UVMin.Add(UVs.Num() > 0 ? FoldMin2(Min) : FVector2D::ZeroVector);
+			OutStatistics.UVMax.Add(UVs.Num() > 0 ? FoldMax2(Max) : FVector2D::ZeroVector);
+		}
+	}
+
+	// 法线: W 读为 0, 不影响结果
+	TVertexInstanceAttributesConstRef<FVector> VertexInstanceNormals = Attributes.GetVertexInstanceNormals();
+	if (VertexInstanceNormals.IsValid())
+	{
+		TArray<FVector> ValidNormals;
+		const TArrayView<const FVector> Normals = GetValidValues(MeshDescription, bCompact, VertexInstanceNormals.GetRawArray(), ValidNormals);
+		VectorRegister Min = VectorSetFloat1(MAX_flt);
+		VectorRegister Max = VectorSetFloat1(-MAX_flt);
+		VectorRegister NotZero = VectorZero();
+		for (const FVector& Normal : Normals)
+		{
+			const VectorRegister Value = VectorLoadFloat3(&Normal.X);
+			Min = VectorMin(Min, Value);
+			Max = VectorMax(Max, Value);
+			NotZero = VectorBitwiseOr(NotZero, VectorCompareNE(Value, VectorZero()));
+		}
+		MS_ALIGN(16) float Lanes[4] GCC_ALIGN(16);
+		VectorStoreAligned(Min, Lanes);
+		OutStatistics.NormalMin = FVector(Lanes[0], Lanes[1], Lanes[2]);
+		VectorStoreAligned(Max, Lanes);
+		OutStatistics.NormalMax = FVector(Lanes[0], Lanes[1], Lanes[2]);
+		OutStatistics.bHasNormals = VectorMaskBits(NotZero) != 0;
+	}
+}
+
+void FMeshAttributeStatisticsCache::Reset()
+{
+	FScopeLock ScopeLock(&CriticalSection);
+	Statistics.Reset();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMeshDescription;
+class UStaticMesh;
+
+/** Ranges of the vertex instance attributes of one mesh description. */
+struct FMeshAttributeStatistics
+{
+	FMeshAttributeStatistics()
+		: NumVertexInstances(0)
+		, ColorMin(ForceInitToZero)
+		, ColorMax(ForceInitToZero)
+		, bHasVertexColors(false)
+		, NormalMin(ForceInitToZero)
+		, NormalMax(ForceInitToZero)
+		, bHasNormals(false)
+	{
+	}
+
+	int32 NumVertexInstances;
+
+	FVector4 ColorMin;
+	FVector4 ColorMax;
+
+	/** Any color other than white, the default of the attribute. */
+	bool bHasVertexColors;
+
+	/** One entry per UV channel. */
+	TArray<FVector2D> UVMin;
+	TArray<FVector2D> UVMax;
+
+	FVector NormalMin;
+	FVector NormalMax;
+
+	/** Any normal other than zero, the default of the attribute. */
+	bool bHasNormals;
+
+	int32 NumUVChannels() const { return UVMin.Num(); }
+
+	/** A channel with the same UV on every vertex instance carries no information and can be stripped. */
+	bool IsUVChannelConstant(int32 UVIndex) const { return UVMin[UVIndex] == UVMax[UVIndex]; }
+};
+
+/**
+ * Computes attribute ranges of a mesh description in one vector pass over the attribute arrays of live vertex instances.
+ * Results are cached by the id of the mesh description bulk data, which changes whenever the description
+ * is committed, so the rules of one check share a single pass. The page resets the cache when a check ends.
+ */
+class FMeshAttributeStatisticsCache
+{
+public:
+	static FMeshAttributeStatisticsCache& Get();
+
+	/** Statistics of a static mesh LOD, nullptr if it has no mesh description. */
+	const FMeshAttributeStatistics* Find(UStaticMesh* StaticMesh, int32 LODIndex);
+
+	static void Compute(const FMeshDescription& MeshDescription, FMeshAttributeStatistics& OutStatistics);
+
+	void Reset();
+
+private:
+	FCriticalSection CriticalSection;
+	TMap<FString, TUniquePtr<FMeshAttributeStatistics>> Statistics;
+};
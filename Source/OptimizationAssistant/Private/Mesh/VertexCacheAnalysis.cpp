@@ -0,0 +1,178 @@
+#include "Mesh/VertexCacheAnalysis.h"
+#include "MeshDescription.h"
+#include "IMeshUtilities.h"
+#include "Modules/ModuleManager.h"
+
+#define OA_VERTEX_CACHE_SIMD (PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_ENABLE_VECTORINTRINSICS_NEON)
+
+#if OA_VERTEX_CACHE_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace VertexCacheAnalysis
+{
+	/** Position of Index in the LRU cache, INDEX_NONE on a miss. PaddedSize is a multiple of 4, unused lanes hold INDEX_NONE. */
+	FORCEINLINE int32 FindInCache(const int32* Cache, int32 PaddedSize, int32 Index)
+	{
+#if OA_VERTEX_CACHE_SIMD
+		const __m128i Key = _mm_set1_epi32(Index);
+		for (int32 Lane = 0; Lane < PaddedSize; Lane += 4)
+		{
+			const int32 Mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(Cache + Lane)), Key)));
+			if (Mask)
+			{
+				return Lane + (int32)FMath::CountTrailingZeros((uint32)Mask);
+			}
+		}
+#else
+		for (int32 Lane = 0; Lane < PaddedSize; ++Lane)
+		{
+			if (Cache[Lane] == Index)
+			{
+				return Lane;
+			}
+		}
+#endif
+		return INDEX_NONE;
+	}
+}
+
+void FVertexCacheAnalysis::Analyze(const TArray<uint32>& Indices, int32 CacheSize, FVertexCacheStats& OutStats)
+{
+	OutStats = FVertexCacheStats();
+	CacheSize = FMath::Clamp(CacheSize, 1, (int32)MaxCacheSize);
+	OutStats.NumTriangles = Indices.Num() / 3;
+	if (Indices.Num() == 0)
+	{
+		return;
+	}
+
+	uint32 MaxIndex = 0;
+	for (uint32 Index : Indices)
+	{
+		MaxIndex = FMath::Max(MaxIndex, Index);
+	}
+
+	// FIFO: 记录每个顶点进入缓存时的序号, 之后又有 CacheSize 个顶点进入时被挤出, 命中不刷新
+	TArray<uint32> FIFOTimestamps;
+	FIFOTimestamps.AddZeroed(MaxIndex + 1);
+	uint32 FIFOCounter = (uint32)CacheSize;
+
+	// LRU: 缓存按最近使用排序, 命中的顶点移到最前面
+	MS_ALIGN(16) int32 LRUCache[MaxCacheSize] GCC_ALIGN(16);
+	const int32 PaddedSize = Align(CacheSize, 4);
+	for (int32 Lane = 0; Lane < MaxCacheSize; ++Lane)
+	{
+		LRUCache[Lane] = INDEX_NONE;
+	}
+
+	for (uint32 Index : Indices)
+	{
+		uint32& Timestamp = FIFOTimestamps[Index];
+		if (Timestamp == 0)
+		{
+			++OutStats.NumVertices;
+		}
+		if (FIFOCounter - Timestamp >= (uint32)CacheSize)
+		{
+			++OutStats.FIFOMisses;
+			Timestamp = ++FIFOCounter;
+		}
+
+		int32 Position = VertexCacheAnalysis::FindInCache(LRUCache, PaddedSize, (int32)Index);
+		if (Position == INDEX_NONE)
+		{
+			++OutStats.LRUMisses;
+			Position = CacheSize - 1;
+		}
+		FMemory::Memmove(LRUCache + 1, LRUCache, Position * sizeof(int32));
+		LRUCache[0] = (int32)Index;
+	}
+}
+
+void FVertexCacheAnalysis::OptimizeMeshDescription(FMeshDescription& MeshDescription)
+{
+	IMeshUtilities& MeshUtilities = FModuleManager::Get().LoadModuleChecked<IMeshUtilities>("MeshUtilities");
+
+	struct FPolygonCorners
+	{
+		FPolygonGroupID PolygonGroupID;
+		TArray<FVertexInstanceID> VertexInstanceIDs;
+	};
+	TArray<FPolygonCorners> OrderedPolygons;
+	OrderedPolygons.Reserve(MeshDescription.Polygons().Num());
+
+	for (const FPolygonGroupID PolygonGroupID : MeshDescription.PolygonGroups().GetElementIDs())
+	{
+		const TArray<FPolygonID>& GroupPolygons = MeshDescription.GetPolygonGroupPolygons(PolygonGroupID);
+
+		// 以顶点实例作为索引, 优化后按三角形第一次出现的顺序排列多边形
+		TArray<uint32> Indices;
+		TMap<FIntVector, int32> TriangleToPolygon;
+		for (int32 PolygonIndex = 0; PolygonIndex < GroupPolygons.Num(); ++PolygonIndex)
+		{
+			for (const FTriangleID TriangleID : MeshDescription.GetPolygonTriangleIDs(GroupPolygons[PolygonIndex]))
+			{
+				const FIntVector Corners(
+					MeshDescription.GetTriangleVertexInstance(TriangleID, 0).GetValue(),
+					MeshDescription.GetTriangleVertexInstance(TriangleID, 1).GetValue(),
+					MeshDescription.GetTriangleVertexInstance(TriangleID, 2).GetValue());
+				Indices.Add(Corners.X);
+				Indices.Add(Corners.Y);
+				Indices.Add(Corners.Z);
+				TriangleToPolygon.Add(Corners, PolygonIndex);
+			}
+		}
+		MeshUtilities.CacheOptimizeIndexBuffer(Indices);
+
+		TBitArray<> AddedPolygons(false, GroupPolygons.Num());
+		auto AddPolygon = [&](int32 PolygonIndex)
+		{
+			AddedPolygons[PolygonIndex] = true;
+			FPolygonCorners& Polygon = OrderedPolygons.AddDefaulted_GetRef();
+			Polygon.PolygonGroupID = PolygonGroupID;
+			Polygon.VertexInstanceIDs = MeshDescription.GetPolygonVertexInstances(GroupPolygons[PolygonIndex]);
+		};
+
+		for (int32 Index = 0; Index + 2 < Indices.Num(); Index += 3)
+		{
+			const int32* PolygonIndex = TriangleToPolygon.Find(FIntVector(Indices[Index], Indices[Index + 1], Indices[Index + 2]));
+			if (PolygonIndex && !AddedPolygons[*PolygonIndex])
+			{
+				AddPolygon(*PolygonIndex);
+			}
+		}
+
+		// 优化时旋转了顶点顺序的三角形找不到对应的多边形, 保持原来的顺序放在最后
+		for (int32 PolygonIndex = 0; PolygonIndex < GroupPolygons.Num(); ++PolygonIndex)
+		{
+			if (!AddedPolygons[PolygonIndex])
+			{
+				AddPolygon(PolygonIndex);
+			}
+		}
+	}
+
+	// 删除后压缩, 重新创建的多边形才会按顺序分配ID
+	TArray<FPolygonID> PolygonIDs;
+	for (const FPolygonID PolygonID : MeshDescription.Polygons().GetElementIDs())
+	{
+		PolygonIDs.Add(PolygonID);
+	}
+	for (const FPolygonID PolygonID : PolygonIDs)
+	{
+		MeshDescription.DeletePolygon(PolygonID);
+	}
+
+	FElementIDRemappings Remappings;
+	MeshDescription.Compact(Remappings);
+
+	for (FPolygonCorners& Polygon : OrderedPolygons)
+	{
+		for (FVertexInstanceID& VertexInstanceID : Polygon.VertexInstanceIDs)
+		{
+			VertexInstanceID = Remappings.GetRemappedVertexInstanceID(VertexInstanceID);
+		}
+		MeshDescription.CreatePolygon(Remappings.GetRemappedPolygonGroupID(Polygon.PolygonGroupID), Polygon.VertexInstanceIDs);
+	}
+}
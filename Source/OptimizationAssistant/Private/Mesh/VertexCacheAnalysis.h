@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMeshDescription;
+
+/** Post transform cache misses of one index buffer. */
+struct FVertexCacheStats
+{
+	FVertexCacheStats()
+		: NumTriangles(0)
+		, NumVertices(0)
+		, FIFOMisses(0)
+		, LRUMisses(0)
+	{
+	}
+
+	int32 NumTriangles;
+
+	/** Unique vertices referenced by the index buffer. */
+	int32 NumVertices;
+
+	int32 FIFOMisses;
+	int32 LRUMisses;
+
+	/** Average cache miss ratio, transformed vertices per triangle. 0.5 is the lower bound of a regular grid, 3 means no reuse at all. */
+	float GetFIFOACMR() const { return NumTriangles > 0 ? (float)FIFOMisses / NumTriangles : 0.f; }
+	float GetLRUACMR() const { return NumTriangles > 0 ? (float)LRUMisses / NumTriangles : 0.f; }
+
+	/** Average transformed vertices per vertex, 1 is optimal. */
+	float GetFIFOATVR() const { return NumVertices > 0 ? (float)FIFOMisses / NumVertices : 0.f; }
+	float GetLRUATVR() const { return NumVertices > 0 ? (float)LRUMisses / NumVertices : 0.f; }
+};
+
+/**
+ * Simulates the post transform vertex cache over an index buffer with a FIFO model (older
+ * hardware, hits do not refresh an entry) and an LRU model (hits move the vertex to the front).
+ */
+class FVertexCacheAnalysis
+{
+public:
+	enum { MaxCacheSize = 64 };
+
+	static void Analyze(const TArray<uint32>& Indices, int32 CacheSize, FVertexCacheStats& OutStats);
+
+	/**
+	 * Reorders the polygons of every polygon group so the triangles built from them follow a cache
+	 * optimized order, the mesh has to be committed and rebuilt afterwards.
+	 */
+	static void OptimizeMeshDescription(FMeshDescription& MeshDescription);
+};
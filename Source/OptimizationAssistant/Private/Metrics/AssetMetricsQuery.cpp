@@ -0,0 +1,620 @@
+#include "AssetMetricsQuery.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/AllOf.h"
+
+#define OA_QUERY_SIMD (PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_ENABLE_VECTORINTRINSICS_NEON)
+
+#if OA_QUERY_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace AssetMetricsQuery
+{
+	static const int32 BitsPerWord = 64;
+
+	FORCEINLINE int32 GetNumWords(int32 NumRecords)
+	{
+		return (NumRecords + BitsPerWord - 1) / BitsPerWord;
+	}
+
+	template<typename T>
+	FORCEINLINE bool CompareScalar(T A, EMetricsCompareOp Op, T B)
+	{
+		switch (Op)
+		{
+		case EMetricsCompareOp::Less:			return A < B;
+		case EMetricsCompareOp::LessEqual:		return A <= B;
+		case EMetricsCompareOp::Greater:		return A > B;
+		case EMetricsCompareOp::GreaterEqual:	return A >= B;
+		case EMetricsCompareOp::Equal:			return A == B;
+		case EMetricsCompareOp::NotEqual:		return A != B;
+		}
+		return false;
+	}
+
+	/** Scalar evaluation of the records that do not fill a whole word. */
+	template<typename T>
+	void EvaluateTail(const T* Data, int32 NumRecords, EMetricsCompareOp Op, T Value, uint64* OutWords, int32 FirstWord)
+	{
+		for (int32 WordIndex = FirstWord; WordIndex < GetNumWords(NumRecords); ++WordIndex)
+		{
+			uint64 Word = 0;
+			const int32 Start = WordIndex * BitsPerWord;
+			const int32 End = FMath::Min(Start + BitsPerWord, NumRecords);
+			for (int32 Index = Start; Index < End; ++Index)
+			{
+				Word |= (uint64)CompareScalar(Data[Index], Op, Value) << (Index - Start);
+			}
+			OutWords[WordIndex] = Word;
+		}
+	}
+
+#if OA_QUERY_SIMD
+	template<EMetricsCompareOp Op>
+	FORCEINLINE uint64 CompareLanes(__m128i Values, __m128i Constant)
+	{
+		switch (Op)
+		{
+		case EMetricsCompareOp::Less:			return (uint64)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(Values, Constant)));
+		case EMetricsCompareOp::LessEqual:		return (uint64)(~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(Values, Constant))) & 0xF);
+		case EMetricsCompareOp::Greater:		return (uint64)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(Values, Constant)));
+		case EMetricsCompareOp::GreaterEqual:	return (uint64)(~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(Values, Constant))) & 0xF);
+		case EMetricsCompareOp::Equal:			return (uint64)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(Values, Constant)));
+		case EMetricsCompareOp::NotEqual:		return (uint64)(~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(Values, Constant))) & 0xF);
+		}
+		return 0;
+	}
+
+	template<EMetricsCompareOp Op>
+	FORCEINLINE uint64 CompareLanes(__m128 Values, __m128 Constant)
+	{
+		switch (Op)
+		{
+		case EMetricsCompareOp::Less:			return (uint64)_mm_movemask_ps(_mm_cmplt_ps(Values, Constant));
+		case EMetricsCompareOp::LessEqual:		return (uint64)_mm_movemask_ps(_mm_cmple_ps(Values, Constant));
+		case EMetricsCompareOp::Greater:		return (uint64)_mm_movemask_ps(_mm_cmpgt_ps(Values, Constant));
+		case EMetricsCompareOp::GreaterEqual:	return (uint64)_mm_movemask_ps(_mm_cmpge_ps(Values, Constant));
+		case EMetricsCompareOp::Equal:			return (uint64)_mm_movemask_ps(_mm_cmpeq_ps(Values, Constant));
+		case EMetricsCompareOp::NotEqual:		return (uint64)_mm_movemask_ps(_mm_cmpneq_ps(Values, Constant));
+		}
+		return 0;
+	}
+
+	FORCEINLINE __m128i LoadLanes(const int32* Data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data)); }
+	FORCEINLINE __m128 LoadLanes(const float* Data) { return _mm_loadu_ps(Data); }
+	FORCEINLINE __m128i SplatLanes(int32 Value) { return _mm_set1_epi32(Value); }
+	FORCEINLINE __m128 SplatLanes(float Value) { return _mm_set1_ps(Value); }
+
+	template<EMetricsCompareOp Op, typename T>
+	void EvaluateWords(const T* Data, int32 NumRecords, T Value, uint64* OutWords)
+	{
+		const int32 NumFullWords = NumRecords / BitsPerWord;
+		const auto Constant = SplatLanes(Value);
+		for (int32 WordIndex = 0; WordIndex < NumFullWords; ++WordIndex)
+		{
+			const T* WordData = Data + WordIndex * BitsPerWord;
+			uint64 Word = 0;
+			for (int32 Lane = 0; Lane < BitsPerWord; Lane += 4)
+			{
+				Word |= CompareLanes<Op>(LoadLanes(WordData + Lane), Constant) << Lane;
+			}
+			OutWords[WordIndex] = Word;
+		}
+		EvaluateTail(Data, NumRecords, Op, Value, OutWords, NumFullWords);
+	}
+#endif
+
+	template<typename T>
+	void Evaluate(const T* Data, int32 NumRecords, EMetricsCompareOp Op, T Value, uint64* OutWords)
+	{
+#if OA_QUERY_SIMD
+		switch (Op)
+		{
+		case EMetricsCompareOp::Less:			EvaluateWords<EMetricsCompareOp::Less>(Data, NumRecords, Value, OutWords); break;
+		case EMetricsCompareOp::LessEqual:		EvaluateWords<EMetricsCompareOp::LessEqual>(Data, NumRecords, Value, OutWords); break;
+		case EMetricsCompareOp::Greater:		EvaluateWords<EMetricsCompareOp::Greater>(Data, NumRecords, Value, OutWords); break;
+		case EMetricsCompareOp::GreaterEqual:	EvaluateWords<EMetricsCompareOp::GreaterEqual>(Data, NumRecords, Value, OutWords); break;
+		case EMetricsCompareOp::Equal:			EvaluateWords<EMetricsCompareOp::Equal>(Data, NumRecords, Value, OutWords); break;
+		case EMetricsCompareOp::NotEqual:		EvaluateWords<EMetricsCompareOp::NotEqual>(Data, NumRecords, Value, OutWords); break;
+		}
+#else
+		EvaluateTail(Data, NumRecords, Op, Value, OutWords, 0);
+#endif
+	}
+
+	void EvaluateByteEqual(const uint8* Data, int32 NumRecords, uint8 Value, uint64* OutWords)
+	{
+		int32 NumFullWords = 0;
+#if OA_QUERY_SIMD
+		NumFullWords = NumRecords / BitsPerWord;
+		const __m128i Constant = _mm_set1_epi8((char)Value);
+		for (int32 WordIndex = 0; WordIndex < NumFullWords; ++WordIndex)
+		{
+			const uint8* WordData = Data + WordIndex * BitsPerWord;
+			uint64 Word = 0;
+			for (int32 Lane = 0; Lane < BitsPerWord; Lane += 16)
+			{
+				const __m128i Values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(WordData + Lane));
+				Word |= (uint64)(uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(Values, Constant)) << Lane;
+			}
+			OutWords[WordIndex] = Word;
+		}
+#endif
+		EvaluateTail(Data, NumRecords, EMetricsCompareOp::Equal, Value, OutWords, NumFullWords);
+	}
+
+	void Intersect(TArray<uint64>& Result, const TArray<uint64>& Other)
+	{
+		uint64* ResultWords = Result.GetData();
+		const uint64* OtherWords = Other.GetData();
+		for (int32 WordIndex = 0; WordIndex < Result.Num(); ++WordIndex)
+		{
+			ResultWords[WordIndex] &= OtherWords[WordIndex];
+		}
+	}
+
+	bool ParseCompareOp(const FString& Token, int32& InOutPos, EMetricsCompareOp& OutOp)
+	{
+		const TCHAR First = Token[InOutPos];
+		const TCHAR Second = InOutPos + 1 < Token.Len() ? Token[InOutPos + 1] : TEXT('\0');
+		const bool bHasEqual = Second == TEXT('=');
+		switch (First)
+		{
+		case TEXT('<'): OutOp = bHasEqual ? EMetricsCompareOp::LessEqual : EMetricsCompareOp::Less; break;
+		case TEXT('>'): OutOp = bHasEqual ? EMetricsCompareOp::GreaterEqual : EMetricsCompareOp::Greater; break;
+		case TEXT('='): OutOp = EMetricsCompareOp::Equal; break;
+		case TEXT('!'):
+			if (!bHasEqual)
+			{
+				return false;
+			}
+			OutOp = EMetricsCompareOp::NotEqual;
+			break;
+		default:
+			return false;
+		}
+		InOutPos += bHasEqual ? 2 : 1;
+		return true;
+	}
+
+	bool ParseKeyword(const FString& Token, const TCHAR* Keyword, FString& OutValue)
+	{
+		if (!Token.StartsWith(Keyword))
+		{
+			return false;
+		}
+		OutValue = Token.Mid(FCString::Strlen(Keyword));
+		return true;
+	}
+
+	bool IsOperatorChar(TCHAR Char)
+	{
+		return Char == TEXT('<') || Char == TEXT('>') || Char == TEXT('=') || Char == TEXT('!');
+	}
+
+	/** Removes the whitespace around operators so "LOD0.Triangles > 500" becomes one token. */
+	FString NormalizeQuery(const FString& QueryString)
+	{
+		FString Normalized;
+		Normalized.Reserve(QueryString.Len());
+		for (int32 CharIndex = 0; CharIndex < QueryString.Len(); ++CharIndex)
+		{
+			const TCHAR Char = QueryString[CharIndex];
+			if (FChar::IsWhitespace(Char))
+			{
+				const bool bAfterOperator = Normalized.Len() > 0 && IsOperatorChar(Normalized[Normalized.Len() - 1]);
+				int32 NextIndex = CharIndex;
+				while (NextIndex < QueryString.Len() && FChar::IsWhitespace(QueryString[NextIndex]))
+				{
+					++NextIndex;
+				}
+				const bool bBeforeOperator = NextIndex < QueryString.Len() && IsOperatorChar(QueryString[NextIndex]);
+				if (bAfterOperator || bBeforeOperator)
+				{
+					CharIndex = NextIndex - 1;
+					continue;
+				}
+			}
+			Normalized.AppendChar(Char);
+		}
+		return Normalized;
+	}
+}
+
+double FAssetMetricsField::GetValue(const FMappedAssetMetrics& Metrics, int32 Index, FName PlatformGroupName) const
+{
+	switch (Column)
+	{
+	case EAssetMetricsColumn::NumLODs:			return Metrics.GetNumLODs()[Index];
+	case EAssetMetricsColumn::NumMaterials:		return Metrics.GetNumMaterials()[Index];
+	case EAssetMetricsColumn::LODTriangles:		return Metrics.GetLODTriangles(LODIndex)[Index];
+	case EAssetMetricsColumn::LODVertices:		return Metrics.GetLODVertices(LODIndex)[Index];
+	case EAssetMetricsColumn::LODUVChannels:	return Metrics.GetLODUVChannels(LODIndex)[Index];
+	case EAssetMetricsColumn::LODSections:		return Metrics.GetLODSections(LODIndex)[Index];
+	case EAssetMetricsColumn::LODResidentBytes:	return Metrics.GetLODResidentBytes(LODIndex)[Index];
+	case EAssetMetricsColumn::LODScreenSize:	return Metrics.GetLODScreenSizes(LODIndex, PlatformGroupName)[Index];
+	default:									return 0.0;
+	}
+}
+
+FString FAssetMetricsField::ToString() const
+{
+	switch (Column)
+	{
+	case EAssetMetricsColumn::NumLODs:			return TEXT("NumLODs");
+	case EAssetMetricsColumn::NumMaterials:		return TEXT("Materials");
+	case EAssetMetricsColumn::LODTriangles:		return FString::Printf(TEXT("LOD%d.Triangles"), LODIndex);
+	case EAssetMetricsColumn::LODVertices:		return FString::Printf(TEXT("LOD%d.Vertices"), LODIndex);
+	case EAssetMetricsColumn::LODUVChannels:	return FString::Printf(TEXT("LOD%d.UVChannels"), LODIndex);
+	case EAssetMetricsColumn::LODSections:		return FString::Printf(TEXT("LOD%d.Sections"), LODIndex);
+	case EAssetMetricsColumn::LODResidentBytes:	return FString::Printf(TEXT("LOD%d.ResidentBytes"), LODIndex);
+	case EAssetMetricsColumn::LODScreenSize:	return FString::Printf(TEXT("LOD%d.ScreenSize"), LODIndex);
+	default:									return FString();
+	}
+}
+
+bool FAssetMetricsField::Parse(const FString& FieldName, FAssetMetricsField& OutField)
+{
+	OutField = FAssetMetricsField();
+	if (FieldName == TEXT("NumLODs") || FieldName == TEXT("LODs"))
+	{
+		OutField.Column = EAssetMetricsColumn::NumLODs;
+		return true;
+	}
+
+	if (FieldName == TEXT("Materials") || FieldName == TEXT("NumMaterials"))
+	{
+		OutField.Column = EAssetMetricsColumn::NumMaterials;
+		return true;
+	}
+
+	FString LODName, LODFieldName;
+	if (!FieldName.StartsWith(TEXT("LOD")) || !FieldName.Split(TEXT("."), &LODName, &LODFieldName))
+	{
+		return false;
+	}
+
+	const FString LODIndexString = LODName.Mid(3);
+	if (LODIndexString.IsEmpty() || !LODIndexString.IsNumeric())
+	{
+		return false;
+	}
+	OutField.LODIndex = FCString::Atoi(*LODIndexString);
+	if (OutField.LODIndex < 0 || OutField.LODIndex >= OA_METRICS_MAX_LODS)
+	{
+		return false;
+	}
+
+	if (LODFieldName == TEXT("Triangles"))
+	{
+		OutField.Column = EAssetMetricsColumn::LODTriangles;
+	}
+	else if (LODFieldName == TEXT("Vertices"))
+	{
+		OutField.Column = EAssetMetricsColumn::LODVertices;
+	}
+	else if (LODFieldName == TEXT("UVChannels"))
+	{
+		OutField.Column = EAssetMetricsColumn::LODUVChannels;
+	}
+	else if (LODFieldName == TEXT("Sections") || LODFieldName == TEXT("Materials"))
+	{
+		OutField.Column = EAssetMetricsColumn::LODSections;
+	}
+	else if (LODFieldName == TEXT("ResidentBytes"))
+	{
+		OutField.Column = EAssetMetricsColumn::LODResidentBytes;
+	}
+	else if (LODFieldName == TEXT("ScreenSize"))
+	{
+		OutField.Column = EAssetMetricsColumn::LODScreenSize;
+	}
+	return OutField.IsValid();
+}
+
+FAssetMetricsQuery::FAssetMetricsQuery()
+	: AssetTypeFilter(INDEX_NONE)
+	, bSortDescending(false)
+	, Limit(100)
+{
+}
+
+bool FAssetMetricsQuery::Parse(const FString& QueryString, FString& OutError)
+{
+	using namespace AssetMetricsQuery;
+
+	TArray<FString> Tokens;
+	NormalizeQuery(QueryString).ParseIntoArrayWS(Tokens);
+	for (const FString& Token : Tokens)
+	{
+		FString Value;
+		if (ParseKeyword(Token, TEXT("Type="), Value))
+		{
+			if (Value == TEXT("StaticMesh"))
+			{
+				AssetTypeFilter = (int32)EAssetMetricsType::StaticMesh;
+			}
+			else if (Value == TEXT("SkeletalMesh"))
+			{
+				AssetTypeFilter = (int32)EAssetMetricsType::SkeletalMesh;
+			}
+			else
+			{
+				OutError = FString::Printf(TEXT("Unknown asset type '%s', expected StaticMesh or SkeletalMesh."), *Value);
+				return false;
+			}
+		}
+		else if (ParseKeyword(Token, TEXT("Path="), Value))
+		{
+			// 目录边界在匹配时检查, 结尾的 / 可以省略
+			PathPrefix = Value;
+			PathPrefix.RemoveFromEnd(TEXT("/"));
+		}
+		else if (ParseKeyword(Token, TEXT("Platform="), Value))
+		{
+			PlatformGroupName = FName(*Value);
+		}
+		else if (ParseKeyword(Token, TEXT("Sort="), Value))
+		{
+			bSortDescending = Value.RemoveFromStart(TEXT("-"));
+			if (!FAssetMetricsField::Parse(Value, SortField))
+			{
+				OutError = FString::Printf(TEXT("Unknown sort field '%s'."), *Value);
+				return false;
+			}
+		}
+		else if (ParseKeyword(Token, TEXT("Limit="), Value))
+		{
+			const bool bIsCount = Value.Len() > 0 && Value.Len() <= 9 && Algo::AllOf(Value, [](TCHAR Char) { return FChar::IsDigit(Char); });
+			if (!bIsCount)
+			{
+				OutError = FString::Printf(TEXT("Invalid limit '%s', expected a non-negative integer (0 for no limit)."), *Value);
+				return false;
+			}
+			Limit = FCString::Atoi(*Value);
+		}
+		else
+		{
+			int32 OperatorPos = INDEX_NONE;
+			for (int32 CharIndex = 0; CharIndex < Token.Len(); ++CharIndex)
+			{
+				if (IsOperatorChar(Token[CharIndex]))
+				{
+					OperatorPos = CharIndex;
+					break;
+				}
+			}
+
+			FPredicate Predicate;
+			int32 ValuePos = OperatorPos;
+			if (OperatorPos <= 0 || !ParseCompareOp(Token, ValuePos, Predicate.Op))
+			{
+				OutError = FString::Printf(TEXT("Unable to parse '%s', expected <Field><Operator><Number>."), *Token);
+				return false;
+			}
+
+			const FString FieldName = Token.Left(OperatorPos);
+			if (!FAssetMetricsField::Parse(FieldName, Predicate.Field))
+			{
+				OutError = FString::Printf(TEXT("Unknown field '%s'."), *FieldName);
+				return false;
+			}
+
+			const FString ValueString = Token.Mid(ValuePos);
+			if (ValueString.IsEmpty() || !ValueString.IsNumeric())
+			{
+				OutError = FString::Printf(TEXT("'%s' is not a number."), *ValueString);
+				return false;
+			}
+			Predicate.Value = FCString::Atod(*ValueString);
+			if (!Predicate.Field.IsFloat() && FMath::Frac(Predicate.Value) != 0.0)
+			{
+				OutError = FString::Printf(TEXT("%s needs an integer value."), *FieldName);
+				return false;
+			}
+			Predicates.Add(Predicate);
+		}
+	}
+	return true;
+}
+
+void FAssetMetricsQuery::Execute(const FMappedAssetMetrics& Metrics, FAssetMetricsQueryResult& OutResult) const
+{
+	using namespace AssetMetricsQuery;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumRecords = Metrics.Num();
+	const int32 NumWords = GetNumWords(NumRecords);
+
+	TArray<uint64> Result;
+	Result.Init(~0ull, NumWords);
+	if (NumWords > 0 && (NumRecords % BitsPerWord) != 0)
+	{
+		Result.Last() = (1ull << (NumRecords % BitsPerWord)) - 1;
+	}
+
+	TArray<uint64> PredicateBits;
+	PredicateBits.SetNumUninitialized(NumWords);
+
+	if (AssetTypeFilter != INDEX_NONE)
+	{
+		EvaluateByteEqual(Metrics.GetAssetTypes(), NumRecords, (uint8)AssetTypeFilter, PredicateBits.GetData());
+		Intersect(Result, PredicateBits);
+	}
+
+	for (const FPredicate& Predicate : Predicates)
+	{
+		const FAssetMetricsField& Field = Predicate.Field;
+		const int32* IntData = nullptr;
+		switch (Field.Column)
+		{
+		case EAssetMetricsColumn::NumLODs:			IntData = Metrics.GetNumLODs(); break;
+		case EAssetMetricsColumn::NumMaterials:		IntData = Metrics.GetNumMaterials(); break;
+		case EAssetMetricsColumn::LODTriangles:		IntData = Metrics.GetLODTriangles(Field.LODIndex); break;
+		case EAssetMetricsColumn::LODVertices:		IntData = Metrics.GetLODVertices(Field.LODIndex); break;
+		case EAssetMetricsColumn::LODUVChannels:	IntData = Metrics.GetLODUVChannels(Field.LODIndex); break;
+		case EAssetMetricsColumn::LODSections:		IntData = Metrics.GetLODSections(Field.LODIndex); break;
+		case EAssetMetricsColumn::LODResidentBytes:	IntData = Metrics.GetLODResidentBytes(Field.LODIndex); break;
+		case EAssetMetricsColumn::LODScreenSize:	break;
+		default:									continue;
+		}
+
+		if (!IntData)
+		{
+			Evaluate(Metrics.GetLODScreenSizes(Field.LODIndex, PlatformGroupName), NumRecords, Predicate.Op, (float)Predicate.Value, PredicateBits.GetData());
+		}
+		else if (Predicate.Value >= (double)MIN_int32 && Predicate.Value <= (double)MAX_int32)
+		{
+			Evaluate(IntData, NumRecords, Predicate.Op, (int32)FMath::RoundToDouble(Predicate.Value), PredicateBits.GetData());
+		}
+		else
+		{
+			// 超出int32范围的常量对所有记录的比较结果都相同
+			const bool bAllMatch = CompareScalar(0.0, Predicate.Op, Predicate.Value);
+			FMemory::Memset(PredicateBits.GetData(), bAllMatch ? 0xFF : 0x00, NumWords * sizeof(uint64));
+		}
+		Intersect(Result, PredicateBits);
+
+		// 没有这一级LOD的记录在LOD列中填的是0, 不参与比较
+		if (Field.IsPerLOD())
+		{
+			Evaluate(Metrics.GetNumLODs(), NumRecords, EMetricsCompareOp::Greater, Field.LODIndex, PredicateBits.GetData());
+			Intersect(Result, PredicateBits);
+		}
+	}
+
+	FTCHARToUTF8 PathPrefixUTF8(*PathPrefix);
+	const int32 PathPrefixLength = PathPrefixUTF8.Length();
+
+	TArray<int32> MatchedIndices;
+	for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+	{
+		uint64 Word = Result[WordIndex];
+		while (Word)
+		{
+			const int32 Index = WordIndex * BitsPerWord + (int32)FMath::CountTrailingZeros64(Word);
+			Word &= Word - 1;
+
+			if (PathPrefixLength > 0)
+			{
+				int32 PathLength = 0;
+				const ANSICHAR* PathChars = Metrics.GetObjectPathChars(Index, PathLength);
+				if (PathLength < PathPrefixLength || FCStringAnsi::Strnicmp(PathChars, PathPrefixUTF8.Get(), PathPrefixLength) != 0)
+				{
+					continue;
+				}
+
+				// Path=/Game/Char 不能匹配 /Game/Characters
+				if (PathLength > PathPrefixLength && PathChars[PathPrefixLength] != '/' && PathChars[PathPrefixLength] != '.')
+				{
+					continue;
+				}
+			}
+			MatchedIndices.Add(Index);
+		}
+	}
+	OutResult.NumMatched = MatchedIndices.Num();
+
+	if (SortField.IsValid())
+	{
+		TArray<TPair<double, int32>> SortKeys;
+		SortKeys.Reserve(MatchedIndices.Num());
+		for (int32 Index : MatchedIndices)
+		{
+			SortKeys.Emplace(SortField.GetValue(Metrics, Index, PlatformGroupName), Index);
+		}
+
+		const bool bDescending = bSortDescending;
+		SortKeys.Sort([bDescending](const TPair<double, int32>& A, const TPair<double, int32>& B)
+		{
+			return bDescending ? A.Key > B.Key : A.Key < B.Key;
+		});
+
+		for (int32 KeyIndex = 0; KeyIndex < SortKeys.Num(); ++KeyIndex)
+		{
+			MatchedIndices[KeyIndex] = SortKeys[KeyIndex].Value;
+		}
+	}
+
+	if (Limit > 0 && MatchedIndices.Num() > Limit)
+	{
+		MatchedIndices.SetNum(Limit);
+	}
+	OutResult.Indices = MoveTemp(MatchedIndices);
+	OutResult.ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+void FAssetMetricsQuery::PrintResult(const FMappedAssetMetrics& Metrics, const FAssetMetricsQueryResult& Result, FOutputDevice& Ar) const
+{
+	TArray<FAssetMetricsField> Fields;
+	FAssetMetricsField::Parse(TEXT("NumLODs"), Fields.AddDefaulted_GetRef());
+	FAssetMetricsField::Parse(TEXT("LOD0.Triangles"), Fields.AddDefaulted_GetRef());
+	auto AddField = [&Fields](const FAssetMetricsField& Field)
+	{
+		if (Field.IsValid() && !Fields.ContainsByPredicate([&Field](const FAssetMetricsField& Other) { return Other.Column == Field.Column && Other.LODIndex == Field.LODIndex; }))
+		{
+			Fields.Add(Field);
+		}
+	};
+	for (const FPredicate& Predicate : Predicates)
+	{
+		AddField(Predicate.Field);
+	}
+	AddField(SortField);
+
+	Ar.Logf(TEXT("Matched %d of %d assets in %.3f ms, showing %d."), Result.NumMatched, Metrics.Num(), Result.ElapsedSeconds * 1000.0, Result.Indices.Num());
+	if (PlatformGroupName != NAME_None && !Metrics.GetPlatformNames().Contains(PlatformGroupName))
+	{
+		Ar.Logf(TEXT("No screen size overrides for platform group %s, default screen sizes are used."), *PlatformGroupName.ToString());
+	}
+
+	FString Header = FString::Printf(TEXT("%-12s"), TEXT("Type"));
+	for (const FAssetMetricsField& Field : Fields)
+	{
+		Header += FString::Printf(TEXT(" %16s"), *Field.ToString());
+	}
+	Ar.Logf(TEXT("%s  Object"), *Header);
+
+	const uint8* AssetTypes = Metrics.GetAssetTypes();
+	for (int32 Index : Result.Indices)
+	{
+		FString Line = FString::Printf(TEXT("%-12s"), AssetTypes[Index] == (uint8)EAssetMetricsType::SkeletalMesh ? TEXT("SkeletalMesh") : TEXT("StaticMesh"));
+		for (const FAssetMetricsField& Field : Fields)
+		{
+			Line += Field.IsFloat() ? FString::Printf(TEXT(" %16.4f"), Field.GetValue(Metrics, Index, PlatformGroupName)) : FString::Printf(TEXT(" %16d"), (int32)Field.GetValue(Metrics, Index));
+		}
+		Ar.Logf(TEXT("%s  %s"), *Line, *Metrics.GetObjectPath(Index));
+	}
+}
+
+bool FAssetMetricsQuery::Run(const FString& QueryString, const FString& Filename, FOutputDevice& Ar)
+{
+	FString ErrorMessage;
+	FAssetMetricsQuery Query;
+	if (!Query.Parse(QueryString, ErrorMessage))
+	{
+		Ar.Logf(ELogVerbosity::Error, TEXT("%s"), *ErrorMessage);
+		return false;
+	}
+
+	const FString MetricsFilename = Filename.IsEmpty() ? FAssetMetricsStore::GetDefaultFilePath() : Filename;
+	FMappedAssetMetrics Metrics;
+	if (!Metrics.Open(MetricsFilename))
+	{
+		Ar.Logf(ELogVerbosity::Error, TEXT("No asset metrics at %s, run an optimization check first."), *MetricsFilename);
+		return false;
+	}
+
+	FAssetMetricsQueryResult Result;
+	Query.Execute(Metrics, Result);
+	Query.PrintResult(Metrics, Result, Ar);
+	return true;
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GQueryAssetMetricsCommand(
+	TEXT("OA.QueryMetrics"),
+	TEXT("Queries the asset metrics of the latest optimization check, e.g. OA.QueryMetrics Type=SkeletalMesh LOD0.Triangles>50000 NumLODs<3 Path=/Game/Characters Sort=-LOD0.Triangles Limit=50"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FAssetMetricsQuery::Run(FString::Join(Args, TEXT(" ")), FString(), Ar);
+	}));
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetMetricsStore.h"
+
+enum class EMetricsCompareOp : uint8
+{
+	Less,
+	LessEqual,
+	Greater,
+	GreaterEqual,
+	Equal,
+	NotEqual
+};
+
+/** One queryable column, LODIndex is only used by the per LOD columns. */
+struct FAssetMetricsField
+{
+	FAssetMetricsField()
+		: Column(EAssetMetricsColumn::Max)
+		, LODIndex(0)
+	{
+	}
+
+	EAssetMetricsColumn Column;
+	int32 LODIndex;
+
+	bool IsValid() const { return Column != EAssetMetricsColumn::Max; }
+	bool IsFloat() const { return Column == EAssetMetricsColumn::LODScreenSize; }
+	bool IsPerLOD() const { return Column >= EAssetMetricsColumn::LODTriangles && Column <= EAssetMetricsColumn::LODScreenSize; }
+	double GetValue(const FMappedAssetMetrics& Metrics, int32 Index, FName PlatformGroupName = NAME_None) const;
+	FString ToString() const;
+
+	/** Parses NumLODs, Materials or LOD<n>.Triangles|Vertices|UVChannels|Sections|ResidentBytes|ScreenSize. */
+	static bool Parse(const FString& FieldName, FAssetMetricsField& OutField);
+};
+
+struct FAssetMetricsQueryResult
+{
+	FAssetMetricsQueryResult()
+		: NumMatched(0)
+		, ElapsedSeconds(0.0)
+	{
+	}
+
+	/** Matched record indices after sorting and limiting. */
+	TArray<int32> Indices;
+	int32 NumMatched;
+	double ElapsedSeconds;
+};
+
+/**
+ * Filter and sort query over a mapped metrics file, e.g.
+ *   Type=SkeletalMesh LOD0.Triangles>50000 NumLODs<3 Path=/Game/Characters Sort=-LOD0.Triangles Limit=50
+ * Platform=<PlatformGroup> makes the ScreenSize fields use the screen sizes of that platform group.
+ * Path= matches whole directories or assets, Limit=0 lists every match.
+ * Every numeric predicate is evaluated with SIMD into its own bitmap and the bitmaps are intersected,
+ * the path prefix is only tested on the rows that survived the numeric predicates.
+ */
+class FAssetMetricsQuery
+{
+public:
+	FAssetMetricsQuery();
+
+	bool Parse(const FString& QueryString, FString& OutError);
+	void Execute(const FMappedAssetMetrics& Metrics, FAssetMetricsQueryResult& OutResult) const;
+	void PrintResult(const FMappedAssetMetrics& Metrics, const FAssetMetricsQueryResult& Result, FOutputDevice& Ar) const;
+
+	/** Opens the metrics file (the latest scan if Filename is empty), runs the query and prints the result. */
+	static bool Run(const FString& QueryString, const FString& Filename, FOutputDevice& Ar);
+
+private:
+	struct FPredicate
+	{
+		FAssetMetricsField Field;
+		EMetricsCompareOp Op;
+		double Value;
+	};
+
+	TArray<FPredicate> Predicates;
+	int32 AssetTypeFilter;
+	FString PathPrefix;
+	FName PlatformGroupName;
+	FAssetMetricsField SortField;
+	bool bSortDescending;
+	int32 Limit;
+};
@@ -1,4 +1,8 @@
 #include "OptimizationAssistantGlobalSettings.h"
+#include "Misc/MessageDialog.h"
+#include "Misc/App.h"
+#include "OptimizationAssistantHelpers.h"
+#include "ThresholdExpression.h"
 
 UGlobalCheckSettings::UGlobalCheckSettings()
 	: Super()
@@ -7,13 +11,11 @@ UGlobalCheckSettings::UGlobalCheckSettings()
 	, MaxNetCullDistanceSquared(15000.f*15000.f)
 	, OptimizationFlagsBitmask(OCF_DefaultValue)
 	, OptimizationCheckType(EOptimizationCheckType::OCT_None)
-	, CullDistanceErrorScale(1.2f)
-	, TrianglesErrorScale(1.2f)
 {
-
+	CameraProfiles.AddDefaulted();
 }
 
-bool UGlobalCheckSettings::IsInNeverCheckDirectory(const FString& InPath)
+bool UGlobalCheckSettings::IsInNeverCheckDirectory(const FString& InPath) const
 {
 	for (const FDirectoryPath& NeverCheckDirectory : DirectoriesToNeverCheck)
 	{
@@ -31,6 +33,9 @@ UMeshOptimizationRules::UMeshOptimizationRules()
 	, MinTrianglesNeededForLOD(500)
 	, MeshCullScreenSize(0.03f)
 	, NeverCullMeshSize(10000.f)
+	, LODTrianglesCondition(TEXT("LOD[i].Triangles > Recommend.Triangles * 1.2"))
+	, LODScreenSizeCondition(TEXT("LOD[i].ScreenSize < Recommend.ScreenSize - 0.06"))
+	, CullDistanceCondition(TEXT("CullDistance > Recommend.CullDistance * 1.2"))
 {
 
 }
@@ -44,5 +49,33 @@ void UMeshOptimizationRules::PostEditChangeProperty(struct FPropertyChangedEvent
 bool UMeshOptimizationRules::ValidateSettings()
 {
 	FString ErrorMessage;
+	auto ValidateCondition = [&ErrorMessage](const FString& Condition)
+	{
+		FString ConditionError;
+		FThresholdExpression Expression;
+		if (!Expression.Compile(Condition, ConditionError))
+		{
+			ErrorMessage += ConditionError + TEXT("\n");
+		}
+	};
+
+	ValidateCondition(SkipCondition);
+	ValidateCondition(LODTrianglesCondition);
+	ValidateCondition(LODScreenSizeCondition);
+	ValidateCondition(CullDistanceCondition);
+	for (const FThresholdRule& ThresholdRule : ThresholdRules)
+	{
+		ValidateCondition(ThresholdRule.Condition);
+	}
+
+	if (!ErrorMessage.IsEmpty())
+	{
+		UE_LOG(LogOptimizationAssistant, Error, TEXT("%s: %s"), *GetName(), *ErrorMessage);
+		// 无人值守时对话框会阻塞流程, 错误已经写入日志
+		if (!FApp::IsUnattended())
+		{
+			FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorMessage));
+		}
+	}
 	return ErrorMessage.IsEmpty();
 }
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 DEFINE_LOG_CATEGORY(LogOptimizationAssistant);
 
-const PlatformInfo::FPlatformInfo* FOptimizationAssistantHelpers::TargetPlatform = nullptr;
+TArray<const PlatformInfo::FPlatformInfo*> FOptimizationAssistantHelpers::TargetPlatforms;
 TArray<const PlatformInfo::FPlatformInfo*> FOptimizationAssistantHelpers::AvailablePlatforms;
 
 void FOptimizationAssistantHelpers::GetDependentPackages(const TSet<UPackage*>& RootPackages, TSet<FName>& FoundPackages)
@@ -70,13 +70,13 @@ void FOptimizationAssistantHelpers::GetDependentPackages(const TSet<FName>& Root
 
 float FOptimizationAssistantHelpers::ComputeDrawDistanceFromScreenSize(const UPrimitiveComponent* PrimitiveComponent, float ScreenSize /*= 0.05f*/, float FOV /*= 90.0f*/)
 {
-	return ComputeDrawDistanceFromScreenSize(ScreenSize, PrimitiveComponent->Bounds.SphereRadius, FOV);
+	return ComputeDrawDistanceFromScreenSize(PrimitiveComponent->Bounds.SphereRadius, ScreenSize, FOV);
 }
 
 float FOptimizationAssistantHelpers::ComputeDrawDistanceFromScreenSize(float SphereRadius, float ScreenSize /*= 0.05f*/, float FOV /*= 90.0f*/)
 {
-	static const float FOVRad = FOV * (float)PI / 360.0f;
-	static const FMatrix ProjectionMatrix = FPerspectiveMatrix(FOVRad, 1920, 1080, 0.01f);
+	const float FOVRad = FOV * (float)PI / 360.0f;
+	const FMatrix ProjectionMatrix = FPerspectiveMatrix(FOVRad, 1920, 1080, 0.01f);
 	return ComputeBoundsDrawDistance(ScreenSize, SphereRadius, ProjectionMatrix);
 }
 
@@ -108,12 +108,39 @@ const TArray<const PlatformInfo::FPlatformInfo*>& FOptimizationAssistantHelpers:
 	return AvailablePlatforms;
 }
 
-const PlatformInfo::FPlatformInfo* FOptimizationAssistantHelpers::GetTargetPlatform()
+const TArray<const PlatformInfo::FPlatformInfo*>& FOptimizationAssistantHelpers::GetTargetPlatforms()
 {
-	return TargetPlatform;
+	return TargetPlatforms;
 }
 
-void FOptimizationAssistantHelpers::SetTargetPlatform(const PlatformInfo::FPlatformInfo* InPlatformInfo)
+TArray<FName> FOptimizationAssistantHelpers::GetTargetPlatformGroupNames()
 {
-	TargetPlatform = InPlatformInfo;
+	TArray<FName> PlatformGroupNames;
+	for (const PlatformInfo::FPlatformInfo* TargetPlatform : TargetPlatforms)
+	{
+		PlatformGroupNames.AddUnique(TargetPlatform->PlatformGroupName);
+	}
+
+	if (PlatformGroupNames.Num() == 0)
+	{
+		PlatformGroupNames.Add(NAME_None);
+	}
+	return PlatformGroupNames;
+}
+
+bool FOptimizationAssistantHelpers::IsTargetPlatform(const PlatformInfo::FPlatformInfo* InPlatformInfo)
+{
+	return TargetPlatforms.Contains(InPlatformInfo);
+}
+
+void FOptimizationAssistantHelpers::SetTargetPlatformEnabled(const PlatformInfo::FPlatformInfo* InPlatformInfo, bool bEnabled)
+{
+	if (bEnabled)
+	{
+		TargetPlatforms.AddUnique(InPlatformInfo);
+	}
+	else
+	{
+		TargetPlatforms.Remove(InPlatformInfo);
+	}
 }
@@ -15,6 +15,8 @@
 #include "Widgets/SOptimizationAssistantView.h"
 #include "Widgets/StaticMesh/StaticMeshOptimizationRules.h"
 #include "Widgets/SkeletalMesh/SkeletalMeshOptimizationRules.h"
+#include "OptimizationRuleRegistry.h"
+#include "Rules/MeshMetricsRules.h"
 
 
 static const FName OptimizationAssistantTabName("OptimizationAssistant");
@@ -33,6 +35,8 @@ void FOptimizationAssistantModule::StartupModule()
 
 	FConfigCacheIni::LoadGlobalIniFile(OptimizationAssistantIni, TEXT("OptimizationAssistant"));
 
+	OAMeshRules::RegisterRules(FOptimizationRuleRegistry::Get());
+
 	PluginCommands = MakeShareable(new FUICommandList);
 	PluginCommands->MapAction(
 		FOptimizationAssistantCommands::Get().OpenPluginWindow,
@@ -77,6 +81,8 @@ void FOptimizationAssistantModule::ShutdownModule()
 {
 	GConfig->Flush(false, FOptimizationAssistantModule::OptimizationAssistantIni);
 
+	OAMeshRules::UnregisterRules(FOptimizationRuleRegistry::Get());
+
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
 	{
 		SettingsModule->UnregisterSettings("Project", "Plugins", "OptimizationAssistant");
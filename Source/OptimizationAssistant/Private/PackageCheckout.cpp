@@ -0,0 +1,148 @@
+#include "PackageCheckout.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "SourceControlOperations.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "OptimizationAssistantHelpers.h"
+
+void FSourceControlCheckoutBackend::CheckOut(const TArray<FString>& Filenames, FPackageCheckoutResult& OutResult)
+{
+	if (Provider.Execute(ISourceControlOperation::Create<FUpdateStatus>(), Filenames) != ECommandResult::Succeeded)
+	{
+		OutResult.FailedFiles.Append(Filenames);
+		return;
+	}
+
+	TArray<FSourceControlStateRef> States;
+	Provider.GetState(Filenames, States, EStateCacheUsage::Use);
+
+	TArray<FString> FilesToCheckOut;
+	TArray<FString> LocalFiles;
+	for (const FSourceControlStateRef& State : States)
+	{
+		if (State->IsCheckedOut() || State->IsAdded())
+		{
+			OutResult.WritableFiles.Add(State->GetFilename());
+		}
+		else if (State->CanCheckout())
+		{
+			FilesToCheckOut.Add(State->GetFilename());
+		}
+		else if (!State->IsSourceControlled())
+		{
+			// 不在版本库中的文件只需要去掉只读属性
+			LocalFiles.Add(State->GetFilename());
+		}
+		else
+		{
+			OutResult.FailedFiles.Add(State->GetFilename());
+		}
+	}
+
+	if (LocalFiles.Num() > 0)
+	{
+		FLocalFileCheckoutBackend().CheckOut(LocalFiles, OutResult);
+	}
+
+	if (FilesToCheckOut.Num() == 0)
+	{
+		return;
+	}
+
+	if (Provider.Execute(ISourceControlOperation::Create<FCheckOut>(), FilesToCheckOut) == ECommandResult::Succeeded)
+	{
+		OutResult.CheckedOutFiles.Append(FilesToCheckOut);
+		return;
+	}
+
+	// 部分文件失败时从缓存的状态中区分, 不再访问服务器
+	Provider.GetState(FilesToCheckOut, States, EStateCacheUsage::Use);
+	for (const FSourceControlStateRef& State : States)
+	{
+		if (State->IsCheckedOut())
+		{
+			OutResult.CheckedOutFiles.Add(State->GetFilename());
+		}
+		else
+		{
+			OutResult.FailedFiles.Add(State->GetFilename());
+		}
+	}
+}
+
+void FLocalFileCheckoutBackend::CheckOut(const TArray<FString>& Filenames, FPackageCheckoutResult& OutResult)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for (const FString& Filename : Filenames)
+	{
+		if (!PlatformFile.IsReadOnly(*Filename))
+		{
+			OutResult.WritableFiles.Add(Filename);
+		}
+		else if (PlatformFile.SetReadOnly(*Filename, false))
+		{
+			OutResult.CheckedOutFiles.Add(Filename);
+		}
+		else
+		{
+			OutResult.FailedFiles.Add(Filename);
+		}
+	}
+}
+
+TUniquePtr<IPackageCheckoutBackend> FPackageCheckout::CreateBackend()
+{
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (SourceControlModule.IsEnabled() && SourceControlModule.GetProvider().IsAvailable())
+	{
+		return MakeUnique<FSourceControlCheckoutBackend>(SourceControlModule.GetProvider());
+	}
+	return MakeUnique<FLocalFileCheckoutBackend>();
+}
+
+bool FPackageCheckout::CheckOutPackages(IPackageCheckoutBackend& Backend, const TArray<FName>& PackageNames, TArray<FName>& OutFailedPackages)
+{
+	OutFailedPackages.Reset();
+
+	TMap<FString, FName> FilePackages;
+	TArray<FString> Filenames;
+	for (const FName PackageName : PackageNames)
+	{
+		FString Filename;
+		if (FPackageName::DoesPackageExist(PackageName.ToString(), nullptr, &Filename))
+		{
+			Filename = FPaths::ConvertRelativePathToFull(Filename);
+			if (!FilePackages.Contains(Filename))
+			{
+				FilePackages.Add(Filename, PackageName);
+				Filenames.Add(Filename);
+			}
+		}
+	}
+
+	if (Filenames.Num() == 0)
+	{
+		return true;
+	}
+
+	FPackageCheckoutResult Result;
+	const double StartTime = FPlatformTime::Seconds();
+	Backend.CheckOut(Filenames, Result);
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+	for (const FString& Filename : Result.FailedFiles)
+	{
+		if (const FName* PackageName = FilePackages.Find(Filename))
+		{
+			OutFailedPackages.Add(*PackageName);
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Failed to check out %s."), *Filename);
+		}
+	}
+
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Checked out %d of %d files (%d already writable, %d failed) in %.2fs using %s."),
+		Result.CheckedOutFiles.Num(), Filenames.Num(), Result.WritableFiles.Num(), Result.FailedFiles.Num(), Result.Seconds, Backend.GetName());
+	return OutFailedPackages.Num() == 0;
+}
@@ -0,0 +1,253 @@
+#include "PackageCheckout.h"
+#include "ISourceControlProvider.h"
+#include "ISourceControlState.h"
+#include "SourceControlOperations.h"
+#include "AssetRegistryModule.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "OptimizationAssistantHelpers.h"
+#if SOURCE_CONTROL_WITH_SLATE
+#include "Widgets/SNullWidget.h"
+#endif
+
+namespace PackageCheckoutTiming
+{
+	/** State of one file in the stub provider, only the flags the checkout backend reads. */
+	class FStubSourceControlState : public ISourceControlState
+	{
+	public:
+		FStubSourceControlState(const FString& InFilename, bool bInSourceControlled, bool bInCheckedOut)
+			: Filename(InFilename)
+			, bSourceControlled(bInSourceControlled)
+			, bCheckedOut(bInCheckedOut)
+		{
+		}
+
+		virtual int32 GetHistorySize() const override { return 0; }
+		virtual TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> GetHistoryItem(int32 HistoryIndex) const override { return nullptr; }
+		virtual TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> FindHistoryRevision(int32 RevisionNumber) const override { return nullptr; }
+		virtual TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> FindHistoryRevision(const FString& InRevision) const override { return nullptr; }
+		virtual TSharedPtr<ISourceControlRevision, ESPMode::ThreadSafe> GetBaseRevForMerge() const override { return nullptr; }
+		virtual FName GetIconName() const override { return NAME_None; }
+		virtual FName GetSmallIconName() const override { return NAME_None; }
+		virtual FText GetDisplayName() const override { return FText::GetEmpty(); }
+		virtual FText GetDisplayTooltip() const override { return FText::GetEmpty(); }
+		virtual const FString& GetFilename() const override { return Filename; }
+		virtual const FDateTime& GetTimeStamp() const override { return TimeStamp; }
+		virtual bool CanCheckIn() const override { return bCheckedOut; }
+		virtual bool CanCheckout() const override { return bSourceControlled && !bCheckedOut; }
+		virtual bool IsCheckedOut() const override { return bCheckedOut; }
+		virtual bool IsCheckedOutOther(FString* Who = nullptr) const override { return false; }
+		virtual bool IsCheckedOutInOtherBranch(const FString& CurrentBranch = FString()) const override { return false; }
+		virtual bool IsModifiedInOtherBranch(const FString& CurrentBranch = FString()) const override { return false; }
+		virtual TArray<FString> GetCheckedOutBranches() const override { return TArray<FString>(); }
+		virtual FString GetOtherUserBranchCheckedOuts() const override { return FString(); }
+		virtual bool GetOtherBranchHeadModification(FString& HeadBranchOut, FString& ActionOut, int32& HeadChangeListOut) const override { return false; }
+		virtual bool IsCurrent() const override { return true; }
+		virtual bool IsSourceControlled() const override { return bSourceControlled; }
+		virtual bool IsAdded() const override { return false; }
+		virtual bool IsDeleted() const override { return false; }
+		virtual bool IsIgnored() const override { return false; }
+		virtual bool CanEdit() const override { return bCheckedOut || !bSourceControlled; }
+		virtual bool CanDelete() const override { return bSourceControlled; }
+		virtual bool IsUnknown() const override { return false; }
+		virtual bool IsModified() const override { return false; }
+		virtual bool CanAdd() const override { return !bSourceControlled; }
+		virtual bool IsConflicted() const override { return false; }
+		virtual bool CanRevert() const override { return bCheckedOut; }
+
+		FString Filename;
+		FDateTime TimeStamp;
+		bool bSourceControlled;
+		bool bCheckedOut;
+	};
+
+	/**
+	 * Provider that answers from the files on disk instead of a server: a read-only file is under source control
+	 * and not checked out, a writable file is checked out. Checkouts only change the cached state, nothing on disk.
+	 * Every Execute waits Latency seconds and is counted, which stands in for one server round trip.
+	 */
+	class FStubSourceControlProvider : public ISourceControlProvider
+	{
+	public:
+		explicit FStubSourceControlProvider(float InLatency)
+			: Latency(InLatency)
+			, NumRequests(0)
+		{
+		}
+
+		int32 GetNumRequests() const { return NumRequests; }
+
+		virtual void Init(bool bForceConnection = true) override {}
+		virtual void Close() override {}
+		virtual const FName& GetName() const override { static const FName Name(TEXT("OAStub")); return Name; }
+		virtual FText GetStatusText() const override { return FText::GetEmpty(); }
+		virtual bool IsEnabled() const override { return true; }
+		virtual bool IsAvailable() const override { return true; }
+		virtual bool QueryStateBranchConfig(const FString& ConfigSrc, const FString& ConfigDest) override { return false; }
+		virtual void RegisterStateBranches(const TArray<FString>& BranchNames, const FString& ContentRoot) override {}
+		virtual int32 GetStateBranchIndex(const FString& BranchName) const override { return INDEX_NONE; }
+
+		virtual ECommandResult::Type GetState(const TArray<FString>& InFiles, TArray<FSourceControlStateRef>& OutState, EStateCacheUsage::Type InStateCacheUsage) override
+		{
+			OutState.Reset(InFiles.Num());
+			for (const FString& Filename : InFiles)
+			{
+				OutState.Add(FindOrAddState(Filename));
+			}
+			return ECommandResult::Succeeded;
+		}
+
+		virtual TArray<FSourceControlStateRef> GetCachedStateByPredicate(TFunctionRef<bool(const FSourceControlStateRef&)> Predicate) const override
+		{
+			TArray<FSourceControlStateRef> Result;
+			for (const TPair<FString, TSharedRef<FStubSourceControlState, ESPMode::ThreadSafe>>& Pair : States)
+			{
+				if (Predicate(Pair.Value))
+				{
+					Result.Add(Pair.Value);
+				}
+			}
+			return Result;
+		}
+
+		virtual FDelegateHandle RegisterSourceControlStateChanged_Handle(const FSourceControlStateChanged::FDelegate& SourceControlStateChanged) override { return FDelegateHandle(); }
+		virtual void UnregisterSourceControlStateChanged_Handle(FDelegateHandle Handle) override {}
+
+#if ENGINE_MINOR_VERSION >= 26
+		virtual ECommandResult::Type GetState(const TArray<FSourceControlChangelistRef>& InChangelists, TArray<FSourceControlChangelistStateRef>& OutState, EStateCacheUsage::Type InStateCacheUsage) override { return ECommandResult::Failed; }
+		virtual TArray<FSourceControlChangelistRef> GetChangelists(EStateCacheUsage::Type InStateCacheUsage) override { return TArray<FSourceControlChangelistRef>(); }
+
+		virtual ECommandResult::Type Execute(const FSourceControlOperationRef& InOperation, FSourceControlChangelistPtr InChangelist, const TArray<FString>& InFiles, EConcurrency::Type InConcurrency = EConcurrency::Synchronous, const FSourceControlOperationComplete& InOperationCompleteDelegate = FSourceControlOperationComplete()) override
+#else
+		virtual ECommandResult::Type Execute(const FSourceControlOperationRef& InOperation, const TArray<FString>& InFiles, EConcurrency::Type InConcurrency = EConcurrency::Synchronous, const FSourceControlOperationComplete& InOperationCompleteDelegate = FSourceControlOperationComplete()) override
+#endif
+		{
+			++NumRequests;
+			FPlatformProcess::Sleep(Latency);
+
+			ECommandResult::Type Result = ECommandResult::Succeeded;
+			if (InOperation->GetName() == TEXT("UpdateStatus"))
+			{
+				for (const FString& Filename : InFiles)
+				{
+					States.Remove(Filename);
+					FindOrAddState(Filename);
+				}
+			}
+			else if (InOperation->GetName() == TEXT("CheckOut"))
+			{
+				for (const FString& Filename : InFiles)
+				{
+					TSharedRef<FStubSourceControlState, ESPMode::ThreadSafe> State = FindOrAddState(Filename);
+					if (State->CanCheckout())
+					{
+						State->bCheckedOut = true;
+					}
+					else if (!State->IsCheckedOut())
+					{
+						Result = ECommandResult::Failed;
+					}
+				}
+			}
+			else
+			{
+				Result = ECommandResult::Failed;
+			}
+
+			InOperationCompleteDelegate.ExecuteIfBound(InOperation, Result);
+			return Result;
+		}
+
+		virtual bool CanCancelOperation(const FSourceControlOperationRef& InOperation) const override { return false; }
+		virtual void CancelOperation(const FSourceControlOperationRef& InOperation) override {}
+		virtual TArray<TSharedRef<ISourceControlLabel>> GetLabels(const FString& InMatchingSpec) const override { return TArray<TSharedRef<ISourceControlLabel>>(); }
+		virtual bool UsesLocalReadOnlyState() const override { return true; }
+		virtual bool UsesChangelists() const override { return false; }
+		virtual bool UsesCheckout() const override { return true; }
+		virtual void Tick() override {}
+#if SOURCE_CONTROL_WITH_SLATE
+		virtual TSharedRef<SWidget> MakeSettingsWidget() const override { return SNullWidget::NullWidget; }
+#endif
+
+	private:
+		TSharedRef<FStubSourceControlState, ESPMode::ThreadSafe> FindOrAddState(const FString& Filename)
+		{
+			if (const TSharedRef<FStubSourceControlState, ESPMode::ThreadSafe>* State = States.Find(Filename))
+			{
+				return *State;
+			}
+
+			IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+			const bool bSourceControlled = PlatformFile.FileExists(*Filename);
+			const bool bCheckedOut = bSourceControlled && !PlatformFile.IsReadOnly(*Filename);
+			return States.Add(Filename, MakeShared<FStubSourceControlState, ESPMode::ThreadSafe>(Filename, bSourceControlled, bCheckedOut));
+		}
+
+		float Latency;
+		int32 NumRequests;
+		TMap<FString, TSharedRef<FStubSourceControlState, ESPMode::ThreadSafe>> States;
+	};
+
+	/** Times the batched checkout of every package under PackagePath against one request per file, both on the stub provider. */
+	static void Run(const FString& PackagePath, float Latency, FOutputDevice& Ar)
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByPath(FName(*PackagePath), Assets, true);
+
+		TArray<FName> PackageNames;
+		TArray<FString> Filenames;
+		for (const FAssetData& Asset : Assets)
+		{
+			FString Filename;
+			if (!PackageNames.Contains(Asset.PackageName) && FPackageName::DoesPackageExist(Asset.PackageName.ToString(), nullptr, &Filename))
+			{
+				PackageNames.Add(Asset.PackageName);
+				Filenames.Add(FPaths::ConvertRelativePathToFull(Filename));
+			}
+		}
+
+		if (PackageNames.Num() == 0)
+		{
+			Ar.Logf(ELogVerbosity::Error, TEXT("No packages found under %s."), *PackagePath);
+			return;
+		}
+
+		// 批量签出走和修复任务相同的路径
+		FStubSourceControlProvider BatchedProvider(Latency);
+		FSourceControlCheckoutBackend BatchedBackend(BatchedProvider);
+		TArray<FName> FailedPackages;
+		double StartTime = FPlatformTime::Seconds();
+		FPackageCheckout::CheckOutPackages(BatchedBackend, PackageNames, FailedPackages);
+		const double BatchedSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// 对照组: 每个文件单独请求
+		FStubSourceControlProvider PerFileProvider(Latency);
+		FSourceControlCheckoutBackend PerFileBackend(PerFileProvider);
+		FPackageCheckoutResult PerFileResult;
+		StartTime = FPlatformTime::Seconds();
+		for (const FString& Filename : Filenames)
+		{
+			PerFileBackend.CheckOut(TArray<FString>{ Filename }, PerFileResult);
+		}
+		const double PerFileSeconds = FPlatformTime::Seconds() - StartTime;
+
+		Ar.Logf(TEXT("Checked out %d packages under %s with %.0fms simulated latency per request."), PackageNames.Num(), *PackagePath, Latency * 1000.f);
+		Ar.Logf(TEXT("    Batched:  %d requests, %.3fs, %d failed"), BatchedProvider.GetNumRequests(), BatchedSeconds, FailedPackages.Num());
+		Ar.Logf(TEXT("    Per file: %d requests, %.3fs, %d failed"), PerFileProvider.GetNumRequests(), PerFileSeconds, PerFileResult.FailedFiles.Num());
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GTimeCheckoutCommand(
+	TEXT("OA.TimeCheckout"),
+	TEXT("Times the batched package checkout against one request per file on a stub source control provider that reads the files on disk and changes nothing, e.g. OA.TimeCheckout /Game/Environment 20"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const FString PackagePath = Args.Num() > 0 ? Args[0] : TEXT("/Game");
+		const float LatencyMs = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 20.f;
+		PackageCheckoutTiming::Run(PackagePath, FMath::Max(LatencyMs, 0.f) / 1000.f, Ar);
+	}));
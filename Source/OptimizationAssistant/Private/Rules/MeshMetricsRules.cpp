@@ -0,0 +1,286 @@
+#include "MeshMetricsRules.h"
+#include "OptimizationRuleRegistry.h"
+
+namespace OAMeshRules
+{
+	class FMeshMetricsRule : public IOptimizationRule
+	{
+	public:
+		FMeshMetricsRule(FName InRuleName, EOptimizationCheckFlags InCheckFlag)
+			: RuleName(InRuleName)
+			, CheckFlag(InCheckFlag)
+		{
+		}
+
+		virtual FName GetRuleName() const override
+		{
+			return RuleName;
+		}
+
+		virtual bool SupportsAssetType(EAssetMetricsType AssetType) const override
+		{
+			return AssetType == EAssetMetricsType::StaticMesh || AssetType == EAssetMetricsType::SkeletalMesh;
+		}
+
+		virtual bool IsEnabled(const FOptimizationRuleContext& Context) const override
+		{
+			return Context.HasAnyFlags(CheckFlag);
+		}
+
+	private:
+		FName RuleName;
+		EOptimizationCheckFlags CheckFlag;
+	};
+
+	class FTrianglesLODNumRule : public FMeshMetricsRule
+	{
+	public:
+		FTrianglesLODNumRule() : FMeshMetricsRule(TEXT("TrianglesLODNum"), OCF_TrianglesLODNum) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const UMeshOptimizationRules* Rules = Context.GetMeshRules(Record.AssetType);
+			const int32 MaxTriangles = Record.NumTriangles[0];
+			for (int32 ThresholdIndex = Rules->MaxTrianglesForLODNum.Num() - 1; ThresholdIndex >= 0; --ThresholdIndex)
+			{
+				const FTriangleLODThresholds& TriangleLODThreshold = Rules->MaxTrianglesForLODNum[ThresholdIndex];
+				if (MaxTriangles >= TriangleLODThreshold.Triangles)
+				{
+					int32 RecommendLODNum = FMath::Min(TriangleLODThreshold.LODCount, 3);
+					if (Record.NumLODs < RecommendLODNum)
+					{
+						ErrorMessage += FString::Printf(TEXT("[%d]Triangles至少要有[%d]级LOD,当前有[%d]级.\n"), MaxTriangles, RecommendLODNum, Record.NumLODs);
+						break;
+					}
+				}
+			}
+		}
+	};
+
+	/** Conditions that read screen sizes are evaluated once per target platform group, the others once. */
+	static int32 GetNumPlatformPasses(const FOptimizationRuleContext& Context, const FThresholdExpression& Condition)
+	{
+		return Condition.DependsOnPlatform() ? Context.NumPlatformGroups() : 1;
+	}
+
+	static FString GetPlatformSuffix(const FOptimizationRuleContext& Context, const FThresholdExpression& Condition, int32 PlatformGroupIndex)
+	{
+		return Condition.DependsOnPlatform() ? Context.GetPlatformGroupSuffix(PlatformGroupIndex) : FString();
+	}
+
+	class FLODNumLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FLODNumLimitRule() : FMeshMetricsRule(TEXT("LODNumLimit"), OCF_LODNumLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			if (Record.NumLODs > OA_MAX_MESH_LODS)
+			{
+				ErrorMessage += FString::Printf(TEXT("LOD数量超过了限制，最多可有[%d]级，当前有[%d]级.\n"), OA_MAX_MESH_LODS, Record.NumLODs);
+			}
+		}
+	};
+
+	class FLODTrianglesLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FLODTrianglesLimitRule() : FMeshMetricsRule(TEXT("LODTrianglesLimit"), OCF_LODTrianglesLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const FThresholdExpression& Condition = Context.GetMeshThresholds(Record.AssetType).LODTriangles;
+			const float* RecommendPercents = Context.RecommendLODTrianglesPercents[(int32)Record.AssetType];
+			FThresholdVariables Variables;
+			for (int32 PlatformGroupIndex = 0; PlatformGroupIndex < GetNumPlatformPasses(Context, Condition); ++PlatformGroupIndex)
+			{
+				for (int32 LODIndex = 0; LODIndex < Record.NumLODs; ++LODIndex)
+				{
+					Context.SetupThresholdVariables(Record, LODIndex, Variables, PlatformGroupIndex);
+					if (Condition.EvaluateCondition(&Record, Variables))
+					{
+						int32 RecommendLODTriangles = (int32)Variables.Get(EThresholdVariable::RecommendTriangles);
+						ErrorMessage += FString::Printf(TEXT("第[%d]级LOD的 Triangles 不得大于[%d]，当前为[%d],推荐基于LOD 0 的Triangles Percent=[%f].%s\n"), LODIndex, RecommendLODTriangles, Record.NumTriangles[LODIndex], RecommendPercents[LODIndex], *GetPlatformSuffix(Context, Condition, PlatformGroupIndex));
+					}
+				}
+			}
+		}
+	};
+
+	class FLODScreenSizeLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FLODScreenSizeLimitRule() : FMeshMetricsRule(TEXT("LODScreenSizeLimit"), OCF_LODScreenSizeLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const FThresholdExpression& Condition = Context.GetMeshThresholds(Record.AssetType).LODScreenSize;
+			// 所有目标平台在同一遍中检查, 每个平台的结果单独列出
+			FThresholdVariables Variables;
+			for (int32 PlatformGroupIndex = 0; PlatformGroupIndex < Context.NumPlatformGroups(); ++PlatformGroupIndex)
+			{
+				const FString PlatformSuffix = Context.GetPlatformGroupSuffix(PlatformGroupIndex);
+				for (int32 LODIndex = 0; LODIndex < Record.NumLODs; ++LODIndex)
+				{
+					Context.SetupThresholdVariables(Record, LODIndex, Variables, PlatformGroupIndex);
+					if (Condition.EvaluateCondition(&Record, Variables))
+					{
+						float LODScreenSize = Record.GetLODScreenSize(Variables.PlatformGroupName, LODIndex);
+						float RecommendLODScreenSize = Variables.Get(EThresholdVariable::RecommendScreenSize);
+						ErrorMessage += FString::Printf(TEXT("第[%d]级LOD的 ScreenSize 不得小于[%f],当前是[%f]%s\n"), LODIndex, RecommendLODScreenSize, LODScreenSize, *PlatformSuffix);
+					}
+				}
+			}
+		}
+	};
+
+	class FLODUVChannelLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FLODUVChannelLimitRule() : FMeshMetricsRule(TEXT("LODUVChannelLimit"), OCF_LODUVChannelLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const int32 MaxUVChannels = Context.GetMeshRules(Record.AssetType)->MaxUVChannels;
+			for (int32 LODIndex = 0; LODIndex < Record.NumLODs; ++LODIndex)
+			{
+				int32 UVChannels = Record.NumUVChannels[LODIndex];
+				if (UVChannels > MaxUVChannels)
+				{
+					ErrorMessage += FString::Printf(TEXT("LOD[%d]使用的UV Channels超过了限制[%d]个，当前为[%d]个\n"), LODIndex, MaxUVChannels, UVChannels);
+				}
+			}
+		}
+	};
+
+	class FLODMaterialNumLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FLODMaterialNumLimitRule() : FMeshMetricsRule(TEXT("LODMaterialNumLimit"), OCF_LODMaterialNumLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const int32 LODMaxMaterials = Context.GetMeshRules(Record.AssetType)->LODMaxMaterials;
+			for (int32 LODIndex = 0; LODIndex < Record.NumLODs; ++LODIndex)
+			{
+				int32 NumSections = Record.NumSections[LODIndex];
+				if (NumSections > LODMaxMaterials)
+				{
+					ErrorMessage += FString::Printf(TEXT("LOD[%d]使用最大的材质数量超过了限制[%d]个，当前有[%d]个\n"), LODIndex, LODMaxMaterials, NumSections);
+				}
+			}
+		}
+	};
+
+	class FMeshMaterialNumLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FMeshMaterialNumLimitRule() : FMeshMetricsRule(TEXT("MeshMaterialNumLimit"), OCF_MeshMaterialNumLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const int32 MaxMaterials = Context.GetMeshRules(Record.AssetType)->MaxMaterials;
+			if (Record.NumMaterials > MaxMaterials)
+			{
+				ErrorMessage += FString::Printf(TEXT("Mesh使用的材质数超过了限制[%d]个, 当前为[%d]个.\n"), MaxMaterials, Record.NumMaterials);
+			}
+		}
+	};
+
+	class FMeshMemoryLimitRule : public FMeshMetricsRule
+	{
+	public:
+		FMeshMemoryLimitRule() : FMeshMetricsRule(TEXT("MeshMemoryLimit"), OCF_MeshMemoryLimit) {}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			const float MaxMemoryMB = Context.GetMeshRules(Record.AssetType)->MaxResidentMemoryMB;
+			const float MemoryMB = Record.GetResidentBytes() / (1024.f * 1024.f);
+			if (MemoryMB > MaxMemoryMB)
+			{
+				ErrorMessage += FString::Printf(TEXT("Mesh常驻内存超过了限制[%.2f]MB, 当前为[%.2f]MB"), MaxMemoryMB, MemoryMB);
+				for (int32 LODIndex = 0; LODIndex < Record.NumLODs; ++LODIndex)
+				{
+					ErrorMessage += FString::Printf(TEXT(", LOD[%d]=[%.2f]MB"), LODIndex, Record.ResidentBytes[LODIndex] / (1024.f * 1024.f));
+				}
+				ErrorMessage += TEXT(".\n");
+			}
+		}
+	};
+
+	/** Custom conditions from UMeshOptimizationRules::ThresholdRules. */
+	class FThresholdConditionRule : public FMeshMetricsRule
+	{
+	public:
+		FThresholdConditionRule() : FMeshMetricsRule(TEXT("ThresholdRules"), OCF_NoFlags) {}
+
+		virtual bool IsEnabled(const FOptimizationRuleContext& Context) const override
+		{
+			return true;
+		}
+
+		virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const override
+		{
+			FThresholdVariables Variables;
+			for (const FCompiledThresholdRule& CustomRule : Context.GetMeshThresholds(Record.AssetType).CustomRules)
+			{
+				const int32 NumIterations = CustomRule.bPerLOD ? Record.NumLODs : 1;
+				for (int32 PlatformGroupIndex = 0; PlatformGroupIndex < GetNumPlatformPasses(Context, CustomRule.Condition); ++PlatformGroupIndex)
+				{
+					const FString PlatformSuffix = GetPlatformSuffix(Context, CustomRule.Condition, PlatformGroupIndex);
+					for (int32 LODIndex = 0; LODIndex < NumIterations; ++LODIndex)
+					{
+						Context.SetupThresholdVariables(Record, LODIndex, Variables, PlatformGroupIndex);
+						if (!CustomRule.Condition.EvaluateCondition(&Record, Variables))
+						{
+							continue;
+						}
+
+						if (CustomRule.bPerLOD)
+						{
+							ErrorMessage += FString::Printf(TEXT("第[%d]级LOD不满足规则[%s]: %s%s\n"), LODIndex, *CustomRule.Name, *CustomRule.Condition.GetSource(), *PlatformSuffix);
+						}
+						else
+						{
+							ErrorMessage += FString::Printf(TEXT("不满足规则[%s]: %s%s\n"), *CustomRule.Name, *CustomRule.Condition.GetSource(), *PlatformSuffix);
+						}
+					}
+				}
+			}
+		}
+	};
+
+	static const TCHAR* BuiltinRuleNames[] =
+	{
+		TEXT("TrianglesLODNum"),
+		TEXT("LODNumLimit"),
+		TEXT("LODTrianglesLimit"),
+		TEXT("LODScreenSizeLimit"),
+		TEXT("LODUVChannelLimit"),
+		TEXT("LODMaterialNumLimit"),
+		TEXT("MeshMaterialNumLimit"),
+		TEXT("MeshMemoryLimit"),
+		TEXT("ThresholdRules"),
+	};
+
+	void RegisterRules(FOptimizationRuleRegistry& Registry)
+	{
+		Registry.RegisterRule(MakeShared<FTrianglesLODNumRule>());
+		Registry.RegisterRule(MakeShared<FLODNumLimitRule>());
+		Registry.RegisterRule(MakeShared<FLODTrianglesLimitRule>());
+		Registry.RegisterRule(MakeShared<FLODScreenSizeLimitRule>());
+		Registry.RegisterRule(MakeShared<FLODUVChannelLimitRule>());
+		Registry.RegisterRule(MakeShared<FLODMaterialNumLimitRule>());
+		Registry.RegisterRule(MakeShared<FMeshMaterialNumLimitRule>());
+		Registry.RegisterRule(MakeShared<FMeshMemoryLimitRule>());
+		Registry.RegisterRule(MakeShared<FThresholdConditionRule>());
+	}
+
+	void UnregisterRules(FOptimizationRuleRegistry& Registry)
+	{
+		for (const TCHAR* RuleName : BuiltinRuleNames)
+		{
+			Registry.UnregisterRule(FName(RuleName));
+		}
+	}
+}
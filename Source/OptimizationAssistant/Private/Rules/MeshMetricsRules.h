@@ -0,0 +1,12 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FOptimizationRuleRegistry;
+
+/** Built-in LOD, triangle and material rules shared by static and skeletal meshes. */
+namespace OAMeshRules
+{
+	void RegisterRules(FOptimizationRuleRegistry& Registry);
+	void UnregisterRules(FOptimizationRuleRegistry& Registry);
+}
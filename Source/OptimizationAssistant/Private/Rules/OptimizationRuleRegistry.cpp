@@ -0,0 +1,181 @@
+#include "OptimizationRuleRegistry.h"
+#include "PlatformInfo.h"
+#include "OptimizationAssistantHelpers.h"
+#include "Widgets/StaticMesh/StaticMeshOptimizationRules.h"
+#include "Widgets/SkeletalMesh/SkeletalMeshOptimizationRules.h"
+
+FOptimizationRuleContext::FOptimizationRuleContext()
+	: OptimizationFlagsBitmask(0)
+	, MaxNetCullDistanceSquared(0.f)
+{
+	FMemory::Memzero(MeshRules);
+	FMemory::Memzero(RecommendLODTrianglesPercents);
+}
+
+static void CompileThreshold(const FString& Condition, FThresholdExpression& OutExpression)
+{
+	FString ErrorMessage;
+	if (!OutExpression.Compile(Condition, ErrorMessage))
+	{
+		UE_LOG(LogOptimizationAssistant, Error, TEXT("%s"), *ErrorMessage);
+	}
+}
+
+static void CompileMeshThresholds(const UMeshOptimizationRules* Rules, FMeshThresholdExpressions& OutThresholds)
+{
+	CompileThreshold(Rules->SkipCondition, OutThresholds.Skip);
+	CompileThreshold(Rules->LODTrianglesCondition, OutThresholds.LODTriangles);
+	CompileThreshold(Rules->LODScreenSizeCondition, OutThresholds.LODScreenSize);
+	CompileThreshold(Rules->CullDistanceCondition, OutThresholds.CullDistance);
+
+	OutThresholds.CustomRules.Reset();
+	for (const FThresholdRule& ThresholdRule : Rules->ThresholdRules)
+	{
+		FCompiledThresholdRule& CustomRule = OutThresholds.CustomRules.AddDefaulted_GetRef();
+		CustomRule.Name = ThresholdRule.Name;
+		CustomRule.bPerLOD = ThresholdRule.bPerLOD;
+		CompileThreshold(ThresholdRule.Condition, CustomRule.Condition);
+	}
+}
+
+FOptimizationRuleContext FOptimizationRuleContext::Create()
+{
+	FOptimizationRuleContext Context;
+
+	const UGlobalCheckSettings* GlobalCheckSettings = GetDefault<UGlobalCheckSettings>();
+	Context.OptimizationFlagsBitmask = GlobalCheckSettings->OptimizationFlagsBitmask;
+	Context.MaxNetCullDistanceSquared = GlobalCheckSettings->MaxNetCullDistanceSquared;
+
+	for (const FName& PlatformGroupName : FOptimizationAssistantHelpers::GetTargetPlatformGroupNames())
+	{
+		FOptimizationPlatformGroup& PlatformGroup = Context.PlatformGroups.AddZeroed_GetRef();
+		PlatformGroup.PlatformGroupName = PlatformGroupName;
+	}
+	Context.CameraProfiles = FCameraProfileTable::CreateForTargetPlatforms();
+
+	Context.MeshRules[(int32)EAssetMetricsType::StaticMesh] = GetMutableDefault<UStaticMeshOptimizationRules>();
+	Context.MeshRules[(int32)EAssetMetricsType::SkeletalMesh] = GetMutableDefault<USkeletalMeshOptimizationRules>();
+	for (int32 TypeIndex = 0; TypeIndex < (int32)EAssetMetricsType::Max; ++TypeIndex)
+	{
+		if (UMeshOptimizationRules* Rules = Context.MeshRules[TypeIndex])
+		{
+			for (int32 LODIndex = 0; LODIndex < OA_METRICS_MAX_LODS; ++LODIndex)
+			{
+				for (FOptimizationPlatformGroup& PlatformGroup : Context.PlatformGroups)
+				{
+					PlatformGroup.RecommendLODScreenSizes[TypeIndex][LODIndex] = Rules->GetRecommendLODScreenSize(PlatformGroup.PlatformGroupName, LODIndex);
+				}
+				Context.RecommendLODTrianglesPercents[TypeIndex][LODIndex] = Rules->GetRecommendLODTrianglesPercent(LODIndex);
+			}
+			CompileMeshThresholds(Rules, Context.MeshThresholds[TypeIndex]);
+		}
+	}
+	return Context;
+}
+
+FString FOptimizationRuleContext::GetPlatformGroupSuffix(int32 PlatformGroupIndex) const
+{
+	const FName PlatformGroupName = PlatformGroups[PlatformGroupIndex].PlatformGroupName;
+	if (PlatformGroupName == NAME_None)
+	{
+		return FString();
+	}
+	return FString::Printf(TEXT(" [平台:%s]"), *PlatformGroupName.ToString());
+}
+
+void FOptimizationRuleContext::SetupThresholdVariables(const FAssetMetricsRecord& Record, int32 LODIndex, FThresholdVariables& OutVariables, int32 PlatformGroupIndex) const
+{
+	const int32 TypeIndex = (int32)Record.AssetType;
+	const UMeshOptimizationRules* Rules = MeshRules[TypeIndex];
+	const int32 ClampedLODIndex = FMath::Clamp(LODIndex, 0, OA_METRICS_MAX_LODS - 1);
+
+	const FOptimizationPlatformGroup& PlatformGroup = PlatformGroups[PlatformGroupIndex];
+
+	OutVariables.PlatformGroupName = PlatformGroup.PlatformGroupName;
+	OutVariables.Set(EThresholdVariable::LODIndex, (float)LODIndex);
+	OutVariables.Set(EThresholdVariable::NumLODs, (float)Record.NumLODs);
+	OutVariables.Set(EThresholdVariable::Materials, (float)Record.NumMaterials);
+	OutVariables.Set(EThresholdVariable::MemoryMB, Record.GetResidentBytes() / (1024.f * 1024.f));
+	OutVariables.Set(EThresholdVariable::RecommendScreenSize, PlatformGroup.RecommendLODScreenSizes[TypeIndex][ClampedLODIndex]);
+	if (Rules)
+	{
+		// 与 URecommendMeshSettings::GetRecommendLODTriangles 一致
+		const float RecommendTriangles = LODIndex == 0 ? (float)Rules->MaxTriangles : (int32)(Record.NumTriangles[0] * RecommendLODTrianglesPercents[TypeIndex][ClampedLODIndex]);
+		OutVariables.Set(EThresholdVariable::RecommendTriangles, RecommendTriangles);
+		OutVariables.Set(EThresholdVariable::MaxTriangles, (float)Rules->MaxTriangles);
+		OutVariables.Set(EThresholdVariable::MaxUVChannels, (float)Rules->MaxUVChannels);
+		OutVariables.Set(EThresholdVariable::MaxMaterials, (float)Rules->MaxMaterials);
+		OutVariables.Set(EThresholdVariable::LODMaxMaterials, (float)Rules->LODMaxMaterials);
+		OutVariables.Set(EThresholdVariable::MaxMemoryMB, Rules->MaxResidentMemoryMB);
+	}
+}
+
+FOptimizationRuleRegistry& FOptimizationRuleRegistry::Get()
+{
+	static FOptimizationRuleRegistry Registry;
+	return Registry;
+}
+
+void FOptimizationRuleRegistry::RegisterRule(const TSharedRef<IOptimizationRule>& Rule)
+{
+	const FName RuleName = Rule->GetRuleName();
+	const int32 ExistingIndex = Rules.IndexOfByPredicate([RuleName](const TSharedRef<IOptimizationRule>& Other) { return Other->GetRuleName() == RuleName; });
+	if (ExistingIndex != INDEX_NONE)
+	{
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("Optimization rule %s is replaced."), *RuleName.ToString());
+		Rules[ExistingIndex] = Rule;
+	}
+	else
+	{
+		Rules.Add(Rule);
+	}
+}
+
+void FOptimizationRuleRegistry::UnregisterRule(FName RuleName)
+{
+	Rules.RemoveAll([RuleName](const TSharedRef<IOptimizationRule>& Rule) { return Rule->GetRuleName() == RuleName; });
+}
+
+FCompiledOptimizationRules::FCompiledOptimizationRules()
+	: AssetType(EAssetMetricsType::Max)
+{
+}
+
+void FCompiledOptimizationRules::Compile(const FOptimizationRuleRegistry& Registry, const FOptimizationRuleContext& InContext, EAssetMetricsType InAssetType)
+{
+	Context = InContext;
+	AssetType = InAssetType;
+	CompiledRules.Reset();
+	Evaluators.Reset();
+
+	for (const TSharedRef<IOptimizationRule>& Rule : Registry.GetRules())
+	{
+		if (Rule->SupportsAssetType(AssetType) && Rule->IsEnabled(Context))
+		{
+			CompiledRules.Add(Rule);
+			Evaluators.Add(&Rule.Get());
+		}
+	}
+}
+
+void FCompiledOptimizationRules::Evaluate(const FAssetMetricsRecord& Record, FString& ErrorMessage) const
+{
+	check(Record.AssetType == AssetType);
+	for (const IOptimizationRule* Evaluator : Evaluators)
+	{
+		Evaluator->Evaluate(Record, Context, ErrorMessage);
+	}
+}
+
+bool FCompiledOptimizationRules::ShouldSkip(const FAssetMetricsRecord& Record) const
+{
+	const FThresholdExpression& SkipCondition = Context.GetMeshThresholds(Record.AssetType).Skip;
+	if (!SkipCondition.IsValid())
+	{
+		return false;
+	}
+
+	FThresholdVariables Variables;
+	Context.SetupThresholdVariables(Record, 0, Variables);
+	return SkipCondition.EvaluateCondition(&Record, Variables);
+}
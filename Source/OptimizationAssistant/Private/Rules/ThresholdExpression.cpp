@@ -0,0 +1,571 @@
+#include "ThresholdExpression.h"
+
+namespace ThresholdExpression
+{
+	struct FVariableName
+	{
+		const TCHAR* Name;
+		EThresholdVariable Variable;
+	};
+
+	static const FVariableName VariableNames[] =
+	{
+		{ TEXT("i"),						EThresholdVariable::LODIndex },
+		{ TEXT("NumLODs"),					EThresholdVariable::NumLODs },
+		{ TEXT("Materials"),				EThresholdVariable::Materials },
+		{ TEXT("MaxTriangles"),				EThresholdVariable::MaxTriangles },
+		{ TEXT("MaxUVChannels"),			EThresholdVariable::MaxUVChannels },
+		{ TEXT("MaxMaterials"),				EThresholdVariable::MaxMaterials },
+		{ TEXT("LODMaxMaterials"),			EThresholdVariable::LODMaxMaterials },
+		{ TEXT("MemoryMB"),					EThresholdVariable::MemoryMB },
+		{ TEXT("MaxMemoryMB"),				EThresholdVariable::MaxMemoryMB },
+		{ TEXT("Recommend.Triangles"),		EThresholdVariable::RecommendTriangles },
+		{ TEXT("Recommend.ScreenSize"),		EThresholdVariable::RecommendScreenSize },
+		{ TEXT("CullDistance"),				EThresholdVariable::CullDistance },
+		{ TEXT("Recommend.CullDistance"),	EThresholdVariable::RecommendCullDistance },
+	};
+
+	struct FFieldName
+	{
+		const TCHAR* Name;
+		EAssetMetricsColumn Column;
+	};
+
+	static const FFieldName FieldNames[] =
+	{
+		{ TEXT("Triangles"),	EAssetMetricsColumn::LODTriangles },
+		{ TEXT("Vertices"),		EAssetMetricsColumn::LODVertices },
+		{ TEXT("UVChannels"),	EAssetMetricsColumn::LODUVChannels },
+		{ TEXT("Sections"),		EAssetMetricsColumn::LODSections },
+		{ TEXT("Materials"),	EAssetMetricsColumn::LODSections },
+		{ TEXT("MemoryMB"),		EAssetMetricsColumn::LODResidentBytes },
+		{ TEXT("ScreenSize"),	EAssetMetricsColumn::LODScreenSize },
+	};
+
+	FORCEINLINE float ReadLODField(const FAssetMetricsRecord* Record, EAssetMetricsColumn Column, int32 LODIndex, FName PlatformGroupName)
+	{
+		if (!Record || LODIndex < 0 || LODIndex >= OA_METRICS_MAX_LODS)
+		{
+			return 0.f;
+		}
+
+		switch (Column)
+		{
+		case EAssetMetricsColumn::LODTriangles:		return (float)Record->NumTriangles[LODIndex];
+		case EAssetMetricsColumn::LODVertices:		return (float)Record->NumVertices[LODIndex];
+		case EAssetMetricsColumn::LODUVChannels:	return (float)Record->NumUVChannels[LODIndex];
+		case EAssetMetricsColumn::LODSections:		return (float)Record->NumSections[LODIndex];
+		case EAssetMetricsColumn::LODResidentBytes:	return Record->ResidentBytes[LODIndex] / (1024.f * 1024.f);
+		case EAssetMetricsColumn::LODScreenSize:	return Record->GetLODScreenSize(PlatformGroupName, LODIndex);
+		default:									return 0.f;
+		}
+	}
+
+	/** Recursive descent parser emitting the bytecode while it parses. */
+	class FParser
+	{
+	public:
+		FParser(const FString& InSource, TArray<FThresholdInstruction>& OutInstructions)
+			: Source(InSource)
+			, Pos(0)
+			, Instructions(OutInstructions)
+			, Depth(0)
+			, MaxDepth(0)
+		{
+		}
+
+		bool Parse(FString& OutError)
+		{
+			bool bSuccess = ParseOr();
+			if (bSuccess && Peek() != TEXT('\0'))
+			{
+				bSuccess = Fail(FString::Printf(TEXT("Unexpected '%c'"), Source[Pos]));
+			}
+			if (bSuccess && MaxDepth > FThresholdExpression::MaxStackDepth)
+			{
+				bSuccess = Fail(TEXT("Expression is too deep"));
+			}
+			OutError = Error;
+			return bSuccess;
+		}
+
+	private:
+		void Emit(EThresholdOpCode OpCode, int32 StackChange, uint8 Operand = 0, float Immediate = 0.f)
+		{
+			FThresholdInstruction& Instruction = Instructions.AddDefaulted_GetRef();
+			Instruction.OpCode = OpCode;
+			Instruction.Operand = Operand;
+			Instruction.Immediate = Immediate;
+			Depth += StackChange;
+			MaxDepth = FMath::Max(MaxDepth, Depth);
+		}
+
+		bool Fail(const FString& Message)
+		{
+			if (Error.IsEmpty())
+			{
+				Error = FString::Printf(TEXT("%s at column %d of \"%s\"."), *Message, Pos + 1, *Source);
+			}
+			return false;
+		}
+
+		void SkipWhitespace()
+		{
+			while (Pos < Source.Len() && FChar::IsWhitespace(Source[Pos]))
+			{
+				++Pos;
+			}
+		}
+
+		TCHAR Peek()
+		{
+			SkipWhitespace();
+			return Pos < Source.Len() ? Source[Pos] : TEXT('\0');
+		}
+
+		bool Match(const TCHAR* Token)
+		{
+			SkipWhitespace();
+			const int32 TokenLength = FCString::Strlen(Token);
+			if (FCString::Strncmp(*Source + Pos, Token, TokenLength) == 0)
+			{
+				Pos += TokenLength;
+				return true;
+			}
+			return false;
+		}
+
+		static bool IsIdentifierChar(TCHAR Char)
+		{
+			return FChar::IsAlnum(Char) || Char == TEXT('_');
+		}
+
+		bool MatchKeyword(const TCHAR* Keyword)
+		{
+			SkipWhitespace();
+			const int32 KeywordLength = FCString::Strlen(Keyword);
+			if (FCString::Strnicmp(*Source + Pos, Keyword, KeywordLength) == 0 &&
+				(Pos + KeywordLength >= Source.Len() || !IsIdentifierChar(Source[Pos + KeywordLength])))
+			{
+				Pos += KeywordLength;
+				return true;
+			}
+			return false;
+		}
+
+		FString ParseIdentifier()
+		{
+			SkipWhitespace();
+			const int32 Start = Pos;
+			while (Pos < Source.Len() && IsIdentifierChar(Source[Pos]))
+			{
+				++Pos;
+			}
+			return Source.Mid(Start, Pos - Start);
+		}
+
+		/** Advances past a run of decimal digits and returns how many there were. */
+		int32 SkipDigits()
+		{
+			const int32 Start = Pos;
+			while (Pos < Source.Len() && FChar::IsDigit(Source[Pos]))
+			{
+				++Pos;
+			}
+			return Pos - Start;
+		}
+
+		bool ParseOr()
+		{
+			if (!ParseAnd())
+			{
+				return false;
+			}
+			while (Match(TEXT("||")) || MatchKeyword(TEXT("or")))
+			{
+				if (!ParseAnd())
+				{
+					return false;
+				}
+				Emit(EThresholdOpCode::Or, -1);
+			}
+			return true;
+		}
+
+		bool ParseAnd()
+		{
+			if (!ParseComparison())
+			{
+				return false;
+			}
+			while (Match(TEXT("&&")) || MatchKeyword(TEXT("and")))
+			{
+				if (!ParseComparison())
+				{
+					return false;
+				}
+				Emit(EThresholdOpCode::And, -1);
+			}
+			return true;
+		}
+
+		bool ParseComparison()
+		{
+			if (!ParseAdditive())
+			{
+				return false;
+			}
+
+			EThresholdOpCode OpCode;
+			if (Match(TEXT("<=")))			OpCode = EThresholdOpCode::LessEqual;
+			else if (Match(TEXT(">=")))		OpCode = EThresholdOpCode::GreaterEqual;
+			else if (Match(TEXT("==")))		OpCode = EThresholdOpCode::Equal;
+			else if (Match(TEXT("!=")))		OpCode = EThresholdOpCode::NotEqual;
+			else if (Match(TEXT("<")))		OpCode = EThresholdOpCode::Less;
+			else if (Match(TEXT(">")))		OpCode = EThresholdOpCode::Greater;
+			else							return true;
+
+			if (!ParseAdditive())
+			{
+				return false;
+			}
+			Emit(OpCode, -1);
+			return true;
+		}
+
+		bool ParseAdditive()
+		{
+			if (!ParseMultiplicative())
+			{
+				return false;
+			}
+			for (;;)
+			{
+				EThresholdOpCode OpCode;
+				if (Match(TEXT("+")))		OpCode = EThresholdOpCode::Add;
+				else if (Match(TEXT("-")))	OpCode = EThresholdOpCode::Subtract;
+				else						return true;
+
+				if (!ParseMultiplicative())
+				{
+					return false;
+				}
+				Emit(OpCode, -1);
+			}
+		}
+
+		bool ParseMultiplicative()
+		{
+			if (!ParseUnary())
+			{
+				return false;
+			}
+			for (;;)
+			{
+				EThresholdOpCode OpCode;
+				if (Match(TEXT("*")))		OpCode = EThresholdOpCode::Multiply;
+				else if (Match(TEXT("/")))	OpCode = EThresholdOpCode::Divide;
+				else						return true;
+
+				if (!ParseUnary())
+				{
+					return false;
+				}
+				Emit(OpCode, -1);
+			}
+		}
+
+		bool ParseUnary()
+		{
+			if (Match(TEXT("-")))
+			{
+				if (!ParseUnary())
+				{
+					return false;
+				}
+				Emit(EThresholdOpCode::Negate, 0);
+				return true;
+			}
+
+			if (Peek() == TEXT('!') && (Pos + 1 >= Source.Len() || Source[Pos + 1] != TEXT('=')))
+			{
+				++Pos;
+				if (!ParseUnary())
+				{
+					return false;
+				}
+				Emit(EThresholdOpCode::Not, 0);
+				return true;
+			}
+			return ParsePrimary();
+		}
+
+		bool ParsePrimary()
+		{
+			const TCHAR Char = Peek();
+			if (Char == TEXT('('))
+			{
+				++Pos;
+				if (!ParseOr())
+				{
+					return false;
+				}
+				return Match(TEXT(")")) || Fail(TEXT("Expected ')'"));
+			}
+
+			if (FChar::IsDigit(Char) || Char == TEXT('.'))
+			{
+				// 数字: 整数部分和小数部分至多一个小数点, 可选指数 e[+-]digits
+				const int32 Start = Pos;
+				int32 NumDigits = SkipDigits();
+				if (Pos < Source.Len() && Source[Pos] == TEXT('.'))
+				{
+					++Pos;
+					NumDigits += SkipDigits();
+				}
+				if (NumDigits > 0 && Pos < Source.Len() && (Source[Pos] == TEXT('e') || Source[Pos] == TEXT('E')))
+				{
+					++Pos;
+					if (Pos < Source.Len() && (Source[Pos] == TEXT('+') || Source[Pos] == TEXT('-')))
+					{
+						++Pos;
+					}
+					if (SkipDigits() == 0)
+					{
+						NumDigits = 0;
+					}
+				}
+				if (NumDigits == 0 || (Pos < Source.Len() && (IsIdentifierChar(Source[Pos]) || Source[Pos] == TEXT('.'))))
+				{
+					while (Pos < Source.Len() && (IsIdentifierChar(Source[Pos]) || Source[Pos] == TEXT('.')))
+					{
+						++Pos;
+					}
+					const FString Literal = Source.Mid(Start, Pos - Start);
+					Pos = Start;
+					return Fail(FString::Printf(TEXT("Malformed number '%s'"), *Literal));
+				}
+				Emit(EThresholdOpCode::PushConstant, 1, 0, FCString::Atof(*Source.Mid(Start, Pos - Start)));
+				return true;
+			}
+
+			const int32 IdentifierPos = Pos;
+			FString Identifier = ParseIdentifier();
+			if (Identifier.IsEmpty())
+			{
+				return Fail(Char == TEXT('\0') ? FString(TEXT("Unexpected end of expression")) : FString::Printf(TEXT("Unexpected '%c'"), Char));
+			}
+
+			if (Peek() == TEXT('('))
+			{
+				return ParseFunction(Identifier);
+			}
+
+			if (Identifier.StartsWith(TEXT("LOD"), ESearchCase::CaseSensitive))
+			{
+				const FString LODIndexString = Identifier.Mid(3);
+				if (LODIndexString.IsEmpty() || LODIndexString.IsNumeric())
+				{
+					return ParseLODField(LODIndexString);
+				}
+			}
+
+			while (Pos < Source.Len() && Source[Pos] == TEXT('.'))
+			{
+				++Pos;
+				Identifier += TEXT(".") + ParseIdentifier();
+			}
+
+			for (const FVariableName& VariableName : VariableNames)
+			{
+				if (Identifier == VariableName.Name)
+				{
+					Emit(EThresholdOpCode::LoadVariable, 1, (uint8)VariableName.Variable);
+					return true;
+				}
+			}
+
+			Pos = IdentifierPos;
+			return Fail(FString::Printf(TEXT("Unknown variable '%s'"), *Identifier));
+		}
+
+		bool ParseFunction(const FString& FunctionName)
+		{
+			EThresholdOpCode OpCode;
+			int32 NumArguments;
+			if (FunctionName == TEXT("min"))		{ OpCode = EThresholdOpCode::Min; NumArguments = 2; }
+			else if (FunctionName == TEXT("max"))	{ OpCode = EThresholdOpCode::Max; NumArguments = 2; }
+			else if (FunctionName == TEXT("abs"))	{ OpCode = EThresholdOpCode::Abs; NumArguments = 1; }
+			else									return Fail(FString::Printf(TEXT("Unknown function '%s'"), *FunctionName));
+
+			Match(TEXT("("));
+			for (int32 ArgumentIndex = 0; ArgumentIndex < NumArguments; ++ArgumentIndex)
+			{
+				if (ArgumentIndex > 0 && !Match(TEXT(",")))
+				{
+					return Fail(FString::Printf(TEXT("%s expects %d arguments"), *FunctionName, NumArguments));
+				}
+				if (!ParseOr())
+				{
+					return false;
+				}
+			}
+			if (!Match(TEXT(")")))
+			{
+				return Fail(TEXT("Expected ')'"));
+			}
+			Emit(OpCode, 1 - NumArguments);
+			return true;
+		}
+
+		/** LOD<n>.Field or LOD[expression].Field, a constant index is folded into the instruction. */
+		bool ParseLODField(const FString& LODIndexString)
+		{
+			bool bConstantIndex = true;
+			float LODIndex = 0.f;
+			if (LODIndexString.IsEmpty())
+			{
+				if (!Match(TEXT("[")))
+				{
+					return Fail(TEXT("Expected LOD<n> or LOD[index]"));
+				}
+
+				const int32 FirstInstruction = Instructions.Num();
+				if (!ParseOr())
+				{
+					return false;
+				}
+				if (!Match(TEXT("]")))
+				{
+					return Fail(TEXT("Expected ']'"));
+				}
+
+				bConstantIndex = Instructions.Num() == FirstInstruction + 1 && Instructions.Last().OpCode == EThresholdOpCode::PushConstant;
+				if (bConstantIndex)
+				{
+					LODIndex = Instructions.Pop().Immediate;
+					--Depth;
+				}
+			}
+			else
+			{
+				LODIndex = (float)FCString::Atoi(*LODIndexString);
+			}
+
+			if (bConstantIndex && (LODIndex < 0.f || LODIndex >= OA_METRICS_MAX_LODS))
+			{
+				return Fail(FString::Printf(TEXT("LOD index %d is out of range"), (int32)LODIndex));
+			}
+
+			if (!Match(TEXT(".")))
+			{
+				return Fail(TEXT("Expected '.' after LOD"));
+			}
+
+			const FString FieldName = ParseIdentifier();
+			for (const FFieldName& Field : FieldNames)
+			{
+				if (FieldName == Field.Name)
+				{
+					if (bConstantIndex)
+					{
+						Emit(EThresholdOpCode::LoadLODField, 1, (uint8)Field.Column, LODIndex);
+					}
+					else
+					{
+						Emit(EThresholdOpCode::LoadLODFieldIndexed, 0, (uint8)Field.Column);
+					}
+					return true;
+				}
+			}
+			return Fail(FString::Printf(TEXT("Unknown LOD field '%s'"), *FieldName));
+		}
+
+	private:
+		const FString& Source;
+		int32 Pos;
+		TArray<FThresholdInstruction>& Instructions;
+		int32 Depth;
+		int32 MaxDepth;
+		FString Error;
+	};
+}
+
+FThresholdExpression::FThresholdExpression()
+	: bDependsOnPlatform(false)
+{
+}
+
+bool FThresholdExpression::Compile(const FString& InSource, FString& OutError)
+{
+	Source = InSource.TrimStartAndEnd();
+	Instructions.Reset();
+	bDependsOnPlatform = false;
+	if (Source.IsEmpty())
+	{
+		return true;
+	}
+
+	ThresholdExpression::FParser Parser(Source, Instructions);
+	if (!Parser.Parse(OutError))
+	{
+		Instructions.Reset();
+		return false;
+	}
+	Instructions.Shrink();
+
+	for (const FThresholdInstruction& Instruction : Instructions)
+	{
+		const bool bLoadsScreenSize = (Instruction.OpCode == EThresholdOpCode::LoadLODField || Instruction.OpCode == EThresholdOpCode::LoadLODFieldIndexed)
+			&& (EAssetMetricsColumn)Instruction.Operand == EAssetMetricsColumn::LODScreenSize;
+		const bool bLoadsRecommendScreenSize = Instruction.OpCode == EThresholdOpCode::LoadVariable
+			&& (EThresholdVariable)Instruction.Operand == EThresholdVariable::RecommendScreenSize;
+		bDependsOnPlatform |= bLoadsScreenSize || bLoadsRecommendScreenSize;
+	}
+	return true;
+}
+
+float FThresholdExpression::Evaluate(const FAssetMetricsRecord* Record, const FThresholdVariables& Variables) const
+{
+	float Stack[MaxStackDepth];
+	int32 Top = -1;
+
+	const FThresholdInstruction* Instruction = Instructions.GetData();
+	const FThresholdInstruction* End = Instruction + Instructions.Num();
+	for (; Instruction != End; ++Instruction)
+	{
+		switch (Instruction->OpCode)
+		{
+		case EThresholdOpCode::PushConstant:
+			Stack[++Top] = Instruction->Immediate;
+			break;
+		case EThresholdOpCode::LoadVariable:
+			Stack[++Top] = Variables.Values[Instruction->Operand];
+			break;
+		case EThresholdOpCode::LoadLODField:
+			Stack[++Top] = ThresholdExpression::ReadLODField(Record, (EAssetMetricsColumn)Instruction->Operand, (int32)Instruction->Immediate, Variables.PlatformGroupName);
+			break;
+		case EThresholdOpCode::LoadLODFieldIndexed:
+			Stack[Top] = ThresholdExpression::ReadLODField(Record, (EAssetMetricsColumn)Instruction->Operand, FMath::TruncToInt(Stack[Top]), Variables.PlatformGroupName);
+			break;
+		case EThresholdOpCode::Add:				--Top; Stack[Top] = Stack[Top] + Stack[Top + 1]; break;
+		case EThresholdOpCode::Subtract:		--Top; Stack[Top] = Stack[Top] - Stack[Top + 1]; break;
+		case EThresholdOpCode::Multiply:		--Top; Stack[Top] = Stack[Top] * Stack[Top + 1]; break;
+		case EThresholdOpCode::Divide:			--Top; Stack[Top] = Stack[Top] / Stack[Top + 1]; break;
+		case EThresholdOpCode::Negate:			Stack[Top] = -Stack[Top]; break;
+		case EThresholdOpCode::Less:			--Top; Stack[Top] = Stack[Top] < Stack[Top + 1] ? 1.f : 0.f; break;
+		case EThresholdOpCode::LessEqual:		--Top; Stack[Top] = Stack[Top] <= Stack[Top + 1] ? 1.f : 0.f; break;
+		case EThresholdOpCode::Greater:			--Top; Stack[Top] = Stack[Top] > Stack[Top + 1] ? 1.f : 0.f; break;
+		case EThresholdOpCode::GreaterEqual:	--Top; Stack[Top] = Stack[Top] >= Stack[Top + 1] ? 1.f : 0.f; break;
+		case EThresholdOpCode::Equal:			--Top; Stack[Top] = Stack[Top] == Stack[Top + 1] ? 1.f : 0.f; break;
+		case EThresholdOpCode::NotEqual:		--Top; Stack[Top] = Stack[Top] != Stack[Top + 1] ? 1.f : 0.f; break;
+		case EThresholdOpCode::And:				--Top; Stack[Top] = (Stack[Top] != 0.f && Stack[Top + 1] != 0.f) ? 1.f : 0.f; break;
+		case EThresholdOpCode::Or:				--Top; Stack[Top] = (Stack[Top] != 0.f || Stack[Top + 1] != 0.f) ? 1.f : 0.f; break;
+		case EThresholdOpCode::Not:				Stack[Top] = Stack[Top] == 0.f ? 1.f : 0.f; break;
+		case EThresholdOpCode::Min:				--Top; Stack[Top] = FMath::Min(Stack[Top], Stack[Top + 1]); break;
+		case EThresholdOpCode::Max:				--Top; Stack[Top] = FMath::Max(Stack[Top], Stack[Top + 1]); break;
+		case EThresholdOpCode::Abs:				Stack[Top] = FMath::Abs(Stack[Top]); break;
+		}
+	}
+	return Top >= 0 ? Stack[Top] : 0.f;
+}
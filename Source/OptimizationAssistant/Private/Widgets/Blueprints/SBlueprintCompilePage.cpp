@@ -7,7 +7,6 @@
 #include "AssetRegistryModule.h"
 #include "Kismet2/CompilerResultsLog.h"
 #include "EngineUtils.h"
-#include "ISourceControlModule.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "Engine/Engine.h"
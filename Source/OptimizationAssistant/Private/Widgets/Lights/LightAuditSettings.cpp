@@ -0,0 +1,11 @@
+#include "LightAuditSettings.h"
+
+ULightAuditSettings::ULightAuditSettings()
+	: Super()
+	, LightGridCellSize(200.f)
+	, MaxOverlappingLights(4)
+	, NumLightHotspots(20)
+	, MovableShadowCost(1.5f)
+	, StationaryShadowCost(0.5f)
+{
+}
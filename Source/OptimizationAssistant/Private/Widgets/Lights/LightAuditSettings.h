@@ -0,0 +1,32 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "LightAuditSettings.generated.h"
+
+UCLASS(config = OptimizationAssistant, defaultconfig)
+class ULightAuditSettings : public UObject
+{
+	GENERATED_BODY()
+public:
+	ULightAuditSettings();
+
+	// 统计光源重叠时使用的三维格子大小
+	UPROPERTY(EditAnywhere, config, Category = LightOverlap, meta = (ClampMin = "10"))
+	float LightGridCellSize;
+
+	// 同一位置重叠的动态光源(Movable 和 Stationary)超过该数量时报告为热点
+	UPROPERTY(EditAnywhere, config, Category = LightOverlap, meta = (ClampMin = "1", ClampMax = "254"))
+	int32 MaxOverlappingLights;
+
+	// 报告中列出的热点数量
+	UPROPERTY(EditAnywhere, config, Category = LightOverlap, meta = (ClampMin = "1"))
+	int32 NumLightHotspots;
+
+	// 可移动光源投射动态阴影时额外的逐像素开销(无阴影光源为 1)
+	UPROPERTY(EditAnywhere, config, Category = LightCost, meta = (ClampMin = "0"))
+	float MovableShadowCost;
+
+	// 固定光源投射动态阴影时额外的逐像素开销(无阴影光源为 1)
+	UPROPERTY(EditAnywhere, config, Category = LightCost, meta = (ClampMin = "0"))
+	float StationaryShadowCost;
+};
@@ -0,0 +1,68 @@
+#include "SLightAuditPage.h"
+#include "Misc/ScopedSlowTask.h"
+#include "OptimizationAssistantHelpers.h"
+#include "OptimizationAssistantGlobalSettings.h"
+#include "LightAuditSettings.h"
+#include "World/LightOverlapAnalysis.h"
+
+SLightAuditPage::SLightAuditPage()
+{
+
+}
+
+SLightAuditPage::~SLightAuditPage()
+{
+
+}
+
+void SLightAuditPage::Construct(const FArguments& InArgs)
+{
+	// initialize settings view
+	FDetailsViewArgs DetailsViewArgs;
+	{
+		DetailsViewArgs.bAllowSearch = true;
+		DetailsViewArgs.bHideSelectionTip = true;
+		DetailsViewArgs.bLockable = false;
+		DetailsViewArgs.bSearchInitialKeyFocus = true;
+		DetailsViewArgs.bUpdatesFromSelection = false;
+		DetailsViewArgs.bShowOptions = true;
+		DetailsViewArgs.bShowModifiedPropertiesOption = false;
+		DetailsViewArgs.bAllowMultipleTopLevelObjects = true;
+		DetailsViewArgs.bShowActorLabel = false;
+		DetailsViewArgs.bCustomNameAreaLocation = true;
+		DetailsViewArgs.bCustomFilterAreaLocation = true;
+		DetailsViewArgs.NameAreaSettings = FDetailsViewArgs::HideNameArea;
+		DetailsViewArgs.bShowPropertyMatrixButton = false;
+	}
+	SettingsView = FModuleManager::GetModuleChecked<FPropertyEditorModule>("PropertyEditor").CreateDetailView(DetailsViewArgs);
+
+	SettingsView->SetObject(GetMutableDefault<ULightAuditSettings>());
+
+	ChildSlot
+	[
+		SettingsView.ToSharedRef()
+	];
+}
+
+void SLightAuditPage::ProcessOptimizationCheck()
+{
+	const ULightAuditSettings* Settings = GetDefault<ULightAuditSettings>();
+	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
+	if (GlobalCheckSettings->OptimizationCheckType != EOptimizationCheckType::OCT_World &&
+		GlobalCheckSettings->OptimizationCheckType != EOptimizationCheckType::OCT_WorldDependentAssets)
+	{
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("Light audit only runs when checking the current world."));
+		return;
+	}
+
+	FScopedSlowTask SlowTask(1.0f, FText::FromString(TEXT("Light Audit")));
+	SlowTask.MakeDialog(true);
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Light Overlap")));
+
+	FLightOverlapAnalysis Analysis;
+	Analysis.Run(GWorld, Settings);
+	Analysis.SaveHotspotsCSV(OAHelper::MakeReportFilePath(TEXT("LightHotspots"), TEXT(".csv")));
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("LightAuditReport"));
+	Analysis.PrintReport(Settings->NumLightHotspots, *ScopeOutputArchive);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+
+class SLightAuditPage : public SCompoundWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SLightAuditPage) { }
+	SLATE_END_ARGS()
+
+public:
+
+	/** Default constructor. */
+	SLightAuditPage();
+
+	/** Destructor. */
+	~SLightAuditPage();
+
+	/**
+	 * Constructs the widget.
+	 *
+	 * @param InArgs The Slate argument list.
+	 */
+	void Construct(const FArguments& InArgs);
+
+	/** Collects the lights of the current world and writes the overlap report. */
+	void ProcessOptimizationCheck();
+
+private:
+	/** Property viewing widget */
+	TSharedPtr<IDetailsView>   SettingsView;
+};
@@ -1,4 +1,8 @@
 #include "ParticleSystemOptimizationRules.h"
+#include "Misc/MessageDialog.h"
+#include "Misc/App.h"
+#include "OptimizationAssistantHelpers.h"
+#include "ThresholdExpression.h"
 
 
 UParticleSystemOptimizationRules::UParticleSystemOptimizationRules()
@@ -11,6 +15,7 @@ UParticleSystemOptimizationRules::UParticleSystemOptimizationRules()
 	, ParticleSystemCullScreenSize(0.02f)
 	, bCheckHighQualityLights(true)
 	, bCheckShadowCastingLights(true)
+	, CullDistanceCondition(TEXT("CullDistance > Recommend.CullDistance * 1.2"))
 {
 
 }
@@ -22,5 +27,16 @@ void UParticleSystemOptimizationRules::PostEditChangeProperty(struct FPropertyCh
 
 bool UParticleSystemOptimizationRules::ValidateSettings()
 {
+	FString ErrorMessage;
+	FThresholdExpression Expression;
+	if (!Expression.Compile(CullDistanceCondition, ErrorMessage))
+	{
+		UE_LOG(LogOptimizationAssistant, Error, TEXT("%s: %s"), *GetName(), *ErrorMessage);
+		if (!FApp::IsUnattended())
+		{
+			FMessageDialog::Open(EAppMsgType::Ok, FText::FromString(ErrorMessage));
+		}
+		return false;
+	}
 	return true;
 }
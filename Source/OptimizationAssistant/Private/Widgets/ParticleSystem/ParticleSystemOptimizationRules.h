@@ -36,6 +36,10 @@ public:
 	UPROPERTY(EditAnywhere, config, meta = (UIMin = "0.005", UIMax = "0.1", ClampMin = "0.005", ClampMax = "0.1"))
 	float ParticleSystemCullScreenSize;
 
+	// 组件设置的裁剪距离(CullDistance)或最后一级LOD距离过大的条件
+	UPROPERTY(EditAnywhere, config, Category = Threshold)
+	FString CullDistanceCondition;
+
 	// 是否检查粒子系统具有高质量光照，通常来说绝大多数粒子系统并不需要高质量光照。
 	UPROPERTY(EditAnywhere, config)
 	bool bCheckHighQualityLights;
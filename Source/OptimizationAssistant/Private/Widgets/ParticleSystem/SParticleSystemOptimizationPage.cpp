@@ -57,8 +57,16 @@ void SParticleSystemOptimizationPage::Construct(const FArguments& InArgs)
 
 void SParticleSystemOptimizationPage::ProcessOptimizationCheck()
 {
-	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("ParticleSystemCheckList"));
 	RuleSettings = GetMutableDefault<UParticleSystemOptimizationRules>();
+	FString ExpressionError;
+	if (!CullDistanceExpression.Compile(RuleSettings->CullDistanceCondition, ExpressionError))
+	{
+		UE_LOG(LogOptimizationAssistant, Error, TEXT("%s"), *ExpressionError);
+		return;
+	}
+	CameraProfiles = FCameraProfileTable::CreateForTargetPlatforms();
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("ParticleSystemCheckList"));
 	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
 	
 	TArray<UParticleSystem*> ProcessedParticleSystems;
@@ -277,36 +285,56 @@ void SParticleSystemOptimizationPage::ProcessOptimizationCheck(UParticleSystemCo
 			}
 
 			FBoxSphereBounds Bounds = ParticleComponent->CalcBounds(ParticleComponent->GetComponentTransform());
-			float RecommendDrawDistance = FOptimizationAssistantHelpers::ComputeDrawDistanceFromScreenSize(Bounds.SphereRadius, RuleSettings->ParticleSystemCullScreenSize);
-			RecommendDrawDistance *= 2;
-			if (SilentDistance > RecommendDrawDistance)
+			CameraProfiles.ComputeDrawDistances(Bounds.SphereRadius, RuleSettings->ParticleSystemCullScreenSize, CameraDrawDistances);
+			float CachedMaxDrawDistance = FMath::Max(ParticleComponent->CachedMaxDrawDistance, ParticleComponent->LDMaxDrawDistance);
+
+			// 未设置裁剪距离时, 取所有镜头中最大的建议距离
+			float MaxRecommendDrawDistance = 0.0f;
+			for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
 			{
+				float RecommendDrawDistance = CameraDrawDistances[ProfileIndex] * 2;
+				if (SilentDistance <= RecommendDrawDistance)
+				{
+					continue;
+				}
+
+				const FString ProfileSuffix = CameraProfiles.GetProfileSuffix(ProfileIndex);
 				if (HasActiveParticlesWithLastLODLevel)
 				{
-					float CachedMaxDrawDistance = FMath::Max(ParticleComponent->CachedMaxDrawDistance, ParticleComponent->LDMaxDrawDistance);
 					if (CachedMaxDrawDistance > 0.0f)
 					{
-						if (CachedMaxDrawDistance > (RecommendDrawDistance * GlobalCheckSettings->CullDistanceErrorScale))
+						FThresholdVariables Variables;
+						Variables.Set(EThresholdVariable::CullDistance, CachedMaxDrawDistance);
+						Variables.Set(EThresholdVariable::RecommendCullDistance, RecommendDrawDistance);
+						if (CullDistanceExpression.EvaluateCondition(nullptr, Variables))
 						{
-							ErrorMessage += FString::Printf(TEXT("设置的裁剪距离过大[建议裁剪距离=%f,当前裁剪距离=%f].\n"), RecommendDrawDistance, CachedMaxDrawDistance);
+							ErrorMessage += FString::Printf(TEXT("设置的裁剪距离过大[建议裁剪距离=%f,当前裁剪距离=%f]%s.\n"), RecommendDrawDistance, CachedMaxDrawDistance, *ProfileSuffix);
 						}
 					}
-					else if (RecommendDrawDistance > 0.0f && RecommendDrawDistance < 25000.0f)
+					else
 					{
-						// 裁剪距离太近，适当的扩大一点
-						RecommendDrawDistance = FMath::Max(RecommendDrawDistance, 1500.0f);
-						ErrorMessage += FString::Printf(TEXT("[CachedMaxDrawDistance=%f]未设置有效裁剪距离, 建议裁剪距离=%f.\n"), CachedMaxDrawDistance, RecommendDrawDistance);
+						MaxRecommendDrawDistance = FMath::Max(MaxRecommendDrawDistance, RecommendDrawDistance);
 					}
 				}
 				else
 				{
 					float LastLODDistance = ParticleSystem->LODDistances[ParticleSystem->LODDistances.Num() - 1];
-					if (RecommendDrawDistance > 0.0f && LastLODDistance > (RecommendDrawDistance*GlobalCheckSettings->CullDistanceErrorScale))
+					FThresholdVariables Variables;
+					Variables.Set(EThresholdVariable::CullDistance, LastLODDistance);
+					Variables.Set(EThresholdVariable::RecommendCullDistance, RecommendDrawDistance);
+					if (RecommendDrawDistance > 0.0f && CullDistanceExpression.EvaluateCondition(nullptr, Variables))
 					{
-						ErrorMessage += FString::Printf(TEXT("最后一级LOD距离过大[建议距离=%f,当前距离=%f].\n"), RecommendDrawDistance, LastLODDistance);
+						ErrorMessage += FString::Printf(TEXT("最后一级LOD距离过大[建议距离=%f,当前距离=%f]%s.\n"), RecommendDrawDistance, LastLODDistance, *ProfileSuffix);
 					}
 				}
 			}
+
+			if (MaxRecommendDrawDistance > 0.0f && MaxRecommendDrawDistance < 25000.0f)
+			{
+				// 裁剪距离太近，适当的扩大一点
+				MaxRecommendDrawDistance = FMath::Max(MaxRecommendDrawDistance, 1500.0f);
+				ErrorMessage += FString::Printf(TEXT("[CachedMaxDrawDistance=%f]未设置有效裁剪距离, 建议裁剪距离=%f.\n"), CachedMaxDrawDistance, MaxRecommendDrawDistance);
+			}
 		}
 	}
 	else
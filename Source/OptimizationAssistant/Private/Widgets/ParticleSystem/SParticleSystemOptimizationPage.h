@@ -3,6 +3,8 @@
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "ThresholdExpression.h"
+#include "CameraProfileTable.h"
 
 class SParticleSystemOptimizationPage : public SCompoundWidget
 {
@@ -35,5 +37,12 @@ private:
 	TSharedPtr<IDetailsView>   SettingsView;
 
 	class UParticleSystemOptimizationRules* RuleSettings;
+
+	FThresholdExpression CullDistanceExpression;
+
+	FCameraProfileTable CameraProfiles;
+
+	/** Per camera profile draw distances of the component being checked. */
+	FCameraDrawDistances CameraDrawDistances;
 };
 
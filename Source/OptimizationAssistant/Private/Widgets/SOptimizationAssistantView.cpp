@@ -6,12 +6,15 @@
 #include "Widgets/Layout/SGridPanel.h"
 #include "Widgets/Layout/SSeparator.h"
 #include "Widgets/Layout/SWrapBox.h"
+#include "Widgets/Input/SComboButton.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Misc/ScopedSlowTask.h"
 #include "Misc/OutputDeviceArchiveWrapper.h"
 #include "Interfaces/IPluginManager.h"
 #include "OptimizationAssistantModule.h"
 #include "SGlobalSettingsPage.h"
 #include "PlatformInfo.h"
+#include "AssetMetricsStore.h"
 
 #include "StaticMesh/SStaticMeshOptimizationPage.h"
 #include "StaticMesh/StaticMeshOptimizationRules.h"
@@ -25,6 +28,12 @@
 #include "Blueprints/SBlueprintCompilePage.h"
 #include "Blueprints/BlueprintCompileSettings.h"
 
+#include "World/SWorldAnalysisPage.h"
+#include "World/WorldAnalysisSettings.h"
+
+#include "Lights/SLightAuditPage.h"
+#include "Lights/LightAuditSettings.h"
+
 
 #define LOCTEXT_NAMESPACE "OptimizationAssistantPlugin"
 
@@ -44,19 +53,25 @@ void SOptimizationAssistantView::Construct(const FArguments & InArgs)
 	EnableSkeletalMeshCheck = ECheckBoxState::Checked;
 	EnableParticleSystemCheck = ECheckBoxState::Checked;
 	EnableBlueprintCompileCheck = ECheckBoxState::Unchecked;
+	EnableWorldAnalysisCheck = ECheckBoxState::Unchecked;
+	EnableLightAuditCheck = ECheckBoxState::Unchecked;
 
 	StaticMeshOptimizationPage = SNew(SStaticMeshOptimizationPage);
 	SkeletalMeshOptimizationPage = SNew(SSkeletalMeshOptimizationPage);
 	ParticleSystemOptimizationPage = SNew(SParticleSystemOptimizationPage);
 	BlueprintCompilePage = SNew(SBlueprintCompilePage);
+	WorldAnalysisPage = SNew(SWorldAnalysisPage);
+	LightAuditPage = SNew(SLightAuditPage);
 
-	int32 CurrentlySelectedIndex = 0;
 	const TArray<const PlatformInfo::FPlatformInfo*>& ConstAvailablePlatforms = FOptimizationAssistantHelpers::GetAvailablePlatforms();
 	for (const PlatformInfo::FPlatformInfo* PlatformInfoItem : ConstAvailablePlatforms)
 	{
 		AvailablePlatforms.Add(MakeShared<FPlatformInfoHolder>(PlatformInfoItem));
 	}
-	FOptimizationAssistantHelpers::SetTargetPlatform(AvailablePlatforms[CurrentlySelectedIndex]->AvailablePlatform);
+	if (FOptimizationAssistantHelpers::GetTargetPlatforms().Num() == 0 && AvailablePlatforms.Num() > 0)
+	{
+		FOptimizationAssistantHelpers::SetTargetPlatformEnabled(AvailablePlatforms[0]->AvailablePlatform, true);
+	}
 	ChildSlot
 	[
 		SNew(SVerticalBox)
@@ -200,6 +215,54 @@ void SOptimizationAssistantView::Construct(const FArguments & InArgs)
 				[
 					SNew(SBlueprintCompilePage)
 				]
+
+				// World analysis section
+				+ SGridPanel::Slot(0, 9)
+				.ColumnSpan(3)
+				.Padding(0.0f, 16.0f)
+				[
+					SNew(SSeparator)
+					.Orientation(Orient_Horizontal)
+				]
+
+				+ SGridPanel::Slot(0, 10)
+				.Padding(8.0f, 0.0f, 0.0f, 0.0f)
+				.VAlign(VAlign_Top)
+				[
+					SNew(STextBlock)
+					.Font(FCoreStyle::GetDefaultFontStyle("Bold", 13))
+					.Text(LOCTEXT("WorldAnalysisSectionHeader", "WorldAnalysis"))
+				]
+
+				+ SGridPanel::Slot(1, 10)
+				.Padding(32.0f, 0.0f, 8.0f, 0.0f)
+				[
+					WorldAnalysisPage.ToSharedRef()
+				]
+
+				// Light audit section
+				+ SGridPanel::Slot(0, 11)
+				.ColumnSpan(3)
+				.Padding(0.0f, 16.0f)
+				[
+					SNew(SSeparator)
+					.Orientation(Orient_Horizontal)
+				]
+
+				+ SGridPanel::Slot(0, 12)
+				.Padding(8.0f, 0.0f, 0.0f, 0.0f)
+				.VAlign(VAlign_Top)
+				[
+					SNew(STextBlock)
+					.Font(FCoreStyle::GetDefaultFontStyle("Bold", 13))
+					.Text(LOCTEXT("LightAuditSectionHeader", "Lights"))
+				]
+
+				+ SGridPanel::Slot(1, 12)
+				.Padding(32.0f, 0.0f, 8.0f, 0.0f)
+				[
+					LightAuditPage.ToSharedRef()
+				]
 				
 				/**
 				// deploy section
@@ -334,6 +397,44 @@ void SOptimizationAssistantView::Construct(const FArguments & InArgs)
 					]
 				]
 
+				+ SHorizontalBox::Slot()
+				.Padding(FMargin(2.0f))
+				.AutoWidth()
+				[
+					SNew(SCheckBox)
+					.IsChecked(EnableWorldAnalysisCheck)
+					.OnCheckStateChanged_Lambda([=](ECheckBoxState NewState)
+					{
+						EnableWorldAnalysisCheck = NewState;
+					})
+					.ToolTipText(LOCTEXT("WorldAnalysisTips", "只在检查当前World时运行"))
+					.Content()
+					[
+						SNew(STextBlock)
+						.TextStyle(FEditorStyle::Get(), "ContentBrowser.TopBar.Font")
+						.Text(FText::FromString(TEXT("WorldAnalysis")))
+					]
+				]
+
+				+ SHorizontalBox::Slot()
+				.Padding(FMargin(2.0f))
+				.AutoWidth()
+				[
+					SNew(SCheckBox)
+					.IsChecked(EnableLightAuditCheck)
+					.OnCheckStateChanged_Lambda([=](ECheckBoxState NewState)
+					{
+						EnableLightAuditCheck = NewState;
+					})
+					.ToolTipText(LOCTEXT("LightAuditTips", "只在检查当前World时运行"))
+					.Content()
+					[
+						SNew(STextBlock)
+						.TextStyle(FEditorStyle::Get(), "ContentBrowser.TopBar.Font")
+						.Text(FText::FromString(TEXT("LightAudit")))
+					]
+				]
+
 				+ SHorizontalBox::Slot()
 				.Padding(FMargin(2.0f))
 				.FillWidth(1.0f)
@@ -371,11 +472,10 @@ void SOptimizationAssistantView::Construct(const FArguments & InArgs)
 				.Padding(FMargin(2.0f))
 				.AutoWidth()
 				[
-					SNew(SComboBox<TSharedPtr<FPlatformInfoHolder>>)
-					.OptionsSource(&AvailablePlatforms)
-					.InitiallySelectedItem(AvailablePlatforms[CurrentlySelectedIndex])
-					.OnGenerateWidget(this, &SOptimizationAssistantView::GenerateTargetPlatformComboItem)
-					.OnSelectionChanged(this, &SOptimizationAssistantView::HandleTargetPlatformComboChanged)
+					SNew(SComboButton)
+					.OnGetMenuContent(this, &SOptimizationAssistantView::GenerateTargetPlatformMenu)
+					.ToolTipText(LOCTEXT("TargetPlatformTips", "可以同时选择多个平台, 所有平台在一次检查中完成"))
+					.ButtonContent()
 					[
 						SNew(STextBlock).Text(this, &SOptimizationAssistantView::GetSelectedPlatformComboText)
 					]
@@ -539,28 +639,50 @@ FReply SOptimizationAssistantView::HandleSaveOptimizationRules()
 	GetMutableDefault<USkeletalMeshOptimizationRules>()->UpdateDefaultConfigFile();
 	GetMutableDefault<UParticleSystemOptimizationRules>()->UpdateDefaultConfigFile();
 	GetMutableDefault<UBlueprintCompileSettings>()->UpdateDefaultConfigFile();
+	GetMutableDefault<UWorldAnalysisSettings>()->UpdateDefaultConfigFile();
+	GetMutableDefault<ULightAuditSettings>()->UpdateDefaultConfigFile();
 	GConfig->Flush(false, FOptimizationAssistantModule::OptimizationAssistantIni);
 	return FReply::Handled();
 }
 
-TSharedRef<SWidget> SOptimizationAssistantView::GenerateTargetPlatformComboItem(const TSharedPtr<FPlatformInfoHolder> InItem)
+TSharedRef<SWidget> SOptimizationAssistantView::GenerateTargetPlatformMenu()
 {
-	return SNew(STextBlock).Text(InItem->AvailablePlatform->DisplayName);
+	FMenuBuilder MenuBuilder(false, nullptr);
+	for (const TSharedPtr<FPlatformInfoHolder>& Item : AvailablePlatforms)
+	{
+		const PlatformInfo::FPlatformInfo* Platform = Item->AvailablePlatform;
+		MenuBuilder.AddMenuEntry(
+			Platform->DisplayName,
+			FText::FromName(Platform->PlatformGroupName),
+			FSlateIcon(),
+			FUIAction(
+				FExecuteAction::CreateSP(this, &SOptimizationAssistantView::HandleTargetPlatformToggled, Platform),
+				FCanExecuteAction(),
+				FIsActionChecked::CreateStatic(&FOptimizationAssistantHelpers::IsTargetPlatform, Platform)),
+			NAME_None,
+			EUserInterfaceActionType::ToggleButton);
+	}
+	return MenuBuilder.MakeWidget();
 }
 
-void SOptimizationAssistantView::HandleTargetPlatformComboChanged(const TSharedPtr<FPlatformInfoHolder> Item, ESelectInfo::Type SelectInfo)
+void SOptimizationAssistantView::HandleTargetPlatformToggled(const PlatformInfo::FPlatformInfo* Platform)
 {
-	FOptimizationAssistantHelpers::SetTargetPlatform(Item->AvailablePlatform);
+	FOptimizationAssistantHelpers::SetTargetPlatformEnabled(Platform, !FOptimizationAssistantHelpers::IsTargetPlatform(Platform));
 }
 
 FText SOptimizationAssistantView::GetSelectedPlatformComboText() const
 {
-	if (const PlatformInfo::FPlatformInfo* TargetPlatform = FOptimizationAssistantHelpers::GetTargetPlatform())
+	TArray<FText> DisplayNames;
+	for (const PlatformInfo::FPlatformInfo* TargetPlatform : FOptimizationAssistantHelpers::GetTargetPlatforms())
 	{
-		return TargetPlatform->DisplayName;
+		DisplayNames.Add(TargetPlatform->DisplayName);
 	}
 
-	return FText::GetEmpty();
+	if (DisplayNames.Num() == 0)
+	{
+		return LOCTEXT("DefaultPlatform", "Default");
+	}
+	return FText::Join(LOCTEXT("PlatformSeparator", ", "), DisplayNames);
 }
 
 void SOptimizationAssistantView::ProcessOptimizationCheck()
@@ -571,10 +693,15 @@ void SOptimizationAssistantView::ProcessOptimizationCheck()
 	TaskCount = EnableSkeletalMeshCheck == ECheckBoxState::Checked ? ++TaskCount : TaskCount;
 	TaskCount = EnableParticleSystemCheck == ECheckBoxState::Checked ? ++TaskCount : TaskCount;
 	TaskCount = EnableBlueprintCompileCheck == ECheckBoxState::Checked ? ++TaskCount : TaskCount;
+	TaskCount = EnableWorldAnalysisCheck == ECheckBoxState::Checked ? ++TaskCount : TaskCount;
+	TaskCount = EnableLightAuditCheck == ECheckBoxState::Checked ? ++TaskCount : TaskCount;
 
 	FScopedSlowTask SlowTask(TaskCount, FText::FromString(TEXT("Optimization Check")));
 	SlowTask.MakeDialog(true);
 
+	FAssetMetricsStore& MetricsStore = FAssetMetricsStore::Get();
+	MetricsStore.Reset();
+
 	if (EnableStaticMeshCheck == ECheckBoxState::Checked)
 	{
 		SlowTask.EnterProgressFrame(1.0f);
@@ -598,6 +725,24 @@ void SOptimizationAssistantView::ProcessOptimizationCheck()
 		SlowTask.EnterProgressFrame(1.0f);
 		BlueprintCompilePage->ProcessOptimizationCheck();
 	}
+
+	if (EnableWorldAnalysisCheck == ECheckBoxState::Checked)
+	{
+		SlowTask.EnterProgressFrame(1.0f);
+		WorldAnalysisPage->ProcessOptimizationCheck();
+	}
+
+	if (EnableLightAuditCheck == ECheckBoxState::Checked)
+	{
+		SlowTask.EnterProgressFrame(1.0f);
+		LightAuditPage->ProcessOptimizationCheck();
+	}
+
+	// 保存本次检查计算出的资源指标，后续查询和调整阈值时不需要重新加载资源
+	if (MetricsStore.Num() > 0)
+	{
+		MetricsStore.Save(FAssetMetricsStore::GetDefaultFilePath());
+	}
 }
 
 
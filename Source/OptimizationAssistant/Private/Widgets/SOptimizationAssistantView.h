@@ -43,9 +43,9 @@ public:
 	FReply HandleSaveOptimizationRules();
 
 protected:
-	/** Platform combo box */
-	TSharedRef<SWidget> GenerateTargetPlatformComboItem(const TSharedPtr<FPlatformInfoHolder> InItem);
-	void HandleTargetPlatformComboChanged(const TSharedPtr<FPlatformInfoHolder> Item, ESelectInfo::Type SelectInfo);
+	/** Platform menu, several target platforms can be checked in the same run */
+	TSharedRef<SWidget> GenerateTargetPlatformMenu();
+	void HandleTargetPlatformToggled(const PlatformInfo::FPlatformInfo* Platform);
 	FText GetSelectedPlatformComboText() const;
 private:
 	void ProcessOptimizationCheck();
@@ -54,11 +54,15 @@ private:
 	TSharedPtr<class SSkeletalMeshOptimizationPage> SkeletalMeshOptimizationPage;
 	TSharedPtr<class SParticleSystemOptimizationPage> ParticleSystemOptimizationPage;
 	TSharedPtr<class SBlueprintCompilePage> BlueprintCompilePage;
+	TSharedPtr<class SWorldAnalysisPage> WorldAnalysisPage;
+	TSharedPtr<class SLightAuditPage> LightAuditPage;
 	
 	ECheckBoxState EnableStaticMeshCheck;
 	ECheckBoxState EnableSkeletalMeshCheck;
 	ECheckBoxState EnableParticleSystemCheck;
 	ECheckBoxState EnableBlueprintCompileCheck;
+	ECheckBoxState EnableWorldAnalysisCheck;
+	ECheckBoxState EnableLightAuditCheck;
 
 	TArray<TSharedPtr<FPlatformInfoHolder>> AvailablePlatforms;
 };
\ No newline at end of file
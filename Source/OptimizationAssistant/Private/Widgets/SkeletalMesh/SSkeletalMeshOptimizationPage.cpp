@@ -10,6 +10,8 @@
 #include "OptimizationAssistantGlobalSettings.h"
 #include "Game/SilentCheckComponent.h"
 #include "Classes/EditorSkeletalMesh.h"
+#include "AssetMetricsStore.h"
+#include "OptimizationRuleRegistry.h"
 
 SSkeletalMeshOptimizationPage::SSkeletalMeshOptimizationPage()
 {
@@ -70,6 +72,12 @@ int32 SSkeletalMeshOptimizationPage::GetMeshMaxTriangles(USkeletalMesh* Skeletal
 void SSkeletalMeshOptimizationPage::ProcessOptimizationCheck()
 {
 	RuleSettings = GetMutableDefault<USkeletalMeshOptimizationRules>();
+	if (!RuleSettings->ValidateSettings())
+	{
+		return;
+	}
+
+	CompiledRules.Compile(FOptimizationRuleRegistry::Get(), FOptimizationRuleContext::Create(), EAssetMetricsType::SkeletalMesh);
 	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
 
 	OAHelper::FScopeOutputArchive AnimationArchive(TEXT("AnimationCheckList"));
@@ -269,16 +277,19 @@ void SSkeletalMeshOptimizationPage::ProcessOptimizationCheck(USkeletalMesh* Skel
 	if (SkeletalMesh && RuleSettings)
 	{
 		EditorSkeletalMesh->Initialize(SkeletalMesh);
+
+		FAssetMetricsRecord MetricsRecord;
+		EditorSkeletalMesh->GetMetricsRecord(MetricsRecord);
+		FAssetMetricsStore::Get().AddRecord(MetricsRecord);
+		if (CompiledRules.ShouldSkip(MetricsRecord))
+		{
+			return;
+		}
+
 		FString MeshName = SkeletalMesh->GetFullName();
 		FString ErrorMessage;
-		CheckTrianglesLODNum(ErrorMessage);
-		CheckLODNumLimit(ErrorMessage);
-		CheckLODTrianglesLimit(ErrorMessage);
-		CheckLODScreenSizeLimit(ErrorMessage);
-		CheckLODUVChannelLimit(ErrorMessage);
-		CheckLODMaterialNumLimit(ErrorMessage);
+		CompiledRules.Evaluate(MetricsRecord, ErrorMessage);
 		CheckLODDuplicateMaterials(ErrorMessage);
-		CheckMeshMaterialNumLimit(ErrorMessage);
 		if (!ErrorMessage.IsEmpty())
 		{
 			//Ar.Logf(TEXT(" ========================== ApplyRecommendMeshSettings =============== "));
@@ -308,8 +319,8 @@ void SSkeletalMeshOptimizationPage::ProcessOptimizationCheck(UAnimSequence* Anim
 
 void SSkeletalMeshOptimizationPage::CheckCullDistance(USkeletalMeshComponent * MeshComponent, FString & ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_CullDistance)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_CullDistance)) return;
 
 	AActor* Actor = MeshComponent->GetOwner();
 	bool bIsReplicated = Actor ? Actor->GetIsReplicated() : false;
@@ -330,153 +341,67 @@ void SSkeletalMeshOptimizationPage::CheckCullDistance(USkeletalMeshComponent * M
 		}
 
 		FBoxSphereBounds Bounds = MeshComponent->CalcBounds(MeshComponent->GetComponentTransform());
-		float RecommendDrawDistance = FOptimizationAssistantHelpers::ComputeDrawDistanceFromScreenSize(Bounds.SphereRadius, RuleSettings->MeshCullScreenSize);
+		const FCameraProfileTable& CameraProfiles = RuleContext.CameraProfiles;
+		CameraProfiles.ComputeDrawDistances(Bounds.SphereRadius, RuleSettings->MeshCullScreenSize, CameraDrawDistances);
 		float CachedMaxDrawDistance = FMath::Max(MeshComponent->CachedMaxDrawDistance, MeshComponent->LDMaxDrawDistance);
 
-		if (SilentDistance > RecommendDrawDistance)
+		// 未设置裁剪距离时, 取所有镜头中最大的建议距离
+		float MaxRecommendDrawDistance = 0.0f;
+		for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
 		{
+			float RecommendDrawDistance = CameraDrawDistances[ProfileIndex];
+			if (SilentDistance <= RecommendDrawDistance)
+			{
+				continue;
+			}
+
 			if (CachedMaxDrawDistance > 0.0f)
 			{
-				if (CachedMaxDrawDistance > (RecommendDrawDistance * GlobalCheckSettings->CullDistanceErrorScale))
+				FThresholdVariables Variables;
+				Variables.Set(EThresholdVariable::CullDistance, CachedMaxDrawDistance);
+				Variables.Set(EThresholdVariable::RecommendCullDistance, RecommendDrawDistance);
+				if (RuleContext.GetMeshThresholds(EAssetMetricsType::SkeletalMesh).CullDistance.EvaluateCondition(nullptr, Variables))
 				{
-					ErrorMessage += FString::Printf(TEXT("设置的裁剪距离过大[建议裁剪距离=%f,当前裁剪距离=%f].\n"), RecommendDrawDistance, CachedMaxDrawDistance);
+					ErrorMessage += FString::Printf(TEXT("设置的裁剪距离过大[建议裁剪距离=%f,当前裁剪距离=%f]%s.\n"), RecommendDrawDistance, CachedMaxDrawDistance, *CameraProfiles.GetProfileSuffix(ProfileIndex));
 				}
 			}
-			else if (RecommendDrawDistance > 0.0f && RecommendDrawDistance < 25000.0f)
+			else
 			{
-				// 裁剪距离太近，适当的扩大一点
-				RecommendDrawDistance = FMath::Max(RecommendDrawDistance, 1500.0f);
-				ErrorMessage += FString::Printf(TEXT("[CachedMaxDrawDistance=%f]未设置有效裁剪距离, 建议裁剪距离=%f.\n"), CachedMaxDrawDistance, RecommendDrawDistance);
+				MaxRecommendDrawDistance = FMath::Max(MaxRecommendDrawDistance, RecommendDrawDistance);
 			}
 		}
+
+		if (MaxRecommendDrawDistance > 0.0f && MaxRecommendDrawDistance < 25000.0f)
+		{
+			// 裁剪距离太近，适当的扩大一点
+			MaxRecommendDrawDistance = FMath::Max(MaxRecommendDrawDistance, 1500.0f);
+			ErrorMessage += FString::Printf(TEXT("[CachedMaxDrawDistance=%f]未设置有效裁剪距离, 建议裁剪距离=%f.\n"), CachedMaxDrawDistance, MaxRecommendDrawDistance);
+		}
 	}
 }
 
 void SSkeletalMeshOptimizationPage::CheckNetCullDistance(USkeletalMeshComponent * MeshComponent, FString & ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_NetCullDistance)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_NetCullDistance)) return;
 	AActor* Actor = MeshComponent->GetOwner();
 	bool bIsReplicated = Actor ? Actor->GetIsReplicated() : false;
 	// 网络同步对象，由网络裁剪距离进行裁剪
 	if (bIsReplicated)
 	{
-		if (Actor->NetCullDistanceSquared > (GlobalCheckSettings->MaxNetCullDistanceSquared))
+		if (Actor->NetCullDistanceSquared > (RuleContext.MaxNetCullDistanceSquared))
 		{
 			float MinNetCullDistanceSquared = 8000.f*8000.f;
-			float RecommendNetCullDistanceSquared = FMath::Min(MinNetCullDistanceSquared, GlobalCheckSettings->MaxNetCullDistanceSquared);
+			float RecommendNetCullDistanceSquared = FMath::Min(MinNetCullDistanceSquared, RuleContext.MaxNetCullDistanceSquared);
 			ErrorMessage += FString::Printf(TEXT("设置的网络裁剪距离过大[建议网络裁剪距离小于=%f, 当前裁剪距离=%f].\n"), RecommendNetCullDistanceSquared, Actor->NetCullDistanceSquared);
 		}
 	}
 }
 
-void SSkeletalMeshOptimizationPage::CheckTrianglesLODNum(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_TrianglesLODNum)) return;
-
-	int32 MaxTriangles = EditorSkeletalMesh->GetNumTriangles();
-	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
-	for (int32 ThresholdIndex = RuleSettings->MaxTrianglesForLODNum.Num() - 1; ThresholdIndex >= 0; --ThresholdIndex)
-	{
-		FTriangleLODThresholds& TriangleLODThreshold = RuleSettings->MaxTrianglesForLODNum[ThresholdIndex];
-		if (MaxTriangles >= TriangleLODThreshold.Triangles)
-		{
-			int32 RecommendLODNum = FMath::Min(TriangleLODThreshold.LODCount, 3);
-			if (NumLODs < RecommendLODNum)
-			{
-				ErrorMessage += FString::Printf(TEXT("[%d]Triangles至少要有[%d]级LOD,当前有[%d]级.\n"), MaxTriangles, RecommendLODNum, NumLODs);
-				break;
-			}
-		}
-	}
-}
-
-void SSkeletalMeshOptimizationPage::CheckLODNumLimit(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODNumLimit)) return;
-	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
-	if (NumLODs > OA_MAX_MESH_LODS)
-	{
-		ErrorMessage += FString::Printf(TEXT("LOD数量超过了限制，最多可有[%d]级，当前有[%d]级.\n"), OA_MAX_MESH_LODS, NumLODs);
-	}
-}
-
-void SSkeletalMeshOptimizationPage::CheckLODTrianglesLimit(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODTrianglesLimit)) return;
-
-	int32 MaxTriangles = EditorSkeletalMesh->GetNumTriangles();
-	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
-	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
-	{
-		int32 LODTriangles = EditorSkeletalMesh->GetNumTriangles(LODIndex);
-		int32 RecommendLODTriangles = RuleSettings->GetRecommendLODTriangles(LODIndex, MaxTriangles);
-		if (LODTriangles > RecommendLODTriangles * GlobalCheckSettings->TrianglesErrorScale)
-		{
-			ErrorMessage += FString::Printf(TEXT("第[%d]级LOD的 Triangles 不得大于[%d]，当前为[%d],推荐[Base LOD[0] Percent of Triangles=%f].\n"), LODIndex, RecommendLODTriangles, LODTriangles, RuleSettings->GetRecommendLODTrianglesPercent(LODIndex));
-		}
-	}
-}
-
-void SSkeletalMeshOptimizationPage::CheckLODScreenSizeLimit(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODScreenSizeLimit)) return;
-
-	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
-	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
-	{
-		float LODScreenSize = EditorSkeletalMesh->GetLODScreenSize(NAME_None, LODIndex);
-		const PlatformInfo::FPlatformInfo* TargetPlatform = FOptimizationAssistantHelpers::GetTargetPlatform();
-		if (TargetPlatform)
-		{
-			LODScreenSize = EditorSkeletalMesh->GetLODScreenSize(TargetPlatform->PlatformGroupName, LODIndex);
-		}
-		float RecommendLODScreenSize = RuleSettings->GetRecommendLODScreenSize(TargetPlatform ? TargetPlatform->PlatformGroupName : NAME_None, LODIndex);
-		if (LODScreenSize < RecommendLODScreenSize * 0.8f)// 误差值0.2
-		{
-			ErrorMessage += FString::Printf(TEXT("第[%d]级LOD的 ScreenSize 不得小于[%f],当前是[%f]\n"), LODIndex, RecommendLODScreenSize, LODScreenSize);
-		}
-	}
-}
-
-void SSkeletalMeshOptimizationPage::CheckLODUVChannelLimit(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODUVChannelLimit)) return;
-	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
-	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
-	{
-		int32 UVChannels = EditorSkeletalMesh->GetNumUVChannels(LODIndex);
-		if (UVChannels > RuleSettings->MaxUVChannels)
-		{
-			ErrorMessage += FString::Printf(TEXT("LOD[%d]使用的UV Channels超过了限制[%d]个，当前为[%d]个\n"), LODIndex, RuleSettings->MaxUVChannels, UVChannels);
-		}
-	}
-}
-
-void SSkeletalMeshOptimizationPage::CheckLODMaterialNumLimit(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODMaterialNumLimit)) return;
-	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
-	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
-	{
-		int32 NumSections = EditorSkeletalMesh->GetNumMaterials(LODIndex);
-		if (NumSections > RuleSettings->LODMaxMaterials)
-		{
-			ErrorMessage += FString::Printf(TEXT("LOD[%d]使用最大的材质数量超过了限制[%d]个，当前有[%d]个\n"), LODIndex, RuleSettings->LODMaxMaterials, NumSections);
-		}
-	}
-}
-
 void SSkeletalMeshOptimizationPage::CheckLODDuplicateMaterials(FString & ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODDuplicateMaterials)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_LODDuplicateMaterials)) return;
 
 	int32 NumLODs = EditorSkeletalMesh->GetNumLODs();
 	for (int32 LODIndex = 0; LODIndex < NumLODs; ++LODIndex)
@@ -497,30 +422,10 @@ void SSkeletalMeshOptimizationPage::CheckLODDuplicateMaterials(FString & ErrorMe
 	}
 }
 
-void SSkeletalMeshOptimizationPage::CheckMeshMaterialNumLimit(FString & ErrorMessage)
-{
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_MeshMaterialNumLimit)) return;
-
-	int32 NonLODMaterials = 0;
-	for (const FSkeletalMaterial& SkeletalMaterial : EditorSkeletalMesh->GetMaterials())
-	{
-		if (!SkeletalMaterial.MaterialSlotName.ToString().Contains(TEXT("LOD"), ESearchCase::CaseSensitive))
-		{
-			++NonLODMaterials;
-		}
-	}
-
-	if (NonLODMaterials > RuleSettings->MaxMaterials)
-	{
-		ErrorMessage += FString::Printf(TEXT("Mesh使用的材质数超过了限制[%d]个, 当前为[%d]个.\n"), RuleSettings->MaxMaterials, NonLODMaterials);
-	}
-}
-
 void SSkeletalMeshOptimizationPage::DumpSortedMeshTriangles(const TArray<USkeletalMesh*>& Meshes)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_SortByTriangles)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_SortByTriangles)) return;
 
 	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("SkeletalMeshSortedTriangles"));
 	FOutputDevice& Ar = *ScopeOutputArchive;
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
+#include "OptimizationRuleRegistry.h"
 
 class SSkeletalMeshOptimizationPage : public SCompoundWidget
 {
@@ -34,14 +35,7 @@ protected:
 
 	void CheckCullDistance(USkeletalMeshComponent* MeshComponent, FString& ErrorMessage);
 	void CheckNetCullDistance(USkeletalMeshComponent* MeshComponent, FString& ErrorMessage);
-	void CheckTrianglesLODNum(FString& ErrorMessage);
-	void CheckLODNumLimit(FString& ErrorMessage);
-	void CheckLODTrianglesLimit(FString& ErrorMessage);
-	void CheckLODScreenSizeLimit(FString& ErrorMessage);
-	void CheckLODUVChannelLimit(FString& ErrorMessage);
-	void CheckLODMaterialNumLimit(FString& ErrorMessage);
 	void CheckLODDuplicateMaterials(FString& ErrorMessage);
-	void CheckMeshMaterialNumLimit(FString& ErrorMessage);
 	void DumpSortedMeshTriangles(const TArray<USkeletalMesh*>& Meshes);
 
 private:
@@ -49,5 +43,11 @@ private:
 	TSharedPtr<IDetailsView>   SettingsView;
 	FEditorSkeletalMeshPtr EditorSkeletalMesh;
 	class USkeletalMeshOptimizationRules* RuleSettings;
+
+	/** Enabled rules and settings resolved at the start of the check run. */
+	FCompiledOptimizationRules CompiledRules;
+
+	/** Per camera profile draw distances of the component being checked. */
+	FCameraDrawDistances CameraDrawDistances;
 };
 
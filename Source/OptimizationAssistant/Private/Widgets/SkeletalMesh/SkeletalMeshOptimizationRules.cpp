@@ -5,5 +5,5 @@ USkeletalMeshOptimizationRules::USkeletalMeshOptimizationRules()
 	, AnimMaxFrameRate(60)
 
 {
-
+	LODScreenSizeCondition = TEXT("LOD[i].ScreenSize < Recommend.ScreenSize * 0.8");
 }
\ No newline at end of file
@@ -9,6 +9,45 @@
 #include "OptimizationAssistantGlobalSettings.h"
 #include "Game/SilentCheckComponent.h"
 #include "Classes/EditorStaticMesh.h"
+#include "AssetMetricsStore.h"
+#include "OptimizationRuleRegistry.h"
+#include "ScopedTransaction.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Mesh/VertexCacheAnalysis.h"
+#include "Mesh/DuplicateMeshAnalysis.h"
+#include "Mesh/MeshAttributeStatistics.h"
+#include "Mesh/LODGeometricError.h"
+#include "Mesh/LODReductionPreview.h"
+#include "PackageCheckout.h"
+
+namespace StaticMeshOptimizationPage
+{
+	/**
+	 * Builds every mesh once, in parallel on engines that support batch builds. Before 4.27 the build
+	 * comes from UStaticMesh::PostEditChangeProperty, after a batch build only the listeners are notified.
+	 */
+	static void RebuildMeshes(const TArray<UStaticMesh*>& Meshes)
+	{
+#if ENGINE_MINOR_VERSION >= 27
+		UStaticMesh::BatchBuild(Meshes, true);
+
+		// BatchBuild 已经刷新了使用它的组件, PostEditChange 会再构建一次, 这里只通知打开的编辑器
+		for (UStaticMesh* StaticMesh : Meshes)
+		{
+			StaticMesh->OnMeshChanged.Broadcast();
+			FPropertyChangedEvent PropertyChangedEvent(nullptr);
+			FCoreUObjectDelegates::OnObjectPropertyChanged.Broadcast(StaticMesh, PropertyChangedEvent);
+			StaticMesh->MarkPackageDirty();
+		}
+#else
+		for (UStaticMesh* StaticMesh : Meshes)
+		{
+			StaticMesh->PostEditChange();
+			StaticMesh->MarkPackageDirty();
+		}
+#endif
+	}
+}
 
 SStaticMeshOptimizationPage::SStaticMeshOptimizationPage()
 {
@@ -59,12 +98,20 @@ void SStaticMeshOptimizationPage::ProcessOptimizationCheck()
 		return;
 	}
 
+	CompiledRules.Compile(FOptimizationRuleRegistry::Get(), FOptimizationRuleContext::Create(), EAssetMetricsType::StaticMesh);
+	VertexFormatFixes.Reset();
+	VertexCacheFixes.Reset();
+	DuplicateMeshConsolidations.Reset();
+
 	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("StaticMeshCheckList"));
 	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
 
 	TArray<UStaticMesh*> ProcessedMeshes;
 	ProcessedMeshes.Add(nullptr); // If UStaticMesh is nullptr,skip check.
 
+	// 每个关卡引用的Mesh, 用于统计关卡的常驻内存
+	TMap<ULevel*, TSet<UStaticMesh*>> LevelMeshes;
+
 	if (GlobalCheckSettings->OptimizationCheckType == EOptimizationCheckType::OCT_World ||
 		GlobalCheckSettings->OptimizationCheckType == EOptimizationCheckType::OCT_WorldDependentAssets)
 	{
@@ -119,6 +166,11 @@ void SStaticMeshOptimizationPage::ProcessOptimizationCheck()
 					continue;
 				}
 
+				if (MeshComponent->GetStaticMesh())
+				{
+					LevelMeshes.FindOrAdd(Actor->GetLevel()).Add(MeshComponent->GetStaticMesh());
+				}
+
 				if (!ProcessedMeshes.Contains(MeshComponent->GetStaticMesh()))
 				{
 					if (GlobalCheckSettings->IsInNeverCheckDirectory(MeshComponent->GetStaticMesh()->GetFullName()))
@@ -194,6 +246,40 @@ void SStaticMeshOptimizationPage::ProcessOptimizationCheck()
 		}
 	}
 	DumpSortedMeshTriangles(ProcessedMeshes);
+	DumpSortedMeshMemory(ProcessedMeshes, LevelMeshes);
+	CheckDuplicateMeshes(ProcessedMeshes);
+	DumpLODReductionPreview(ProcessedMeshes);
+	DumpLODSettingsDiff();
+
+	// 所有修复先写入设置, 最后一起重新构建, 每个Mesh只构建一次
+	CheckOutFixedPackages();
+	TArray<UStaticMesh*> MeshesToBuild;
+	if (RuleSettings->bFixVertexFormatPrecision)
+	{
+		ApplyVertexFormatFixes(MeshesToBuild);
+	}
+	if (RuleSettings->bOptimizeVertexCache)
+	{
+		ApplyVertexCacheFixes(MeshesToBuild);
+	}
+	if (RuleSettings->bFixLODSettings)
+	{
+		ApplyLODSettingsFixes(MeshesToBuild);
+	}
+	RebuildFixedMeshes(MeshesToBuild);
+
+	// 合并重复Mesh会删除资源并回收垃圾, 之后不能再使用 ProcessedMeshes 中的指针
+	if (DuplicateMeshConsolidations.Num() > 0)
+	{
+		ProcessedMeshes.Reset();
+		LevelMeshes.Reset();
+		FDuplicateMeshAnalysis::Consolidate(DuplicateMeshConsolidations);
+	}
+	VertexFormatFixes.Reset();
+	VertexCacheFixes.Reset();
+	LODSettingsFixes.Reset();
+	DuplicateMeshConsolidations.Reset();
+	FMeshAttributeStatisticsCache::Get().Reset();
 	GEngine->TrimMemory();
 }
 
@@ -251,20 +337,23 @@ void SStaticMeshOptimizationPage::ProcessOptimizationCheck(UStaticMesh* StaticMe
 		if (!bAutoGenerated)
 		{
 			EditorStaticMesh->Initialize(StaticMesh);
-			if (EditorStaticMesh->GetNumTriangles() > 500)
+
+			FAssetMetricsRecord MetricsRecord;
+			EditorStaticMesh->GetMetricsRecord(MetricsRecord);
+			FAssetMetricsStore::Get().AddRecord(MetricsRecord);
+
+			if (!CompiledRules.ShouldSkip(MetricsRecord))
 			{
 				FString ErrorMessage;
-				CheckTrianglesLODNum(ErrorMessage);
-				CheckLODNumLimit(ErrorMessage);
-				CheckLODTrianglesLimit(ErrorMessage);
-				CheckLODScreenSizeLimit(ErrorMessage);
-				CheckLODUVChannelLimit(ErrorMessage);
-				CheckLODMaterialNumLimit(ErrorMessage);
+				CompiledRules.Evaluate(MetricsRecord, ErrorMessage);
 				CheckLODDuplicateMaterials(ErrorMessage);
-				CheckMeshMaterialNumLimit(ErrorMessage);
+				CheckVertexFormatPrecision(ErrorMessage);
+				CheckVertexCacheEfficiency(ErrorMessage);
+				CheckUnusedVertexStreams(ErrorMessage);
+				CheckLODGeometricError(ErrorMessage);
+				GatherLODSettingsFix();
 				if (!ErrorMessage.IsEmpty())
 				{
-					//EditorStaticMesh->ApplyRecommendMeshSettings(RuleSettings, Ar);
 					Ar.Logf(TEXT("%s"), *MeshName);
 					Ar.Logf(TEXT("%s"), *ErrorMessage);
 				}
@@ -275,8 +364,8 @@ void SStaticMeshOptimizationPage::ProcessOptimizationCheck(UStaticMesh* StaticMe
 
 void SStaticMeshOptimizationPage::CheckCullDistance(UStaticMeshComponent * MeshComponent, FString & ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if(!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_CullDistance)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_CullDistance)) return;
 
 	AActor* Actor = MeshComponent->GetOwner();
 	bool bIsReplicated = Actor ? Actor->GetIsReplicated() : false;
@@ -297,202 +386,484 @@ void SStaticMeshOptimizationPage::CheckCullDistance(UStaticMeshComponent * MeshC
 		}
 
 		FBoxSphereBounds Bounds = MeshComponent->CalcBounds(MeshComponent->GetComponentTransform());
-		float RecommendDrawDistance = FOptimizationAssistantHelpers::ComputeDrawDistanceFromScreenSize(Bounds.SphereRadius, RuleSettings->MeshCullScreenSize);
+		const FCameraProfileTable& CameraProfiles = RuleContext.CameraProfiles;
+		CameraProfiles.ComputeDrawDistances(Bounds.SphereRadius, RuleSettings->MeshCullScreenSize, CameraDrawDistances);
 		float CachedMaxDrawDistance = FMath::Max(MeshComponent->CachedMaxDrawDistance, MeshComponent->LDMaxDrawDistance);
 
-		if (SilentDistance > RecommendDrawDistance)
+		// 未设置裁剪距离时, 取所有镜头中最大的建议距离
+		float MaxRecommendDrawDistance = 0.0f;
+		for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
 		{
+			float RecommendDrawDistance = CameraDrawDistances[ProfileIndex];
+			if (SilentDistance <= RecommendDrawDistance)
+			{
+				continue;
+			}
+
 			if (CachedMaxDrawDistance > 0.0f)
 			{
-				if (CachedMaxDrawDistance > (RecommendDrawDistance * GlobalCheckSettings->CullDistanceErrorScale))
+				FThresholdVariables Variables;
+				Variables.Set(EThresholdVariable::CullDistance, CachedMaxDrawDistance);
+				Variables.Set(EThresholdVariable::RecommendCullDistance, RecommendDrawDistance);
+				if (RuleContext.GetMeshThresholds(EAssetMetricsType::StaticMesh).CullDistance.EvaluateCondition(nullptr, Variables))
 				{
-					ErrorMessage += FString::Printf(TEXT("设置的裁剪距离过大[建议裁剪距离=%f,当前裁剪距离=%f].\n"), RecommendDrawDistance, CachedMaxDrawDistance);
+					ErrorMessage += FString::Printf(TEXT("设置的裁剪距离过大[建议裁剪距离=%f,当前裁剪距离=%f]%s.\n"), RecommendDrawDistance, CachedMaxDrawDistance, *CameraProfiles.GetProfileSuffix(ProfileIndex));
 				}
 			}
-			else if (RecommendDrawDistance > 0.0f && RecommendDrawDistance < 25000.0f)
+			else
 			{
-				// 裁剪距离太近，适当的扩大一点
-				RecommendDrawDistance = FMath::Max(RecommendDrawDistance, 1500.0f);
-				ErrorMessage += FString::Printf(TEXT("[CachedMaxDrawDistance=%f]未设置有效裁剪距离, 建议裁剪距离=%f.\n"), CachedMaxDrawDistance, RecommendDrawDistance);
+				MaxRecommendDrawDistance = FMath::Max(MaxRecommendDrawDistance, RecommendDrawDistance);
 			}
 		}
+
+		if (MaxRecommendDrawDistance > 0.0f && MaxRecommendDrawDistance < 25000.0f)
+		{
+			// 裁剪距离太近，适当的扩大一点
+			MaxRecommendDrawDistance = FMath::Max(MaxRecommendDrawDistance, 1500.0f);
+			ErrorMessage += FString::Printf(TEXT("[CachedMaxDrawDistance=%f]未设置有效裁剪距离, 建议裁剪距离=%f.\n"), CachedMaxDrawDistance, MaxRecommendDrawDistance);
+		}
 	}
 }
 
 void SStaticMeshOptimizationPage::CheckNetCullDistance(UStaticMeshComponent * MeshComponent, FString & ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_NetCullDistance)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_NetCullDistance)) return;
 
 	AActor* Actor = MeshComponent->GetOwner();
 	bool bIsReplicated = Actor ? Actor->GetIsReplicated() : false;
 	// 网络同步对象，由网络裁剪距离进行裁剪
 	if (bIsReplicated)
 	{
-		if (Actor->NetCullDistanceSquared > (GlobalCheckSettings->MaxNetCullDistanceSquared))
+		if (Actor->NetCullDistanceSquared > (RuleContext.MaxNetCullDistanceSquared))
 		{
 			float MinNetCullDistanceSquared = 8000.f*8000.f;
-			float RecommendNetCullDistanceSquared = FMath::Min(MinNetCullDistanceSquared, GlobalCheckSettings->MaxNetCullDistanceSquared);
+			float RecommendNetCullDistanceSquared = FMath::Min(MinNetCullDistanceSquared, RuleContext.MaxNetCullDistanceSquared);
 			ErrorMessage += FString::Printf(TEXT("设置的网络裁剪距离过大[建议网络裁剪距离小于=%f, 当前裁剪距离=%f].\n"), RecommendNetCullDistanceSquared, Actor->NetCullDistanceSquared);
 		}
 	}
 }
 
-void SStaticMeshOptimizationPage::CheckTrianglesLODNum(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::CheckLODDuplicateMaterials(FString & ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_TrianglesLODNum)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_LODDuplicateMaterials)) return;
 
-	int32 NumLODs = EditorStaticMesh->GetNumLODs();
-	int32 MaxTriangles = EditorStaticMesh->GetNumTriangles();
-	for (int32 ThresholdIndex = RuleSettings->MaxTrianglesForLODNum.Num() - 1; ThresholdIndex >= 0; --ThresholdIndex)
+	int32 NumLODLevels = EditorStaticMesh->GetNumLODs();
+	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
 	{
-		FTriangleLODThresholds& TriangleLODThreshold = RuleSettings->MaxTrianglesForLODNum[ThresholdIndex];
-		if (MaxTriangles >= TriangleLODThreshold.Triangles)
+		FStaticMeshLODResources& LODModel = EditorStaticMesh->GetMesh()->RenderData->LODResources[LODIndex];
+		TArray<int32> UsedMaterialIndexs;
+		for (const FStaticMeshSection& MaterialSection : LODModel.Sections)
 		{
-			int32 RecommendLODNum = FMath::Min(TriangleLODThreshold.LODCount, 3);
-			if (NumLODs < RecommendLODNum)
+			if (UsedMaterialIndexs.Contains(MaterialSection.MaterialIndex))
 			{
-				ErrorMessage += FString::Printf(TEXT("[%d]Triangles至少要有[%d]级LOD,当前有[%d]级.\n"), MaxTriangles, RecommendLODNum, NumLODs);
-				break;
+				ErrorMessage += FString::Printf(TEXT("LOD[%d]使用多个重复的材质，材质索引[%d]\n"), LODIndex, MaterialSection.MaterialIndex);
+			}
+			else
+			{
+				UsedMaterialIndexs.Add(MaterialSection.MaterialIndex);
 			}
 		}
 	}
 }
 
-void SStaticMeshOptimizationPage::CheckLODNumLimit(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::CheckVertexFormatPrecision(FString& ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODNumLimit)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_VertexFormatPrecision)) return;
+
+	UStaticMesh* StaticMesh = EditorStaticMesh->GetMesh();
+	const bool bHeroMesh = RuleSettings->IsHeroMesh(StaticMesh->GetPathName());
+
+	FVertexFormatFix Fix;
+	Fix.MeshPath = StaticMesh;
+	Fix.HalfPrecisionUVLODs = 0;
+	Fix.DefaultTangentLODs = 0;
+
+	int64 TotalSavedBytes = 0;
+	const int32 NumLODLevels = FMath::Min(EditorStaticMesh->GetNumLODs(), 32);
+	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
+	{
+		FVertexFormatSavings Savings;
+		EditorStaticMesh->GetVertexFormatSavings(LODIndex, RuleSettings->MaxHalfPrecisionUVError, bHeroMesh, Savings);
+		if (Savings.UVBytes > 0)
+		{
+			Fix.HalfPrecisionUVLODs |= 1u << LODIndex;
+			ErrorMessage += FString::Printf(TEXT("LOD[%d]开启了bUseFullPrecisionUVs，但UV转为半精度的误差仅为[%f]，关闭后可节省[%lld]字节\n"), LODIndex, Savings.HalfPrecisionUVError, Savings.UVBytes);
+		}
+		if (Savings.TangentBytes > 0)
+		{
+			Fix.DefaultTangentLODs |= 1u << LODIndex;
+			ErrorMessage += FString::Printf(TEXT("LOD[%d]开启了bUseHighPrecisionTangentBasis，非重要资源关闭后可节省[%lld]字节\n"), LODIndex, Savings.TangentBytes);
+		}
+		if (Savings.IndexBytes > 0)
+		{
+			ErrorMessage += FString::Printf(TEXT("LOD[%d]只有[%d]个顶点却使用了32位索引，重新构建为16位索引可节省[%lld]字节\n"), LODIndex, EditorStaticMesh->GetNumVertices(LODIndex), Savings.IndexBytes);
+		}
+		TotalSavedBytes += Savings.GetTotalBytes();
+	}
 
-	int32 NumLODs = EditorStaticMesh->GetNumLODs();
-	if (NumLODs > OA_MAX_MESH_LODS)
+	if (TotalSavedBytes > 0)
 	{
-		ErrorMessage += FString::Printf(TEXT("LOD数量超过了限制，最多可有[%d]级，当前有[%d]级.\n"), OA_MAX_MESH_LODS, NumLODs);
+		ErrorMessage += FString::Printf(TEXT("降低顶点格式精度共可节省[%lld]字节\n"), TotalSavedBytes);
+		VertexFormatFixes.Add(Fix);
 	}
 }
 
-void SStaticMeshOptimizationPage::CheckLODTrianglesLimit(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::ApplyVertexFormatFixes(TArray<UStaticMesh*>& MeshesToBuild)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODTrianglesLimit)) return;
+	if (VertexFormatFixes.Num() == 0)
+	{
+		return;
+	}
 
-	int32 NumLODLevels = EditorStaticMesh->GetNumLODs();
-	int32 MaxTriangles = EditorStaticMesh->GetNumTriangles();
-	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
+	FScopedSlowTask SlowTask(VertexFormatFixes.Num(), FText::FromString(TEXT("Fixing Vertex Format Precision")));
+	SlowTask.MakeDialog();
+
+	const FScopedTransaction Transaction(FText::FromString(TEXT("Fix Vertex Format Precision")));
+	for (const FVertexFormatFix& Fix : VertexFormatFixes)
 	{
-		int32 LODTriangles = EditorStaticMesh->GetNumTriangles(LODIndex);
-		int32 RecommendLODTriangles = RuleSettings->GetRecommendLODTriangles(LODIndex, MaxTriangles);
-		if (LODTriangles > RecommendLODTriangles * GlobalCheckSettings->TrianglesErrorScale)
+		SlowTask.EnterProgressFrame(1.f);
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(Fix.MeshPath.TryLoad());
+		if (!StaticMesh)
 		{
-			ErrorMessage += FString::Printf(TEXT("第[%d]级LOD的 Triangles 不得大于[%d]，当前为[%d],推荐基于LOD 0 的Triangles Percent=[%f].\n"), LODIndex, RecommendLODTriangles, LODTriangles, RuleSettings->GetRecommendLODTrianglesPercent(LODIndex));
+			continue;
 		}
+
+		StaticMesh->Modify();
+		for (int32 LODIndex = 0; LODIndex < StaticMesh->GetNumSourceModels() && LODIndex < 32; ++LODIndex)
+		{
+			FMeshBuildSettings& BuildSettings = StaticMesh->GetSourceModel(LODIndex).BuildSettings;
+			if (Fix.HalfPrecisionUVLODs & (1u << LODIndex))
+			{
+				BuildSettings.bUseFullPrecisionUVs = false;
+			}
+			if (Fix.DefaultTangentLODs & (1u << LODIndex))
+			{
+				BuildSettings.bUseHighPrecisionTangentBasis = false;
+			}
+		}
+		MeshesToBuild.AddUnique(StaticMesh);
 	}
+
+	// 32位索引不需要修改设置, 重新构建后会自动使用16位索引
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Lowered vertex format precision of %d static meshes."), VertexFormatFixes.Num());
 }
 
-void SStaticMeshOptimizationPage::CheckLODScreenSizeLimit(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::CheckVertexCacheEfficiency(FString& ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODScreenSizeLimit)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_VertexCacheEfficiency)) return;
 
-	int32 NumLODLevels = EditorStaticMesh->GetNumLODs();
+	UStaticMesh* StaticMesh = EditorStaticMesh->GetMesh();
+	uint32 LODsToOptimize = 0;
+	const int32 NumLODLevels = FMath::Min(StaticMesh->RenderData->LODResources.Num(), 32);
 	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
 	{
-		float LODScreenSize = EditorStaticMesh->GetLODScreenSize(NAME_None, LODIndex);
-		const PlatformInfo::FPlatformInfo* TargetPlatform = FOptimizationAssistantHelpers::GetTargetPlatform();
-		if (TargetPlatform)
-		{
-			LODScreenSize = EditorStaticMesh->GetLODScreenSize(TargetPlatform->PlatformGroupName, LODIndex);
-		}
+		TArray<uint32> Indices;
+		StaticMesh->RenderData->LODResources[LODIndex].IndexBuffer.GetCopy(Indices);
 
-		float RecommendLODScreenSize = RuleSettings->GetRecommendLODScreenSize(TargetPlatform ? TargetPlatform->PlatformGroupName : NAME_None, LODIndex);
-		if (LODScreenSize < (RecommendLODScreenSize - 0.06f))// 误差值0.06
+		FVertexCacheStats Stats;
+		FVertexCacheAnalysis::Analyze(Indices, RuleSettings->VertexCacheSize, Stats);
+		if (Stats.GetFIFOATVR() > RuleSettings->MaxVertexCacheATVR)
 		{
-			ErrorMessage += FString::Printf(TEXT("第[%d]级LOD的 ScreenSize 不得小于[%f],当前是[%f]\n"), LODIndex, RecommendLODScreenSize, LODScreenSize);
+			LODsToOptimize |= 1u << LODIndex;
+			ErrorMessage += FString::Printf(TEXT("LOD[%d]顶点缓存效率过低, ATVR不得大于[%.2f], 当前 FIFO ACMR=[%.3f] ATVR=[%.3f], LRU ACMR=[%.3f] ATVR=[%.3f]\n"),
+				LODIndex, RuleSettings->MaxVertexCacheATVR, Stats.GetFIFOACMR(), Stats.GetFIFOATVR(), Stats.GetLRUACMR(), Stats.GetLRUATVR());
 		}
 	}
+
+	if (LODsToOptimize != 0)
+	{
+		VertexCacheFixes.Add(FSoftObjectPath(StaticMesh), LODsToOptimize);
+	}
 }
 
-void SStaticMeshOptimizationPage::CheckLODUVChannelLimit(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::CheckUnusedVertexStreams(FString& ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODUVChannelLimit)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_UnusedVertexStreams)) return;
 
-	int32 NumLODLevels = EditorStaticMesh->GetNumLODs();
+	UStaticMesh* StaticMesh = EditorStaticMesh->GetMesh();
+	const int32 NumLODLevels = FMath::Min(StaticMesh->RenderData->LODResources.Num(), StaticMesh->GetNumSourceModels());
 	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
 	{
-		int32 UVChannels = EditorStaticMesh->GetNumUVChannels(LODIndex);
-		if (UVChannels > RuleSettings->MaxUVChannels)
+		const FMeshAttributeStatistics* Statistics = FMeshAttributeStatisticsCache::Get().Find(StaticMesh, LODIndex);
+		if (!Statistics)
+		{
+			continue;
+		}
+
+		const FStaticMeshVertexBuffers& VertexBuffers = StaticMesh->RenderData->LODResources[LODIndex].VertexBuffers;
+		const FColorVertexBuffer& ColorBuffer = VertexBuffers.ColorVertexBuffer;
+		if (!Statistics->bHasVertexColors && ColorBuffer.GetNumVertices() > 0)
 		{
-			ErrorMessage += FString::Printf(TEXT("LOD[%d]使用的UV Channels超过了限制[%d]个，当前为[%d]个\n"), LODIndex, RuleSettings->MaxUVChannels, UVChannels);
+			ErrorMessage += FString::Printf(TEXT("LOD[%d]的顶点色全部为白色，去掉顶点色可节省[%d]字节\n"), LODIndex, ColorBuffer.GetNumVertices() * ColorBuffer.GetStride());
+		}
+
+		const FStaticMeshVertexBuffer& VertexBuffer = VertexBuffers.StaticMeshVertexBuffer;
+		const int32 UVStride = VertexBuffer.GetUseFullPrecisionUVs() ? sizeof(FVector2D) : sizeof(FVector2DHalf);
+		const int32 NumUVChannels = FMath::Min((int32)VertexBuffer.GetNumTexCoords(), Statistics->NumUVChannels());
+		for (int32 UVIndex = 0; UVIndex < NumUVChannels; ++UVIndex)
+		{
+			if (Statistics->IsUVChannelConstant(UVIndex))
+			{
+				ErrorMessage += FString::Printf(TEXT("LOD[%d]的UV[%d]所有顶点都是(%f, %f)，去掉该通道可节省[%d]字节\n"),
+					LODIndex, UVIndex, Statistics->UVMin[UVIndex].X, Statistics->UVMin[UVIndex].Y, VertexBuffer.GetNumVertices() * UVStride);
+			}
 		}
 	}
 }
 
-void SStaticMeshOptimizationPage::CheckLODMaterialNumLimit(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::CheckLODGeometricError(FString& ErrorMessage)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODMaterialNumLimit)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_LODGeometricError)) return;
 
-	int32 NumLODLevels = EditorStaticMesh->GetNumLODs();
-	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
+	UStaticMesh* StaticMesh = EditorStaticMesh->GetMesh();
+	if (StaticMesh->RenderData->LODResources.Num() < 2)
 	{
-		int32 NumMaterials = EditorStaticMesh->GetNumMaterials(LODIndex);
-		if (NumMaterials > RuleSettings->LODMaxMaterials)
+		return;
+	}
+
+	TArray<FLODGeometricError> Errors;
+	TArray<FPerPlatformFloat> RecommendScreenSizes;
+	FLODGeometricErrorAnalysis::MeasureLODs(StaticMesh, RuleSettings->LODErrorSamples, Errors);
+	FLODGeometricErrorAnalysis::ComputeScreenSizes(Errors, StaticMesh->RenderData->Bounds.SphereRadius, RuleContext.CameraProfiles, RuleSettings->MaxLODPixelError, RecommendScreenSizes);
+
+	// 大于推荐值时切换会出现跳变, 小于推荐值太多则高精度的LOD显示得过久
+	const float Tolerance = RuleSettings->LODScreenSizeTolerance;
+	auto CheckScreenSize = [this, &ErrorMessage, &Errors, Tolerance](int32 LODIndex, FName PlatformGroupName, float RecommendScreenSize)
+	{
+		const float ScreenSize = EditorStaticMesh->GetLODScreenSize(PlatformGroupName, LODIndex);
+		const FString PlatformSuffix = PlatformGroupName == NAME_None ? FString() : FString::Printf(TEXT(" [平台:%s]"), *PlatformGroupName.ToString());
+		if (ScreenSize > RecommendScreenSize * (1.f + Tolerance))
+		{
+			ErrorMessage += FString::Printf(TEXT("第[%d]级LOD与LOD0的误差为[%.3f], ScreenSize不得大于[%f], 否则切换时会出现跳变, 当前是[%f]%s\n"),
+				LODIndex, Errors[LODIndex].MaxDeviation, RecommendScreenSize, ScreenSize, *PlatformSuffix);
+		}
+		else if (ScreenSize < RecommendScreenSize * (1.f - Tolerance))
+		{
+			ErrorMessage += FString::Printf(TEXT("第[%d]级LOD与LOD0的误差为[%.3f], ScreenSize可以提高到[%f]以更早切换, 当前是[%f]%s\n"),
+				LODIndex, Errors[LODIndex].MaxDeviation, RecommendScreenSize, ScreenSize, *PlatformSuffix);
+		}
+	};
+
+	for (int32 LODIndex = 1; LODIndex < RecommendScreenSizes.Num(); ++LODIndex)
+	{
+		const FPerPlatformFloat& RecommendScreenSize = RecommendScreenSizes[LODIndex];
+		CheckScreenSize(LODIndex, NAME_None, RecommendScreenSize.Default);
+		for (const TPair<FName, float>& PlatformScreenSize : RecommendScreenSize.PerPlatform)
 		{
-			ErrorMessage += FString::Printf(TEXT("LOD[%d]使用最大的材质数量超过了限制[%d]个，当前有[%d]个\n"), LODIndex, RuleSettings->LODMaxMaterials, NumMaterials);
+			CheckScreenSize(LODIndex, PlatformScreenSize.Key, PlatformScreenSize.Value);
 		}
 	}
 }
 
-void SStaticMeshOptimizationPage::CheckLODDuplicateMaterials(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::ApplyVertexCacheFixes(TArray<UStaticMesh*>& MeshesToBuild)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_LODDuplicateMaterials)) return;
+	if (VertexCacheFixes.Num() == 0)
+	{
+		return;
+	}
 
-	int32 NumLODLevels = EditorStaticMesh->GetNumLODs();
-	for (int32 LODIndex = 0; LODIndex < NumLODLevels; ++LODIndex)
+	FScopedSlowTask SlowTask(VertexCacheFixes.Num(), FText::FromString(TEXT("Optimizing Vertex Cache")));
+	SlowTask.MakeDialog();
+
+	const FScopedTransaction Transaction(FText::FromString(TEXT("Optimize Vertex Cache")));
+	int32 NumOptimized = 0;
+	for (const TPair<FSoftObjectPath, uint32>& Fix : VertexCacheFixes)
 	{
-		FStaticMeshLODResources& LODModel = EditorStaticMesh->GetMesh()->RenderData->LODResources[LODIndex];
-		TArray<int32> UsedMaterialIndexs;
-		for (const FStaticMeshSection& MaterialSection : LODModel.Sections)
+		SlowTask.EnterProgressFrame(1.f);
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(Fix.Key.TryLoad());
+		if (!StaticMesh)
 		{
-			if (UsedMaterialIndexs.Contains(MaterialSection.MaterialIndex))
-			{
-				ErrorMessage += FString::Printf(TEXT("LOD[%d]使用多个重复的材质，材质索引[%d]\n"), LODIndex, MaterialSection.MaterialIndex);
-			}
-			else
+			continue;
+		}
+
+		StaticMesh->Modify();
+		bool bModified = false;
+		for (int32 LODIndex = 0; LODIndex < StaticMesh->GetNumSourceModels() && LODIndex < 32; ++LODIndex)
+		{
+			// 自动生成的LOD没有自己的MeshDescription, 重新构建时会从LOD0减面
+			if ((Fix.Value & (1u << LODIndex)) && StaticMesh->IsMeshDescriptionValid(LODIndex))
 			{
-				UsedMaterialIndexs.Add(MaterialSection.MaterialIndex);
+				FVertexCacheAnalysis::OptimizeMeshDescription(*StaticMesh->GetMeshDescription(LODIndex));
+				StaticMesh->CommitMeshDescription(LODIndex);
+				bModified = true;
 			}
 		}
+		if (bModified)
+		{
+			MeshesToBuild.AddUnique(StaticMesh);
+			++NumOptimized;
+		}
 	}
+
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Reordered triangles of %d static meshes for the vertex cache."), NumOptimized);
 }
 
-void SStaticMeshOptimizationPage::CheckMeshMaterialNumLimit(FString & ErrorMessage)
+void SStaticMeshOptimizationPage::GatherLODSettingsFix()
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_MeshMaterialNumLimit)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_LODSettingsFix)) return;
+
+	FStaticMeshLODSettingsChange Change;
+	if (EditorStaticMesh->GatherRecommendLODSettings(RuleSettings, Change))
+	{
+		LODSettingsFixes.Add(MoveTemp(Change));
+	}
+}
+
+void SStaticMeshOptimizationPage::DumpLODSettingsDiff()
+{
+	if (LODSettingsFixes.Num() == 0)
+	{
+		return;
+	}
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("StaticMeshLODSettingsDiff"));
+	FOutputDevice& Ar = *ScopeOutputArchive;
+	Ar.Logf(TEXT("[%d]个Mesh的LOD设置%s"), LODSettingsFixes.Num(), RuleSettings->bFixLODSettings ? TEXT("将按推荐设置修改") : TEXT("可以按推荐设置修改, 开启bFixLODSettings后生效"));
+	for (const FStaticMeshLODSettingsChange& Change : LODSettingsFixes)
+	{
+		Change.PrintDiff(Ar);
+	}
+}
+
+void SStaticMeshOptimizationPage::ApplyLODSettingsFixes(TArray<UStaticMesh*>& MeshesToBuild)
+{
+	if (LODSettingsFixes.Num() == 0)
+	{
+		return;
+	}
+
+	FScopedSlowTask SlowTask(LODSettingsFixes.Num(), FText::FromString(TEXT("Fixing LOD Settings")));
+	SlowTask.MakeDialog();
+
+	const FScopedTransaction Transaction(FText::FromString(TEXT("Fix LOD Settings")));
+	for (const FStaticMeshLODSettingsChange& Change : LODSettingsFixes)
+	{
+		SlowTask.EnterProgressFrame(1.f);
+		UStaticMesh* StaticMesh = Cast<UStaticMesh>(Change.MeshPath.TryLoad());
+		if (!StaticMesh)
+		{
+			continue;
+		}
+
+		FEditorStaticMesh::ApplyLODSettingsChange(StaticMesh, Change);
+		MeshesToBuild.AddUnique(StaticMesh);
+	}
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Changed LOD settings of %d static meshes."), LODSettingsFixes.Num());
+}
+
+void SStaticMeshOptimizationPage::CheckOutFixedPackages()
+{
+	// 要被删除的重复Mesh不需要再修复
+	TSet<FSoftObjectPath> DuplicatePaths;
+	for (const FDuplicateMeshConsolidation& Consolidation : DuplicateMeshConsolidations)
+	{
+		DuplicatePaths.Append(Consolidation.DuplicatePaths);
+	}
+	if (DuplicatePaths.Num() > 0)
+	{
+		VertexFormatFixes.RemoveAll([&DuplicatePaths](const FVertexFormatFix& Fix) { return DuplicatePaths.Contains(Fix.MeshPath); });
+		LODSettingsFixes.RemoveAll([&DuplicatePaths](const FStaticMeshLODSettingsChange& Change) { return DuplicatePaths.Contains(Change.MeshPath); });
+		for (auto It = VertexCacheFixes.CreateIterator(); It; ++It)
+		{
+			if (DuplicatePaths.Contains(It.Key()))
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	TArray<FName> PackageNames;
+	if (RuleSettings->bFixVertexFormatPrecision)
+	{
+		for (const FVertexFormatFix& Fix : VertexFormatFixes)
+		{
+			PackageNames.AddUnique(FName(*Fix.MeshPath.GetLongPackageName()));
+		}
+	}
+	if (RuleSettings->bOptimizeVertexCache)
+	{
+		for (const TPair<FSoftObjectPath, uint32>& Fix : VertexCacheFixes)
+		{
+			PackageNames.AddUnique(FName(*Fix.Key.GetLongPackageName()));
+		}
+	}
+	if (RuleSettings->bFixLODSettings)
+	{
+		for (const FStaticMeshLODSettingsChange& Change : LODSettingsFixes)
+		{
+			PackageNames.AddUnique(FName(*Change.MeshPath.GetLongPackageName()));
+		}
+	}
+	for (const FDuplicateMeshConsolidation& Consolidation : DuplicateMeshConsolidations)
+	{
+		for (const FName PackageName : Consolidation.PackageNames)
+		{
+			PackageNames.AddUnique(PackageName);
+		}
+	}
+	if (PackageNames.Num() == 0)
+	{
+		return;
+	}
+
+	// 一次请求签出所有要修改的文件, 签出失败的Mesh不做修改
+	FScopedSlowTask SlowTask(1.f, FText::FromString(FString::Printf(TEXT("Checking Out %d Packages"), PackageNames.Num())));
+	SlowTask.MakeDialog();
+	SlowTask.EnterProgressFrame(1.f);
+
+	TArray<FName> FailedPackages;
+	TUniquePtr<IPackageCheckoutBackend> Backend = FPackageCheckout::CreateBackend();
+	if (FPackageCheckout::CheckOutPackages(*Backend, PackageNames, FailedPackages))
+	{
+		return;
+	}
 
-	int32 NonLODMaterials = 0;
-	for (const FStaticMaterial&StaticMaterial : EditorStaticMesh->GetMaterials())
+	auto IsFailed = [&FailedPackages](const FSoftObjectPath& MeshPath) { return FailedPackages.Contains(FName(*MeshPath.GetLongPackageName())); };
+	VertexFormatFixes.RemoveAll([&IsFailed](const FVertexFormatFix& Fix) { return IsFailed(Fix.MeshPath); });
+	LODSettingsFixes.RemoveAll([&IsFailed](const FStaticMeshLODSettingsChange& Change) { return IsFailed(Change.MeshPath); });
+	for (auto It = VertexCacheFixes.CreateIterator(); It; ++It)
 	{
-		if (!StaticMaterial.MaterialSlotName.ToString().Contains(TEXT("LOD"), ESearchCase::CaseSensitive))
+		if (IsFailed(It.Key()))
 		{
-			++NonLODMaterials;
+			It.RemoveCurrent();
 		}
 	}
 
-	if (NonLODMaterials > RuleSettings->MaxMaterials)
+	// 合并一组重复Mesh要修改的包中有一个签出失败, 整组都不合并
+	DuplicateMeshConsolidations.RemoveAll([&FailedPackages](const FDuplicateMeshConsolidation& Consolidation)
 	{
-		ErrorMessage += FString::Printf(TEXT("Mesh使用的材质数超过了限制[%d]个, 当前为[%d]个.\n"), RuleSettings->MaxMaterials, NonLODMaterials);
+		return Consolidation.PackageNames.ContainsByPredicate([&FailedPackages](const FName PackageName) { return FailedPackages.Contains(PackageName); });
+	});
+}
+
+void SStaticMeshOptimizationPage::RebuildFixedMeshes(const TArray<UStaticMesh*>& MeshesToBuild)
+{
+	if (MeshesToBuild.Num() == 0)
+	{
+		return;
 	}
+
+	FScopedSlowTask SlowTask(1.f, FText::FromString(FString::Printf(TEXT("Building %d Static Meshes"), MeshesToBuild.Num())));
+	SlowTask.MakeDialog();
+	SlowTask.EnterProgressFrame(1.f);
+
+	// 渲染线程只需要同步一次, 之后所有Mesh一起构建
+	FlushRenderingCommands();
+	StaticMeshOptimizationPage::RebuildMeshes(MeshesToBuild);
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Rebuilt %d fixed static meshes."), MeshesToBuild.Num());
 }
 
 void SStaticMeshOptimizationPage::DumpSortedMeshTriangles(const TArray<UStaticMesh*>& Meshes)
 {
-	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
-	if (!GlobalCheckSettings->HasAnyFlags(EOptimizationCheckFlags::OCF_SortByTriangles)) return;
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_SortByTriangles)) return;
 
 	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("StaticMeshSortedTriangles"));
 	FOutputDevice& Ar = *ScopeOutputArchive;
@@ -523,3 +894,135 @@ void SStaticMeshOptimizationPage::DumpSortedMeshTriangles(const TArray<UStaticMe
 		Ar.Logf(TEXT("%140s %10d"), *MeshName, MeshTrianglesPair.Value);
 	}
 }
+
+void SStaticMeshOptimizationPage::CheckDuplicateMeshes(const TArray<UStaticMesh*>& Meshes)
+{
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_DuplicateMeshes)) return;
+
+	FDuplicateMeshAnalysis Analysis;
+	Analysis.Run(Meshes, RuleSettings->DuplicateMeshTolerance);
+	{
+		OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("DuplicateMeshReport"));
+		Analysis.PrintReport(*ScopeOutputArchive);
+	}
+
+	// 这里只记录要合并的Mesh, 签出后在所有读取 ProcessedMeshes 的步骤之后再合并
+	if (RuleSettings->DuplicateClustersToConsolidate.Num() > 0)
+	{
+		Analysis.GatherConsolidations(RuleSettings->DuplicateClustersToConsolidate, DuplicateMeshConsolidations);
+		RuleSettings->DuplicateClustersToConsolidate.Reset();
+	}
+}
+
+void SStaticMeshOptimizationPage::DumpLODReductionPreview(const TArray<UStaticMesh*>& Meshes)
+{
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_LODReductionPreview)) return;
+
+	// 面数太少的Mesh不需要LOD
+	TArray<UStaticMesh*> PreviewMeshes;
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		if (Mesh && Mesh->RenderData && Mesh->RenderData->LODResources.Num() > 0 &&
+			Mesh->RenderData->LODResources[0].GetNumTriangles() >= RuleSettings->MinTrianglesNeededForLOD)
+		{
+			PreviewMeshes.Add(Mesh);
+		}
+	}
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("StaticMeshLODReductionPreview"));
+	FOutputDevice& Ar = *ScopeOutputArchive;
+
+	// 分批处理, 同时加载的MeshDescription和减面结果不会太多
+	const int32 BatchSize = 16;
+	FScopedSlowTask SlowTask(PreviewMeshes.Num(), FText::FromString(TEXT("LOD Reduction Preview")));
+	SlowTask.MakeDialog(true);
+	for (int32 BatchStart = 0; BatchStart < PreviewMeshes.Num(); BatchStart += BatchSize)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			break;
+		}
+
+		const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, PreviewMeshes.Num());
+		SlowTask.EnterProgressFrame(BatchEnd - BatchStart);
+
+		TArray<FLODReductionPreview> Previews;
+		for (int32 MeshIndex = BatchStart; MeshIndex < BatchEnd; ++MeshIndex)
+		{
+			Previews.Emplace(PreviewMeshes[MeshIndex], RuleSettings->PreviewPercentTriangles);
+		}
+		FLODReductionPreview::Run(Previews);
+
+		for (FLODReductionPreview& Preview : Previews)
+		{
+			Preview.ComputeScreenSizes(RuleContext.CameraProfiles, RuleSettings->MaxLODPixelError);
+			Preview.PrintReport(Ar);
+		}
+	}
+}
+
+void SStaticMeshOptimizationPage::DumpSortedMeshMemory(const TArray<UStaticMesh*>& Meshes, const TMap<ULevel*, TSet<UStaticMesh*>>& LevelMeshes)
+{
+	const FOptimizationRuleContext& RuleContext = CompiledRules.GetContext();
+	if (!RuleContext.HasAnyFlags(EOptimizationCheckFlags::OCF_SortByMemory)) return;
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("StaticMeshSortedMemory"));
+	FOutputDevice& Ar = *ScopeOutputArchive;
+
+	// 所有LOD的内存按缓冲区分类累加
+	TMap<UStaticMesh*, FStaticMeshLODMemory> MeshMemoryMapping;
+	for (UStaticMesh* Mesh : Meshes)
+	{
+		if (Mesh && Mesh->RenderData)
+		{
+			FStaticMeshLODMemory& MeshMemory = MeshMemoryMapping.Add(Mesh);
+			for (int32 LODIndex = 0; LODIndex < Mesh->RenderData->LODResources.Num(); ++LODIndex)
+			{
+				FStaticMeshLODMemory LODMemory;
+				FStaticMeshLODMemory::Compute(Mesh, LODIndex, LODMemory);
+				MeshMemory.PositionBytes      += LODMemory.PositionBytes;
+				MeshMemory.TangentBytes       += LODMemory.TangentBytes;
+				MeshMemory.TexCoordBytes      += LODMemory.TexCoordBytes;
+				MeshMemory.ColorBytes         += LODMemory.ColorBytes;
+				MeshMemory.IndexBytes         += LODMemory.IndexBytes;
+				MeshMemory.DistanceFieldBytes += LODMemory.DistanceFieldBytes;
+				MeshMemory.CPUAccessBytes     += LODMemory.CPUAccessBytes;
+			}
+		}
+	}
+	MeshMemoryMapping.ValueSort([](const FStaticMeshLODMemory& Left, const FStaticMeshLODMemory& Right){return Left.GetTotalBytes() > Right.GetTotalBytes();});
+
+	const float KB = 1024.f;
+	const float MB = 1024.f * 1024.f;
+	if (LevelMeshes.Num() > 0)
+	{
+		Ar.Logf(TEXT("%-100s %10s %12s"), TEXT("Level"), TEXT("Meshes"), TEXT("Memory(MB)"));
+		for (const TPair<ULevel*, TSet<UStaticMesh*>>& LevelMeshesPair : LevelMeshes)
+		{
+			int64 LevelBytes = 0;
+			for (UStaticMesh* Mesh : LevelMeshesPair.Value)
+			{
+				const FStaticMeshLODMemory* MeshMemory = MeshMemoryMapping.Find(Mesh);
+				LevelBytes += MeshMemory ? MeshMemory->GetTotalBytes() : 0;
+			}
+			Ar.Logf(TEXT("%-100s %10d %12.2f"), *LevelMeshesPair.Key->GetOutermost()->GetName(), LevelMeshesPair.Value.Num(), LevelBytes / MB);
+		}
+		Ar.Logf(TEXT(""));
+	}
+
+	Ar.Logf(TEXT("%140s %12s %10s %10s %10s %10s %10s %10s %10s"), TEXT("Object"), TEXT("Memory(MB)"), TEXT("Pos(KB)"), TEXT("Tan(KB)"), TEXT("UV(KB)"), TEXT("Color(KB)"), TEXT("Index(KB)"), TEXT("DF(KB)"), TEXT("CPU(KB)"));
+
+	int64 TotalBytes = 0;
+	for (const TPair<UStaticMesh*, FStaticMeshLODMemory>& MeshMemoryPair : MeshMemoryMapping)
+	{
+		const FStaticMeshLODMemory& MeshMemory = MeshMemoryPair.Value;
+		TotalBytes += MeshMemory.GetTotalBytes();
+		FString MeshName = MeshMemoryPair.Key->GetFullName();
+		Ar.Logf(TEXT("%140s %12.2f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f"), *MeshName, MeshMemory.GetTotalBytes() / MB,
+			MeshMemory.PositionBytes / KB, MeshMemory.TangentBytes / KB, MeshMemory.TexCoordBytes / KB, MeshMemory.ColorBytes / KB,
+			MeshMemory.IndexBytes / KB, MeshMemory.DistanceFieldBytes / KB, MeshMemory.CPUAccessBytes / KB);
+	}
+	Ar.Logf(TEXT("%140s %12.2f"), TEXT("Total"), TotalBytes / MB);
+}
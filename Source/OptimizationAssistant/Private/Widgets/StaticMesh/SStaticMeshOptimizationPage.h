@@ -2,6 +2,24 @@
 
 #include "CoreMinimal.h"
 #include "Widgets/SCompoundWidget.h"
+#include "UObject/SoftObjectPath.h"
+#include "OptimizationRuleRegistry.h"
+#include "Classes/EditorStaticMesh.h"
+#include "Mesh/DuplicateMeshAnalysis.h"
+
+class ULevel;
+
+/** Lower precision vertex formats applied to a mesh after the check. */
+struct FVertexFormatFix
+{
+	FSoftObjectPath MeshPath;
+
+	/** LODs whose UVs fit in half precision, one bit per LOD. */
+	uint32 HalfPrecisionUVLODs;
+
+	/** LODs that do not need the high precision tangent basis, one bit per LOD. */
+	uint32 DefaultTangentLODs;
+};
 
 class SStaticMeshOptimizationPage : public SCompoundWidget
 {
@@ -33,15 +51,22 @@ protected:
 
 	void CheckCullDistance(UStaticMeshComponent* MeshComponent, FString& ErrorMessage);
 	void CheckNetCullDistance(UStaticMeshComponent* MeshComponent, FString& ErrorMessage);
-	void CheckTrianglesLODNum(FString& ErrorMessage);
-	void CheckLODNumLimit(FString& ErrorMessage);
-	void CheckLODTrianglesLimit(FString& ErrorMessage);
-	void CheckLODScreenSizeLimit(FString& ErrorMessage);
-	void CheckLODUVChannelLimit(FString& ErrorMessage);
-	void CheckLODMaterialNumLimit(FString& ErrorMessage);
 	void CheckLODDuplicateMaterials(FString& ErrorMessage);
-	void CheckMeshMaterialNumLimit(FString& ErrorMessage);
+	void CheckVertexFormatPrecision(FString& ErrorMessage);
+	void ApplyVertexFormatFixes(TArray<UStaticMesh*>& MeshesToBuild);
+	void CheckVertexCacheEfficiency(FString& ErrorMessage);
+	void CheckUnusedVertexStreams(FString& ErrorMessage);
+	void CheckLODGeometricError(FString& ErrorMessage);
+	void ApplyVertexCacheFixes(TArray<UStaticMesh*>& MeshesToBuild);
+	void GatherLODSettingsFix();
+	void DumpLODSettingsDiff();
+	void ApplyLODSettingsFixes(TArray<UStaticMesh*>& MeshesToBuild);
+	void RebuildFixedMeshes(const TArray<UStaticMesh*>& MeshesToBuild);
+	void CheckOutFixedPackages();
 	void DumpSortedMeshTriangles(const TArray<UStaticMesh*>& Meshes);
+	void CheckDuplicateMeshes(const TArray<UStaticMesh*>& Meshes);
+	void DumpLODReductionPreview(const TArray<UStaticMesh*>& Meshes);
+	void DumpSortedMeshMemory(const TArray<UStaticMesh*>& Meshes, const TMap<ULevel*, TSet<UStaticMesh*>>& LevelMeshes);
 
 
 private:
@@ -49,5 +74,23 @@ private:
 	TSharedPtr<IDetailsView>   SettingsView;
 	FEditorStaticMeshPtr EditorStaticMesh;
 	class UStaticMeshOptimizationRules* RuleSettings;
+
+	/** Enabled rules and settings resolved at the start of the check run. */
+	FCompiledOptimizationRules CompiledRules;
+
+	/** Per camera profile draw distances of the component being checked. */
+	FCameraDrawDistances CameraDrawDistances;
+
+	/** Meshes found by CheckVertexFormatPrecision, rebuilt together once the check is done. */
+	TArray<FVertexFormatFix> VertexFormatFixes;
+
+	/** Meshes found by CheckVertexCacheEfficiency and the LODs to reorder, one bit per LOD. */
+	TMap<FSoftObjectPath, uint32> VertexCacheFixes;
+
+	/** LOD settings changes found by GatherLODSettingsFix, reported as a dry run and applied together. */
+	TArray<FStaticMeshLODSettingsChange> LODSettingsFixes;
+
+	/** Duplicate mesh clusters chosen in the rules, consolidated after every other pass because it deletes meshes. */
+	TArray<FDuplicateMeshConsolidation> DuplicateMeshConsolidations;
 };
 
@@ -2,7 +2,31 @@
 
 UStaticMeshOptimizationRules::UStaticMeshOptimizationRules()
 	: UMeshOptimizationRules()
-
+	, MaxHalfPrecisionUVError(1.f / 2048.f)
+	, bFixVertexFormatPrecision(false)
+	, VertexCacheSize(16)
+	, MaxVertexCacheATVR(1.5f)
+	, bOptimizeVertexCache(false)
+	, DuplicateMeshTolerance(0.01f)
+	, LODScreenSizeTolerance(0.2f)
+	, bFixLODSettings(false)
 {
+	SkipCondition = TEXT("LOD0.Triangles <= 500");
+
+	PreviewPercentTriangles.Add(0.5f);
+	PreviewPercentTriangles.Add(0.25f);
+	PreviewPercentTriangles.Add(0.125f);
+	PreviewPercentTriangles.Add(0.0625f);
+}
 
+bool UStaticMeshOptimizationRules::IsHeroMesh(const FString& InPath) const
+{
+	for (const FDirectoryPath& HeroMeshDirectory : HeroMeshDirectories)
+	{
+		if (!HeroMeshDirectory.Path.IsEmpty() && InPath.Contains(HeroMeshDirectory.Path))
+		{
+			return true;
+		}
+	}
+	return false;
 }
\ No newline at end of file
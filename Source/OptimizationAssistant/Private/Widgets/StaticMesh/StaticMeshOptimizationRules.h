@@ -11,4 +11,50 @@ class UStaticMeshOptimizationRules : public UMeshOptimizationRules
 	GENERATED_BODY()
 public:
 	UStaticMeshOptimizationRules();
+
+	// 主角等重要资源所在的目录，这些Mesh允许使用高精度切线
+	UPROPERTY(EditAnywhere, config, Category = VertexFormat, meta = (LongPackageName))
+	TArray<FDirectoryPath> HeroMeshDirectories;
+
+	// UV转换为半精度后允许的最大误差，小于该值时不需要开启bUseFullPrecisionUVs
+	UPROPERTY(EditAnywhere, config, Category = VertexFormat, meta = (UIMin = "0.0001", UIMax = "0.01", ClampMin = "0"))
+	float MaxHalfPrecisionUVError;
+
+	// 检查结束后降低顶点格式精度并重新构建Mesh
+	UPROPERTY(EditAnywhere, config, Category = VertexFormat)
+	bool bFixVertexFormatPrecision;
+
+	// 模拟的顶点缓存大小
+	UPROPERTY(EditAnywhere, config, Category = VertexCache, meta = (UIMin = "8", UIMax = "32", ClampMin = "4", ClampMax = "64"))
+	int32 VertexCacheSize;
+
+	// 平均每个顶点被变换的次数(FIFO ATVR)超过该值时报告问题，1为最优
+	UPROPERTY(EditAnywhere, config, Category = VertexCache, meta = (UIMin = "1", UIMax = "3", ClampMin = "1"))
+	float MaxVertexCacheATVR;
+
+	// 检查结束后重新排列低效Mesh的三角形顺序并重新构建
+	UPROPERTY(EditAnywhere, config, Category = VertexCache)
+	bool bOptimizeVertexCache;
+
+	// 计算Mesh内容哈希时顶点位置的量化精度，误差小于该值的Mesh视为相同
+	UPROPERTY(EditAnywhere, config, Category = DuplicateMesh, meta = (UIMin = "0.001", UIMax = "1", ClampMin = "0.0001"))
+	float DuplicateMeshTolerance;
+
+	// 检查结束后把这些组中重复Mesh的引用替换为保留的那个，并删除其余的Mesh，填写重复Mesh报告中 [ ] 内的组序号，执行后清空
+	UPROPERTY(EditAnywhere, Category = DuplicateMesh)
+	TArray<int32> DuplicateClustersToConsolidate;
+
+	// 当前ScreenSize与按几何误差推荐的ScreenSize相差超过该比例时报告问题
+	UPROPERTY(EditAnywhere, config, Category = LODError, meta = (UIMin = "0", UIMax = "1", ClampMin = "0"))
+	float LODScreenSizeTolerance;
+
+	// 预览减面效果时尝试的PercentTriangles，只生成报告不修改资源
+	UPROPERTY(EditAnywhere, config, Category = LODPreview)
+	TArray<float> PreviewPercentTriangles;
+
+	// 检查结束后按推荐设置修改LOD数量、减面比例和ScreenSize并重新构建，关闭时只输出修改预览
+	UPROPERTY(EditAnywhere, config, Category = LODFix)
+	bool bFixLODSettings;
+
+	bool IsHeroMesh(const FString& InPath) const;
 };
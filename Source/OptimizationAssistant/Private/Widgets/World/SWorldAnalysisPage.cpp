@@ -0,0 +1,323 @@
+#include "SWorldAnalysisPage.h"
+#include "Misc/ScopedSlowTask.h"
+#include "OptimizationAssistantHelpers.h"
+#include "OptimizationAssistantGlobalSettings.h"
+#include "CameraProfileTable.h"
+#include "WorldAnalysisSettings.h"
+#include "World/CullDistanceVolumeAnalysis.h"
+#include "World/CameraPathSimulation.h"
+#include "World/SoftwareOcclusion.h"
+#include "World/InstancingAnalysis.h"
+#include "World/DensityHeatmap.h"
+#include "World/MeshMergeAnalysis.h"
+#include "World/ReplicationRelevancyAnalysis.h"
+#include "World/ShadowCasterAudit.h"
+
+SWorldAnalysisPage::SWorldAnalysisPage()
+	: Settings(nullptr)
+{
+
+}
+
+SWorldAnalysisPage::~SWorldAnalysisPage()
+{
+
+}
+
+void SWorldAnalysisPage::Construct(const FArguments& InArgs)
+{
+	// initialize settings view
+	FDetailsViewArgs DetailsViewArgs;
+	{
+		DetailsViewArgs.bAllowSearch = true;
+		DetailsViewArgs.bHideSelectionTip = true;
+		DetailsViewArgs.bLockable = false;
+		DetailsViewArgs.bSearchInitialKeyFocus = true;
+		DetailsViewArgs.bUpdatesFromSelection = false;
+		DetailsViewArgs.bShowOptions = true;
+		DetailsViewArgs.bShowModifiedPropertiesOption = false;
+		DetailsViewArgs.bAllowMultipleTopLevelObjects = true;
+		DetailsViewArgs.bShowActorLabel = false;
+		DetailsViewArgs.bCustomNameAreaLocation = true;
+		DetailsViewArgs.bCustomFilterAreaLocation = true;
+		DetailsViewArgs.NameAreaSettings = FDetailsViewArgs::HideNameArea;
+		DetailsViewArgs.bShowPropertyMatrixButton = false;
+	}
+	SettingsView = FModuleManager::GetModuleChecked<FPropertyEditorModule>("PropertyEditor").CreateDetailView(DetailsViewArgs);
+
+	SettingsView->SetObject(GetMutableDefault<UWorldAnalysisSettings>());
+
+	ChildSlot
+	[
+		SettingsView.ToSharedRef()
+	];
+}
+
+void SWorldAnalysisPage::ProcessOptimizationCheck()
+{
+	Settings = GetMutableDefault<UWorldAnalysisSettings>();
+	UGlobalCheckSettings* GlobalCheckSettings = GetMutableDefault<UGlobalCheckSettings>();
+	if (GlobalCheckSettings->OptimizationCheckType != EOptimizationCheckType::OCT_World &&
+		GlobalCheckSettings->OptimizationCheckType != EOptimizationCheckType::OCT_WorldDependentAssets)
+	{
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("World analysis only runs when checking the current world."));
+		return;
+	}
+
+	UWorld* World = GWorld;
+	FScopedSlowTask SlowTask(9.0f, FText::FromString(TEXT("World Analysis")));
+	SlowTask.MakeDialog(true);
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Gathering primitive bounds")));
+	Snapshot.Build(World, GlobalCheckSettings);
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Cull Distance Volumes")));
+	if (Settings->bCullDistanceVolumeAnalysis)
+	{
+		ProcessCullDistanceVolumeAnalysis(World);
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Camera Path")));
+	if (Settings->bCameraPathAnalysis)
+	{
+		ProcessCameraPathAnalysis(World);
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Occlusion")));
+	if (Settings->bOcclusionAnalysis)
+	{
+		ProcessOcclusionAnalysis(World);
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Density")));
+	if (Settings->bDensityAnalysis)
+	{
+		ProcessDensityAnalysis();
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Replication")));
+	if (Settings->bReplicationAnalysis)
+	{
+		ProcessReplicationAnalysis(World);
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Shadow Casters")));
+	if (Settings->bShadowAudit)
+	{
+		ProcessShadowAudit(World);
+	}
+
+	// 合并网格和实例化都会替换场景中的 Actor, 放在所有分析之后
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Instancing")));
+	if (Settings->bInstancingAnalysis)
+	{
+		ProcessInstancingAnalysis(World);
+	}
+
+	SlowTask.EnterProgressFrame(1.0f, FText::FromString(TEXT("Mesh Merge")));
+	if (Settings->bMeshMergeAnalysis)
+	{
+		ProcessMeshMergeAnalysis(World);
+	}
+
+	Snapshot.Reset();
+}
+
+void SWorldAnalysisPage::ProcessCullDistanceVolumeAnalysis(UWorld* World)
+{
+	FCullDistanceVolumeAnalysis Analysis;
+	Analysis.Run(World, Snapshot, Settings, FCameraProfileTable::CreateForTargetPlatforms());
+
+	{
+		OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("CullDistanceVolumeReport"));
+		Analysis.PrintReport(Snapshot, *ScopeOutputArchive);
+	}
+
+	if (Settings->bApplyFittedCullDistances)
+	{
+		Analysis.ApplyFittedTables();
+	}
+}
+
+bool SWorldAnalysisPage::GatherCameraPathSamples(TArray<FCameraPathSample>& OutSamples) const
+{
+	if (AActor* PathActor = Settings->CameraPathActor.Get())
+	{
+		if (!FCameraPathSimulation::SampleSplineActor(PathActor, Settings->CameraPathSampleSpacing, OutSamples))
+		{
+			UE_LOG(LogOptimizationAssistant, Error, TEXT("%s has no spline component."), *PathActor->GetName());
+			return false;
+		}
+		return true;
+	}
+	else if (!Settings->CameraPathFile.FilePath.IsEmpty())
+	{
+		if (!FCameraPathSimulation::LoadCSV(Settings->CameraPathFile.FilePath, OutSamples))
+		{
+			UE_LOG(LogOptimizationAssistant, Error, TEXT("Failed to read camera path %s."), *Settings->CameraPathFile.FilePath);
+			return false;
+		}
+		return true;
+	}
+	return false;
+}
+
+int32 SWorldAnalysisPage::FindCameraProfile(const FCameraProfileTable& CameraProfiles, const FString& ProfileName)
+{
+	for (int32 Index = 0; Index < CameraProfiles.Num(); ++Index)
+	{
+		if (CameraProfiles.GetProfile(Index).Name == ProfileName)
+		{
+			return Index;
+		}
+	}
+	return 0;
+}
+
+void SWorldAnalysisPage::ProcessCameraPathAnalysis(UWorld* World)
+{
+	TArray<FCameraPathSample> Samples;
+	if (!GatherCameraPathSamples(Samples))
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Camera path analysis needs a CameraPathActor or a CameraPathFile."));
+		return;
+	}
+
+	const FCameraProfileTable CameraProfiles = FCameraProfileTable::CreateForTargetPlatforms();
+	const FCameraProfileEntry& CameraProfile = CameraProfiles.GetProfile(FindCameraProfile(CameraProfiles, Settings->CameraPathProfileName));
+	const FName PlatformGroupName = CameraProfile.PlatformGroupName != NAME_None ? CameraProfile.PlatformGroupName : FOptimizationAssistantHelpers::GetTargetPlatformGroupNames()[0];
+
+	FCameraPathSimulation Simulation;
+	Simulation.Run(Snapshot, Samples, CameraProfile, PlatformGroupName);
+	Simulation.SaveBudgetCurve(OAHelper::MakeReportFilePath(TEXT("CameraPathBudget"), TEXT(".csv")));
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("CameraPathReport"));
+	ScopeOutputArchive->Logf(TEXT("镜头: %s, FOV=%.1f, %dx%d, 平台: %s"), *CameraProfile.Name, CameraProfile.FOV, CameraProfile.ResolutionX, CameraProfile.ResolutionY, *PlatformGroupName.ToString());
+	Simulation.PrintReport(Snapshot, Settings->NumCameraPathPeaks, Settings->NumCameraPathOffenders, *ScopeOutputArchive);
+}
+
+void SWorldAnalysisPage::ProcessOcclusionAnalysis(UWorld* World)
+{
+	TArray<FVector> Viewpoints;
+	if (Settings->bOcclusionUsePlayerStarts)
+	{
+		FSoftwareOcclusionAnalysis::GatherPlayerStartViewpoints(World, Settings->OcclusionEyeHeight, Viewpoints);
+	}
+
+	TArray<FCameraPathSample> Samples;
+	if (Settings->bOcclusionUseCameraPath && GatherCameraPathSamples(Samples))
+	{
+		for (const FCameraPathSample& Sample : Samples)
+		{
+			Viewpoints.Add(Sample.Location);
+		}
+	}
+
+	if (Settings->OcclusionGridSpacing > 0.0f)
+	{
+		FSoftwareOcclusionAnalysis::GatherGridViewpoints(World, Snapshot.WorldBounds, Settings->OcclusionGridSpacing, Settings->OcclusionEyeHeight, Viewpoints);
+	}
+
+	if (Viewpoints.Num() == 0)
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Occlusion analysis found no viewpoints, enable player starts, the camera path or the grid."));
+		return;
+	}
+
+	FSoftwareOcclusionAnalysis::FSettings OcclusionSettings;
+	OcclusionSettings.Resolution = Settings->OcclusionResolution;
+	OcclusionSettings.OccluderMinSize = Settings->OccluderMinSize;
+	OcclusionSettings.OccluderMaxTriangles = Settings->OccluderMaxTriangles;
+	OcclusionSettings.OccluderMaxTotalTriangles = Settings->OccluderMaxTotalTriangles;
+	OcclusionSettings.TerrainSpacing = Settings->OcclusionTerrainSpacing;
+
+	FSoftwareOcclusionAnalysis Analysis;
+	Analysis.Run(World, Snapshot, Viewpoints, OcclusionSettings);
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("OcclusionReport"));
+	Analysis.PrintReport(Snapshot, *ScopeOutputArchive);
+}
+
+void SWorldAnalysisPage::ProcessInstancingAnalysis(UWorld* World)
+{
+	FInstancingAnalysis Analysis;
+	Analysis.Run(Snapshot, Settings);
+
+	{
+		OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("InstancingReport"));
+		Analysis.PrintReport(Snapshot, *ScopeOutputArchive);
+	}
+
+	if (Settings->InstancingClustersToConvert.Num() > 0)
+	{
+		// 组序号只对应本次报告, 转换后场景变化, 序号不能再用于下一次检查
+		Analysis.ConvertClusters(World, Snapshot, Settings->InstancingClustersToConvert);
+		Settings->InstancingClustersToConvert.Reset();
+	}
+}
+
+void SWorldAnalysisPage::ProcessDensityAnalysis()
+{
+	const FCameraProfileTable CameraProfiles = FCameraProfileTable::CreateForTargetPlatforms();
+	const FCameraProfileEntry& CameraProfile = CameraProfiles.GetProfile(FindCameraProfile(CameraProfiles, Settings->DensityProfileName));
+	const FName PlatformGroupName = CameraProfile.PlatformGroupName != NAME_None ? CameraProfile.PlatformGroupName : FOptimizationAssistantHelpers::GetTargetPlatformGroupNames()[0];
+
+	FDensityHeatmap Heatmap;
+	Heatmap.Run(Snapshot, Settings->DensityCellSize, Settings->DensityReferenceDistance, CameraProfile, PlatformGroupName);
+	Heatmap.SaveCSV(OAHelper::MakeReportFilePath(TEXT("DensityHeatmap"), TEXT(".csv")));
+	Heatmap.SaveImages(OAHelper::MakeReportFilePath(TEXT("DensityHeatmap"), TEXT("")));
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("DensityReport"));
+	ScopeOutputArchive->Logf(TEXT("镜头: %s, 参考距离=%.0f, 平台: %s"), *CameraProfile.Name, Settings->DensityReferenceDistance, *PlatformGroupName.ToString());
+	Heatmap.PrintReport(Settings->NumDensityHotspots, *ScopeOutputArchive);
+}
+
+void SWorldAnalysisPage::ProcessMeshMergeAnalysis(UWorld* World)
+{
+	FMeshMergeAnalysis Analysis;
+	Analysis.Run(Snapshot, Settings);
+
+	{
+		OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("MeshMergeReport"));
+		Analysis.PrintReport(Snapshot, *ScopeOutputArchive);
+	}
+
+	if (Settings->CandidatesToMerge.Num() > 0)
+	{
+		// 和实例化转换一样, 组序号只对应本次报告
+		Analysis.MergeCandidates(World, Snapshot, Settings->CandidatesToMerge, Settings->MergedMeshPath.Path);
+		Settings->CandidatesToMerge.Reset();
+	}
+}
+
+void SWorldAnalysisPage::ProcessReplicationAnalysis(UWorld* World)
+{
+	// 客户端位置取地面上方的网格点和 PlayerStart
+	TArray<FVector> ClientPositions;
+	FSoftwareOcclusionAnalysis::GatherPlayerStartViewpoints(World, 0.0f, ClientPositions);
+	FSoftwareOcclusionAnalysis::GatherGridViewpoints(World, Snapshot.WorldBounds, Settings->ReplicationSampleSpacing, 100.0f, ClientPositions);
+	if (ClientPositions.Num() == 0)
+	{
+		UE_LOG(LogOptimizationAssistant, Warning, TEXT("Replication analysis found no client positions."));
+		return;
+	}
+
+	FReplicationRelevancyAnalysis Analysis;
+	Analysis.Run(World, ClientPositions, GetDefault<UGlobalCheckSettings>(), Settings);
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("ReplicationReport"));
+	Analysis.PrintReport(*ScopeOutputArchive);
+}
+
+void SWorldAnalysisPage::ProcessShadowAudit(UWorld* World)
+{
+	TArray<FVector> Viewpoints;
+	FSoftwareOcclusionAnalysis::GatherPlayerStartViewpoints(World, 170.0f, Viewpoints);
+	FSoftwareOcclusionAnalysis::GatherGridViewpoints(World, Snapshot.WorldBounds, Settings->ShadowSampleSpacing, 170.0f, Viewpoints);
+
+	FShadowCasterAudit Audit;
+	Audit.Run(World, Snapshot, Viewpoints, FCameraProfileTable::CreateForTargetPlatforms(), Settings);
+
+	OAHelper::FScopeOutputArchive ScopeOutputArchive(TEXT("ShadowCasterReport"));
+	Audit.PrintReport(Snapshot, Settings->NumShadowOffenders, *ScopeOutputArchive);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "World/WorldPrimitiveSnapshot.h"
+
+class SWorldAnalysisPage : public SCompoundWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SWorldAnalysisPage) { }
+	SLATE_END_ARGS()
+
+public:
+
+	/** Default constructor. */
+	SWorldAnalysisPage();
+
+	/** Destructor. */
+	~SWorldAnalysisPage();
+
+	/**
+	 * Constructs the widget.
+	 *
+	 * @param InArgs The Slate argument list.
+	 */
+	void Construct(const FArguments& InArgs);
+
+	/** Builds the world snapshot once and runs every enabled world analysis over it. */
+	void ProcessOptimizationCheck();
+
+protected:
+	void ProcessCullDistanceVolumeAnalysis(UWorld* World);
+	void ProcessCameraPathAnalysis(UWorld* World);
+	void ProcessOcclusionAnalysis(UWorld* World);
+	void ProcessInstancingAnalysis(UWorld* World);
+	void ProcessDensityAnalysis();
+	void ProcessMeshMergeAnalysis(UWorld* World);
+	void ProcessReplicationAnalysis(UWorld* World);
+	void ProcessShadowAudit(UWorld* World);
+
+	/** Samples of the CameraPathActor or CameraPathFile, false if none is set or it can't be read. */
+	bool GatherCameraPathSamples(TArray<struct FCameraPathSample>& OutSamples) const;
+
+	/** Index of the camera profile called ProfileName, the first one if there is none. */
+	static int32 FindCameraProfile(const class FCameraProfileTable& CameraProfiles, const FString& ProfileName);
+
+private:
+	/** Property viewing widget */
+	TSharedPtr<IDetailsView>   SettingsView;
+
+	class UWorldAnalysisSettings* Settings;
+
+	/** Primitive bounds of the world, shared by all analyses of a run. */
+	FWorldPrimitiveSnapshot Snapshot;
+};
@@ -0,0 +1,50 @@
+#include "WorldAnalysisSettings.h"
+
+UWorldAnalysisSettings::UWorldAnalysisSettings()
+	: Super()
+	, bCullDistanceVolumeAnalysis(true)
+	, CullDistanceScreenSize(0.03f)
+	, NumCullDistanceSizes(8)
+	, CullDistanceCoverage(0.9f)
+	, bApplyFittedCullDistances(false)
+	, bCameraPathAnalysis(false)
+	, CameraPathSampleSpacing(500.f)
+	, NumCameraPathPeaks(5)
+	, NumCameraPathOffenders(10)
+	, bOcclusionAnalysis(false)
+	, OcclusionResolution(128)
+	, OcclusionGridSpacing(5000.f)
+	, OcclusionEyeHeight(170.f)
+	, bOcclusionUsePlayerStarts(true)
+	, bOcclusionUseCameraPath(true)
+	, OccluderMinSize(500.f)
+	, OccluderMaxTriangles(2000)
+	, OccluderMaxTotalTriangles(2000000)
+	, OcclusionTerrainSpacing(800.f)
+	, bInstancingAnalysis(true)
+	, InstancingClusterRadius(2000.f)
+	, MinInstancingClusterSize(4)
+	, HierarchicalInstancingClusterSize(32)
+	, bDensityAnalysis(true)
+	, DensityCellSize(5000.f)
+	, DensityReferenceDistance(2000.f)
+	, NumDensityHotspots(10)
+	, bMeshMergeAnalysis(true)
+	, MergeMaxComponentSize(300.f)
+	, MergeClusterRadius(500.f)
+	, MinMergeClusterSize(3)
+	, bReplicationAnalysis(true)
+	, ReplicationSampleSpacing(5000.f)
+	, RelevantActorBudget(200)
+	, ReplicationConnections(64)
+	, ReplicationServerTickRate(30.f)
+	, MinNetCullDistance(2000.f)
+	, bShadowAudit(true)
+	, ShadowScreenSize(0.02f)
+	, ShadowDistanceTolerance(1.5f)
+	, ShadowSampleSpacing(5000.f)
+	, NumShadowOffenders(50)
+{
+	CullDistanceSampleDistances = { 1000.f, 2000.f, 5000.f, 10000.f, 20000.f, 50000.f };
+	MergedMeshPath.Path = TEXT("/Game/MergedMeshes");
+}
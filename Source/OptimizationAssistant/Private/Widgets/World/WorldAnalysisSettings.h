@@ -0,0 +1,213 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/EngineTypes.h"
+#include "WorldAnalysisSettings.generated.h"
+
+UCLASS(config = OptimizationAssistant, defaultconfig)
+class UWorldAnalysisSettings : public UObject
+{
+	GENERATED_BODY()
+public:
+	UWorldAnalysisSettings();
+
+	// 模拟场景中每个 CullDistanceVolume 给组件设置的裁剪距离，并拟合出新的 CullDistances 表
+	UPROPERTY(EditAnywhere, config, Category = CullDistanceVolume)
+	bool bCullDistanceVolumeAnalysis;
+
+	// 组件屏幕占比小于该值时可以被裁剪，用于计算每个组件的建议裁剪距离
+	UPROPERTY(EditAnywhere, config, Category = CullDistanceVolume, meta = (UIMin = "0.005", UIMax = "0.1", ClampMin = "0.001", ClampMax = "0.5"))
+	float CullDistanceScreenSize;
+
+	// 拟合的 CullDistances 表中 Size 的数量
+	UPROPERTY(EditAnywhere, config, Category = CullDistanceVolume, meta = (UIMin = "2", UIMax = "16", ClampMin = "2", ClampMax = "32"))
+	int32 NumCullDistanceSizes;
+
+	// 每一档 Size 中至少有多少比例的组件在裁剪前屏幕占比不小于 CullDistanceScreenSize
+	UPROPERTY(EditAnywhere, config, Category = CullDistanceVolume, meta = (UIMin = "0.5", UIMax = "1.0", ClampMin = "0.0", ClampMax = "1.0"))
+	float CullDistanceCoverage;
+
+	// 统计可见组件数量时使用的镜头距离
+	UPROPERTY(EditAnywhere, config, Category = CullDistanceVolume)
+	TArray<float> CullDistanceSampleDistances;
+
+	// 检查结束后把拟合的 CullDistances 表写入场景中的 CullDistanceVolume (可撤销)
+	UPROPERTY(EditAnywhere, config, Category = CullDistanceVolume)
+	bool bApplyFittedCullDistances;
+
+	// 沿镜头路径统计每个采样点可见的 Triangles、DrawCalls 和蒙皮顶点数
+	UPROPERTY(EditAnywhere, config, Category = CameraPath)
+	bool bCameraPathAnalysis;
+
+	// 带有 Spline 组件的 Actor，镜头沿样条线移动
+	UPROPERTY(EditAnywhere, Category = CameraPath)
+	TSoftObjectPtr<AActor> CameraPathActor;
+
+	// 录制的镜头位置，每行 X,Y,Z[,Pitch,Yaw,Roll]，设置了 CameraPathActor 时忽略
+	UPROPERTY(EditAnywhere, config, Category = CameraPath, meta = (FilePathFilter = "csv"))
+	FFilePath CameraPathFile;
+
+	// 沿样条线采样的间隔
+	UPROPERTY(EditAnywhere, config, Category = CameraPath, meta = (ClampMin = "10"))
+	float CameraPathSampleSpacing;
+
+	// 模拟使用的镜头名称(GlobalSettings 中的 CameraProfiles)，为空时使用第一个
+	UPROPERTY(EditAnywhere, config, Category = CameraPath)
+	FString CameraPathProfileName;
+
+	// 报告中列出的峰值数量
+	UPROPERTY(EditAnywhere, config, Category = CameraPath, meta = (ClampMin = "1"))
+	int32 NumCameraPathPeaks;
+
+	// 每个峰值列出的消耗最大的组件数量
+	UPROPERTY(EditAnywhere, config, Category = CameraPath, meta = (ClampMin = "1"))
+	int32 NumCameraPathOffenders;
+
+	// 在采样点周围用 CPU 光栅化遮挡体(静态网格和地形)，找出从任何采样点都看不到的组件
+	UPROPERTY(EditAnywhere, config, Category = Occlusion)
+	bool bOcclusionAnalysis;
+
+	// 每个采样点渲染 6 个面，每个面的深度缓冲分辨率
+	UPROPERTY(EditAnywhere, config, Category = Occlusion, meta = (UIMin = "32", UIMax = "512", ClampMin = "16", ClampMax = "1024"))
+	int32 OcclusionResolution;
+
+	// 在场景范围内按该间隔生成地面采样点，0 表示不使用网格采样点
+	UPROPERTY(EditAnywhere, config, Category = Occlusion, meta = (ClampMin = "0"))
+	float OcclusionGridSpacing;
+
+	// 网格采样点距离地面的高度
+	UPROPERTY(EditAnywhere, config, Category = Occlusion)
+	float OcclusionEyeHeight;
+
+	// 把 PlayerStart 作为采样点
+	UPROPERTY(EditAnywhere, config, Category = Occlusion)
+	bool bOcclusionUsePlayerStarts;
+
+	// 把 CameraPath 的采样点作为采样点
+	UPROPERTY(EditAnywhere, config, Category = Occlusion)
+	bool bOcclusionUseCameraPath;
+
+	// 尺寸(包围球直径)不小于该值的静态组件才作为遮挡体
+	UPROPERTY(EditAnywhere, config, Category = Occlusion, meta = (ClampMin = "0"))
+	float OccluderMinSize;
+
+	// 遮挡体使用面数不超过该值的第一级LOD
+	UPROPERTY(EditAnywhere, config, Category = Occlusion, meta = (ClampMin = "12"))
+	int32 OccluderMaxTriangles;
+
+	// 所有遮挡体(包括地形)的面数上限, 超过时优先保留尺寸大的遮挡体
+	UPROPERTY(EditAnywhere, config, Category = Occlusion, meta = (ClampMin = "12"))
+	int32 OccluderMaxTotalTriangles;
+
+	// 地形遮挡体的采样间隔
+	UPROPERTY(EditAnywhere, config, Category = Occlusion, meta = (ClampMin = "50"))
+	float OcclusionTerrainSpacing;
+
+	// 找出网格、材质、Mobility 和碰撞设置都相同且距离较近的 StaticMeshComponent，建议改为实例化组件
+	UPROPERTY(EditAnywhere, config, Category = Instancing)
+	bool bInstancingAnalysis;
+
+	// 距离在该半径内的相同组件归为一组
+	UPROPERTY(EditAnywhere, config, Category = Instancing, meta = (ClampMin = "0"))
+	float InstancingClusterRadius;
+
+	// 组件数量不少于该值的组才会报告
+	UPROPERTY(EditAnywhere, config, Category = Instancing, meta = (ClampMin = "2"))
+	int32 MinInstancingClusterSize;
+
+	// 组件数量不少于该值(或网格有多级LOD)时建议使用 HierarchicalInstancedStaticMeshComponent
+	UPROPERTY(EditAnywhere, config, Category = Instancing, meta = (ClampMin = "2"))
+	int32 HierarchicalInstancingClusterSize;
+
+	// 检查结束后把这些组的 StaticMeshActor 替换为一个实例化组件 (可撤销), 填写实例化报告中 [ ] 内的组序号, 转换后清空
+	UPROPERTY(EditAnywhere, Category = Instancing)
+	TArray<int32> InstancingClustersToConvert;
+
+	// 把场景划分为二维格子，统计每个格子的组件数量、Sections 和 Triangles，输出 CSV 和热力图
+	UPROPERTY(EditAnywhere, config, Category = Density)
+	bool bDensityAnalysis;
+
+	// 格子大小
+	UPROPERTY(EditAnywhere, config, Category = Density, meta = (ClampMin = "100"))
+	float DensityCellSize;
+
+	// 按该镜头距离选择每个网格的LOD
+	UPROPERTY(EditAnywhere, config, Category = Density, meta = (ClampMin = "0"))
+	float DensityReferenceDistance;
+
+	// 选择LOD使用的镜头名称(GlobalSettings 中的 CameraProfiles)，为空时使用第一个
+	UPROPERTY(EditAnywhere, config, Category = Density)
+	FString DensityProfileName;
+
+	// 报告中列出的最密集格子数量
+	UPROPERTY(EditAnywhere, config, Category = Density, meta = (ClampMin = "1"))
+	int32 NumDensityHotspots;
+
+	// 找出距离很近的小型静态组件，估算合并为一个网格后减少的 DrawCalls 和显存变化
+	UPROPERTY(EditAnywhere, config, Category = MeshMerge)
+	bool bMeshMergeAnalysis;
+
+	// 尺寸(包围球直径)不大于该值的组件才会参与合并
+	UPROPERTY(EditAnywhere, config, Category = MeshMerge, meta = (ClampMin = "0"))
+	float MergeMaxComponentSize;
+
+	// 以最大的组件为中心，该半径内的组件归为一组
+	UPROPERTY(EditAnywhere, config, Category = MeshMerge, meta = (ClampMin = "0"))
+	float MergeClusterRadius;
+
+	// 组件数量不少于该值的组才会报告
+	UPROPERTY(EditAnywhere, config, Category = MeshMerge, meta = (ClampMin = "2"))
+	int32 MinMergeClusterSize;
+
+	// 合并生成的网格资源保存的目录
+	UPROPERTY(EditAnywhere, config, Category = MeshMerge, meta = (ContentDir))
+	FDirectoryPath MergedMeshPath;
+
+	// 检查结束后用引擎的 Merge Actors 工具合并这些组的 StaticMeshActor (可撤销), 填写合并报告中 [ ] 内的组序号, 合并后清空
+	UPROPERTY(EditAnywhere, Category = MeshMerge)
+	TArray<int32> CandidatesToMerge;
+
+	// 在客户端采样点统计同时相关的同步 Actor 数量，估算服务器相关性检查的开销并给出每个类的 NetCullDistanceSquared 建议
+	UPROPERTY(EditAnywhere, config, Category = Replication)
+	bool bReplicationAnalysis;
+
+	// 在场景范围内按该间隔生成客户端采样点(另外包括 PlayerStart)
+	UPROPERTY(EditAnywhere, config, Category = Replication, meta = (ClampMin = "100"))
+	float ReplicationSampleSpacing;
+
+	// 每个客户端采样点最多相关的 Actor 数量
+	UPROPERTY(EditAnywhere, config, Category = Replication, meta = (ClampMin = "1"))
+	int32 RelevantActorBudget;
+
+	// 服务器的客户端连接数量
+	UPROPERTY(EditAnywhere, config, Category = Replication, meta = (ClampMin = "1"))
+	int32 ReplicationConnections;
+
+	// 服务器帧率(NetServerMaxTickRate)，Actor 的 NetUpdateFrequency 不会超过它
+	UPROPERTY(EditAnywhere, config, Category = Replication, meta = (ClampMin = "1"))
+	float ReplicationServerTickRate;
+
+	// 建议的网络裁剪距离不小于该值
+	UPROPERTY(EditAnywhere, config, Category = Replication, meta = (ClampMin = "0"))
+	float MinNetCullDistance;
+
+	// 统计动态阴影投射者的设置，估算每一级级联阴影渲染的投射者数量，找出阴影渲染距离远超可见距离的小组件
+	UPROPERTY(EditAnywhere, config, Category = Shadow)
+	bool bShadowAudit;
+
+	// 投射者屏幕占比小于该值时认为阴影已经看不清
+	UPROPERTY(EditAnywhere, config, Category = Shadow, meta = (UIMin = "0.005", UIMax = "0.1", ClampMin = "0.001", ClampMax = "0.5"))
+	float ShadowScreenSize;
+
+	// 阴影渲染距离超过可见距离的倍数时报告
+	UPROPERTY(EditAnywhere, config, Category = Shadow, meta = (ClampMin = "1.0"))
+	float ShadowDistanceTolerance;
+
+	// 在场景范围内按该间隔生成镜头采样点(另外包括 PlayerStart)
+	UPROPERTY(EditAnywhere, config, Category = Shadow, meta = (ClampMin = "100"))
+	float ShadowSampleSpacing;
+
+	// 报告中列出的组件数量
+	UPROPERTY(EditAnywhere, config, Category = Shadow, meta = (ClampMin = "1"))
+	int32 NumShadowOffenders;
+};
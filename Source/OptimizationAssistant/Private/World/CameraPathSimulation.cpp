@@ -0,0 +1,205 @@
+#include "World/CameraPathSimulation.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "SceneManagement.h"
+#include "ConvexVolume.h"
+#include "Components/SplineComponent.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "World/WorldMeshRecords.h"
+#include "CameraProfileTable.h"
+#include "OptimizationAssistantHelpers.h"
+
+bool FCameraPathSimulation::SampleSplineActor(AActor* PathActor, float SampleSpacing, TArray<FCameraPathSample>& OutSamples)
+{
+	USplineComponent* Spline = PathActor ? PathActor->FindComponentByClass<USplineComponent>() : nullptr;
+	if (!Spline)
+	{
+		return false;
+	}
+
+	const float SplineLength = Spline->GetSplineLength();
+	const float Spacing = FMath::Max(SampleSpacing, 1.0f);
+	for (float Distance = 0.0f; Distance <= SplineLength; Distance += Spacing)
+	{
+		FCameraPathSample& Sample = OutSamples.AddDefaulted_GetRef();
+		Sample.Location = Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+		Sample.Rotation = Spline->GetRotationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	}
+	return OutSamples.Num() > 0;
+}
+
+bool FCameraPathSimulation::LoadCSV(const FString& Filename, TArray<FCameraPathSample>& OutSamples)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+	{
+		return false;
+	}
+
+	TArray<bool> HasRotation;
+	TArray<FString> Values;
+	for (const FString& Line : Lines)
+	{
+		Line.ParseIntoArray(Values, TEXT(","), true);
+		if (Values.Num() < 3 || !Values[0].TrimStartAndEnd().IsNumeric())
+		{
+			// 表头或空行
+			continue;
+		}
+
+		FCameraPathSample& Sample = OutSamples.AddDefaulted_GetRef();
+		Sample.Location = FVector(FCString::Atof(*Values[0]), FCString::Atof(*Values[1]), FCString::Atof(*Values[2]));
+		Sample.Rotation = FRotator::ZeroRotator;
+		if (Values.Num() >= 6)
+		{
+			Sample.Rotation = FRotator(FCString::Atof(*Values[3]), FCString::Atof(*Values[4]), FCString::Atof(*Values[5]));
+		}
+		HasRotation.Add(Values.Num() >= 6);
+	}
+
+	for (int32 Index = 0; Index < OutSamples.Num(); ++Index)
+	{
+		if (!HasRotation[Index] && OutSamples.Num() > 1)
+		{
+			const int32 From = Index + 1 < OutSamples.Num() ? Index : Index - 1;
+			const FVector Direction = OutSamples[From + 1].Location - OutSamples[From].Location;
+			OutSamples[Index].Rotation = Direction.Rotation();
+		}
+	}
+	return OutSamples.Num() > 0;
+}
+
+void FCameraPathSimulation::Run(const FWorldPrimitiveSnapshot& InSnapshot, const TArray<FCameraPathSample>& InSamples, const FCameraProfileEntry& CameraProfile, FName InPlatformGroupName)
+{
+	Snapshot = &InSnapshot;
+	Samples = InSamples;
+	ProjectionMatrix = CameraProfile.ProjectionMatrix;
+	PlatformGroupName = InPlatformGroupName;
+
+	// 读取网格指标需要在游戏线程完成, 之后每个采样点只读这些数据
+	MeshRecords.Build(InSnapshot);
+
+	FrameStats.SetNum(Samples.Num());
+	ParallelFor(Samples.Num(), [this](int32 SampleIndex)
+	{
+		FrameStats[SampleIndex] = EvaluateSample(SampleIndex, nullptr);
+	});
+}
+
+FCameraPathFrameStats FCameraPathSimulation::EvaluateSample(int32 SampleIndex, TArray<FCameraPathPrimitiveCost>* OutCosts) const
+{
+	const FCameraPathSample& Sample = Samples[SampleIndex];
+	const FMatrix ViewMatrix = FTranslationMatrix(-Sample.Location)
+		* FInverseRotationMatrix(Sample.Rotation)
+		* FMatrix(FPlane(0, 0, 1, 0), FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 0, 1));
+
+	FConvexVolume Frustum;
+	GetViewFrustumBounds(Frustum, ViewMatrix * ProjectionMatrix, false);
+
+	TArray<int32> InFrustum;
+	Snapshot->BVH.QueryFrustum(Frustum, InFrustum);
+
+	FCameraPathFrameStats Stats;
+	for (int32 Index : InFrustum)
+	{
+		const FVector Origin = Snapshot->GetOrigin(Index);
+		const float MaxDrawDistance = Snapshot->CachedMaxDrawDistance[Index];
+		if (MaxDrawDistance > 0.0f && !Snapshot->HasAnyFlags(Index, WPF_NeverDistanceCull)
+			&& FVector::DistSquared(Origin, Sample.Location) > FMath::Square(MaxDrawDistance))
+		{
+			continue;
+		}
+
+		++Stats.VisiblePrimitives;
+		const FAssetMetricsRecord* Record = MeshRecords.GetRecord(Index);
+		if (!Record)
+		{
+			++Stats.DrawCalls;
+			continue;
+		}
+
+		// 实例化组件用整体包围盒选择LOD, 结果偏保守
+		const float ScreenSize = ComputeBoundsScreenSize(Origin, Snapshot->SphereRadius[Index], Sample.Location, ProjectionMatrix);
+		const int32 LODIndex = FWorldMeshRecords::SelectLOD(*Record, PlatformGroupName, ScreenSize);
+		const int64 Triangles = (int64)Record->NumTriangles[LODIndex] * MeshRecords.PrimitiveInstances[Index];
+		const int32 DrawCalls = Record->NumSections[LODIndex];
+
+		Stats.Triangles += Triangles;
+		Stats.DrawCalls += DrawCalls;
+		if (Record->AssetType == EAssetMetricsType::SkeletalMesh)
+		{
+			Stats.SkinnedVertices += Record->NumVertices[LODIndex];
+		}
+
+		if (OutCosts)
+		{
+			OutCosts->Add({ Index, LODIndex, Triangles, DrawCalls });
+		}
+	}
+	return Stats;
+}
+
+void FCameraPathSimulation::PrintReport(const FWorldPrimitiveSnapshot& InSnapshot, int32 NumPeaks, int32 NumOffenders, FOutputDevice& Ar) const
+{
+	if (FrameStats.Num() == 0)
+	{
+		Ar.Logf(TEXT("镜头路径没有采样点."));
+		return;
+	}
+
+	int64 TotalTriangles = 0;
+	int64 TotalDrawCalls = 0;
+	for (const FCameraPathFrameStats& Stats : FrameStats)
+	{
+		TotalTriangles += Stats.Triangles;
+		TotalDrawCalls += Stats.DrawCalls;
+	}
+	Ar.Logf(TEXT("采样点数量: %d, 平均 Triangles=%lld, 平均 DrawCalls=%lld"), FrameStats.Num(), TotalTriangles / FrameStats.Num(), TotalDrawCalls / FrameStats.Num());
+
+	// 峰值取局部最大值, 避免相邻的采样点重复出现
+	TArray<int32> Peaks;
+	for (int32 SampleIndex = 0; SampleIndex < FrameStats.Num(); ++SampleIndex)
+	{
+		const int64 Triangles = FrameStats[SampleIndex].Triangles;
+		const bool bAbovePrevious = SampleIndex == 0 || Triangles >= FrameStats[SampleIndex - 1].Triangles;
+		const bool bAboveNext = SampleIndex == FrameStats.Num() - 1 || Triangles > FrameStats[SampleIndex + 1].Triangles;
+		if (bAbovePrevious && bAboveNext)
+		{
+			Peaks.Add(SampleIndex);
+		}
+	}
+	Peaks.Sort([this](int32 A, int32 B) { return FrameStats[A].Triangles > FrameStats[B].Triangles; });
+	Peaks.SetNum(FMath::Min(Peaks.Num(), NumPeaks));
+
+	TArray<FCameraPathPrimitiveCost> Costs;
+	for (int32 SampleIndex : Peaks)
+	{
+		const FCameraPathSample& Sample = Samples[SampleIndex];
+		const FCameraPathFrameStats& Stats = FrameStats[SampleIndex];
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== 峰值 采样点[%d] 位置=%s 朝向=%s ===="), SampleIndex, *Sample.Location.ToString(), *Sample.Rotation.ToString());
+		Ar.Logf(TEXT("可见组件=%d, Triangles=%lld, DrawCalls=%d, SkinnedVertices=%lld"), Stats.VisiblePrimitives, Stats.Triangles, Stats.DrawCalls, Stats.SkinnedVertices);
+
+		Costs.Reset();
+		EvaluateSample(SampleIndex, &Costs);
+		Costs.Sort([](const FCameraPathPrimitiveCost& A, const FCameraPathPrimitiveCost& B) { return A.Triangles > B.Triangles; });
+		for (int32 CostIndex = 0; CostIndex < FMath::Min(Costs.Num(), NumOffenders); ++CostIndex)
+		{
+			const FCameraPathPrimitiveCost& Cost = Costs[CostIndex];
+			UPrimitiveComponent* Component = InSnapshot.GetComponent(Cost.PrimitiveIndex);
+			Ar.Logf(TEXT("    %s LOD[%d] Triangles=%lld DrawCalls=%d"), Component ? *Component->GetFullName() : TEXT("None"), Cost.LODIndex, Cost.Triangles, Cost.DrawCalls);
+		}
+	}
+}
+
+bool FCameraPathSimulation::SaveBudgetCurve(const FString& Filename) const
+{
+	FString Csv = TEXT("Sample,X,Y,Z,VisiblePrimitives,Triangles,DrawCalls,SkinnedVertices\n");
+	for (int32 SampleIndex = 0; SampleIndex < FrameStats.Num(); ++SampleIndex)
+	{
+		const FVector& Location = Samples[SampleIndex].Location;
+		const FCameraPathFrameStats& Stats = FrameStats[SampleIndex];
+		Csv += FString::Printf(TEXT("%d,%.1f,%.1f,%.1f,%d,%lld,%d,%lld\n"), SampleIndex, Location.X, Location.Y, Location.Z, Stats.VisiblePrimitives, Stats.Triangles, Stats.DrawCalls, Stats.SkinnedVertices);
+	}
+	return FFileHelper::SaveStringToFile(Csv, *Filename);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "World/WorldMeshRecords.h"
+
+struct FWorldPrimitiveSnapshot;
+struct FCameraProfileEntry;
+class UWorldAnalysisSettings;
+
+struct FCameraPathSample
+{
+	FVector Location;
+	FRotator Rotation;
+};
+
+/** What one camera sample sees after frustum, distance culling and LOD selection. */
+struct FCameraPathFrameStats
+{
+	int32 VisiblePrimitives;
+	int64 Triangles;
+	int32 DrawCalls;
+	int64 SkinnedVertices;
+
+	FCameraPathFrameStats()
+		: VisiblePrimitives(0)
+		, Triangles(0)
+		, DrawCalls(0)
+		, SkinnedVertices(0)
+	{}
+};
+
+/** Cost of one primitive at a sample, used to list the worst offenders of the peaks. */
+struct FCameraPathPrimitiveCost
+{
+	int32 PrimitiveIndex;
+	int32 LODIndex;
+	int64 Triangles;
+	int32 DrawCalls;
+};
+
+/**
+ * Flies a camera profile along a path (spline actor or CSV of positions) and, for every sample,
+ * culls the snapshot primitives against the view frustum and their draw distance, picks the LOD
+ * the engine would use from the mesh screen sizes and sums what is left into a per frame budget.
+ */
+class FCameraPathSimulation
+{
+public:
+	FCameraPathSimulation() : Snapshot(nullptr) {}
+
+	/** Samples the spline of PathActor every SampleSpacing units. */
+	static bool SampleSplineActor(AActor* PathActor, float SampleSpacing, TArray<FCameraPathSample>& OutSamples);
+
+	/** Reads "X,Y,Z[,Pitch,Yaw,Roll]" lines, samples without rotation look at the next sample. */
+	static bool LoadCSV(const FString& Filename, TArray<FCameraPathSample>& OutSamples);
+
+	void Run(const FWorldPrimitiveSnapshot& Snapshot, const TArray<FCameraPathSample>& InSamples, const FCameraProfileEntry& CameraProfile, FName PlatformGroupName);
+
+	void PrintReport(const FWorldPrimitiveSnapshot& Snapshot, int32 NumPeaks, int32 NumOffenders, FOutputDevice& Ar) const;
+
+	/** One line per sample: index, location and the frame stats. */
+	bool SaveBudgetCurve(const FString& Filename) const;
+
+private:
+	/** Culls and sums one sample, OutCosts is filled when not nullptr. */
+	FCameraPathFrameStats EvaluateSample(int32 SampleIndex, TArray<FCameraPathPrimitiveCost>* OutCosts) const;
+
+	const FWorldPrimitiveSnapshot* Snapshot;
+
+	TArray<FCameraPathSample> Samples;
+	TArray<FCameraPathFrameStats> FrameStats;
+
+	FWorldMeshRecords MeshRecords;
+
+	FMatrix ProjectionMatrix;
+	FName PlatformGroupName;
+};
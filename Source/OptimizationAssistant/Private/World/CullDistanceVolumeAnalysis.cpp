@@ -0,0 +1,308 @@
+#include "World/CullDistanceVolumeAnalysis.h"
+#include "EngineUtils.h"
+#include "ScopedTransaction.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "Widgets/World/WorldAnalysisSettings.h"
+#include "CameraProfileTable.h"
+#include "OptimizationAssistantHelpers.h"
+
+#define LOCTEXT_NAMESPACE "CullDistanceVolumeAnalysis"
+
+float FCullDistanceVolumeAnalysis::GetTableCullDistance(const TArray<FCullDistanceSizePair>& CullDistances, float PrimitiveSize)
+{
+	float CullDistance = 0.0f;
+	float CurrentError = FLT_MAX;
+	for (const FCullDistanceSizePair& SizePair : CullDistances)
+	{
+		const float Error = FMath::Abs(PrimitiveSize - SizePair.Size);
+		if (Error < CurrentError)
+		{
+			CurrentError = Error;
+			CullDistance = SizePair.CullDistance;
+		}
+	}
+	return CullDistance;
+}
+
+float FCullDistanceVolumeAnalysis::CombineCullDistance(float CurrentCullDistance, float VolumeCullDistance)
+{
+	// 与 ACullDistanceVolume::GetPrimitiveMaxDrawDistances 一致, 体积中的0会让已有的距离变成永不剔除
+	if (CurrentCullDistance > 0.0f)
+	{
+		return FMath::Min(CurrentCullDistance, VolumeCullDistance);
+	}
+	return VolumeCullDistance;
+}
+
+void FCullDistanceVolumeAnalysis::Run(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const UWorldAnalysisSettings* Settings, const FCameraProfileTable& CameraProfiles)
+{
+	Simulations.Reset();
+	SampleDistances = Settings->CullDistanceSampleDistances;
+	SampleDistances.Sort();
+	NumSizes = FMath::Max(Settings->NumCullDistanceSizes, 2);
+	Coverage = FMath::Clamp(Settings->CullDistanceCoverage, 0.0f, 1.0f);
+
+	FCameraDrawDistances DrawDistances;
+	RecommendDistances.SetNumUninitialized(Snapshot.Num());
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		CameraProfiles.ComputeDrawDistances(Snapshot.SphereRadius[Index], Settings->CullDistanceScreenSize, DrawDistances);
+		float RecommendDistance = 0.0f;
+		for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
+		{
+			RecommendDistance = FMath::Max(RecommendDistance, DrawDistances[ProfileIndex]);
+		}
+		RecommendDistances[Index] = RecommendDistance;
+	}
+
+	TArray<int32> Candidates;
+	for (TActorIterator<ACullDistanceVolume> It(World); It; ++It)
+	{
+		ACullDistanceVolume* Volume = *It;
+		if (!Volume->bEnabled)
+		{
+			continue;
+		}
+
+		FCullDistanceVolumeSimulation& Simulation = Simulations.AddDefaulted_GetRef();
+		Simulation.Volume = Volume;
+		Simulation.Name = Volume->GetActorLabel();
+		Simulation.CurrentTable = Volume->CullDistances;
+		Candidates.Reset();
+		// 体积的刷子组件没有碰撞, 需要把不碰撞的组件也算进包围盒
+		Snapshot.BVH.QueryBox(Volume->GetComponentsBoundingBox(true), Candidates);
+		Candidates.Sort();
+		for (int32 Index : Candidates)
+		{
+			if (Snapshot.HasAnyFlags(Index, WPF_AffectedByCullDistanceVolume) && Volume->EncompassesPoint(Snapshot.GetOrigin(Index)))
+			{
+				Simulation.Primitives.Add(Index);
+			}
+		}
+	}
+
+	if (Simulations.Num() == 0)
+	{
+		// 场景中没有 CullDistanceVolume, 给出覆盖整个场景的建议表
+		FCullDistanceVolumeSimulation& Simulation = Simulations.AddDefaulted_GetRef();
+		Simulation.Name = TEXT("(World)");
+		for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+		{
+			if (Snapshot.HasAnyFlags(Index, WPF_AffectedByCullDistanceVolume))
+			{
+				Simulation.Primitives.Add(Index);
+			}
+		}
+	}
+
+	for (FCullDistanceVolumeSimulation& Simulation : Simulations)
+	{
+		FitTable(Simulation, Snapshot);
+	}
+
+	// 一个组件可以同时在多个体积内, 先合并所有体积再统计
+	TArray<float> CurrentEffective;
+	TArray<float> FittedEffective;
+	CurrentEffective.SetNumUninitialized(Snapshot.Num());
+	FittedEffective.SetNumUninitialized(Snapshot.Num());
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		CurrentEffective[Index] = Snapshot.LDMaxDrawDistance[Index];
+		FittedEffective[Index] = Snapshot.LDMaxDrawDistance[Index];
+	}
+
+	// 和 ACullDistanceVolume::GetPrimitiveMaxDrawDistances 一样, 空表的体积不参与合并
+	for (const FCullDistanceVolumeSimulation& Simulation : Simulations)
+	{
+		const bool bHasCurrentTable = Simulation.CurrentTable.Num() > 0;
+		const bool bHasFittedTable = Simulation.FittedTable.Num() > 0;
+		for (int32 Index : Simulation.Primitives)
+		{
+			const float PrimitiveSize = Snapshot.SphereRadius[Index] * 2.0f;
+			if (bHasCurrentTable)
+			{
+				CurrentEffective[Index] = CombineCullDistance(CurrentEffective[Index], GetTableCullDistance(Simulation.CurrentTable, PrimitiveSize));
+			}
+			if (bHasFittedTable)
+			{
+				FittedEffective[Index] = CombineCullDistance(FittedEffective[Index], GetTableCullDistance(Simulation.FittedTable, PrimitiveSize));
+			}
+		}
+	}
+
+	for (FCullDistanceVolumeSimulation& Simulation : Simulations)
+	{
+		Simulation.CurrentDistances.Reset(Simulation.Primitives.Num());
+		Simulation.FittedDistances.Reset(Simulation.Primitives.Num());
+		for (int32 Index : Simulation.Primitives)
+		{
+			Simulation.CurrentDistances.Add(CurrentEffective[Index]);
+			Simulation.FittedDistances.Add(FittedEffective[Index]);
+		}
+		Evaluate(Simulation, Snapshot);
+	}
+}
+
+void FCullDistanceVolumeAnalysis::FitTable(FCullDistanceVolumeSimulation& Simulation, const FWorldPrimitiveSnapshot& Snapshot) const
+{
+	Simulation.FittedTable.Reset();
+	if (Simulation.Primitives.Num() == 0)
+	{
+		return;
+	}
+
+	float MinSize = FLT_MAX;
+	float MaxSize = 0.0f;
+	for (int32 Index : Simulation.Primitives)
+	{
+		const float PrimitiveSize = Snapshot.SphereRadius[Index] * 2.0f;
+		MinSize = FMath::Min(MinSize, PrimitiveSize);
+		MaxSize = FMath::Max(MaxSize, PrimitiveSize);
+	}
+	MinSize = FMath::Max(MinSize, 1.0f);
+	MaxSize = FMath::Max(MaxSize, MinSize * 2.0f);
+
+	// Size 按几何级数分布, 与引擎一样按最接近的 Size 分配组件
+	const float SizeRatio = FMath::Pow(MaxSize / MinSize, 1.0f / (NumSizes - 1));
+	for (int32 SizeIndex = 0; SizeIndex < NumSizes; ++SizeIndex)
+	{
+		FCullDistanceSizePair& SizePair = Simulation.FittedTable.AddDefaulted_GetRef();
+		SizePair.Size = FMath::RoundToFloat(MinSize * FMath::Pow(SizeRatio, (float)SizeIndex));
+		SizePair.CullDistance = 0.0f;
+	}
+
+	TArray<TArray<float>> BucketDistances;
+	BucketDistances.SetNum(NumSizes);
+	for (int32 Index : Simulation.Primitives)
+	{
+		const float PrimitiveSize = Snapshot.SphereRadius[Index] * 2.0f;
+		int32 BestBucket = 0;
+		float CurrentError = FLT_MAX;
+		for (int32 SizeIndex = 0; SizeIndex < NumSizes; ++SizeIndex)
+		{
+			const float Error = FMath::Abs(PrimitiveSize - Simulation.FittedTable[SizeIndex].Size);
+			if (Error < CurrentError)
+			{
+				CurrentError = Error;
+				BestBucket = SizeIndex;
+			}
+		}
+		BucketDistances[BestBucket].Add(RecommendDistances[Index]);
+	}
+
+	float PreviousDistance = 0.0f;
+	for (int32 SizeIndex = 0; SizeIndex < NumSizes; ++SizeIndex)
+	{
+		TArray<float>& Distances = BucketDistances[SizeIndex];
+		float CullDistance;
+		if (Distances.Num() > 0)
+		{
+			// 满足覆盖率的最小距离, 距离越小可见组件越少
+			Distances.Sort();
+			const int32 CoverageIndex = FMath::Clamp(FMath::CeilToInt(Coverage * Distances.Num()) - 1, 0, Distances.Num() - 1);
+			CullDistance = Distances[CoverageIndex];
+		}
+		else
+		{
+			// 没有组件的档位按比例插值, 保证表是单调的
+			CullDistance = SizeIndex > 0 ? PreviousDistance * SizeRatio : 0.0f;
+		}
+
+		CullDistance = FMath::Max(CullDistance, PreviousDistance);
+		CullDistance = FMath::CeilToFloat(CullDistance / 100.0f) * 100.0f;
+		Simulation.FittedTable[SizeIndex].CullDistance = CullDistance;
+		PreviousDistance = CullDistance;
+	}
+
+	// 首档为空时用第一个有效距离补齐
+	for (int32 SizeIndex = NumSizes - 1; SizeIndex > 0; --SizeIndex)
+	{
+		if (Simulation.FittedTable[SizeIndex - 1].CullDistance <= 0.0f)
+		{
+			Simulation.FittedTable[SizeIndex - 1].CullDistance = Simulation.FittedTable[SizeIndex].CullDistance;
+		}
+	}
+}
+
+void FCullDistanceVolumeAnalysis::Evaluate(FCullDistanceVolumeSimulation& Simulation, const FWorldPrimitiveSnapshot& Snapshot) const
+{
+	Simulation.CurrentVisible.SetNumZeroed(SampleDistances.Num());
+	Simulation.FittedVisible.SetNumZeroed(SampleDistances.Num());
+	Simulation.CurrentCulledTooEarly = 0;
+	Simulation.FittedCulledTooEarly = 0;
+
+	for (int32 PrimitiveIndex = 0; PrimitiveIndex < Simulation.Primitives.Num(); ++PrimitiveIndex)
+	{
+		const float CurrentDistance = Simulation.CurrentDistances[PrimitiveIndex];
+		const float FittedDistance = Simulation.FittedDistances[PrimitiveIndex];
+		for (int32 SampleIndex = 0; SampleIndex < SampleDistances.Num(); ++SampleIndex)
+		{
+			const float SampleDistance = SampleDistances[SampleIndex];
+			Simulation.CurrentVisible[SampleIndex] += (CurrentDistance <= 0.0f || CurrentDistance > SampleDistance) ? 1 : 0;
+			Simulation.FittedVisible[SampleIndex] += (FittedDistance <= 0.0f || FittedDistance > SampleDistance) ? 1 : 0;
+		}
+
+		const float RecommendDistance = RecommendDistances[Simulation.Primitives[PrimitiveIndex]];
+		Simulation.CurrentCulledTooEarly += (CurrentDistance > 0.0f && CurrentDistance < RecommendDistance) ? 1 : 0;
+		Simulation.FittedCulledTooEarly += (FittedDistance > 0.0f && FittedDistance < RecommendDistance) ? 1 : 0;
+	}
+}
+
+static FString CullDistanceTableToString(const TArray<FCullDistanceSizePair>& CullDistances)
+{
+	// 与 DefaultEngine.ini / 复制粘贴属性的格式一致
+	FString Result = TEXT("(");
+	for (int32 Index = 0; Index < CullDistances.Num(); ++Index)
+	{
+		Result += FString::Printf(TEXT("%s(Size=%.0f,CullDistance=%.0f)"), Index > 0 ? TEXT(",") : TEXT(""), CullDistances[Index].Size, CullDistances[Index].CullDistance);
+	}
+	Result += TEXT(")");
+	return Result;
+}
+
+void FCullDistanceVolumeAnalysis::PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const
+{
+	for (const FCullDistanceVolumeSimulation& Simulation : Simulations)
+	{
+		Ar.Logf(TEXT("==== CullDistanceVolume: %s ===="), *Simulation.Name);
+		if (!Simulation.Volume.IsValid())
+		{
+			Ar.Logf(TEXT("场景中没有启用的 CullDistanceVolume, 建议新建一个覆盖整个场景的体积并使用下面的表."));
+		}
+		Ar.Logf(TEXT("受影响的组件数量: %d"), Simulation.Primitives.Num());
+		Ar.Logf(TEXT("当前 CullDistances=%s"), *CullDistanceTableToString(Simulation.CurrentTable));
+		Ar.Logf(TEXT("拟合 CullDistances=%s"), *CullDistanceTableToString(Simulation.FittedTable));
+		for (int32 SampleIndex = 0; SampleIndex < SampleDistances.Num(); ++SampleIndex)
+		{
+			Ar.Logf(TEXT("镜头距离[%.0f]: 可见组件 当前=%d, 拟合=%d"), SampleDistances[SampleIndex], Simulation.CurrentVisible[SampleIndex], Simulation.FittedVisible[SampleIndex]);
+		}
+		Ar.Logf(TEXT("屏幕占比仍较大时就被裁剪的组件: 当前=%d, 拟合=%d"), Simulation.CurrentCulledTooEarly, Simulation.FittedCulledTooEarly);
+
+		int32 NumNeverCulled = 0;
+		for (float CullDistance : Simulation.CurrentDistances)
+		{
+			NumNeverCulled += CullDistance <= 0.0f ? 1 : 0;
+		}
+		Ar.Logf(TEXT("当前没有有效裁剪距离的组件: %d"), NumNeverCulled);
+		Ar.Logf(TEXT(""));
+	}
+}
+
+void FCullDistanceVolumeAnalysis::ApplyFittedTables() const
+{
+	FScopedTransaction Transaction(LOCTEXT("ApplyFittedCullDistances", "Apply Fitted Cull Distances"));
+	for (const FCullDistanceVolumeSimulation& Simulation : Simulations)
+	{
+		ACullDistanceVolume* Volume = Simulation.Volume.Get();
+		if (Volume && Simulation.FittedTable.Num() > 0)
+		{
+			Volume->Modify();
+			Volume->CullDistances = Simulation.FittedTable;
+			// ACullDistanceVolume::PostEditChangeProperty 会刷新场景中组件的裁剪距离
+			Volume->PostEditChange();
+			UE_LOG(LogOptimizationAssistant, Log, TEXT("Applied fitted cull distances to %s."), *Simulation.Name);
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/CullDistanceVolume.h"
+
+struct FWorldPrimitiveSnapshot;
+class FCameraProfileTable;
+class UWorldAnalysisSettings;
+
+/** Cull distances a volume assigns to the primitives inside it, now and with the fitted table. */
+struct FCullDistanceVolumeSimulation
+{
+	/** nullptr for the table proposed for a world that has no volume yet. */
+	TWeakObjectPtr<ACullDistanceVolume> Volume;
+
+	FString Name;
+
+	/** Snapshot indices of the primitives the volume affects. */
+	TArray<int32> Primitives;
+
+	TArray<FCullDistanceSizePair> CurrentTable;
+	TArray<FCullDistanceSizePair> FittedTable;
+
+	/** Effective cull distance of each primitive in Primitives, 0 is never culled. */
+	TArray<float> CurrentDistances;
+	TArray<float> FittedDistances;
+
+	/** Visible primitives at each of the sample distances. */
+	TArray<int32> CurrentVisible;
+	TArray<int32> FittedVisible;
+
+	/** Primitives culled while still bigger than the cull screen size. */
+	int32 CurrentCulledTooEarly;
+	int32 FittedCulledTooEarly;
+
+	FCullDistanceVolumeSimulation()
+		: CurrentCulledTooEarly(0)
+		, FittedCulledTooEarly(0)
+	{}
+};
+
+/**
+ * Reproduces the cull distances ACullDistanceVolume assigns (UWorld::UpdateCullDistanceVolumes),
+ * then fits a size to distance table per volume: for every size entry the smallest distance at
+ * which CullDistanceCoverage of its primitives are already smaller than the cull screen size.
+ */
+class FCullDistanceVolumeAnalysis
+{
+public:
+	/** Distance of the entry whose size is closest to PrimitiveSize, like the engine picks it. */
+	static float GetTableCullDistance(const TArray<FCullDistanceSizePair>& CullDistances, float PrimitiveSize);
+
+	/**
+	 * Same as ACullDistanceVolume::GetPrimitiveMaxDrawDistances: the smaller of the two once the component has a
+	 * distance, the volume's distance otherwise. Volumes are applied in actor order, so a volume entry of 0 resets
+	 * the component to never cull and a later volume can set it again.
+	 */
+	static float CombineCullDistance(float CurrentCullDistance, float VolumeCullDistance);
+
+	void Run(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const UWorldAnalysisSettings* Settings, const FCameraProfileTable& CameraProfiles);
+
+	void PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const;
+
+	/** Writes the fitted tables to the volumes in one undoable transaction. */
+	void ApplyFittedTables() const;
+
+	const TArray<FCullDistanceVolumeSimulation>& GetSimulations() const { return Simulations; }
+
+private:
+	void FitTable(FCullDistanceVolumeSimulation& Simulation, const FWorldPrimitiveSnapshot& Snapshot) const;
+	void Evaluate(FCullDistanceVolumeSimulation& Simulation, const FWorldPrimitiveSnapshot& Snapshot) const;
+
+	TArray<FCullDistanceVolumeSimulation> Simulations;
+
+	TArray<float> SampleDistances;
+
+	/** Recommended cull distance of every snapshot primitive, the largest over the camera profiles. */
+	TArray<float> RecommendDistances;
+
+	int32 NumSizes;
+	float Coverage;
+};
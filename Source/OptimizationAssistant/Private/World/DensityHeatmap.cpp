@@ -0,0 +1,167 @@
+#include "World/DensityHeatmap.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "SceneManagement.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "CameraProfileTable.h"
+#include "OptimizationAssistantHelpers.h"
+
+void FDensityHeatmap::Run(const FWorldPrimitiveSnapshot& Snapshot, float InCellSize, float ReferenceDistance, const FCameraProfileEntry& CameraProfile, FName PlatformGroupName)
+{
+	static const int32 MaxCellsPerAxis = 1024;
+
+	Cells.Reset();
+	NumX = NumY = 0;
+	if (!Snapshot.WorldBounds.IsValid)
+	{
+		return;
+	}
+
+	// 格子数量有上限, 场景很大时自动放大格子
+	const FVector WorldSize = Snapshot.WorldBounds.GetSize();
+	CellSize = FMath::Max3(InCellSize, WorldSize.X / MaxCellsPerAxis, WorldSize.Y / MaxCellsPerAxis);
+	CellSize = FMath::Max(CellSize, 1.0f);
+	Origin = FVector2D(Snapshot.WorldBounds.Min.X, Snapshot.WorldBounds.Min.Y);
+	NumX = FMath::Max(FMath::CeilToInt(WorldSize.X / CellSize), 1);
+	NumY = FMath::Max(FMath::CeilToInt(WorldSize.Y / CellSize), 1);
+
+	// 读取网格指标需要在游戏线程完成, 每个组件在参考距离下的LOD也只算一次
+	MeshRecords.Build(Snapshot);
+	TArray<int32> PrimitiveSections;
+	TArray<int64> PrimitiveTriangles;
+	PrimitiveSections.SetNumUninitialized(Snapshot.Num());
+	PrimitiveTriangles.SetNumUninitialized(Snapshot.Num());
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		const FAssetMetricsRecord* Record = MeshRecords.GetRecord(Index);
+		if (!Record)
+		{
+			PrimitiveSections[Index] = 1;
+			PrimitiveTriangles[Index] = 0;
+			continue;
+		}
+
+		const float ScreenSize = ComputeBoundsScreenSize(FVector::ZeroVector, Snapshot.SphereRadius[Index], FVector(ReferenceDistance, 0.0f, 0.0f), CameraProfile.ProjectionMatrix);
+		const int32 LODIndex = FWorldMeshRecords::SelectLOD(*Record, PlatformGroupName, ScreenSize);
+		PrimitiveSections[Index] = Record->NumSections[LODIndex];
+		PrimitiveTriangles[Index] = (int64)Record->NumTriangles[LODIndex] * MeshRecords.PrimitiveInstances[Index];
+	}
+
+	Cells.SetNumZeroed(NumX * NumY);
+	const FBox& WorldBounds = Snapshot.WorldBounds;
+	ParallelFor(Cells.Num(), [this, &Snapshot, &WorldBounds, &PrimitiveSections, &PrimitiveTriangles](int32 CellIndex)
+	{
+		const int32 X = CellIndex % NumX;
+		const int32 Y = CellIndex / NumX;
+		const FVector2D CellMin = GetCellMin(X, Y);
+		const FVector2D CellMax = CellMin + FVector2D(CellSize, CellSize);
+
+		TArray<int32> Primitives;
+		Snapshot.BVH.QueryBox(FBox(FVector(CellMin, WorldBounds.Min.Z), FVector(CellMax, WorldBounds.Max.Z)), Primitives);
+
+		// 按包围盒中心归属格子, 跨格子的组件只统计一次
+		FDensityCell& Cell = Cells[CellIndex];
+		for (int32 Index : Primitives)
+		{
+			const float OriginX = Snapshot.OriginX[Index];
+			const float OriginY = Snapshot.OriginY[Index];
+			const bool bInsideX = OriginX >= CellMin.X && (OriginX < CellMax.X || X == NumX - 1);
+			const bool bInsideY = OriginY >= CellMin.Y && (OriginY < CellMax.Y || Y == NumY - 1);
+			if (bInsideX && bInsideY)
+			{
+				++Cell.Components;
+				Cell.Sections += PrimitiveSections[Index];
+				Cell.Triangles += PrimitiveTriangles[Index];
+			}
+		}
+	});
+}
+
+bool FDensityHeatmap::SaveCSV(const FString& Filename) const
+{
+	FString Csv = TEXT("CellX,CellY,MinX,MinY,MaxX,MaxY,Components,Sections,Triangles\n");
+	for (int32 Y = 0; Y < NumY; ++Y)
+	{
+		for (int32 X = 0; X < NumX; ++X)
+		{
+			const FDensityCell& Cell = Cells[Y * NumX + X];
+			const FVector2D CellMin = GetCellMin(X, Y);
+			Csv += FString::Printf(TEXT("%d,%d,%.0f,%.0f,%.0f,%.0f,%d,%d,%lld\n"), X, Y, CellMin.X, CellMin.Y, CellMin.X + CellSize, CellMin.Y + CellSize, Cell.Components, Cell.Sections, Cell.Triangles);
+		}
+	}
+	return FFileHelper::SaveStringToFile(Csv, *Filename);
+}
+
+void FDensityHeatmap::SaveImages(const FString& BaseFilename) const
+{
+	if (Cells.Num() == 0)
+	{
+		return;
+	}
+
+	// 小场景的格子放大到至少 512 像素宽, 方便查看
+	const int32 PixelsPerCell = FMath::Max(1, 512 / FMath::Max(NumX, NumY));
+	const int32 Width = NumX * PixelsPerCell;
+	const int32 Height = NumY * PixelsPerCell;
+
+	auto SaveImage = [this, PixelsPerCell, Width, Height](const FString& Filename, TFunctionRef<double(const FDensityCell&)> GetValue)
+	{
+		double MaxValue = 0.0;
+		for (const FDensityCell& Cell : Cells)
+		{
+			MaxValue = FMath::Max(MaxValue, GetValue(Cell));
+		}
+
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(Width * Height);
+		for (int32 PixelY = 0; PixelY < Height; ++PixelY)
+		{
+			for (int32 PixelX = 0; PixelX < Width; ++PixelX)
+			{
+				const FDensityCell& Cell = Cells[(PixelY / PixelsPerCell) * NumX + PixelX / PixelsPerCell];
+				const double Value = GetValue(Cell);
+				Pixels[PixelY * Width + PixelX] = Value <= 0.0
+					? FColor::Black
+					: FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, (float)(Value / MaxValue)).ToFColor(true);
+			}
+		}
+		FFileHelper::CreateBitmap(*Filename, Width, Height, Pixels.GetData());
+	};
+
+	SaveImage(BaseFilename + TEXT("_Components.bmp"), [](const FDensityCell& Cell) { return (double)Cell.Components; });
+	SaveImage(BaseFilename + TEXT("_Sections.bmp"), [](const FDensityCell& Cell) { return (double)Cell.Sections; });
+	SaveImage(BaseFilename + TEXT("_Triangles.bmp"), [](const FDensityCell& Cell) { return (double)Cell.Triangles; });
+}
+
+void FDensityHeatmap::PrintReport(int32 NumHotspots, FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("格子大小: %.0f, 格子数量: %d x %d"), CellSize, NumX, NumY);
+
+	auto PrintHotspots = [this, NumHotspots, &Ar](const TCHAR* Title, TFunctionRef<int64(const FDensityCell&)> GetValue)
+	{
+		TArray<int32> Sorted;
+		for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+		{
+			if (GetValue(Cells[CellIndex]) > 0)
+			{
+				Sorted.Add(CellIndex);
+			}
+		}
+		Sorted.Sort([this, &GetValue](int32 A, int32 B) { return GetValue(Cells[A]) > GetValue(Cells[B]); });
+
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== %s 最高的格子 ===="), Title);
+		for (int32 Rank = 0; Rank < FMath::Min(NumHotspots, Sorted.Num()); ++Rank)
+		{
+			const int32 X = Sorted[Rank] % NumX;
+			const int32 Y = Sorted[Rank] / NumX;
+			const FDensityCell& Cell = Cells[Sorted[Rank]];
+			const FVector2D CellMin = GetCellMin(X, Y);
+			Ar.Logf(TEXT("[%d, %d] 范围=(%.0f, %.0f)-(%.0f, %.0f) Components=%d Sections=%d Triangles=%lld"),
+				X, Y, CellMin.X, CellMin.Y, CellMin.X + CellSize, CellMin.Y + CellSize, Cell.Components, Cell.Sections, Cell.Triangles);
+		}
+	};
+
+	PrintHotspots(TEXT("Sections"), [](const FDensityCell& Cell) { return (int64)Cell.Sections; });
+	PrintHotspots(TEXT("Triangles"), [](const FDensityCell& Cell) { return Cell.Triangles; });
+}
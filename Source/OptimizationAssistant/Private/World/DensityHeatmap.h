@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "World/WorldMeshRecords.h"
+
+struct FWorldPrimitiveSnapshot;
+struct FCameraProfileEntry;
+
+/** Totals of the primitives whose bounds origin is inside one cell. */
+struct FDensityCell
+{
+	int32 Components;
+	int32 Sections;
+	int64 Triangles;
+};
+
+/**
+ * Splits the world bounds into a 2D grid of cells and sums, per cell, the components, the material
+ * sections and the triangles of the LOD every mesh would use seen from the reference distance.
+ * Cells are computed in parallel with box queries against the snapshot BVH.
+ */
+class FDensityHeatmap
+{
+public:
+	FDensityHeatmap() : NumX(0), NumY(0), CellSize(0.0f) {}
+
+	void Run(const FWorldPrimitiveSnapshot& Snapshot, float InCellSize, float ReferenceDistance, const FCameraProfileEntry& CameraProfile, FName PlatformGroupName);
+
+	/** One line per cell: grid and world position followed by the totals. */
+	bool SaveCSV(const FString& Filename) const;
+
+	/** One bitmap per metric, green to red relative to the densest cell, row 0 is the smallest Y. */
+	void SaveImages(const FString& BaseFilename) const;
+
+	void PrintReport(int32 NumHotspots, FOutputDevice& Ar) const;
+
+private:
+	FVector2D GetCellMin(int32 X, int32 Y) const { return FVector2D(Origin.X + X * CellSize, Origin.Y + Y * CellSize); }
+
+	FWorldMeshRecords MeshRecords;
+
+	/** Row major, NumX cells per row. */
+	TArray<FDensityCell> Cells;
+
+	int32 NumX;
+	int32 NumY;
+	float CellSize;
+	FVector2D Origin;
+};
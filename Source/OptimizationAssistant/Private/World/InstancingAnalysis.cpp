@@ -0,0 +1,235 @@
+#include "World/InstancingAnalysis.h"
+#include "ScopedTransaction.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "StaticMeshResources.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "Widgets/World/WorldAnalysisSettings.h"
+#include "OptimizationAssistantHelpers.h"
+
+#define LOCTEXT_NAMESPACE "InstancingAnalysis"
+
+namespace InstancingAnalysis
+{
+	static int32 FindRoot(TArray<int32>& Parents, int32 Index)
+	{
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	}
+}
+
+void FInstancingAnalysis::Run(const FWorldPrimitiveSnapshot& Snapshot, const UWorldAnalysisSettings* Settings)
+{
+	using namespace InstancingAnalysis;
+
+	Keys.Reset();
+	Clusters.Reset();
+
+	// 每个组件的 Key 索引, 不参与合批的组件为 INDEX_NONE
+	TArray<int32> PrimitiveKeys;
+	PrimitiveKeys.Init(INDEX_NONE, Snapshot.Num());
+	TMap<FInstancingKey, int32> KeyToIndex;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		if (Snapshot.Types[Index] != EWorldPrimitiveType::StaticMesh)
+		{
+			continue;
+		}
+
+		UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Snapshot.GetComponent(Index));
+		if (!MeshComponent || !MeshComponent->GetStaticMesh())
+		{
+			continue;
+		}
+
+		FInstancingKey Key;
+		Key.StaticMesh = MeshComponent->GetStaticMesh();
+		Key.Mobility = MeshComponent->Mobility;
+		Key.CollisionProfileName = MeshComponent->GetCollisionProfileName();
+		for (int32 MaterialIndex = 0; MaterialIndex < MeshComponent->GetNumMaterials(); ++MaterialIndex)
+		{
+			Key.Materials.Add(MeshComponent->GetMaterial(MaterialIndex));
+		}
+
+		const int32* ExistingIndex = KeyToIndex.Find(Key);
+		PrimitiveKeys[Index] = ExistingIndex ? *ExistingIndex : KeyToIndex.Add(Key, Keys.Add(Key));
+	}
+
+	// 相同 Key 且距离在半径内的组件合并为一组
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(Snapshot.Num());
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		Parents[Index] = Index;
+	}
+
+	TArray<int32> Neighbours;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		if (PrimitiveKeys[Index] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		Neighbours.Reset();
+		Snapshot.BVH.QuerySphere(Snapshot.GetOrigin(Index), Settings->InstancingClusterRadius, Neighbours);
+		for (int32 Neighbour : Neighbours)
+		{
+			if (Neighbour != Index && PrimitiveKeys[Neighbour] == PrimitiveKeys[Index])
+			{
+				Parents[FindRoot(Parents, Neighbour)] = FindRoot(Parents, Index);
+			}
+		}
+	}
+
+	TMap<int32, int32> RootToCluster;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		if (PrimitiveKeys[Index] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 Root = FindRoot(Parents, Index);
+		int32* ClusterIndex = RootToCluster.Find(Root);
+		if (!ClusterIndex)
+		{
+			ClusterIndex = &RootToCluster.Add(Root, Clusters.AddDefaulted());
+			Clusters[*ClusterIndex].KeyIndex = PrimitiveKeys[Index];
+			Clusters[*ClusterIndex].Bounds.Init();
+		}
+		Clusters[*ClusterIndex].Primitives.Add(Index);
+		Clusters[*ClusterIndex].Bounds += Snapshot.GetBox(Index);
+	}
+
+	const int32 MinClusterSize = FMath::Max(Settings->MinInstancingClusterSize, 2);
+	Clusters.RemoveAll([MinClusterSize](const FInstancingCluster& Cluster) { return Cluster.Primitives.Num() < MinClusterSize; });
+
+	for (FInstancingCluster& Cluster : Clusters)
+	{
+		UStaticMesh* StaticMesh = Keys[Cluster.KeyIndex].StaticMesh;
+		const FStaticMeshRenderData* RenderData = StaticMesh->RenderData.Get();
+		const int32 NumLODs = RenderData ? RenderData->LODResources.Num() : 1;
+		Cluster.NumSections = RenderData && NumLODs > 0 ? RenderData->LODResources[0].Sections.Num() : 1;
+		Cluster.DrawCallSavings = (Cluster.Primitives.Num() - 1) * Cluster.NumSections;
+		Cluster.bRecommendHierarchical = NumLODs > 1 || Cluster.Primitives.Num() >= Settings->HierarchicalInstancingClusterSize;
+	}
+
+	// 报告中的组序号用于选择要转换的组, 相同的场景需要得到相同的顺序
+	Clusters.Sort([](const FInstancingCluster& A, const FInstancingCluster& B)
+	{
+		return A.DrawCallSavings != B.DrawCallSavings ? A.DrawCallSavings > B.DrawCallSavings : A.Primitives[0] < B.Primitives[0];
+	});
+}
+
+void FInstancingAnalysis::PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const
+{
+	int32 TotalSavings = 0;
+	for (const FInstancingCluster& Cluster : Clusters)
+	{
+		TotalSavings += Cluster.DrawCallSavings;
+	}
+	Ar.Logf(TEXT("可以合并为实例的组数量: %d, 预计减少 DrawCalls: %d"), Clusters.Num(), TotalSavings);
+
+	for (int32 ClusterIndex = 0; ClusterIndex < Clusters.Num(); ++ClusterIndex)
+	{
+		const FInstancingCluster& Cluster = Clusters[ClusterIndex];
+		const FInstancingKey& Key = Keys[Cluster.KeyIndex];
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== [%d] %s ===="), ClusterIndex, *Key.StaticMesh->GetPathName());
+		Ar.Logf(TEXT("组件数量=%d, Sections=%d, 预计减少 DrawCalls=%d, 范围=%s, 建议使用 %s"),
+			Cluster.Primitives.Num(), Cluster.NumSections, Cluster.DrawCallSavings, *Cluster.Bounds.GetSize().ToString(),
+			Cluster.bRecommendHierarchical ? TEXT("HierarchicalInstancedStaticMeshComponent") : TEXT("InstancedStaticMeshComponent"));
+		for (int32 Index : Cluster.Primitives)
+		{
+			if (UPrimitiveComponent* Component = Snapshot.GetComponent(Index))
+			{
+				Ar.Logf(TEXT("    %s"), *Component->GetFullName());
+			}
+		}
+	}
+}
+
+void FInstancingAnalysis::ConvertClusters(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<int32>& ClusterIndices) const
+{
+	FScopedTransaction Transaction(LOCTEXT("ConvertToInstances", "Convert Static Meshes To Instances"));
+	TSet<int32> ConvertedClusters;
+	for (int32 ClusterIndex : ClusterIndices)
+	{
+		if (!Clusters.IsValidIndex(ClusterIndex))
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Instancing cluster %d does not exist, the report has %d clusters."), ClusterIndex, Clusters.Num());
+			continue;
+		}
+
+		bool bAlreadyConverted = false;
+		ConvertedClusters.Add(ClusterIndex, &bAlreadyConverted);
+		if (bAlreadyConverted)
+		{
+			continue;
+		}
+
+		const FInstancingCluster& Cluster = Clusters[ClusterIndex];
+
+		// 只转换 StaticMeshActor 上的组件, 蓝图等 Actor 上的组件需要手动处理
+		TArray<UStaticMeshComponent*> MeshComponents;
+		for (int32 Index : Cluster.Primitives)
+		{
+			UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Snapshot.GetComponent(Index));
+			if (MeshComponent && MeshComponent->GetOwner() && MeshComponent->GetOwner()->GetClass() == AStaticMeshActor::StaticClass())
+			{
+				MeshComponents.Add(MeshComponent);
+			}
+		}
+
+		if (MeshComponents.Num() < 2)
+		{
+			continue;
+		}
+
+		const FInstancingKey& Key = Keys[Cluster.KeyIndex];
+		ULevel* Level = MeshComponents[0]->GetOwner()->GetLevel();
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.OverrideLevel = Level;
+		AActor* InstanceActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Cluster.Bounds.GetCenter()), SpawnParameters);
+		if (!InstanceActor)
+		{
+			continue;
+		}
+		InstanceActor->SetActorLabel(FString::Printf(TEXT("Instances_%s"), *Key.StaticMesh->GetName()));
+
+		const TSubclassOf<UInstancedStaticMeshComponent> ComponentClass = Cluster.bRecommendHierarchical
+			? UHierarchicalInstancedStaticMeshComponent::StaticClass()
+			: UInstancedStaticMeshComponent::StaticClass();
+		UInstancedStaticMeshComponent* InstancedComponent = NewObject<UInstancedStaticMeshComponent>(InstanceActor, ComponentClass, NAME_None, RF_Transactional);
+		InstancedComponent->SetMobility(Key.Mobility);
+		InstancedComponent->SetWorldTransform(FTransform(Cluster.Bounds.GetCenter()));
+		InstancedComponent->SetStaticMesh(Key.StaticMesh);
+		for (int32 MaterialIndex = 0; MaterialIndex < Key.Materials.Num(); ++MaterialIndex)
+		{
+			InstancedComponent->SetMaterial(MaterialIndex, Key.Materials[MaterialIndex]);
+		}
+		InstancedComponent->SetCollisionProfileName(Key.CollisionProfileName);
+		InstanceActor->SetRootComponent(InstancedComponent);
+		InstanceActor->AddInstanceComponent(InstancedComponent);
+		InstancedComponent->RegisterComponent();
+
+		for (UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			InstancedComponent->AddInstanceWorldSpace(MeshComponent->GetComponentTransform());
+			World->EditorDestroyActor(MeshComponent->GetOwner(), true);
+		}
+
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("Converted %d components of %s to instances (cluster %d)."), MeshComponents.Num(), *Key.StaticMesh->GetName(), ClusterIndex);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+struct FWorldPrimitiveSnapshot;
+class UStaticMesh;
+class UMaterialInterface;
+class UWorldAnalysisSettings;
+
+/** Components can share one instanced component only if all of these match. */
+struct FInstancingKey
+{
+	UStaticMesh* StaticMesh;
+	TArray<UMaterialInterface*> Materials;
+	EComponentMobility::Type Mobility;
+	FName CollisionProfileName;
+
+	bool operator==(const FInstancingKey& Other) const
+	{
+		return StaticMesh == Other.StaticMesh
+			&& Mobility == Other.Mobility
+			&& CollisionProfileName == Other.CollisionProfileName
+			&& Materials == Other.Materials;
+	}
+
+	friend uint32 GetTypeHash(const FInstancingKey& Key)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Key.StaticMesh), GetTypeHash(Key.CollisionProfileName));
+		Hash = HashCombine(Hash, (uint32)Key.Mobility);
+		for (UMaterialInterface* Material : Key.Materials)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Material));
+		}
+		return Hash;
+	}
+};
+
+/** Spatially close static mesh components with the same instancing key. */
+struct FInstancingCluster
+{
+	int32 KeyIndex;
+
+	/** Snapshot indices of the components. */
+	TArray<int32> Primitives;
+
+	FBox Bounds;
+
+	/** Draw calls of one component, the sections of LOD0. */
+	int32 NumSections;
+
+	/** Draw calls saved by drawing the cluster as one instanced component. */
+	int32 DrawCallSavings;
+
+	/** Meshes with LODs or big clusters should use HISM so instances can be culled and LODed separately. */
+	bool bRecommendHierarchical;
+};
+
+/**
+ * Finds plain static mesh components that could be drawn as instances: components are grouped by
+ * mesh, materials, mobility and collision profile, then linked to same group neighbours within the
+ * cluster radius through the snapshot BVH.
+ */
+class FInstancingAnalysis
+{
+public:
+	void Run(const FWorldPrimitiveSnapshot& Snapshot, const UWorldAnalysisSettings* Settings);
+
+	void PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const;
+
+	/**
+	 * Replaces each of the given clusters, by their index in the report, with one actor with an ISM / HISM
+	 * component in one undoable transaction. Only components of plain static mesh actors are converted,
+	 * the others are left in place.
+	 */
+	void ConvertClusters(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<int32>& ClusterIndices) const;
+
+	const TArray<FInstancingCluster>& GetClusters() const { return Clusters; }
+
+private:
+	TArray<FInstancingKey> Keys;
+	TArray<FInstancingCluster> Clusters;
+};
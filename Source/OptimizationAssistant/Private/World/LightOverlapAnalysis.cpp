@@ -0,0 +1,248 @@
+#include "World/LightOverlapAnalysis.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "UObject/UObjectIterator.h"
+#include "Engine/World.h"
+#include "Components/LocalLightComponent.h"
+#include "Components/SpotLightComponent.h"
+#include "Components/DirectionalLightComponent.h"
+#include "Widgets/Lights/LightAuditSettings.h"
+#include "OptimizationAssistantHelpers.h"
+
+void FLightOverlapAnalysis::Run(UWorld* World, const ULightAuditSettings* Settings)
+{
+	static const int32 MaxCells = 4 * 1024 * 1024;
+
+	Lights.Reset();
+	OverlapCounts.Reset();
+	OverlapCosts.Reset();
+	Hotspots.Reset();
+	NumStaticLights = 0;
+	NumDirectionalLights = 0;
+	MaxOverlappingLights = Settings->MaxOverlappingLights;
+
+	for (TObjectIterator<ULightComponent> It; It; ++It)
+	{
+		ULightComponent* LightComponent = *It;
+		if (LightComponent->GetWorld() != World || !LightComponent->IsRegistered() || !LightComponent->IsVisible() || LightComponent->IsEditorOnly())
+		{
+			continue;
+		}
+
+		if (LightComponent->Mobility == EComponentMobility::Static)
+		{
+			// 静态光源已经烘焙, 不参与延迟渲染的逐像素光照
+			++NumStaticLights;
+			continue;
+		}
+
+		if (LightComponent->IsA<UDirectionalLightComponent>())
+		{
+			++NumDirectionalLights;
+			continue;
+		}
+
+		ULocalLightComponent* LocalLight = Cast<ULocalLightComponent>(LightComponent);
+		if (!LocalLight || LocalLight->AttenuationRadius <= 0.0f)
+		{
+			continue;
+		}
+
+		FLightAuditEntry& Entry = Lights.AddDefaulted_GetRef();
+		Entry.Light = LocalLight;
+		Entry.Position = LocalLight->GetComponentLocation();
+		Entry.Radius = LocalLight->AttenuationRadius;
+		Entry.Direction = LocalLight->GetDirection();
+		Entry.bMovable = LocalLight->Mobility == EComponentMobility::Movable;
+		Entry.bDynamicShadow = LocalLight->CastShadows && LocalLight->CastDynamicShadows;
+		Entry.NumCells = 0;
+
+		USpotLightComponent* SpotLight = Cast<USpotLightComponent>(LocalLight);
+		Entry.bSpotLight = SpotLight != nullptr;
+		Entry.CosOuterCone = SpotLight ? FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(SpotLight->OuterConeAngle, 1.0f, 89.0f))) : -1.0f;
+
+		// 可移动光源的阴影每帧都要重新渲染, 固定光源只投影动态物体的阴影
+		Entry.CostWeight = 1.0f;
+		if (Entry.bDynamicShadow)
+		{
+			Entry.CostWeight += Entry.bMovable ? Settings->MovableShadowCost : Settings->StationaryShadowCost;
+		}
+	}
+
+	if (Lights.Num() == 0)
+	{
+		return;
+	}
+
+	FBox Bounds(ForceInit);
+	for (const FLightAuditEntry& Entry : Lights)
+	{
+		Bounds += FBox::BuildAABB(Entry.Position, FVector(Entry.Radius));
+	}
+
+	// 格子数量有上限, 光源范围很大时自动放大格子
+	const FVector Size = Bounds.GetSize();
+	CellSize = FMath::Max(Settings->LightGridCellSize, 10.0f);
+	CellSize = FMath::Max(CellSize, FMath::Pow(Size.X * Size.Y * Size.Z / MaxCells, 1.0f / 3.0f));
+	Origin = Bounds.Min;
+	NumX = FMath::Max(FMath::CeilToInt(Size.X / CellSize), 1);
+	NumY = FMath::Max(FMath::CeilToInt(Size.Y / CellSize), 1);
+	NumZ = FMath::Max(FMath::CeilToInt(Size.Z / CellSize), 1);
+	OverlapCounts.SetNumZeroed(NumX * NumY * NumZ);
+	OverlapCosts.SetNumZeroed(NumX * NumY * NumZ);
+
+	TArray<FIntVector> LightMinCells;
+	TArray<FIntVector> LightMaxCells;
+	for (const FLightAuditEntry& Entry : Lights)
+	{
+		const FVector Min = (Entry.Position - Entry.Radius - Origin) / CellSize;
+		const FVector Max = (Entry.Position + Entry.Radius - Origin) / CellSize;
+		LightMinCells.Add(FIntVector(FMath::Max(FMath::FloorToInt(Min.X), 0), FMath::Max(FMath::FloorToInt(Min.Y), 0), FMath::Max(FMath::FloorToInt(Min.Z), 0)));
+		LightMaxCells.Add(FIntVector(FMath::Min(FMath::FloorToInt(Max.X), NumX - 1), FMath::Min(FMath::FloorToInt(Max.Y), NumY - 1), FMath::Min(FMath::FloorToInt(Max.Z), NumZ - 1)));
+	}
+
+	// 每个任务负责一层 Z, 写入互不重叠
+	TArray<int32> LightCells;
+	LightCells.SetNumZeroed(Lights.Num() * NumZ);
+	ParallelFor(NumZ, [this, &LightMinCells, &LightMaxCells, &LightCells](int32 Z)
+	{
+		for (int32 LightIndex = 0; LightIndex < Lights.Num(); ++LightIndex)
+		{
+			const FIntVector& MinCell = LightMinCells[LightIndex];
+			const FIntVector& MaxCell = LightMaxCells[LightIndex];
+			if (Z < MinCell.Z || Z > MaxCell.Z)
+			{
+				continue;
+			}
+
+			const FLightAuditEntry& Entry = Lights[LightIndex];
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+				{
+					const int32 CellIndex = (Z * NumY + Y) * NumX + X;
+					if (ContainsPoint(Entry, GetCellCenter(CellIndex)))
+					{
+						OverlapCounts[CellIndex] = (uint8)FMath::Min(OverlapCounts[CellIndex] + 1, 255);
+						OverlapCosts[CellIndex] += Entry.CostWeight;
+						++LightCells[LightIndex * NumZ + Z];
+					}
+				}
+			}
+		}
+	});
+
+	for (int32 LightIndex = 0; LightIndex < Lights.Num(); ++LightIndex)
+	{
+		for (int32 Z = 0; Z < NumZ; ++Z)
+		{
+			Lights[LightIndex].NumCells += LightCells[LightIndex * NumZ + Z];
+		}
+	}
+
+	for (int32 CellIndex = 0; CellIndex < OverlapCounts.Num(); ++CellIndex)
+	{
+		if (OverlapCounts[CellIndex] > MaxOverlappingLights)
+		{
+			Hotspots.Add({ CellIndex, OverlapCounts[CellIndex], OverlapCosts[CellIndex] });
+		}
+	}
+	Hotspots.Sort([](const FLightHotspot& A, const FLightHotspot& B) { return A.Cost > B.Cost; });
+}
+
+bool FLightOverlapAnalysis::ContainsPoint(const FLightAuditEntry& Entry, const FVector& Point) const
+{
+	const FVector ToPoint = Point - Entry.Position;
+	const float DistanceSquared = ToPoint.SizeSquared();
+	if (DistanceSquared > FMath::Square(Entry.Radius))
+	{
+		return false;
+	}
+
+	if (!Entry.bSpotLight || DistanceSquared < KINDA_SMALL_NUMBER)
+	{
+		return true;
+	}
+	return FVector::DotProduct(ToPoint, Entry.Direction) >= Entry.CosOuterCone * FMath::Sqrt(DistanceSquared);
+}
+
+void FLightOverlapAnalysis::PrintReport(int32 NumHotspotsToList, FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("动态局部光源: %d, 静态光源: %d, 非静态方向光: %d (每个像素都要计算)"), Lights.Num(), NumStaticLights, NumDirectionalLights);
+	if (Lights.Num() == 0)
+	{
+		return;
+	}
+
+	int32 OccupiedCells = 0;
+	float TotalCost = 0.0f;
+	float MaxCost = 0.0f;
+	for (int32 CellIndex = 0; CellIndex < OverlapCounts.Num(); ++CellIndex)
+	{
+		if (OverlapCounts[CellIndex] > 0)
+		{
+			++OccupiedCells;
+			TotalCost += OverlapCosts[CellIndex];
+			MaxCost = FMath::Max(MaxCost, OverlapCosts[CellIndex]);
+		}
+	}
+
+	Ar.Logf(TEXT("格子大小: %.0f, 格子数量: %d x %d x %d, 有光照的格子: %d"), CellSize, NumX, NumY, NumZ, OccupiedCells);
+	Ar.Logf(TEXT("逐像素光照开销(光源权重之和): 平均=%.2f, 最大=%.2f"), OccupiedCells > 0 ? TotalCost / OccupiedCells : 0.0f, MaxCost);
+	Ar.Logf(TEXT("超过 %d 个动态光源重叠的格子: %d (体积 %.1f m^3)"), MaxOverlappingLights, Hotspots.Num(), Hotspots.Num() * FMath::Pow(CellSize / 100.0f, 3.0f));
+
+	TArray<int32> CellLights;
+	for (int32 Rank = 0; Rank < FMath::Min(NumHotspotsToList, Hotspots.Num()); ++Rank)
+	{
+		const FLightHotspot& Hotspot = Hotspots[Rank];
+		const FVector Center = GetCellCenter(Hotspot.CellIndex);
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== 热点[%d] 位置=%s 光源数量=%d 开销=%.2f ===="), Rank, *Center.ToString(), Hotspot.NumLights, Hotspot.Cost);
+		for (const FLightAuditEntry& Entry : Lights)
+		{
+			ULocalLightComponent* Light = Entry.Light.Get();
+			if (Light && ContainsPoint(Entry, Center))
+			{
+				Ar.Logf(TEXT("    %s"), *Light->GetFullName());
+			}
+		}
+	}
+
+	// 按影响的体积乘以权重排序, 越靠前对整体开销贡献越大
+	TArray<const FLightAuditEntry*> SortedLights;
+	for (const FLightAuditEntry& Entry : Lights)
+	{
+		SortedLights.Add(&Entry);
+	}
+	SortedLights.Sort([](const FLightAuditEntry& A, const FLightAuditEntry& B) { return A.NumCells * A.CostWeight > B.NumCells * B.CostWeight; });
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("==== 光源 ===="));
+	for (const FLightAuditEntry* Entry : SortedLights)
+	{
+		ULocalLightComponent* Light = Entry->Light.Get();
+		if (!Light)
+		{
+			continue;
+		}
+
+		Ar.Logf(TEXT("%s"), *Light->GetFullName());
+		Ar.Logf(TEXT("    %s %s Radius=%.0f CastShadows=%d CastDynamicShadows=%d ShadowResolutionScale=%.2f 权重=%.2f 影响格子=%d"),
+			Entry->bSpotLight ? TEXT("Spot") : TEXT("Point"), Entry->bMovable ? TEXT("Movable") : TEXT("Stationary"), Entry->Radius,
+			Light->CastShadows ? 1 : 0, Light->CastDynamicShadows ? 1 : 0, Light->ShadowResolutionScale, Entry->CostWeight, Entry->NumCells);
+	}
+}
+
+bool FLightOverlapAnalysis::SaveHotspotsCSV(const FString& Filename) const
+{
+	FString Csv = TEXT("CellX,CellY,CellZ,X,Y,Z,Lights,Cost\n");
+	for (const FLightHotspot& Hotspot : Hotspots)
+	{
+		const FVector Center = GetCellCenter(Hotspot.CellIndex);
+		const int32 X = Hotspot.CellIndex % NumX;
+		const int32 Y = (Hotspot.CellIndex / NumX) % NumY;
+		const int32 Z = Hotspot.CellIndex / (NumX * NumY);
+		Csv += FString::Printf(TEXT("%d,%d,%d,%.0f,%.0f,%.0f,%d,%.2f\n"), X, Y, Z, Center.X, Center.Y, Center.Z, Hotspot.NumLights, Hotspot.Cost);
+	}
+	return FFileHelper::SaveStringToFile(Csv, *Filename);
+}
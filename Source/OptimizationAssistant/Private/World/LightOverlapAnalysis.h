@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ULocalLightComponent;
+class ULightAuditSettings;
+
+/** Influence volume and shadow settings of one point or spot light. */
+struct FLightAuditEntry
+{
+	TWeakObjectPtr<ULocalLightComponent> Light;
+
+	FVector Position;
+	float Radius;
+
+	/** Spot lights only, cos of the outer cone angle, -1 for point lights. */
+	FVector Direction;
+	float CosOuterCone;
+
+	bool bSpotLight;
+	bool bMovable;
+	bool bDynamicShadow;
+
+	/** Per pixel cost weight: 1 for the lighting plus the shadow projection when shadowed. */
+	float CostWeight;
+
+	/** Grid cells inside the influence volume. */
+	int32 NumCells;
+};
+
+/** A cell where more dynamic lights overlap than the budget. */
+struct FLightHotspot
+{
+	int32 CellIndex;
+	int32 NumLights;
+	float Cost;
+};
+
+/**
+ * Rasterizes the attenuation spheres and cones of the movable and stationary local lights of a
+ * world into a 3D grid of overlap counts, one Z slice per task, and reports the cells where more
+ * lights overlap than the budget together with the estimated per pixel lighting cost.
+ */
+class FLightOverlapAnalysis
+{
+public:
+	FLightOverlapAnalysis() : NumX(0), NumY(0), NumZ(0), CellSize(0.0f), NumStaticLights(0), NumDirectionalLights(0) {}
+
+	void Run(UWorld* World, const ULightAuditSettings* Settings);
+
+	void PrintReport(int32 NumHotspotsToList, FOutputDevice& Ar) const;
+
+	/** One line per hotspot cell: grid and world position, light count and cost. */
+	bool SaveHotspotsCSV(const FString& Filename) const;
+
+private:
+	bool ContainsPoint(const FLightAuditEntry& Entry, const FVector& Point) const;
+
+	FVector GetCellCenter(int32 CellIndex) const
+	{
+		const int32 X = CellIndex % NumX;
+		const int32 Y = (CellIndex / NumX) % NumY;
+		const int32 Z = CellIndex / (NumX * NumY);
+		return Origin + (FVector(X, Y, Z) + 0.5f) * CellSize;
+	}
+
+	TArray<FLightAuditEntry> Lights;
+
+	/** Overlapping dynamic lights and summed cost weights of every cell, X fastest then Y then Z. */
+	TArray<uint8> OverlapCounts;
+	TArray<float> OverlapCosts;
+
+	TArray<FLightHotspot> Hotspots;
+
+	int32 NumX;
+	int32 NumY;
+	int32 NumZ;
+	float CellSize;
+	FVector Origin;
+
+	int32 NumStaticLights;
+	int32 NumDirectionalLights;
+	int32 MaxOverlappingLights;
+};
@@ -0,0 +1,255 @@
+#include "World/MeshMergeAnalysis.h"
+#include "ScopedTransaction.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/MeshMerging.h"
+#include "Engine/World.h"
+#include "Components/StaticMeshComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "StaticMeshResources.h"
+#include "MeshMergeModule.h"
+#include "IMeshMergeUtilities.h"
+#include "AssetRegistryModule.h"
+#include "AssetToolsModule.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "Classes/EditorStaticMesh.h"
+#include "Widgets/World/WorldAnalysisSettings.h"
+#include "OptimizationAssistantHelpers.h"
+
+#define LOCTEXT_NAMESPACE "MeshMergeAnalysis"
+
+namespace MeshMergeAnalysis
+{
+	/** Vertex and index buffer bytes of LOD0, what a copy of the mesh adds to a merged mesh. */
+	static int64 GetLOD0Bytes(const UStaticMesh* StaticMesh)
+	{
+		FStaticMeshLODMemory LODMemory;
+		FStaticMeshLODMemory::Compute(StaticMesh, 0, LODMemory);
+		return LODMemory.GetGPUBytes() - LODMemory.DistanceFieldBytes;
+	}
+}
+
+void FMeshMergeAnalysis::Run(const FWorldPrimitiveSnapshot& Snapshot, const UWorldAnalysisSettings* Settings)
+{
+	Candidates.Reset();
+
+	// 每个可合并组件的材质混合模式, 混合模式不同的组件不能放在一起
+	TArray<int32> BlendModes;
+	TArray<int32> Seeds;
+	BlendModes.Init(INDEX_NONE, Snapshot.Num());
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		if (Snapshot.Types[Index] != EWorldPrimitiveType::StaticMesh || Snapshot.SphereRadius[Index] * 2.0f > Settings->MergeMaxComponentSize)
+		{
+			continue;
+		}
+
+		UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Snapshot.GetComponent(Index));
+		if (!MeshComponent || !MeshComponent->GetStaticMesh() || MeshComponent->Mobility != EComponentMobility::Static)
+		{
+			continue;
+		}
+
+		int32 BlendMode = INDEX_NONE;
+		for (int32 MaterialIndex = 0; MaterialIndex < MeshComponent->GetNumMaterials(); ++MaterialIndex)
+		{
+			UMaterialInterface* Material = MeshComponent->GetMaterial(MaterialIndex);
+			const int32 MaterialBlendMode = Material ? (int32)Material->GetBlendMode() : (int32)BLEND_Opaque;
+			if (BlendMode != INDEX_NONE && BlendMode != MaterialBlendMode)
+			{
+				// 自身材质混合模式不一致的组件不参与合并
+				BlendMode = INDEX_NONE;
+				break;
+			}
+			BlendMode = MaterialBlendMode;
+		}
+
+		if (BlendMode != INDEX_NONE)
+		{
+			BlendModes[Index] = BlendMode;
+			Seeds.Add(Index);
+		}
+	}
+
+	// 从最大的组件开始, 把半径内未分配的兼容组件归为一组
+	// 报告中的组序号用于选择要合并的组, 排序要稳定
+	Seeds.Sort([&Snapshot](int32 A, int32 B)
+	{
+		return Snapshot.SphereRadius[A] != Snapshot.SphereRadius[B] ? Snapshot.SphereRadius[A] > Snapshot.SphereRadius[B] : A < B;
+	});
+	TBitArray<> Assigned(false, Snapshot.Num());
+	TArray<int32> Neighbours;
+	for (int32 Seed : Seeds)
+	{
+		if (Assigned[Seed])
+		{
+			continue;
+		}
+
+		Neighbours.Reset();
+		Snapshot.BVH.QuerySphere(Snapshot.GetOrigin(Seed), Settings->MergeClusterRadius, Neighbours);
+		Neighbours.RemoveAll([&](int32 Index) { return Assigned[Index] || BlendModes[Index] != BlendModes[Seed]; });
+		if (Neighbours.Num() < FMath::Max(Settings->MinMergeClusterSize, 2))
+		{
+			continue;
+		}
+
+		FMeshMergeCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+		Candidate.Bounds.Init();
+		Candidate.NumSections = 0;
+		Candidate.SourceBytes = 0;
+		Candidate.MergedBytes = 0;
+
+		TSet<UMaterialInterface*> Materials;
+		TSet<UStaticMesh*> Meshes;
+		for (int32 Index : Neighbours)
+		{
+			Assigned[Index] = true;
+			Candidate.Primitives.Add(Index);
+			Candidate.Bounds += Snapshot.GetBox(Index);
+
+			UStaticMeshComponent* MeshComponent = CastChecked<UStaticMeshComponent>(Snapshot.GetComponent(Index));
+			UStaticMesh* StaticMesh = MeshComponent->GetStaticMesh();
+			const FStaticMeshRenderData* RenderData = StaticMesh->RenderData.Get();
+			if (RenderData && RenderData->LODResources.Num() > 0)
+			{
+				for (const FStaticMeshSection& Section : RenderData->LODResources[0].Sections)
+				{
+					Materials.Add(MeshComponent->GetMaterial(Section.MaterialIndex));
+					++Candidate.NumSections;
+				}
+			}
+
+			const int64 MeshBytes = MeshMergeAnalysis::GetLOD0Bytes(StaticMesh);
+			Candidate.MergedBytes += MeshBytes;
+			if (!Meshes.Contains(StaticMesh))
+			{
+				Meshes.Add(StaticMesh);
+				Candidate.SourceBytes += MeshBytes;
+			}
+		}
+		Candidate.NumMergedSections = Materials.Num();
+	}
+
+	Candidates.RemoveAll([](const FMeshMergeCandidate& Candidate) { return Candidate.GetDrawCallSavings() <= 0; });
+	Candidates.Sort([](const FMeshMergeCandidate& A, const FMeshMergeCandidate& B)
+	{
+		return A.GetDrawCallSavings() != B.GetDrawCallSavings() ? A.GetDrawCallSavings() > B.GetDrawCallSavings() : A.Primitives[0] < B.Primitives[0];
+	});
+}
+
+void FMeshMergeAnalysis::PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const
+{
+	int32 TotalSavings = 0;
+	int64 TotalMemoryDelta = 0;
+	for (const FMeshMergeCandidate& Candidate : Candidates)
+	{
+		TotalSavings += Candidate.GetDrawCallSavings();
+		TotalMemoryDelta += Candidate.MergedBytes - Candidate.SourceBytes;
+	}
+	Ar.Logf(TEXT("建议合并的组数量: %d, 预计减少 DrawCalls: %d, 显存变化: %+.2f MB"), Candidates.Num(), TotalSavings, TotalMemoryDelta / (1024.0 * 1024.0));
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Candidates.Num(); ++CandidateIndex)
+	{
+		const FMeshMergeCandidate& Candidate = Candidates[CandidateIndex];
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== [%d] 中心=%s 范围=%s ===="), CandidateIndex, *Candidate.Bounds.GetCenter().ToString(), *Candidate.Bounds.GetSize().ToString());
+		Ar.Logf(TEXT("组件数量=%d, DrawCalls %d -> %d, 显存 %.1f KB -> %.1f KB"),
+			Candidate.Primitives.Num(), Candidate.NumSections, Candidate.NumMergedSections, Candidate.SourceBytes / 1024.0, Candidate.MergedBytes / 1024.0);
+		for (int32 Index : Candidate.Primitives)
+		{
+			if (UPrimitiveComponent* Component = Snapshot.GetComponent(Index))
+			{
+				Ar.Logf(TEXT("    %s"), *Component->GetFullName());
+			}
+		}
+	}
+}
+
+void FMeshMergeAnalysis::MergeCandidates(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<int32>& CandidateIndices, const FString& PackagePath) const
+{
+	const IMeshMergeUtilities& MeshMergeUtilities = FModuleManager::Get().LoadModuleChecked<IMeshMergeModule>("MeshMergeUtilities").GetUtilities();
+	IAssetTools& AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+
+	// 保留每个材质的 Section, 不烘焙材质, 合并结果和源组件的显示一致
+	FMeshMergingSettings MergeSettings;
+	MergeSettings.bMergeMaterials = false;
+	MergeSettings.bPivotPointAtZero = false;
+	MergeSettings.LODSelectionType = EMeshLODSelectionType::AllLODs;
+
+	FScopedTransaction Transaction(LOCTEXT("MergeMeshCandidates", "Merge Mesh Candidates"));
+	TSet<int32> MergedCandidates;
+	for (int32 CandidateIndex : CandidateIndices)
+	{
+		if (!Candidates.IsValidIndex(CandidateIndex))
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Mesh merge candidate %d does not exist, the report has %d candidates."), CandidateIndex, Candidates.Num());
+			continue;
+		}
+
+		bool bAlreadyMerged = false;
+		MergedCandidates.Add(CandidateIndex, &bAlreadyMerged);
+		if (bAlreadyMerged)
+		{
+			continue;
+		}
+
+		const FMeshMergeCandidate& Candidate = Candidates[CandidateIndex];
+		TArray<UPrimitiveComponent*> ComponentsToMerge;
+		TArray<AActor*> SourceActors;
+		for (int32 Index : Candidate.Primitives)
+		{
+			UPrimitiveComponent* Component = Snapshot.GetComponent(Index);
+			AActor* Owner = Component ? Component->GetOwner() : nullptr;
+			if (Owner && Owner->GetClass() == AStaticMeshActor::StaticClass())
+			{
+				ComponentsToMerge.Add(Component);
+				SourceActors.Add(Owner);
+			}
+		}
+
+		if (ComponentsToMerge.Num() < 2)
+		{
+			continue;
+		}
+
+		// 重复合并时不能覆盖之前生成的资源
+		FString PackageName;
+		FString AssetName;
+		AssetTools.CreateUniqueAssetName(FString::Printf(TEXT("%s/SM_Merged_%s"), *PackagePath, *World->GetName()), TEXT(""), PackageName, AssetName);
+		TArray<UObject*> CreatedAssets;
+		FVector MergedActorLocation;
+		MeshMergeUtilities.MergeComponentsToStaticMesh(ComponentsToMerge, World, MergeSettings, nullptr, nullptr, PackageName, CreatedAssets, MergedActorLocation, TNumericLimits<float>::Max(), true);
+
+		UStaticMesh* MergedMesh = nullptr;
+		for (UObject* Asset : CreatedAssets)
+		{
+			FAssetRegistryModule::AssetCreated(Asset);
+			MergedMesh = MergedMesh ? MergedMesh : Cast<UStaticMesh>(Asset);
+		}
+
+		if (!MergedMesh)
+		{
+			UE_LOG(LogOptimizationAssistant, Warning, TEXT("Failed to merge candidate %d."), CandidateIndex);
+			continue;
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.OverrideLevel = SourceActors[0]->GetLevel();
+		AStaticMeshActor* MergedActor = World->SpawnActor<AStaticMeshActor>(MergedActorLocation, FRotator::ZeroRotator, SpawnParameters);
+		if (!MergedActor)
+		{
+			continue;
+		}
+		MergedActor->GetStaticMeshComponent()->SetStaticMesh(MergedMesh);
+		MergedActor->SetActorLabel(MergedMesh->GetName());
+
+		for (AActor* SourceActor : SourceActors)
+		{
+			World->EditorDestroyActor(SourceActor, true);
+		}
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("Merged %d actors into %s."), SourceActors.Num(), *PackageName);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
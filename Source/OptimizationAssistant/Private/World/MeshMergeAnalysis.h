@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWorldPrimitiveSnapshot;
+class UWorldAnalysisSettings;
+
+/** Small static components close to each other that could be merged into one mesh. */
+struct FMeshMergeCandidate
+{
+	/** Snapshot indices of the components. */
+	TArray<int32> Primitives;
+
+	FBox Bounds;
+
+	/** Draw calls now, the LOD0 sections of every component. */
+	int32 NumSections;
+
+	/** Draw calls of the merged mesh, one section per unique material. */
+	int32 NumMergedSections;
+
+	/** GPU bytes of the distinct meshes now and of the merged mesh, merging duplicates of one mesh costs memory. */
+	int64 SourceBytes;
+	int64 MergedBytes;
+
+	int32 GetDrawCallSavings() const { return NumSections - NumMergedSections; }
+};
+
+/**
+ * Finds tight groups of small static mobility static mesh components whose materials use the same
+ * blend mode, grown greedily around the biggest remaining component with sphere queries against
+ * the snapshot BVH. Candidates can be merged in batch with the engine mesh merge utilities.
+ */
+class FMeshMergeAnalysis
+{
+public:
+	void Run(const FWorldPrimitiveSnapshot& Snapshot, const UWorldAnalysisSettings* Settings);
+
+	void PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const;
+
+	/**
+	 * Merges the candidates at CandidateIndices with IMeshMergeUtilities::MergeComponentsToStaticMesh into new
+	 * uniquely named assets under PackagePath and replaces the source actors, only plain static mesh actors are merged.
+	 */
+	void MergeCandidates(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<int32>& CandidateIndices, const FString& PackagePath) const;
+
+	const TArray<FMeshMergeCandidate>& GetCandidates() const { return Candidates; }
+
+private:
+	TArray<FMeshMergeCandidate> Candidates;
+};
@@ -0,0 +1,252 @@
+#include "World/ReplicationRelevancyAnalysis.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "OptimizationAssistantGlobalSettings.h"
+#include "Widgets/World/WorldAnalysisSettings.h"
+#include "OptimizationAssistantHelpers.h"
+
+namespace ReplicationRelevancyAnalysis
+{
+	static int32 GetPercentile(TArray<int32> Values, float Percentile)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0;
+		}
+		Values.Sort();
+		return Values[FMath::Clamp(FMath::CeilToInt(Percentile * Values.Num()) - 1, 0, Values.Num() - 1)];
+	}
+
+	static int32 GetMax(const TArray<int32>& Values)
+	{
+		int32 Result = 0;
+		for (int32 Value : Values)
+		{
+			Result = FMath::Max(Result, Value);
+		}
+		return Result;
+	}
+}
+
+void FReplicationRelevancyAnalysis::Run(UWorld* World, const TArray<FVector>& ClientPositions, const UGlobalCheckSettings* GlobalCheckSettings, const UWorldAnalysisSettings* Settings)
+{
+	Clients = ClientPositions;
+	ActorLocations.Reset();
+	ActorNetCullDistanceSquared.Reset();
+	ActorClasses.Reset();
+	SpatialHash.Reset();
+	Classes.Reset();
+	NumAlwaysRelevant = 0;
+	NumConnections = Settings->ReplicationConnections;
+	RelevantActorBudget = Settings->RelevantActorBudget;
+	RelevancyChecksPerSecond = 0.0f;
+
+	TMap<UClass*, int32> ClassToIndex;
+	float MaxCullDistanceSquared = 0.0f;
+	for (FActorIterator ActorIterator(World); ActorIterator; ++ActorIterator)
+	{
+		AActor* Actor = *ActorIterator;
+		if (!Actor->GetIsReplicated() || Actor->IsEditorOnly() || Actor->ActorHasTag(GlobalCheckSettings->DisableCheckTagName))
+		{
+			continue;
+		}
+
+		if (GlobalCheckSettings->IsInNeverCheckDirectory(Actor->GetFullName()))
+		{
+			continue;
+		}
+
+		// 服务器每次检查 Actor 时都要对每个连接判断一次相关性
+		RelevancyChecksPerSecond += FMath::Min(Actor->NetUpdateFrequency, Settings->ReplicationServerTickRate);
+
+		if (Actor->bAlwaysRelevant)
+		{
+			++NumAlwaysRelevant;
+			continue;
+		}
+
+		// 只对 Owner 相关或使用 Owner 相关性的 Actor 不按距离判断
+		if (Actor->bOnlyRelevantToOwner || Actor->bNetUseOwnerRelevancy)
+		{
+			continue;
+		}
+
+		int32* ClassIndex = ClassToIndex.Find(Actor->GetClass());
+		if (!ClassIndex)
+		{
+			ClassIndex = &ClassToIndex.Add(Actor->GetClass(), Classes.AddDefaulted());
+			FReplicatedClassStats& ClassStats = Classes[*ClassIndex];
+			ClassStats.Class = Actor->GetClass();
+			ClassStats.NumActors = 0;
+			ClassStats.NetCullDistanceSquared = 0.0f;
+			ClassStats.MaxRelevant = 0;
+		}
+
+		FReplicatedClassStats& ClassStats = Classes[*ClassIndex];
+		++ClassStats.NumActors;
+		ClassStats.NetCullDistanceSquared = FMath::Max(ClassStats.NetCullDistanceSquared, Actor->NetCullDistanceSquared);
+
+		ActorLocations.Add(Actor->GetActorLocation());
+		ActorNetCullDistanceSquared.Add(Actor->NetCullDistanceSquared);
+		ActorClasses.Add(*ClassIndex);
+		MaxCullDistanceSquared = FMath::Max(MaxCullDistanceSquared, Actor->NetCullDistanceSquared);
+	}
+
+	HashCellSize = FMath::Max(FMath::Sqrt(MaxCullDistanceSquared), 100.0f);
+	for (int32 ActorIndex = 0; ActorIndex < ActorLocations.Num(); ++ActorIndex)
+	{
+		SpatialHash.FindOrAdd(GetHashCell(ActorLocations[ActorIndex])).Add(ActorIndex);
+	}
+
+	TArray<int32> ClassMaxRelevant;
+	CountRelevant(TArray<float>(), CurrentCounts, &ClassMaxRelevant);
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		Classes[ClassIndex].MaxRelevant = ClassMaxRelevant[ClassIndex];
+	}
+
+	MinNetCullDistance = Settings->MinNetCullDistance;
+	MaxNetCullDistance = FMath::Sqrt(GlobalCheckSettings->MaxNetCullDistanceSquared);
+
+	// 相关 Actor 数量随距离缩放单调变化, 二分查找满足预算的最大缩放
+	// 每一步都使用取整和限制后的建议值计数, 报告的建议数量就是建议值的结果
+	TArray<float> RecommendDistancesSquared;
+	RecommendScale = 1.0f;
+	ComputeRecommendDistances(RecommendScale, RecommendDistancesSquared);
+	CountRelevant(RecommendDistancesSquared, RecommendCounts, nullptr);
+	if (ReplicationRelevancyAnalysis::GetMax(RecommendCounts) > RelevantActorBudget)
+	{
+		float Low = 0.0f;
+		float High = 1.0f;
+		TArray<int32> Counts;
+		for (int32 Iteration = 0; Iteration < 16; ++Iteration)
+		{
+			const float Scale = (Low + High) * 0.5f;
+			ComputeRecommendDistances(Scale, RecommendDistancesSquared);
+			CountRelevant(RecommendDistancesSquared, Counts, nullptr);
+			if (ReplicationRelevancyAnalysis::GetMax(Counts) > RelevantActorBudget)
+			{
+				High = Scale;
+			}
+			else
+			{
+				Low = Scale;
+			}
+		}
+		RecommendScale = Low;
+		ComputeRecommendDistances(RecommendScale, RecommendDistancesSquared);
+		CountRelevant(RecommendDistancesSquared, RecommendCounts, nullptr);
+	}
+
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		Classes[ClassIndex].RecommendNetCullDistanceSquared = RecommendDistancesSquared[ClassIndex];
+	}
+
+	Classes.Sort([](const FReplicatedClassStats& A, const FReplicatedClassStats& B) { return A.MaxRelevant > B.MaxRelevant; });
+}
+
+void FReplicationRelevancyAnalysis::ComputeRecommendDistances(float DistanceScale, TArray<float>& OutClassNetCullDistanceSquared) const
+{
+	OutClassNetCullDistanceSquared.SetNumUninitialized(Classes.Num());
+	for (int32 ClassIndex = 0; ClassIndex < Classes.Num(); ++ClassIndex)
+	{
+		const float NetCullDistanceSquared = Classes[ClassIndex].NetCullDistanceSquared;
+		float Distance = FMath::Min(FMath::Sqrt(NetCullDistanceSquared), MaxNetCullDistance) * DistanceScale;
+		Distance = FMath::Max(FMath::CeilToFloat(Distance / 100.0f) * 100.0f, MinNetCullDistance);
+		OutClassNetCullDistanceSquared[ClassIndex] = FMath::Min(FMath::Square(Distance), NetCullDistanceSquared);
+	}
+}
+
+void FReplicationRelevancyAnalysis::CountRelevant(const TArray<float>& ClassNetCullDistanceSquared, TArray<int32>& OutCounts, TArray<int32>* OutClassMaxRelevant) const
+{
+	OutCounts.SetNumZeroed(Clients.Num());
+	TArray<TArray<int32>> ClassCounts;
+	if (OutClassMaxRelevant)
+	{
+		ClassCounts.SetNum(Clients.Num());
+	}
+
+	ParallelFor(Clients.Num(), [this, &ClassNetCullDistanceSquared, &OutCounts, &ClassCounts, OutClassMaxRelevant](int32 ClientIndex)
+	{
+		const FVector& Client = Clients[ClientIndex];
+		const FIntPoint Cell = GetHashCell(Client);
+		TArray<int32>* PerClass = OutClassMaxRelevant ? &ClassCounts[ClientIndex] : nullptr;
+		if (PerClass)
+		{
+			PerClass->SetNumZeroed(Classes.Num());
+		}
+
+		int32 Count = NumAlwaysRelevant;
+		for (int32 OffsetY = -1; OffsetY <= 1; ++OffsetY)
+		{
+			for (int32 OffsetX = -1; OffsetX <= 1; ++OffsetX)
+			{
+				const TArray<int32>* Actors = SpatialHash.Find(FIntPoint(Cell.X + OffsetX, Cell.Y + OffsetY));
+				if (!Actors)
+				{
+					continue;
+				}
+
+				for (int32 ActorIndex : *Actors)
+				{
+					// 与 AActor::IsNetRelevantFor 相同, 按距离平方比较
+					float NetCullDistanceSquared = ActorNetCullDistanceSquared[ActorIndex];
+					if (ClassNetCullDistanceSquared.Num() > 0)
+					{
+						NetCullDistanceSquared = FMath::Min(NetCullDistanceSquared, ClassNetCullDistanceSquared[ActorClasses[ActorIndex]]);
+					}
+					if (FVector::DistSquared(ActorLocations[ActorIndex], Client) < NetCullDistanceSquared)
+					{
+						++Count;
+						if (PerClass)
+						{
+							++(*PerClass)[ActorClasses[ActorIndex]];
+						}
+					}
+				}
+			}
+		}
+		OutCounts[ClientIndex] = Count;
+	});
+
+	if (OutClassMaxRelevant)
+	{
+		OutClassMaxRelevant->SetNumZeroed(Classes.Num());
+		for (const TArray<int32>& PerClass : ClassCounts)
+		{
+			for (int32 ClassIndex = 0; ClassIndex < PerClass.Num(); ++ClassIndex)
+			{
+				(*OutClassMaxRelevant)[ClassIndex] = FMath::Max((*OutClassMaxRelevant)[ClassIndex], PerClass[ClassIndex]);
+			}
+		}
+	}
+}
+
+void FReplicationRelevancyAnalysis::PrintReport(FOutputDevice& Ar) const
+{
+	using namespace ReplicationRelevancyAnalysis;
+
+	Ar.Logf(TEXT("客户端采样点: %d, 按距离判断的同步 Actor: %d, AlwaysRelevant: %d"), Clients.Num(), ActorLocations.Num(), NumAlwaysRelevant);
+	Ar.Logf(TEXT("每个连接每秒相关性检查: %.0f, %d 个连接: %.0f"), RelevancyChecksPerSecond, NumConnections, RelevancyChecksPerSecond * NumConnections);
+	Ar.Logf(TEXT("相关 Actor 数量 当前: 最大=%d, P95=%d, 中位数=%d, 预算=%d"), GetMax(CurrentCounts), GetPercentile(CurrentCounts, 0.95f), GetPercentile(CurrentCounts, 0.5f), RelevantActorBudget);
+	if (RecommendCounts != CurrentCounts)
+	{
+		Ar.Logf(TEXT("相关 Actor 数量 建议: 最大=%d, P95=%d, 中位数=%d (裁剪距离缩放 %.2f)"), GetMax(RecommendCounts), GetPercentile(RecommendCounts, 0.95f), GetPercentile(RecommendCounts, 0.5f), RecommendScale);
+	}
+	if (GetMax(RecommendCounts) > RelevantActorBudget)
+	{
+		Ar.Logf(TEXT("    最小裁剪距离 %.0f 限制下无法满足预算, 需要减少同步 Actor 的数量"), MinNetCullDistance);
+	}
+
+	Ar.Logf(TEXT(""));
+	for (const FReplicatedClassStats& ClassStats : Classes)
+	{
+		Ar.Logf(TEXT("%s: Actors=%d, 单个采样点最多相关=%d, NetCullDistanceSquared=%.0f"), *ClassStats.Class->GetPathName(), ClassStats.NumActors, ClassStats.MaxRelevant, ClassStats.NetCullDistanceSquared);
+		if (ClassStats.RecommendNetCullDistanceSquared < ClassStats.NetCullDistanceSquared)
+		{
+			Ar.Logf(TEXT("    建议 NetCullDistanceSquared=%.0f (距离 %.0f)"), ClassStats.RecommendNetCullDistanceSquared, FMath::Sqrt(ClassStats.RecommendNetCullDistanceSquared));
+		}
+	}
+}
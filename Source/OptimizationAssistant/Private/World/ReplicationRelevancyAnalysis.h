@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGlobalCheckSettings;
+class UWorldAnalysisSettings;
+
+/** Replicated actors of one class, with the NetCullDistanceSquared that keeps the relevant count in budget. */
+struct FReplicatedClassStats
+{
+	UClass* Class;
+	int32 NumActors;
+	float NetCullDistanceSquared;
+	float RecommendNetCullDistanceSquared;
+
+	/** Largest number of actors of the class relevant to one client sample. */
+	int32 MaxRelevant;
+};
+
+/**
+ * Estimates the server relevancy cost of the replicated actors of a world: for sampled client
+ * positions, how many actors pass the NetCullDistanceSquared test (found through a 2D spatial hash),
+ * and how many IsNetRelevantFor checks every connection costs per second. Per class cull distances
+ * are recommended by scaling all distances until the worst sample fits the relevant actor budget,
+ * the rounding and limits of the recommended values are applied at every step of the search.
+ */
+class FReplicationRelevancyAnalysis
+{
+public:
+	void Run(UWorld* World, const TArray<FVector>& ClientPositions, const UGlobalCheckSettings* GlobalCheckSettings, const UWorldAnalysisSettings* Settings);
+
+	void PrintReport(FOutputDevice& Ar) const;
+
+private:
+	/** Per class distances for a scale: capped by MaxNetCullDistance, rounded up to 100 and at least MinNetCullDistance. */
+	void ComputeRecommendDistances(float DistanceScale, TArray<float>& OutClassNetCullDistanceSquared) const;
+
+	/**
+	 * Relevant actor count at every client position. Every actor uses the smaller of its own distance and the
+	 * distance of its class in ClassNetCullDistanceSquared, or its own distance if that is empty.
+	 */
+	void CountRelevant(const TArray<float>& ClassNetCullDistanceSquared, TArray<int32>& OutCounts, TArray<int32>* OutClassMaxRelevant) const;
+
+	FIntPoint GetHashCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / HashCellSize), FMath::FloorToInt(Location.Y / HashCellSize));
+	}
+
+	TArray<FVector> Clients;
+
+	/** Actors that are not always relevant, tested by distance. */
+	TArray<FVector> ActorLocations;
+	TArray<float> ActorNetCullDistanceSquared;
+	TArray<int32> ActorClasses;
+
+	/** Actor indices per hash cell, the cell size is the largest cull distance so a query reads 3x3 cells. */
+	TMap<FIntPoint, TArray<int32>> SpatialHash;
+	float HashCellSize;
+
+	TArray<FReplicatedClassStats> Classes;
+
+	int32 NumAlwaysRelevant;
+	int32 NumConnections;
+	int32 RelevantActorBudget;
+
+	/** IsNetRelevantFor calls per second of one connection, NetUpdateFrequency capped by the server tick rate. */
+	float RelevancyChecksPerSecond;
+
+	float MinNetCullDistance;
+	float MaxNetCullDistance;
+
+	float RecommendScale;
+	TArray<int32> CurrentCounts;
+	TArray<int32> RecommendCounts;
+};
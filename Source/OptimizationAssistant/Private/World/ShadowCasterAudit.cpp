@@ -0,0 +1,233 @@
+#include "World/ShadowCasterAudit.h"
+#include "Async/ParallelFor.h"
+#include "UObject/UObjectIterator.h"
+#include "Engine/World.h"
+#include "Components/DirectionalLightComponent.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "Widgets/World/WorldAnalysisSettings.h"
+#include "CameraProfileTable.h"
+#include "OptimizationAssistantHelpers.h"
+
+float FShadowCasterAudit::GetCascadeSplit(float ShadowDistance, float Exponent, int32 SplitIndex, int32 NumCascades)
+{
+	if (SplitIndex <= 0)
+	{
+		return 0.0f;
+	}
+
+	// ComputeAccumulatedScale, 每一级的范围是上一级的 Exponent 倍
+	float CurrentScale = 1.0f;
+	float TotalScale = 0.0f;
+	float AccumulatedScale = 0.0f;
+	for (int32 CascadeIndex = 0; CascadeIndex < NumCascades; ++CascadeIndex)
+	{
+		if (CascadeIndex < SplitIndex)
+		{
+			AccumulatedScale += CurrentScale;
+		}
+		TotalScale += CurrentScale;
+		CurrentScale *= Exponent;
+	}
+	return ShadowDistance * AccumulatedScale / TotalScale;
+}
+
+void FShadowCasterAudit::Run(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<FVector>& Viewpoints, const FCameraProfileTable& CameraProfiles, const UWorldAnalysisSettings* Settings)
+{
+	CascadeSetups.Reset();
+	WastedCasters.Reset();
+	InsetShadowCasters.Reset();
+	NumViewpoints = Viewpoints.Num();
+	NumCastShadow = NumDynamicShadow = NumMovableCasters = NumInsetShadow = NumFarShadow = 0;
+
+	for (TObjectIterator<UDirectionalLightComponent> It; It; ++It)
+	{
+		UDirectionalLightComponent* Light = *It;
+		if (Light->GetWorld() != World || !Light->IsRegistered() || !Light->IsVisible() || !Light->CastShadows || !Light->CastDynamicShadows)
+		{
+			continue;
+		}
+
+		// 静态光源没有动态阴影, 固定光源的 CSM 距离为 0 时只有逐物体阴影
+		const bool bMovable = Light->Mobility == EComponentMobility::Movable;
+		const float ShadowDistance = bMovable ? Light->DynamicShadowDistanceMovableLight : Light->DynamicShadowDistanceStationaryLight;
+		if (Light->Mobility == EComponentMobility::Static || ShadowDistance <= 0.0f || Light->DynamicShadowCascades <= 0)
+		{
+			continue;
+		}
+
+		FShadowCascadeSetup& Setup = CascadeSetups.AddDefaulted_GetRef();
+		Setup.LightName = Light->GetOwner() ? Light->GetOwner()->GetActorLabel() : Light->GetName();
+		Setup.bMovable = bMovable;
+		Setup.ShadowDistance = ShadowDistance;
+		for (int32 SplitIndex = 0; SplitIndex <= Light->DynamicShadowCascades; ++SplitIndex)
+		{
+			Setup.Splits.Add(GetCascadeSplit(ShadowDistance, Light->CascadeDistributionExponent, SplitIndex, Light->DynamicShadowCascades));
+		}
+	}
+
+	float MaxShadowDistance = 0.0f;
+	for (const FShadowCascadeSetup& Setup : CascadeSetups)
+	{
+		MaxShadowDistance = FMath::Max(MaxShadowDistance, Setup.ShadowDistance);
+	}
+
+	FCameraDrawDistances DrawDistances;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		if (!Snapshot.HasAnyFlags(Index, WPF_CastShadow))
+		{
+			continue;
+		}
+		++NumCastShadow;
+
+		if (!Snapshot.HasAnyFlags(Index, WPF_CastDynamicShadow))
+		{
+			continue;
+		}
+		++NumDynamicShadow;
+
+		UPrimitiveComponent* Component = Snapshot.GetComponent(Index);
+		if (Snapshot.HasAnyFlags(Index, WPF_Movable))
+		{
+			++NumMovableCasters;
+			if (Component && Component->bCastInsetShadow)
+			{
+				InsetShadowCasters.Add(Index);
+			}
+		}
+		NumInsetShadow += Component && Component->bCastInsetShadow ? 1 : 0;
+		NumFarShadow += Component && Component->bCastFarShadow ? 1 : 0;
+
+		if (MaxShadowDistance <= 0.0f)
+		{
+			continue;
+		}
+
+		CameraProfiles.ComputeDrawDistances(Snapshot.SphereRadius[Index], Settings->ShadowScreenSize, DrawDistances);
+		float VisibleShadowDistance = 0.0f;
+		for (int32 ProfileIndex = 0; ProfileIndex < CameraProfiles.Num(); ++ProfileIndex)
+		{
+			VisibleShadowDistance = FMath::Max(VisibleShadowDistance, DrawDistances[ProfileIndex]);
+		}
+
+		const float MaxDrawDistance = Snapshot.CachedMaxDrawDistance[Index];
+		const bool bDistanceCulled = MaxDrawDistance > 0.0f && !Snapshot.HasAnyFlags(Index, WPF_NeverDistanceCull);
+		const float ShadowRenderDistance = bDistanceCulled ? FMath::Min(MaxDrawDistance, MaxShadowDistance) : MaxShadowDistance;
+		if (ShadowRenderDistance > VisibleShadowDistance * Settings->ShadowDistanceTolerance)
+		{
+			WastedCasters.Add({ Index, VisibleShadowDistance, ShadowRenderDistance });
+		}
+	}
+
+	WastedCasters.Sort([](const FShadowCasterWaste& A, const FShadowCasterWaste& B)
+	{
+		return A.ShadowRenderDistance - A.VisibleShadowDistance > B.ShadowRenderDistance - B.VisibleShadowDistance;
+	});
+
+	for (FShadowCascadeSetup& Setup : CascadeSetups)
+	{
+		CountCascadeCasters(Setup, Snapshot, Viewpoints);
+	}
+}
+
+void FShadowCasterAudit::CountCascadeCasters(FShadowCascadeSetup& Setup, const FWorldPrimitiveSnapshot& Snapshot, const TArray<FVector>& Viewpoints) const
+{
+	const int32 NumCascades = Setup.Splits.Num() - 1;
+	TArray<int32> Counts;
+	Counts.SetNumZeroed(Viewpoints.Num() * NumCascades);
+
+	ParallelFor(Viewpoints.Num(), [&Setup, &Snapshot, &Viewpoints, &Counts, NumCascades](int32 ViewIndex)
+	{
+		const FVector& ViewOrigin = Viewpoints[ViewIndex];
+		TArray<int32> Primitives;
+		Snapshot.BVH.QuerySphere(ViewOrigin, Setup.ShadowDistance, Primitives);
+
+		int32* ViewCounts = Counts.GetData() + ViewIndex * NumCascades;
+		for (int32 Index : Primitives)
+		{
+			if (!Snapshot.HasAnyFlags(Index, WPF_CastDynamicShadow))
+			{
+				continue;
+			}
+
+			const float Distance = FVector::Dist(ViewOrigin, Snapshot.GetOrigin(Index));
+			const float MaxDrawDistance = Snapshot.CachedMaxDrawDistance[Index];
+			if (MaxDrawDistance > 0.0f && !Snapshot.HasAnyFlags(Index, WPF_NeverDistanceCull) && Distance > MaxDrawDistance)
+			{
+				continue;
+			}
+
+			// 包围球与级联的距离范围相交就会被渲染进该级联
+			const float Radius = Snapshot.SphereRadius[Index];
+			for (int32 Cascade = 0; Cascade < NumCascades; ++Cascade)
+			{
+				if (Distance + Radius >= Setup.Splits[Cascade] && Distance - Radius <= Setup.Splits[Cascade + 1])
+				{
+					++ViewCounts[Cascade];
+				}
+			}
+		}
+	});
+
+	Setup.AverageCasters.SetNumZeroed(NumCascades);
+	Setup.MaxCasters.SetNumZeroed(NumCascades);
+	for (int32 ViewIndex = 0; ViewIndex < Viewpoints.Num(); ++ViewIndex)
+	{
+		for (int32 Cascade = 0; Cascade < NumCascades; ++Cascade)
+		{
+			const int32 Count = Counts[ViewIndex * NumCascades + Cascade];
+			Setup.AverageCasters[Cascade] += (float)Count / Viewpoints.Num();
+			Setup.MaxCasters[Cascade] = FMath::Max(Setup.MaxCasters[Cascade], Count);
+		}
+	}
+}
+
+void FShadowCasterAudit::PrintReport(const FWorldPrimitiveSnapshot& Snapshot, int32 NumOffenders, FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("组件数量: %d, CastShadow: %d, 动态阴影: %d, 可移动的动态阴影投射者: %d, InsetShadow: %d, FarShadow: %d"),
+		Snapshot.Num(), NumCastShadow, NumDynamicShadow, NumMovableCasters, NumInsetShadow, NumFarShadow);
+
+	if (CascadeSetups.Num() == 0)
+	{
+		Ar.Logf(TEXT("场景中没有使用级联阴影的方向光."));
+	}
+
+	for (const FShadowCascadeSetup& Setup : CascadeSetups)
+	{
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== 方向光: %s (%s) 阴影距离=%.0f 级联数=%d ===="), *Setup.LightName, Setup.bMovable ? TEXT("Movable") : TEXT("Stationary"), Setup.ShadowDistance, Setup.Splits.Num() - 1);
+		for (int32 Cascade = 0; Cascade < Setup.AverageCasters.Num(); ++Cascade)
+		{
+			Ar.Logf(TEXT("级联[%d] %.0f - %.0f: 平均投射者=%.1f, 最多=%d (%d 个采样点)"),
+				Cascade, Setup.Splits[Cascade], Setup.Splits[Cascade + 1], Setup.AverageCasters[Cascade], Setup.MaxCasters[Cascade], NumViewpoints);
+		}
+	}
+
+	if (InsetShadowCasters.Num() > 0)
+	{
+		Ar.Logf(TEXT(""));
+		Ar.Logf(TEXT("==== 开启 bCastInsetShadow 的可移动组件, 每个都会渲染单独的阴影 ===="));
+		for (int32 Index : InsetShadowCasters)
+		{
+			if (UPrimitiveComponent* Component = Snapshot.GetComponent(Index))
+			{
+				Ar.Logf(TEXT("%s"), *Component->GetFullName());
+			}
+		}
+	}
+
+	Ar.Logf(TEXT(""));
+	Ar.Logf(TEXT("==== 阴影在可见距离之外仍然渲染的组件: %d ===="), WastedCasters.Num());
+	for (int32 Rank = 0; Rank < FMath::Min(NumOffenders, WastedCasters.Num()); ++Rank)
+	{
+		const FShadowCasterWaste& Waste = WastedCasters[Rank];
+		UPrimitiveComponent* Component = Snapshot.GetComponent(Waste.PrimitiveIndex);
+		if (!Component)
+		{
+			continue;
+		}
+		Ar.Logf(TEXT("%s"), *Component->GetFullName());
+		Ar.Logf(TEXT("    [Size=%.0f] 阴影可见距离=%.0f, 渲染到=%.0f, 建议关闭 bCastDynamicShadow 或设置裁剪距离."),
+			Snapshot.SphereRadius[Waste.PrimitiveIndex] * 2.0f, Waste.VisibleShadowDistance, Waste.ShadowRenderDistance);
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWorldPrimitiveSnapshot;
+class FCameraProfileTable;
+class UWorldAnalysisSettings;
+
+/** Cascaded shadow map layout of a directional light, split distances computed like the renderer. */
+struct FShadowCascadeSetup
+{
+	FString LightName;
+	bool bMovable;
+	float ShadowDistance;
+
+	/** NumCascades + 1 distances, the first is 0 and the last is ShadowDistance. */
+	TArray<float> Splits;
+
+	/** Average and largest number of casters rendered into each cascade over the viewpoints. */
+	TArray<float> AverageCasters;
+	TArray<int32> MaxCasters;
+};
+
+/** A caster that keeps rendering into the cascades long after its shadow is too small to see. */
+struct FShadowCasterWaste
+{
+	int32 PrimitiveIndex;
+
+	/** Distance at which the caster reaches the shadow screen size for the largest camera profile. */
+	float VisibleShadowDistance;
+
+	/** Distance up to which the caster is rendered into the cascades now. */
+	float ShadowRenderDistance;
+};
+
+/**
+ * Audits the dynamic shadow casters of a world against the cascaded shadow maps of its directional
+ * lights: shadow settings totals, movable casters, how many casters each cascade renders seen from
+ * sampled viewpoints, and small casters whose shadows render far beyond the distance they are visible.
+ */
+class FShadowCasterAudit
+{
+public:
+	/** Same distribution as FDirectionalLightSceneProxy::GetSplitDistance, 0 is the near plane. */
+	static float GetCascadeSplit(float ShadowDistance, float Exponent, int32 SplitIndex, int32 NumCascades);
+
+	void Run(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<FVector>& Viewpoints, const FCameraProfileTable& CameraProfiles, const UWorldAnalysisSettings* Settings);
+
+	void PrintReport(const FWorldPrimitiveSnapshot& Snapshot, int32 NumOffenders, FOutputDevice& Ar) const;
+
+private:
+	void CountCascadeCasters(FShadowCascadeSetup& Cascades, const FWorldPrimitiveSnapshot& Snapshot, const TArray<FVector>& Viewpoints) const;
+
+	TArray<FShadowCascadeSetup> CascadeSetups;
+	TArray<FShadowCasterWaste> WastedCasters;
+
+	int32 NumViewpoints;
+	int32 NumCastShadow;
+	int32 NumDynamicShadow;
+	int32 NumMovableCasters;
+	int32 NumInsetShadow;
+	int32 NumFarShadow;
+
+	/** Movable casters with bCastInsetShadow, each one renders its own per object shadow. */
+	TArray<int32> InsetShadowCasters;
+};
@@ -0,0 +1,587 @@
+#include "World/SoftwareOcclusion.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerStart.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "LandscapeProxy.h"
+#include "StaticMeshResources.h"
+#include "SceneManagement.h"
+#include "ConvexVolume.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "OptimizationAssistantHelpers.h"
+
+namespace SoftwareOcclusion
+{
+	static const float NearPlane = 10.0f;
+
+	/** Occluders must be this much in front of a box to hide it, so coplanar neighbours do not hide each other. */
+	static const float DepthBias = 1.0f;
+
+	/** Cube map faces, 90 degree frustums that together cover every direction. */
+	static const FRotator CubeFaceRotations[6] =
+	{
+		FRotator(0.0f, 0.0f, 0.0f),
+		FRotator(0.0f, 90.0f, 0.0f),
+		FRotator(0.0f, 180.0f, 0.0f),
+		FRotator(0.0f, -90.0f, 0.0f),
+		FRotator(90.0f, 0.0f, 0.0f),
+		FRotator(-90.0f, 0.0f, 0.0f),
+	};
+
+	FORCEINLINE float EdgeFunction(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+	{
+		return (B.X - A.X) * (C.Y - A.Y) - (B.Y - A.Y) * (C.X - A.X);
+	}
+
+	/** Screen rect and nearest depth of a box, returns false if the box is completely behind the near plane. */
+	static bool ProjectBox(const FMatrix& ViewMatrix, int32 Resolution, const FVector& Min, const FVector& Max, FVector2D& OutMin, FVector2D& OutMax, float& OutMinZ, bool& bOutCrossesNearPlane)
+	{
+		OutMin = FVector2D(FLT_MAX, FLT_MAX);
+		OutMax = FVector2D(-FLT_MAX, -FLT_MAX);
+		OutMinZ = FLT_MAX;
+		bOutCrossesNearPlane = false;
+
+		int32 NumInFront = 0;
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			const FVector WorldCorner((Corner & 1) ? Max.X : Min.X, (Corner & 2) ? Max.Y : Min.Y, (Corner & 4) ? Max.Z : Min.Z);
+			const FVector View = ViewMatrix.TransformPosition(WorldCorner);
+			if (View.Z < NearPlane)
+			{
+				bOutCrossesNearPlane = true;
+				continue;
+			}
+
+			++NumInFront;
+			const FVector2D Screen((View.X / View.Z * 0.5f + 0.5f) * Resolution, (0.5f - View.Y / View.Z * 0.5f) * Resolution);
+			OutMin = FVector2D::Min(OutMin, Screen);
+			OutMax = FVector2D::Max(OutMax, Screen);
+			OutMinZ = FMath::Min(OutMinZ, View.Z);
+		}
+		return NumInFront > 0;
+	}
+}
+
+FOcclusionDepthBuffer::FOcclusionDepthBuffer(int32 InResolution, const FVector& InViewOrigin, const FRotator& InViewRotation)
+	: Resolution(InResolution)
+{
+	ViewMatrix = FTranslationMatrix(-InViewOrigin)
+		* FInverseRotationMatrix(InViewRotation)
+		* FMatrix(FPlane(0, 0, 1, 0), FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 0, 1));
+	Depths.Init(FLT_MAX, Resolution * Resolution);
+	Occluders.Init(INDEX_NONE, Resolution * Resolution);
+}
+
+void FOcclusionDepthBuffer::RasterizeTriangle(const FVector& A, const FVector& B, const FVector& C, int32 OccluderIndex)
+{
+	using namespace SoftwareOcclusion;
+
+	const FVector View[3] = { ToView(A), ToView(B), ToView(C) };
+	if (View[0].Z < NearPlane && View[1].Z < NearPlane && View[2].Z < NearPlane)
+	{
+		return;
+	}
+
+	// 裁剪到近平面, 三角形最多变成四边形
+	FVector Clipped[4];
+	int32 NumClipped = 0;
+	for (int32 Index = 0; Index < 3; ++Index)
+	{
+		const FVector& Current = View[Index];
+		const FVector& Next = View[(Index + 1) % 3];
+		const bool bCurrentIn = Current.Z >= NearPlane;
+		const bool bNextIn = Next.Z >= NearPlane;
+		if (bCurrentIn)
+		{
+			Clipped[NumClipped++] = Current;
+		}
+		if (bCurrentIn != bNextIn)
+		{
+			const float T = (NearPlane - Current.Z) / (Next.Z - Current.Z);
+			Clipped[NumClipped++] = Current + (Next - Current) * T;
+		}
+	}
+
+	float Depth = 0.0f;
+	for (int32 Index = 0; Index < NumClipped; ++Index)
+	{
+		Depth = FMath::Max(Depth, Clipped[Index].Z);
+	}
+
+	for (int32 Index = 1; Index + 1 < NumClipped; ++Index)
+	{
+		RasterizeViewTriangle(Clipped[0], Clipped[Index], Clipped[Index + 1], Depth, OccluderIndex);
+	}
+}
+
+void FOcclusionDepthBuffer::RasterizeViewTriangle(const FVector& A, const FVector& B, const FVector& C, float Depth, int32 OccluderIndex)
+{
+	auto Project = [this](const FVector& View)
+	{
+		return FVector2D((View.X / View.Z * 0.5f + 0.5f) * Resolution, (0.5f - View.Y / View.Z * 0.5f) * Resolution);
+	};
+
+	const FVector2D P0 = Project(A);
+	const FVector2D P1 = Project(B);
+	const FVector2D P2 = Project(C);
+	const float Area = SoftwareOcclusion::EdgeFunction(P0, P1, P2);
+	if (FMath::Abs(Area) < KINDA_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	const int32 MinX = FMath::Max(FMath::FloorToInt(FMath::Min3(P0.X, P1.X, P2.X)), 0);
+	const int32 MaxX = FMath::Min(FMath::CeilToInt(FMath::Max3(P0.X, P1.X, P2.X)), Resolution - 1);
+	const int32 MinY = FMath::Max(FMath::FloorToInt(FMath::Min3(P0.Y, P1.Y, P2.Y)), 0);
+	const int32 MaxY = FMath::Min(FMath::CeilToInt(FMath::Max3(P0.Y, P1.Y, P2.Y)), Resolution - 1);
+
+	// 两种绕序都接受, 遮挡体不区分正反面
+	const float Sign = Area > 0.0f ? 1.0f : -1.0f;
+
+	// 像素中心的边函数值减去半个像素内的最大变化量, 只写入被三角形完全覆盖的像素
+	auto GetEdgeOffset = [](const FVector2D& EdgeStart, const FVector2D& EdgeEnd)
+	{
+		return 0.5f * (FMath::Abs(EdgeEnd.X - EdgeStart.X) + FMath::Abs(EdgeEnd.Y - EdgeStart.Y));
+	};
+	const float Offset0 = GetEdgeOffset(P1, P2);
+	const float Offset1 = GetEdgeOffset(P2, P0);
+	const float Offset2 = GetEdgeOffset(P0, P1);
+
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		float* Row = Depths.GetData() + Y * Resolution;
+		int32* OccluderRow = Occluders.GetData() + Y * Resolution;
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			const FVector2D Pixel(X + 0.5f, Y + 0.5f);
+			const float W0 = SoftwareOcclusion::EdgeFunction(P1, P2, Pixel) * Sign;
+			const float W1 = SoftwareOcclusion::EdgeFunction(P2, P0, Pixel) * Sign;
+			const float W2 = SoftwareOcclusion::EdgeFunction(P0, P1, Pixel) * Sign;
+			if (W0 >= Offset0 && W1 >= Offset1 && W2 >= Offset2 && Depth < Row[X])
+			{
+				Row[X] = Depth;
+				OccluderRow[X] = OccluderIndex;
+			}
+		}
+	}
+}
+
+bool FOcclusionDepthBuffer::IsBoxInView(const FBox& Box) const
+{
+	FVector2D ScreenMin, ScreenMax;
+	float MinZ;
+	bool bCrossesNearPlane;
+	if (!SoftwareOcclusion::ProjectBox(ViewMatrix, Resolution, Box.Min, Box.Max, ScreenMin, ScreenMax, MinZ, bCrossesNearPlane))
+	{
+		return false;
+	}
+	return bCrossesNearPlane || (ScreenMax.X >= 0.0f && ScreenMin.X < Resolution && ScreenMax.Y >= 0.0f && ScreenMin.Y < Resolution);
+}
+
+void FOcclusionDepthBuffer::GetFrustum(FConvexVolume& OutFrustum) const
+{
+	GetViewFrustumBounds(OutFrustum, ViewMatrix * FPerspectiveMatrix(PI / 4.0f, 1.0f, 1.0f, SoftwareOcclusion::NearPlane), false);
+}
+
+bool FOcclusionDepthBuffer::IsBoxVisible(const FVector& Origin, const FVector& Extent, int32 PrimitiveIndex) const
+{
+	FVector2D ScreenMin, ScreenMax;
+	float MinZ;
+	bool bCrossesNearPlane;
+	if (!SoftwareOcclusion::ProjectBox(ViewMatrix, Resolution, Origin - Extent, Origin + Extent, ScreenMin, ScreenMax, MinZ, bCrossesNearPlane))
+	{
+		return false;
+	}
+
+	if (bCrossesNearPlane)
+	{
+		// 包围盒跨过近平面(视点在包围盒内或很近), 视为可见
+		return true;
+	}
+
+	if (ScreenMax.X < 0.0f || ScreenMin.X >= Resolution || ScreenMax.Y < 0.0f || ScreenMin.Y >= Resolution)
+	{
+		return false;
+	}
+
+	// 包围盒部分覆盖的像素也参与测试
+	const int32 MinX = FMath::Max(FMath::FloorToInt(ScreenMin.X), 0);
+	const int32 MaxX = FMath::Min(FMath::FloorToInt(ScreenMax.X), Resolution - 1);
+	const int32 MinY = FMath::Max(FMath::FloorToInt(ScreenMin.Y), 0);
+	const int32 MaxY = FMath::Min(FMath::FloorToInt(ScreenMax.Y), Resolution - 1);
+	const float OccludedDepth = MinZ - SoftwareOcclusion::DepthBias;
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		const float* Row = Depths.GetData() + Y * Resolution;
+		const int32* OccluderRow = Occluders.GetData() + Y * Resolution;
+		for (int32 X = MinX; X <= MaxX; ++X)
+		{
+			if (Row[X] >= OccludedDepth || (PrimitiveIndex != INDEX_NONE && OccluderRow[X] == PrimitiveIndex))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void FSoftwareOcclusionAnalysis::GatherGridViewpoints(UWorld* World, const FBox& WorldBounds, float Spacing, float EyeHeight, TArray<FVector>& OutViewpoints)
+{
+	if (!WorldBounds.IsValid || Spacing <= 0.0f)
+	{
+		return;
+	}
+
+	static const int32 MaxGridViewpoints = 4096;
+	const FVector Size = WorldBounds.GetSize();
+	const int32 NumX = FMath::Min(FMath::CeilToInt(Size.X / Spacing), 1024);
+	const int32 NumY = FMath::Min(FMath::CeilToInt(Size.Y / Spacing), 1024);
+	FCollisionQueryParams QueryParams(FName(TEXT("OAOcclusionViewpoint")), false);
+	for (int32 Y = 0; Y <= NumY; ++Y)
+	{
+		for (int32 X = 0; X <= NumX; ++X)
+		{
+			const float PositionX = WorldBounds.Min.X + X * Spacing;
+			const float PositionY = WorldBounds.Min.Y + Y * Spacing;
+			FHitResult Hit;
+			const FVector Start(PositionX, PositionY, WorldBounds.Max.Z + 100.0f);
+			const FVector End(PositionX, PositionY, WorldBounds.Min.Z - 100.0f);
+			if (World->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, QueryParams))
+			{
+				OutViewpoints.Add(Hit.ImpactPoint + FVector(0.0f, 0.0f, EyeHeight));
+				if (OutViewpoints.Num() >= MaxGridViewpoints)
+				{
+					UE_LOG(LogOptimizationAssistant, Warning, TEXT("Occlusion grid is limited to %d viewpoints, increase the grid spacing."), MaxGridViewpoints);
+					return;
+				}
+			}
+		}
+	}
+}
+
+void FSoftwareOcclusionAnalysis::GatherPlayerStartViewpoints(UWorld* World, float EyeHeight, TArray<FVector>& OutViewpoints)
+{
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		// PlayerStart 位于胶囊体中心
+		const float HalfHeight = It->GetCapsuleComponent() ? It->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 0.0f;
+		OutViewpoints.Add(It->GetActorLocation() + FVector(0.0f, 0.0f, EyeHeight - HalfHeight));
+	}
+}
+
+void FSoftwareOcclusionAnalysis::GatherOccluders(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot)
+{
+	OccluderVertices.Reset();
+	OccluderMeshes.Reset();
+
+	// 地形最重要, 先加入, 网格遮挡体使用剩余的面数
+	AddLandscapeOccluders(World);
+	const int64 MaxVertices = (int64)FMath::Max(Settings.OccluderMaxTotalTriangles, 0) * 3;
+
+	/** The LOD and opaque sections of one component, shared by its instances. */
+	struct FOccluderSource
+	{
+		UStaticMeshComponent* MeshComponent;
+		const FStaticMeshLODResources* LOD;
+		TArray<int32> OpaqueSections;
+		int32 NumVertices;
+		int32 PrimitiveIndex;
+	};
+
+	/** One component or instance that is big enough to occlude. */
+	struct FOccluderCandidate
+	{
+		int32 SourceIndex;
+		FTransform Transform;
+		FBoxSphereBounds Bounds;
+	};
+
+	TArray<FOccluderSource> Sources;
+	TArray<FOccluderCandidate> Candidates;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		// 组件包围盒比最小尺寸还小时, 其中的实例也都更小
+		if (Snapshot.HasAnyFlags(Index, WPF_Movable) || Snapshot.SphereRadius[Index] * 2.0f < Settings.OccluderMinSize)
+		{
+			continue;
+		}
+
+		UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Snapshot.GetComponent(Index));
+		UStaticMesh* StaticMesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+		if (!StaticMesh || !StaticMesh->RenderData || StaticMesh->RenderData->LODResources.Num() == 0)
+		{
+			continue;
+		}
+
+		// 使用面数不超过限制的第一级LOD, 都超过时使用最后一级
+		const TIndirectArray<FStaticMeshLODResources>& LODResources = StaticMesh->RenderData->LODResources;
+		int32 LODIndex = 0;
+		while (LODIndex < LODResources.Num() - 1 && LODResources[LODIndex].GetNumTriangles() > Settings.OccluderMaxTriangles)
+		{
+			++LODIndex;
+		}
+
+		FOccluderSource Source;
+		Source.MeshComponent = MeshComponent;
+		Source.LOD = &LODResources[LODIndex];
+		Source.NumVertices = 0;
+		Source.PrimitiveIndex = Index;
+		if (Source.LOD->VertexBuffers.PositionVertexBuffer.GetNumVertices() == 0)
+		{
+			continue;
+		}
+		for (int32 SectionIndex = 0; SectionIndex < Source.LOD->Sections.Num(); ++SectionIndex)
+		{
+			// 只有不透明材质才能遮挡
+			const FStaticMeshSection& Section = Source.LOD->Sections[SectionIndex];
+			UMaterialInterface* Material = MeshComponent->GetMaterial(Section.MaterialIndex);
+			if (Material && Material->GetBlendMode() == BLEND_Opaque && Section.NumTriangles > 0)
+			{
+				Source.OpaqueSections.Add(SectionIndex);
+				Source.NumVertices += Section.NumTriangles * 3;
+			}
+		}
+		if (Source.NumVertices == 0)
+		{
+			continue;
+		}
+
+		const int32 SourceIndex = Sources.Add(MoveTemp(Source));
+		const FBoxSphereBounds MeshBounds = StaticMesh->GetBounds();
+		auto AddCandidate = [this, &Candidates, &MeshBounds, SourceIndex](const FTransform& Transform)
+		{
+			const FBoxSphereBounds Bounds = MeshBounds.TransformBy(Transform);
+			if (Bounds.SphereRadius * 2.0f >= Settings.OccluderMinSize)
+			{
+				Candidates.Add({ SourceIndex, Transform, Bounds });
+			}
+		};
+
+		if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(MeshComponent))
+		{
+			// 每个实例按自己的包围盒判断尺寸
+			for (int32 InstanceIndex = 0; InstanceIndex < InstancedComponent->GetInstanceCount(); ++InstanceIndex)
+			{
+				FTransform InstanceTransform;
+				if (InstancedComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true))
+				{
+					AddCandidate(InstanceTransform);
+				}
+			}
+		}
+		else
+		{
+			AddCandidate(MeshComponent->GetComponentTransform());
+		}
+	}
+
+	// 超出面数上限时优先保留尺寸大的遮挡体
+	Candidates.StableSort([](const FOccluderCandidate& A, const FOccluderCandidate& B) { return A.Bounds.SphereRadius > B.Bounds.SphereRadius; });
+	int32 NumSkipped = 0;
+	for (const FOccluderCandidate& Candidate : Candidates)
+	{
+		const FOccluderSource& Source = Sources[Candidate.SourceIndex];
+		if (OccluderVertices.Num() + (int64)Source.NumVertices > MaxVertices)
+		{
+			++NumSkipped;
+			continue;
+		}
+
+		const FPositionVertexBuffer& Positions = Source.LOD->VertexBuffers.PositionVertexBuffer;
+		const FIndexArrayView Indices = Source.LOD->IndexBuffer.GetArrayView();
+		FOccluderMesh& OccluderMesh = OccluderMeshes.AddDefaulted_GetRef();
+		OccluderMesh.Bounds = Candidate.Bounds.GetBox();
+		OccluderMesh.FirstVertex = OccluderVertices.Num();
+		OccluderMesh.PrimitiveIndex = Source.PrimitiveIndex;
+		for (int32 SectionIndex : Source.OpaqueSections)
+		{
+			const FStaticMeshSection& Section = Source.LOD->Sections[SectionIndex];
+			for (uint32 Corner = 0; Corner < Section.NumTriangles * 3; ++Corner)
+			{
+				OccluderVertices.Add(Candidate.Transform.TransformPosition(Positions.VertexPosition(Indices[Section.FirstIndex + Corner])));
+			}
+		}
+		OccluderMesh.NumVertices = OccluderVertices.Num() - OccluderMesh.FirstVertex;
+	}
+
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogOptimizationAssistant, Log, TEXT("Software occlusion: %d smaller occluders skipped, the occluders reached %d triangles."), NumSkipped, Settings.OccluderMaxTotalTriangles);
+	}
+	OccluderMeshes.RemoveAll([](const FOccluderMesh& OccluderMesh) { return OccluderMesh.NumVertices == 0; });
+}
+
+void FSoftwareOcclusionAnalysis::AddLandscapeOccluders(UWorld* World)
+{
+	// 地形按网格采样高度, 每 16 行生成一个遮挡块
+	static const int32 RowsPerChunk = 16;
+	const float Spacing = FMath::Max(Settings.TerrainSpacing, 50.0f);
+	const int64 MaxVertices = (int64)FMath::Max(Settings.OccluderMaxTotalTriangles, 0) * 3;
+	FCollisionQueryParams QueryParams(FName(TEXT("OAOcclusionTerrain")), true);
+	for (TActorIterator<ALandscapeProxy> It(World); It; ++It)
+	{
+		ALandscapeProxy* Landscape = *It;
+		const FBox Bounds = Landscape->GetComponentsBoundingBox();
+		if (!Bounds.IsValid)
+		{
+			continue;
+		}
+
+		const int32 NumX = FMath::Min(FMath::CeilToInt(Bounds.GetSize().X / Spacing), 2048) + 1;
+		const int32 NumY = FMath::Min(FMath::CeilToInt(Bounds.GetSize().Y / Spacing), 2048) + 1;
+		TArray<FVector> Heights;
+		TBitArray<> ValidHeights(false, NumX * NumY);
+		Heights.SetNumUninitialized(NumX * NumY);
+		for (int32 Y = 0; Y < NumY; ++Y)
+		{
+			for (int32 X = 0; X < NumX; ++X)
+			{
+				const float PositionX = FMath::Min(Bounds.Min.X + X * Spacing, Bounds.Max.X);
+				const float PositionY = FMath::Min(Bounds.Min.Y + Y * Spacing, Bounds.Max.Y);
+				FHitResult Hit;
+				if (Landscape->ActorLineTraceSingle(Hit, FVector(PositionX, PositionY, Bounds.Max.Z + 100.0f), FVector(PositionX, PositionY, Bounds.Min.Z - 100.0f), ECC_Visibility, QueryParams))
+				{
+					Heights[Y * NumX + X] = Hit.ImpactPoint;
+					ValidHeights[Y * NumX + X] = true;
+				}
+			}
+		}
+
+		for (int32 ChunkY = 0; ChunkY < NumY - 1; ChunkY += RowsPerChunk)
+		{
+			FOccluderMesh& OccluderMesh = OccluderMeshes.AddDefaulted_GetRef();
+			OccluderMesh.Bounds.Init();
+			OccluderMesh.FirstVertex = OccluderVertices.Num();
+			OccluderMesh.PrimitiveIndex = INDEX_NONE;
+			for (int32 Y = ChunkY; Y < FMath::Min(ChunkY + RowsPerChunk, NumY - 1); ++Y)
+			{
+				for (int32 X = 0; X < NumX - 1; ++X)
+				{
+					const int32 I00 = Y * NumX + X;
+					const int32 I10 = I00 + 1;
+					const int32 I01 = I00 + NumX;
+					const int32 I11 = I01 + 1;
+					if (!ValidHeights[I00] || !ValidHeights[I10] || !ValidHeights[I01] || !ValidHeights[I11])
+					{
+						continue;
+					}
+					if (OccluderVertices.Num() + 6 > MaxVertices)
+					{
+						break;
+					}
+
+					OccluderVertices.Add(Heights[I00]);
+					OccluderVertices.Add(Heights[I10]);
+					OccluderVertices.Add(Heights[I11]);
+					OccluderVertices.Add(Heights[I00]);
+					OccluderVertices.Add(Heights[I11]);
+					OccluderVertices.Add(Heights[I01]);
+					OccluderMesh.Bounds += Heights[I00];
+					OccluderMesh.Bounds += Heights[I10];
+					OccluderMesh.Bounds += Heights[I01];
+					OccluderMesh.Bounds += Heights[I11];
+				}
+			}
+			OccluderMesh.NumVertices = OccluderVertices.Num() - OccluderMesh.FirstVertex;
+		}
+	}
+}
+
+void FSoftwareOcclusionAnalysis::RenderViewFace(const FWorldPrimitiveSnapshot& Snapshot, const FVector& ViewOrigin, const FRotator& ViewRotation)
+{
+	FOcclusionDepthBuffer DepthBuffer(Settings.Resolution, ViewOrigin, ViewRotation);
+	for (const FOccluderMesh& OccluderMesh : OccluderMeshes)
+	{
+		if (!DepthBuffer.IsBoxInView(OccluderMesh.Bounds))
+		{
+			continue;
+		}
+
+		const FVector* Vertices = OccluderVertices.GetData() + OccluderMesh.FirstVertex;
+		for (int32 Corner = 0; Corner + 2 < OccluderMesh.NumVertices; Corner += 3)
+		{
+			DepthBuffer.RasterizeTriangle(Vertices[Corner], Vertices[Corner + 1], Vertices[Corner + 2], OccluderMesh.PrimitiveIndex);
+		}
+	}
+
+	FConvexVolume Frustum;
+	DepthBuffer.GetFrustum(Frustum);
+	TArray<int32> InFrustum;
+	Snapshot.BVH.QueryFrustum(Frustum, InFrustum);
+	for (int32 Index : InFrustum)
+	{
+		if (FPlatformAtomics::AtomicRead(&Visible[Index]) != 0)
+		{
+			continue;
+		}
+
+		const FVector Origin = Snapshot.GetOrigin(Index);
+		const float MaxDrawDistance = Snapshot.CachedMaxDrawDistance[Index];
+		if (MaxDrawDistance > 0.0f && !Snapshot.HasAnyFlags(Index, WPF_NeverDistanceCull)
+			&& FVector::DistSquared(Origin, ViewOrigin) > FMath::Square(MaxDrawDistance))
+		{
+			continue;
+		}
+
+		if (DepthBuffer.IsBoxVisible(Origin, Snapshot.GetExtent(Index), Index))
+		{
+			FPlatformAtomics::InterlockedExchange(&Visible[Index], 1);
+		}
+	}
+}
+
+void FSoftwareOcclusionAnalysis::Run(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<FVector>& Viewpoints, const FSettings& InSettings)
+{
+	Settings = InSettings;
+	Settings.Resolution = FMath::Clamp(Settings.Resolution, 16, 1024);
+	NumViewpoints = Viewpoints.Num();
+	Visible.Init(0, Snapshot.Num());
+
+	// 遮挡体的顶点在游戏线程读取, 光栅化在工作线程完成
+	GatherOccluders(World, Snapshot);
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("Software occlusion: %d viewpoints, %d occluders, %d triangles."), Viewpoints.Num(), OccluderMeshes.Num(), OccluderVertices.Num() / 3);
+
+	ParallelFor(Viewpoints.Num() * 6, [this, &Snapshot, &Viewpoints](int32 TaskIndex)
+	{
+		RenderViewFace(Snapshot, Viewpoints[TaskIndex / 6], SoftwareOcclusion::CubeFaceRotations[TaskIndex % 6]);
+	});
+}
+
+void FSoftwareOcclusionAnalysis::PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const
+{
+	TArray<int32> NeverVisible;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		if (Visible[Index] == 0)
+		{
+			NeverVisible.Add(Index);
+		}
+	}
+	NeverVisible.Sort([&Snapshot](int32 A, int32 B) { return Snapshot.SphereRadius[A] > Snapshot.SphereRadius[B]; });
+
+	Ar.Logf(TEXT("采样点数量: %d, 遮挡体数量: %d, 组件数量: %d"), NumViewpoints, OccluderMeshes.Num(), Snapshot.Num());
+	Ar.Logf(TEXT("从任何采样点都不可见的组件: %d"), NeverVisible.Num());
+	for (int32 Index : NeverVisible)
+	{
+		UPrimitiveComponent* Component = Snapshot.GetComponent(Index);
+		if (!Component)
+		{
+			continue;
+		}
+
+		const float MaxDrawDistance = Snapshot.CachedMaxDrawDistance[Index];
+		Ar.Logf(TEXT("%s"), *Component->GetFullName());
+		if (MaxDrawDistance > 0.0f)
+		{
+			Ar.Logf(TEXT("    [Size=%.0f, CullDistance=%.0f] 始终被遮挡或超出裁剪距离, 可以删除或减小裁剪距离."), Snapshot.SphereRadius[Index] * 2.0f, MaxDrawDistance);
+		}
+		else
+		{
+			Ar.Logf(TEXT("    [Size=%.0f] 始终被遮挡, 可以删除或设置裁剪距离."), Snapshot.SphereRadius[Index] * 2.0f);
+		}
+	}
+}
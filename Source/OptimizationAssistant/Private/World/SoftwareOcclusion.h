@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWorldPrimitiveSnapshot;
+struct FConvexVolume;
+
+/** Occluder triangles of one component in world space, culled as a whole against each view. */
+struct FOccluderMesh
+{
+	FBox Bounds;
+	int32 FirstVertex;
+	int32 NumVertices;
+
+	/** Snapshot index of the component, INDEX_NONE for landscape chunks. */
+	int32 PrimitiveIndex;
+};
+
+/**
+ * Coarse depth buffer of one cube face. Occlusion stays conservative: a triangle only writes the pixels it
+ * covers completely, with its farthest depth, and every pixel remembers which primitive wrote it.
+ */
+class FOcclusionDepthBuffer
+{
+public:
+	FOcclusionDepthBuffer(int32 InResolution, const FVector& InViewOrigin, const FRotator& InViewRotation);
+
+	void RasterizeTriangle(const FVector& A, const FVector& B, const FVector& C, int32 OccluderIndex);
+
+	/**
+	 * True if the box is in this face and any pixel its screen rect touches is not in front of the nearest corner.
+	 * Pixels written by the primitive's own occluder triangles never hide it.
+	 */
+	bool IsBoxVisible(const FVector& Origin, const FVector& Extent, int32 PrimitiveIndex) const;
+
+	/** True if the box is at least partially in front of the face. */
+	bool IsBoxInView(const FBox& Box) const;
+
+	/** 90 degree frustum of the face, without near plane. */
+	void GetFrustum(FConvexVolume& OutFrustum) const;
+
+private:
+	FVector ToView(const FVector& WorldPosition) const { return ViewMatrix.TransformPosition(WorldPosition); }
+	void RasterizeViewTriangle(const FVector& A, const FVector& B, const FVector& C, float Depth, int32 OccluderIndex);
+
+	int32 Resolution;
+	FMatrix ViewMatrix;
+	TArray<float> Depths;
+
+	/** Primitive whose triangle wrote the depth of each pixel. */
+	TArray<int32> Occluders;
+};
+
+/**
+ * Renders occluder meshes (static meshes and landscapes) into small cube maps around sampled
+ * viewpoints and tests the snapshot bounds against them, on worker threads and without the GPU.
+ * Primitives that are not visible from any viewpoint are reported.
+ */
+class FSoftwareOcclusionAnalysis
+{
+public:
+	struct FSettings
+	{
+		int32 Resolution;
+		float OccluderMinSize;
+		int32 OccluderMaxTriangles;
+		int32 OccluderMaxTotalTriangles;
+		float TerrainSpacing;
+	};
+
+	/** Ground positions on a grid over the world bounds, EyeHeight above the first hit of a downward trace. */
+	static void GatherGridViewpoints(UWorld* World, const FBox& WorldBounds, float Spacing, float EyeHeight, TArray<FVector>& OutViewpoints);
+
+	static void GatherPlayerStartViewpoints(UWorld* World, float EyeHeight, TArray<FVector>& OutViewpoints);
+
+	void Run(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot, const TArray<FVector>& Viewpoints, const FSettings& InSettings);
+
+	void PrintReport(const FWorldPrimitiveSnapshot& Snapshot, FOutputDevice& Ar) const;
+
+	bool IsVisible(int32 PrimitiveIndex) const { return Visible[PrimitiveIndex] != 0; }
+
+private:
+	void GatherOccluders(UWorld* World, const FWorldPrimitiveSnapshot& Snapshot);
+	void AddLandscapeOccluders(UWorld* World);
+	void RenderViewFace(const FWorldPrimitiveSnapshot& Snapshot, const FVector& ViewOrigin, const FRotator& ViewRotation);
+
+	FSettings Settings;
+
+	TArray<FVector> OccluderVertices;
+	TArray<FOccluderMesh> OccluderMeshes;
+
+	int32 NumViewpoints;
+
+	/** Written from the worker threads, non zero once the primitive was seen from any face. */
+	TArray<int32> Visible;
+};
@@ -0,0 +1,71 @@
+#include "World/WorldMeshRecords.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "World/WorldPrimitiveSnapshot.h"
+#include "Classes/EditorStaticMesh.h"
+#include "Classes/EditorSkeletalMesh.h"
+
+int32 FWorldMeshRecords::SelectLOD(const FAssetMetricsRecord& Record, FName PlatformGroupName, float ScreenSize)
+{
+	for (int32 LODIndex = Record.NumLODs - 1; LODIndex > 0; --LODIndex)
+	{
+		if (Record.GetLODScreenSize(PlatformGroupName, LODIndex) > ScreenSize)
+		{
+			return LODIndex;
+		}
+	}
+	return 0;
+}
+
+void FWorldMeshRecords::Build(const FWorldPrimitiveSnapshot& Snapshot)
+{
+	Records.Reset();
+	PrimitiveRecords.Init(INDEX_NONE, Snapshot.Num());
+	PrimitiveInstances.Init(1, Snapshot.Num());
+	TMap<UObject*, int32> MeshToRecord;
+	for (int32 Index = 0; Index < Snapshot.Num(); ++Index)
+	{
+		UPrimitiveComponent* Component = Snapshot.GetComponent(Index);
+		UObject* Mesh = nullptr;
+		if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+		{
+			Mesh = StaticMeshComponent->GetStaticMesh();
+			if (UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+			{
+				PrimitiveInstances[Index] = InstancedComponent->GetInstanceCount();
+			}
+		}
+		else if (USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Component))
+		{
+			Mesh = SkeletalMeshComponent->SkeletalMesh;
+		}
+
+		if (!Mesh)
+		{
+			continue;
+		}
+
+		if (const int32* RecordIndex = MeshToRecord.Find(Mesh))
+		{
+			PrimitiveRecords[Index] = *RecordIndex;
+			continue;
+		}
+
+		FAssetMetricsRecord& Record = Records.AddDefaulted_GetRef();
+		if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(Mesh))
+		{
+			FEditorStaticMesh EditorStaticMesh;
+			EditorStaticMesh.Initialize(StaticMesh);
+			EditorStaticMesh.GetMetricsRecord(Record);
+		}
+		else
+		{
+			FEditorSkeletalMesh EditorSkeletalMesh;
+			EditorSkeletalMesh.Initialize(CastChecked<USkeletalMesh>(Mesh));
+			EditorSkeletalMesh.GetMetricsRecord(Record);
+		}
+		PrimitiveRecords[Index] = Records.Num() - 1;
+		MeshToRecord.Add(Mesh, Records.Num() - 1);
+	}
+}
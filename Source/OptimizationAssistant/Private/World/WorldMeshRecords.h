@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetMetricsStore.h"
+
+struct FWorldPrimitiveSnapshot;
+
+/**
+ * Metrics records of every static and skeletal mesh used by the snapshot primitives, read once on
+ * the game thread so the world analyses can use them from worker threads.
+ */
+struct FWorldMeshRecords
+{
+	void Build(const FWorldPrimitiveSnapshot& Snapshot);
+
+	/** nullptr if the primitive has no mesh. */
+	const FAssetMetricsRecord* GetRecord(int32 PrimitiveIndex) const
+	{
+		return PrimitiveRecords[PrimitiveIndex] != INDEX_NONE ? &Records[PrimitiveRecords[PrimitiveIndex]] : nullptr;
+	}
+
+	/** Same LOD choice as the engine: the last LOD whose screen size is still above the bounds screen size. */
+	static int32 SelectLOD(const FAssetMetricsRecord& Record, FName PlatformGroupName, float ScreenSize);
+
+	/** Metrics of every mesh used in the world, indexed by PrimitiveRecords. */
+	TArray<FAssetMetricsRecord> Records;
+
+	/** Index into Records of each snapshot primitive, INDEX_NONE if it has no mesh. */
+	TArray<int32> PrimitiveRecords;
+
+	/** Instance count of each snapshot primitive, 1 unless instanced. */
+	TArray<int32> PrimitiveInstances;
+};
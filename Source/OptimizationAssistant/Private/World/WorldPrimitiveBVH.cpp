@@ -0,0 +1,272 @@
+#include "World/WorldPrimitiveBVH.h"
+#include "ConvexVolume.h"
+#include "World/WorldPrimitiveSnapshot.h"
+
+namespace WorldPrimitiveBVH
+{
+	static const int32 MaxLeafPrimitives = 4;
+	static const int32 NumBins = 12;
+
+	struct FBuildTask
+	{
+		int32 NodeIndex;
+		int32 Begin;
+		int32 End;
+	};
+
+	FORCEINLINE float HalfSurfaceArea(const FBox& Box)
+	{
+		const FVector Size = Box.GetSize();
+		return Size.X * Size.Y + Size.Y * Size.Z + Size.Z * Size.X;
+	}
+}
+
+void FWorldPrimitiveBVH::Reset()
+{
+	NodeMinX.Reset();
+	NodeMinY.Reset();
+	NodeMinZ.Reset();
+	NodeMaxX.Reset();
+	NodeMaxY.Reset();
+	NodeMaxZ.Reset();
+	NodeFirst.Reset();
+	NodeNumPrimitives.Reset();
+	PrimitiveIndices.Reset();
+	PrimitiveMinX.Reset();
+	PrimitiveMinY.Reset();
+	PrimitiveMinZ.Reset();
+	PrimitiveMaxX.Reset();
+	PrimitiveMaxY.Reset();
+	PrimitiveMaxZ.Reset();
+}
+
+int32 FWorldPrimitiveBVH::AddNode()
+{
+	NodeMinX.Add(0.0f);
+	NodeMinY.Add(0.0f);
+	NodeMinZ.Add(0.0f);
+	NodeMaxX.Add(0.0f);
+	NodeMaxY.Add(0.0f);
+	NodeMaxZ.Add(0.0f);
+	NodeNumPrimitives.Add(0);
+	return NodeFirst.Add(INDEX_NONE);
+}
+
+void FWorldPrimitiveBVH::Build(const FWorldPrimitiveSnapshot& Snapshot)
+{
+	using namespace WorldPrimitiveBVH;
+
+	Reset();
+	const int32 NumPrimitives = Snapshot.Num();
+	if (NumPrimitives == 0)
+	{
+		return;
+	}
+
+	TArray<FBox> Boxes;
+	TArray<FVector> Centers;
+	Boxes.SetNumUninitialized(NumPrimitives);
+	Centers.SetNumUninitialized(NumPrimitives);
+	PrimitiveIndices.SetNumUninitialized(NumPrimitives);
+	for (int32 Index = 0; Index < NumPrimitives; ++Index)
+	{
+		Boxes[Index] = Snapshot.GetBox(Index);
+		Centers[Index] = Snapshot.GetOrigin(Index);
+		PrimitiveIndices[Index] = Index;
+	}
+
+	// 一个叶子最多 MaxLeafPrimitives 个组件, 节点数量不超过 2N
+	NodeFirst.Reserve(2 * NumPrimitives);
+	AddNode();
+
+	TArray<FBuildTask> Tasks;
+	Tasks.Add({ 0, 0, NumPrimitives });
+	while (Tasks.Num() > 0)
+	{
+		const FBuildTask Task = Tasks.Pop(false);
+		const int32 Count = Task.End - Task.Begin;
+
+		FBox Bounds(ForceInit);
+		FBox CenterBounds(ForceInit);
+		for (int32 Index = Task.Begin; Index < Task.End; ++Index)
+		{
+			Bounds += Boxes[PrimitiveIndices[Index]];
+			CenterBounds += Centers[PrimitiveIndices[Index]];
+		}
+		NodeMinX[Task.NodeIndex] = Bounds.Min.X;
+		NodeMinY[Task.NodeIndex] = Bounds.Min.Y;
+		NodeMinZ[Task.NodeIndex] = Bounds.Min.Z;
+		NodeMaxX[Task.NodeIndex] = Bounds.Max.X;
+		NodeMaxY[Task.NodeIndex] = Bounds.Max.Y;
+		NodeMaxZ[Task.NodeIndex] = Bounds.Max.Z;
+
+		if (Count <= MaxLeafPrimitives)
+		{
+			NodeFirst[Task.NodeIndex] = Task.Begin;
+			NodeNumPrimitives[Task.NodeIndex] = Count;
+			continue;
+		}
+
+		const FVector CenterSize = CenterBounds.GetSize();
+		const int32 Axis = CenterSize.X >= CenterSize.Y && CenterSize.X >= CenterSize.Z ? 0 : (CenterSize.Y >= CenterSize.Z ? 1 : 2);
+		const float AxisMin = CenterBounds.Min[Axis];
+		const float AxisSize = CenterSize[Axis];
+
+		int32 Split = Task.Begin + Count / 2;
+		if (AxisSize > KINDA_SMALL_NUMBER)
+		{
+			auto GetBin = [&Centers, Axis, AxisMin, AxisSize](int32 Primitive)
+			{
+				return FMath::Min((int32)((Centers[Primitive][Axis] - AxisMin) / AxisSize * NumBins), NumBins - 1);
+			};
+
+			FBox BinBounds[NumBins];
+			int32 BinCounts[NumBins];
+			for (int32 Bin = 0; Bin < NumBins; ++Bin)
+			{
+				BinBounds[Bin].Init();
+				BinCounts[Bin] = 0;
+			}
+			for (int32 Index = Task.Begin; Index < Task.End; ++Index)
+			{
+				const int32 Bin = GetBin(PrimitiveIndices[Index]);
+				BinBounds[Bin] += Boxes[PrimitiveIndices[Index]];
+				++BinCounts[Bin];
+			}
+
+			float RightCosts[NumBins];
+			FBox Accumulated(ForceInit);
+			int32 AccumulatedCount = 0;
+			for (int32 Bin = NumBins - 1; Bin > 0; --Bin)
+			{
+				Accumulated += BinBounds[Bin];
+				AccumulatedCount += BinCounts[Bin];
+				RightCosts[Bin] = AccumulatedCount > 0 ? HalfSurfaceArea(Accumulated) * AccumulatedCount : 0.0f;
+			}
+
+			// 最小和最大的中心点分别落在第一个和最后一个 Bin, 总能找到有效的划分
+			float BestCost = MAX_flt;
+			int32 BestBin = 0;
+			Accumulated.Init();
+			AccumulatedCount = 0;
+			for (int32 Bin = 0; Bin < NumBins - 1; ++Bin)
+			{
+				Accumulated += BinBounds[Bin];
+				AccumulatedCount += BinCounts[Bin];
+				if (AccumulatedCount == 0 || AccumulatedCount == Count)
+				{
+					continue;
+				}
+
+				const float Cost = HalfSurfaceArea(Accumulated) * AccumulatedCount + RightCosts[Bin + 1];
+				if (Cost < BestCost)
+				{
+					BestCost = Cost;
+					BestBin = Bin;
+				}
+			}
+
+			Split = Task.Begin;
+			for (int32 Index = Task.Begin; Index < Task.End; ++Index)
+			{
+				if (GetBin(PrimitiveIndices[Index]) <= BestBin)
+				{
+					Swap(PrimitiveIndices[Index], PrimitiveIndices[Split++]);
+				}
+			}
+		}
+
+		const int32 LeftChild = AddNode();
+		AddNode();
+		NodeFirst[Task.NodeIndex] = LeftChild;
+		NodeNumPrimitives[Task.NodeIndex] = 0;
+		Tasks.Add({ LeftChild, Task.Begin, Split });
+		Tasks.Add({ LeftChild + 1, Split, Task.End });
+	}
+
+	PrimitiveMinX.SetNumUninitialized(NumPrimitives);
+	PrimitiveMinY.SetNumUninitialized(NumPrimitives);
+	PrimitiveMinZ.SetNumUninitialized(NumPrimitives);
+	PrimitiveMaxX.SetNumUninitialized(NumPrimitives);
+	PrimitiveMaxY.SetNumUninitialized(NumPrimitives);
+	PrimitiveMaxZ.SetNumUninitialized(NumPrimitives);
+	for (int32 Index = 0; Index < NumPrimitives; ++Index)
+	{
+		const FBox& Box = Boxes[PrimitiveIndices[Index]];
+		PrimitiveMinX[Index] = Box.Min.X;
+		PrimitiveMinY[Index] = Box.Min.Y;
+		PrimitiveMinZ[Index] = Box.Min.Z;
+		PrimitiveMaxX[Index] = Box.Max.X;
+		PrimitiveMaxY[Index] = Box.Max.Y;
+		PrimitiveMaxZ[Index] = Box.Max.Z;
+	}
+}
+
+template <typename BoundsTestType>
+void FWorldPrimitiveBVH::Traverse(const BoundsTestType& BoundsTest, TArray<int32>& OutPrimitives) const
+{
+	if (NodeFirst.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const int32 Node = Stack.Pop(false);
+		if (!BoundsTest(NodeMinX[Node], NodeMinY[Node], NodeMinZ[Node], NodeMaxX[Node], NodeMaxY[Node], NodeMaxZ[Node]))
+		{
+			continue;
+		}
+
+		const int32 First = NodeFirst[Node];
+		const int32 NumLeafPrimitives = NodeNumPrimitives[Node];
+		if (NumLeafPrimitives == 0)
+		{
+			Stack.Add(First);
+			Stack.Add(First + 1);
+			continue;
+		}
+
+		for (int32 Index = First; Index < First + NumLeafPrimitives; ++Index)
+		{
+			if (BoundsTest(PrimitiveMinX[Index], PrimitiveMinY[Index], PrimitiveMinZ[Index], PrimitiveMaxX[Index], PrimitiveMaxY[Index], PrimitiveMaxZ[Index]))
+			{
+				OutPrimitives.Add(PrimitiveIndices[Index]);
+			}
+		}
+	}
+}
+
+void FWorldPrimitiveBVH::QueryBox(const FBox& Box, TArray<int32>& OutPrimitives) const
+{
+	Traverse([&Box](float MinX, float MinY, float MinZ, float MaxX, float MaxY, float MaxZ)
+	{
+		return MinX <= Box.Max.X && MaxX >= Box.Min.X
+			&& MinY <= Box.Max.Y && MaxY >= Box.Min.Y
+			&& MinZ <= Box.Max.Z && MaxZ >= Box.Min.Z;
+	}, OutPrimitives);
+}
+
+void FWorldPrimitiveBVH::QuerySphere(const FVector& Center, float Radius, TArray<int32>& OutPrimitives) const
+{
+	const float RadiusSquared = FMath::Square(Radius);
+	Traverse([&Center, RadiusSquared](float MinX, float MinY, float MinZ, float MaxX, float MaxY, float MaxZ)
+	{
+		const float DX = FMath::Max3(MinX - Center.X, 0.0f, Center.X - MaxX);
+		const float DY = FMath::Max3(MinY - Center.Y, 0.0f, Center.Y - MaxY);
+		const float DZ = FMath::Max3(MinZ - Center.Z, 0.0f, Center.Z - MaxZ);
+		return DX * DX + DY * DY + DZ * DZ <= RadiusSquared;
+	}, OutPrimitives);
+}
+
+void FWorldPrimitiveBVH::QueryFrustum(const FConvexVolume& Frustum, TArray<int32>& OutPrimitives) const
+{
+	Traverse([&Frustum](float MinX, float MinY, float MinZ, float MaxX, float MaxY, float MaxZ)
+	{
+		const FVector Origin((MinX + MaxX) * 0.5f, (MinY + MaxY) * 0.5f, (MinZ + MaxZ) * 0.5f);
+		const FVector Extent((MaxX - MinX) * 0.5f, (MaxY - MinY) * 0.5f, (MaxZ - MinZ) * 0.5f);
+		return Frustum.IntersectBox(Origin, Extent);
+	}, OutPrimitives);
+}
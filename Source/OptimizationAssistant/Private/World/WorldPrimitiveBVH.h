@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FWorldPrimitiveSnapshot;
+struct FConvexVolume;
+
+/**
+ * Bounding volume hierarchy over the primitive bounds of a world snapshot, built once per check run
+ * with a binned SAH split. Nodes are stored in flat arrays with separate min / max bounds arrays,
+ * the two children of an interior node are always adjacent. Queries return snapshot indices.
+ */
+class FWorldPrimitiveBVH
+{
+public:
+	FWorldPrimitiveBVH() {}
+
+	void Build(const FWorldPrimitiveSnapshot& Snapshot);
+
+	void Reset();
+
+	int32 NumNodes() const { return NodeFirst.Num(); }
+
+	/** Primitives whose bounds overlap the box. */
+	void QueryBox(const FBox& Box, TArray<int32>& OutPrimitives) const;
+
+	/** Primitives whose bounds overlap the sphere. */
+	void QuerySphere(const FVector& Center, float Radius, TArray<int32>& OutPrimitives) const;
+
+	/** Primitives whose bounds intersect the frustum. */
+	void QueryFrustum(const FConvexVolume& Frustum, TArray<int32>& OutPrimitives) const;
+
+private:
+	template <typename BoundsTestType>
+	void Traverse(const BoundsTestType& BoundsTest, TArray<int32>& OutPrimitives) const;
+
+	int32 AddNode();
+
+	/** Node bounds. */
+	TArray<float> NodeMinX;
+	TArray<float> NodeMinY;
+	TArray<float> NodeMinZ;
+	TArray<float> NodeMaxX;
+	TArray<float> NodeMaxY;
+	TArray<float> NodeMaxZ;
+
+	/** Left child of an interior node, first entry in PrimitiveIndices of a leaf. */
+	TArray<int32> NodeFirst;
+
+	/** Number of primitives of a leaf, 0 for interior nodes. */
+	TArray<int32> NodeNumPrimitives;
+
+	/** Snapshot indices in leaf order, leaves reference contiguous ranges. */
+	TArray<int32> PrimitiveIndices;
+
+	/** Primitive bounds in leaf order so leaf tests don't jump around the snapshot. */
+	TArray<float> PrimitiveMinX;
+	TArray<float> PrimitiveMinY;
+	TArray<float> PrimitiveMinZ;
+	TArray<float> PrimitiveMaxX;
+	TArray<float> PrimitiveMaxY;
+	TArray<float> PrimitiveMaxZ;
+};
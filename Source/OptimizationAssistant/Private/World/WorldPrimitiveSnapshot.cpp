@@ -0,0 +1,110 @@
+#include "World/WorldPrimitiveSnapshot.h"
+#include "EngineUtils.h"
+#include "Engine/CullDistanceVolume.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "OptimizationAssistantGlobalSettings.h"
+#include "OptimizationAssistantHelpers.h"
+
+static EWorldPrimitiveType GetWorldPrimitiveType(const UPrimitiveComponent* Component)
+{
+	if (Component->IsA<UInstancedStaticMeshComponent>())
+	{
+		return EWorldPrimitiveType::InstancedStaticMesh;
+	}
+	if (Component->IsA<UStaticMeshComponent>())
+	{
+		return EWorldPrimitiveType::StaticMesh;
+	}
+	if (Component->IsA<USkeletalMeshComponent>())
+	{
+		return EWorldPrimitiveType::SkeletalMesh;
+	}
+	if (Component->IsA<UParticleSystemComponent>())
+	{
+		return EWorldPrimitiveType::ParticleSystem;
+	}
+	return EWorldPrimitiveType::Other;
+}
+
+void FWorldPrimitiveSnapshot::Reset()
+{
+	Components.Reset();
+	OriginX.Reset();
+	OriginY.Reset();
+	OriginZ.Reset();
+	ExtentX.Reset();
+	ExtentY.Reset();
+	ExtentZ.Reset();
+	SphereRadius.Reset();
+	LDMaxDrawDistance.Reset();
+	CachedMaxDrawDistance.Reset();
+	Types.Reset();
+	Flags.Reset();
+	WorldBounds.Init();
+	BVH.Reset();
+}
+
+void FWorldPrimitiveSnapshot::Build(UWorld* World, const UGlobalCheckSettings* GlobalCheckSettings)
+{
+	Reset();
+	if (!World)
+	{
+		return;
+	}
+
+	for (FActorIterator ActorIterator(World); ActorIterator; ++ActorIterator)
+	{
+		AActor* Actor = *ActorIterator;
+		if (Actor->IsEditorOnly() || Actor->ActorHasTag(GlobalCheckSettings->DisableCheckTagName))
+		{
+			continue;
+		}
+
+		if (GlobalCheckSettings->IsInNeverCheckDirectory(Actor->GetFullName()))
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents;
+		Actor->GetComponents<UPrimitiveComponent>(PrimitiveComponents, true);
+		for (UPrimitiveComponent* Component : PrimitiveComponents)
+		{
+			if (!Component->IsRegistered() || Component->IsEditorOnly() || Component->bHiddenInGame || !Component->IsVisible())
+			{
+				continue;
+			}
+
+			if (Component->ComponentHasTag(GlobalCheckSettings->DisableCheckTagName))
+			{
+				continue;
+			}
+
+			uint8 PrimitiveFlags = WPF_None;
+			PrimitiveFlags |= ACullDistanceVolume::CanBeAffectedByVolumes(Component) ? WPF_AffectedByCullDistanceVolume : 0;
+			PrimitiveFlags |= (Component->bNeverDistanceCull || Component->GetLODParentPrimitive()) ? WPF_NeverDistanceCull : 0;
+			PrimitiveFlags |= Component->CastShadow ? WPF_CastShadow : 0;
+			PrimitiveFlags |= (Component->CastShadow && Component->bCastDynamicShadow) ? WPF_CastDynamicShadow : 0;
+			PrimitiveFlags |= Component->Mobility == EComponentMobility::Movable ? WPF_Movable : 0;
+
+			const FBoxSphereBounds& Bounds = Component->Bounds;
+			Components.Add(Component);
+			OriginX.Add(Bounds.Origin.X);
+			OriginY.Add(Bounds.Origin.Y);
+			OriginZ.Add(Bounds.Origin.Z);
+			ExtentX.Add(Bounds.BoxExtent.X);
+			ExtentY.Add(Bounds.BoxExtent.Y);
+			ExtentZ.Add(Bounds.BoxExtent.Z);
+			SphereRadius.Add(Bounds.SphereRadius);
+			LDMaxDrawDistance.Add(Component->LDMaxDrawDistance);
+			CachedMaxDrawDistance.Add(Component->CachedMaxDrawDistance);
+			Types.Add(GetWorldPrimitiveType(Component));
+			Flags.Add(PrimitiveFlags);
+			WorldBounds += Bounds.GetBox();
+		}
+	}
+
+	BVH.Build(*this);
+	UE_LOG(LogOptimizationAssistant, Log, TEXT("World snapshot of %s: %d primitives, %d BVH nodes."), *World->GetName(), Components.Num(), BVH.NumNodes());
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "World/WorldPrimitiveBVH.h"
+
+class UPrimitiveComponent;
+class UGlobalCheckSettings;
+
+enum class EWorldPrimitiveType : uint8
+{
+	StaticMesh,
+	InstancedStaticMesh,
+	SkeletalMesh,
+	ParticleSystem,
+	Other,
+};
+
+enum EWorldPrimitiveFlags : uint8
+{
+	WPF_None = 0,
+	/** ACullDistanceVolume::CanBeAffectedByVolumes is true. */
+	WPF_AffectedByCullDistanceVolume = 1 << 0,
+	WPF_NeverDistanceCull = 1 << 1,
+	WPF_CastShadow = 1 << 2,
+	WPF_CastDynamicShadow = 1 << 3,
+	WPF_Movable = 1 << 4,
+};
+
+/**
+ * Bounds of every checked primitive of a world, gathered once per check run and shared by the
+ * world analyses. Bounds are kept as separate float arrays so the analyses can run tight loops
+ * over them without touching the components, spatial queries go through the BVH built with it.
+ */
+struct FWorldPrimitiveSnapshot
+{
+	/** Gathers the primitives of World, skipping the same actors and components as the asset checks. */
+	void Build(UWorld* World, const UGlobalCheckSettings* GlobalCheckSettings);
+
+	void Reset();
+
+	int32 Num() const { return Components.Num(); }
+
+	/** nullptr if the component was destroyed after the snapshot was built. */
+	UPrimitiveComponent* GetComponent(int32 Index) const { return Components[Index].Get(); }
+
+	FVector GetOrigin(int32 Index) const { return FVector(OriginX[Index], OriginY[Index], OriginZ[Index]); }
+	FVector GetExtent(int32 Index) const { return FVector(ExtentX[Index], ExtentY[Index], ExtentZ[Index]); }
+	FBox GetBox(int32 Index) const { return FBox::BuildAABB(GetOrigin(Index), GetExtent(Index)); }
+
+	bool HasAnyFlags(int32 Index, uint8 InFlags) const { return (Flags[Index] & InFlags) != 0; }
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Components;
+
+	TArray<float> OriginX;
+	TArray<float> OriginY;
+	TArray<float> OriginZ;
+	TArray<float> ExtentX;
+	TArray<float> ExtentY;
+	TArray<float> ExtentZ;
+	TArray<float> SphereRadius;
+
+	/** LDMaxDrawDistance set on the component, 0 means never culled by distance. */
+	TArray<float> LDMaxDrawDistance;
+
+	/** CachedMaxDrawDistance, includes the distance assigned by cull distance volumes. */
+	TArray<float> CachedMaxDrawDistance;
+
+	TArray<EWorldPrimitiveType> Types;
+	TArray<uint8> Flags;
+
+	/** Union of all primitive bounds. */
+	FBox WorldBounds;
+
+	/** Built at the end of Build, queries return indices into the arrays above. */
+	FWorldPrimitiveBVH BVH;
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PerPlatformProperties.h"
+
+#define OA_METRICS_MAX_LODS 8
+
+enum class EAssetMetricsType : uint8
+{
+	StaticMesh,
+	SkeletalMesh,
+	Max
+};
+
+/** Metrics of one asset gathered during a scan. */
+struct FAssetMetricsRecord
+{
+	FAssetMetricsRecord();
+
+	FString ObjectPath;
+
+	EAssetMetricsType AssetType;
+
+	int32 NumLODs;
+
+	/** Number of material slots whose name does not contain "LOD". */
+	int32 NumMaterials;
+
+	int32 NumTriangles[OA_METRICS_MAX_LODS];
+
+	int32 NumVertices[OA_METRICS_MAX_LODS];
+
+	int32 NumUVChannels[OA_METRICS_MAX_LODS];
+
+	int32 NumSections[OA_METRICS_MAX_LODS];
+
+	/** Estimated GPU and CPU access memory of each LOD, the distance field is counted on LOD0. */
+	int32 ResidentBytes[OA_METRICS_MAX_LODS];
+
+	/** The display factors at which LODs swap */
+	FPerPlatformFloat LODScreenSizes[OA_METRICS_MAX_LODS];
+
+	float GetLODScreenSize(FName PlatformGroupName, int32 LODIndex) const;
+
+	/** Resident memory of all LODs. */
+	int64 GetResidentBytes() const;
+};
+
+/** Column identifiers of the metrics file, every column is one contiguous block. */
+enum class EAssetMetricsColumn : uint32
+{
+	AssetType,			// uint8[N]
+	NumLODs,			// int32[N]
+	NumMaterials,		// int32[N]
+	LODTriangles,		// int32[OA_METRICS_MAX_LODS][N]
+	LODVertices,		// int32[OA_METRICS_MAX_LODS][N]
+	LODUVChannels,		// int32[OA_METRICS_MAX_LODS][N]
+	LODSections,		// int32[OA_METRICS_MAX_LODS][N]
+	LODResidentBytes,	// int32[OA_METRICS_MAX_LODS][N]
+	LODScreenSize,		// float[OA_METRICS_MAX_LODS][N], default screen sizes
+	PathOffsets,		// int32[N + 1], offsets into PathChars
+	PathChars,			// UTF8 object paths
+	PlatformNames,		// UTF8 platform group names, each terminated by '\0'
+	PlatformLODScreenSize,	// float[NumPlatforms][OA_METRICS_MAX_LODS][N], the default screen size where a platform has no override
+	Max
+};
+
+/**
+ * Columnar (structure of arrays) store of the asset metrics computed by a scan.
+ * Records are appended while the pages run and the whole store is written once at the end.
+ */
+class FAssetMetricsStore
+{
+public:
+	static FAssetMetricsStore& Get();
+
+	/** Path of the metrics file written next to the check reports. */
+	static FString GetDefaultFilePath();
+
+	void Reset();
+
+	void AddRecord(const FAssetMetricsRecord& Record);
+
+	int32 Num() const { return ObjectPaths.Num(); }
+
+	bool Save(const FString& Filename) const;
+
+private:
+	TArray<FString> ObjectPaths;
+	TArray<uint8> AssetTypes;
+	TArray<int32> NumLODs;
+	TArray<int32> NumMaterials;
+	TArray<int32> LODTriangles[OA_METRICS_MAX_LODS];
+	TArray<int32> LODVertices[OA_METRICS_MAX_LODS];
+	TArray<int32> LODUVChannels[OA_METRICS_MAX_LODS];
+	TArray<int32> LODSections[OA_METRICS_MAX_LODS];
+	TArray<int32> LODResidentBytes[OA_METRICS_MAX_LODS];
+	TArray<float> LODScreenSizes[OA_METRICS_MAX_LODS];
+
+	/** Per platform overrides of the screen sizes, expanded into dense columns when saved. */
+	struct FPlatformScreenSize
+	{
+		int32 RecordIndex;
+		int32 LODIndex;
+		FName PlatformGroupName;
+		float ScreenSize;
+	};
+	TArray<FPlatformScreenSize> PlatformScreenSizes;
+};
+
+/**
+ * Read only view of a metrics file. The file is memory mapped and the columns are
+ * used in place, nothing is copied or deserialized.
+ */
+class FMappedAssetMetrics
+{
+public:
+	FMappedAssetMetrics();
+	~FMappedAssetMetrics();
+
+	bool Open(const FString& Filename);
+	void Close();
+
+	bool IsValid() const { return MappedRegion != nullptr; }
+	int32 Num() const { return NumRecords; }
+
+	const uint8* GetAssetTypes() const { return GetColumn<uint8>(EAssetMetricsColumn::AssetType); }
+	const int32* GetNumLODs() const { return GetColumn<int32>(EAssetMetricsColumn::NumLODs); }
+	const int32* GetNumMaterials() const { return GetColumn<int32>(EAssetMetricsColumn::NumMaterials); }
+	const int32* GetLODTriangles(int32 LODIndex) const { return GetLODColumn<int32>(EAssetMetricsColumn::LODTriangles, LODIndex); }
+	const int32* GetLODVertices(int32 LODIndex) const { return GetLODColumn<int32>(EAssetMetricsColumn::LODVertices, LODIndex); }
+	const int32* GetLODUVChannels(int32 LODIndex) const { return GetLODColumn<int32>(EAssetMetricsColumn::LODUVChannels, LODIndex); }
+	const int32* GetLODSections(int32 LODIndex) const { return GetLODColumn<int32>(EAssetMetricsColumn::LODSections, LODIndex); }
+	const int32* GetLODResidentBytes(int32 LODIndex) const { return GetLODColumn<int32>(EAssetMetricsColumn::LODResidentBytes, LODIndex); }
+	const float* GetLODScreenSizes(int32 LODIndex) const { return GetLODColumn<float>(EAssetMetricsColumn::LODScreenSize, LODIndex); }
+
+	/** Screen sizes seen by a platform group, the default screen sizes if the file has no overrides for it. */
+	const float* GetLODScreenSizes(int32 LODIndex, FName PlatformGroupName) const;
+
+	const TArray<FName>& GetPlatformNames() const { return PlatformNames; }
+
+	FString GetObjectPath(int32 Index) const;
+	const ANSICHAR* GetObjectPathChars(int32 Index, int32& OutLength) const;
+
+private:
+	const uint8* GetColumnData(EAssetMetricsColumn Column) const;
+
+	/** Rejects columns smaller than NumRecords elements and object paths outside of PathChars. */
+	bool ValidateColumns(const FString& Filename);
+
+	template<typename T>
+	const T* GetColumn(EAssetMetricsColumn Column) const
+	{
+		return reinterpret_cast<const T*>(GetColumnData(Column));
+	}
+
+	template<typename T>
+	const T* GetLODColumn(EAssetMetricsColumn Column, int32 LODIndex) const
+	{
+		const T* Data = GetColumn<T>(Column);
+		return Data && LODIndex >= 0 && LODIndex < OA_METRICS_MAX_LODS ? Data + (int64)LODIndex * NumRecords : nullptr;
+	}
+
+	class IMappedFileHandle* MappedHandle;
+	class IMappedFileRegion* MappedRegion;
+	int32 NumRecords;
+	int64 ColumnOffsets[(uint32)EAssetMetricsColumn::Max];
+	int64 ColumnSizes[(uint32)EAssetMetricsColumn::Max];
+	TArray<FName> PlatformNames;
+};
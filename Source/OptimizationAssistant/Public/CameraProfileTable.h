@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FCameraProfile;
+
+/** A camera profile with its projection resolved once when the table is built. */
+struct FCameraProfileEntry
+{
+	FString Name;
+
+	/** NAME_None applies to every target platform. */
+	FName PlatformGroupName;
+
+	float FOV;
+	int32 ResolutionX;
+	int32 ResolutionY;
+
+	FMatrix ProjectionMatrix;
+
+	/** max(0.5 * M[0][0], 0.5 * M[1][1]) of the projection, see ComputeBoundsDrawDistance. */
+	float ScreenMultiple;
+};
+
+/** Draw distances of one bounds for every profile, padded to a multiple of 4 for the vector kernel. */
+typedef TArray<float, TAlignedHeapAllocator<16>> FCameraDrawDistances;
+
+/**
+ * Camera profiles (FOV, resolution, platform) used to turn a screen size into a draw distance.
+ * The table is built at the start of a check run from UGlobalCheckSettings::CameraProfiles,
+ * keeping the profiles of the selected target platforms.
+ */
+class OPTIMIZATIONASSISTANT_API FCameraProfileTable
+{
+public:
+	static FCameraProfileTable Create(const TArray<FCameraProfile>& CameraProfiles, const TArray<FName>& PlatformGroupNames);
+
+	/** Profiles from the global check settings that apply to the selected target platforms. */
+	static FCameraProfileTable CreateForTargetPlatforms();
+
+	void AddProfile(const FString& Name, FName PlatformGroupName, float FOV, int32 ResolutionX, int32 ResolutionY);
+
+	int32 Num() const { return Profiles.Num(); }
+
+	const FCameraProfileEntry& GetProfile(int32 ProfileIndex) const { return Profiles[ProfileIndex]; }
+
+	/** Appended to a report line when the table holds more than one profile. */
+	FString GetProfileSuffix(int32 ProfileIndex) const;
+
+	/** Computes the draw distance at which bounds of SphereRadius reach ScreenSize for all profiles at once, OutDrawDistances[i] belongs to profile i. */
+	void ComputeDrawDistances(float SphereRadius, float ScreenSize, FCameraDrawDistances& OutDrawDistances) const;
+
+	/**
+	 * Largest screen size at which a world space deviation of WorldError projects to at most MaxPixelError
+	 * pixels on the profile's render target. MAX_flt when the deviation is zero.
+	 */
+	float ComputeMaxScreenSize(int32 ProfileIndex, float SphereRadius, float WorldError, float MaxPixelError) const;
+
+private:
+	TArray<FCameraProfileEntry> Profiles;
+
+	/** ScreenMultiple of each profile, padded with zeros to a multiple of 4. */
+	TArray<float, TAlignedHeapAllocator<16>> ScreenMultiples;
+};
@@ -19,12 +19,42 @@ enum EOptimizationCheckFlags
 	OCF_LODDuplicateMaterials UMETA(DisplayName = "LODDuplicateMaterials"),
 	OCF_MeshMaterialNumLimit UMETA(DisplayName = "MeshMaterialNumLimit"),
 	OCF_SortByTriangles UMETA(DisplayName = "SortMeshByTriangles"),
+	OCF_MeshMemoryLimit UMETA(DisplayName = "MeshMemoryLimit"),
+	OCF_SortByMemory UMETA(DisplayName = "SortMeshByMemory"),
+	OCF_VertexFormatPrecision UMETA(DisplayName = "VertexFormatPrecision"),
+	OCF_VertexCacheEfficiency UMETA(DisplayName = "VertexCacheEfficiency"),
+	OCF_DuplicateMeshes UMETA(DisplayName = "DuplicateMeshes"),
+	OCF_UnusedVertexStreams UMETA(DisplayName = "UnusedVertexStreams"),
+	OCF_LODGeometricError UMETA(DisplayName = "LODGeometricError"),
+	OCF_LODReductionPreview UMETA(DisplayName = "LODReductionPreview"),
+	OCF_LODSettingsFix UMETA(DisplayName = "LODSettingsFix"),
 	OCF_Max UMETA(Hidden),
 };
-const int32 OCF_DefaultValue = 0xFFFF;
-
 #define EMUM_TO_FLAG(Enum) (1 << static_cast<uint32>(Enum))
 
+// 只输出报告的检查默认开启 (OCF_NoFlags 对应自定义的 ThresholdRules)
+// LODReductionPreview 对每个Mesh的每个候选值都要减面一次, LODSettingsFix 会修改资源, 这两项需要手动开启
+const int32 OCF_DefaultValue =
+	EMUM_TO_FLAG(OCF_NoFlags) |
+	EMUM_TO_FLAG(OCF_CullDistance) |
+	EMUM_TO_FLAG(OCF_NetCullDistance) |
+	EMUM_TO_FLAG(OCF_TrianglesLODNum) |
+	EMUM_TO_FLAG(OCF_LODNumLimit) |
+	EMUM_TO_FLAG(OCF_LODTrianglesLimit) |
+	EMUM_TO_FLAG(OCF_LODScreenSizeLimit) |
+	EMUM_TO_FLAG(OCF_LODMaterialNumLimit) |
+	EMUM_TO_FLAG(OCF_LODUVChannelLimit) |
+	EMUM_TO_FLAG(OCF_LODDuplicateMaterials) |
+	EMUM_TO_FLAG(OCF_MeshMaterialNumLimit) |
+	EMUM_TO_FLAG(OCF_SortByTriangles) |
+	EMUM_TO_FLAG(OCF_MeshMemoryLimit) |
+	EMUM_TO_FLAG(OCF_SortByMemory) |
+	EMUM_TO_FLAG(OCF_VertexFormatPrecision) |
+	EMUM_TO_FLAG(OCF_VertexCacheEfficiency) |
+	EMUM_TO_FLAG(OCF_DuplicateMeshes) |
+	EMUM_TO_FLAG(OCF_UnusedVertexStreams) |
+	EMUM_TO_FLAG(OCF_LODGeometricError);
+
 enum class EOptimizationCheckType
 {
 	OCT_None,
@@ -33,6 +63,38 @@ enum class EOptimizationCheckType
 	OCT_AllAssets
 };
 
+USTRUCT()
+struct FCameraProfile
+{
+	GENERATED_BODY()
+
+	// 镜头名称，会输出到检查报告中
+	UPROPERTY(EditAnywhere, config)
+	FString Name;
+
+	// 水平视角(度)
+	UPROPERTY(EditAnywhere, config, meta = (UIMin = "5", UIMax = "170", ClampMin = "1", ClampMax = "170"))
+	float FOV;
+
+	UPROPERTY(EditAnywhere, config, meta = (ClampMin = "1"))
+	int32 ResolutionX;
+
+	UPROPERTY(EditAnywhere, config, meta = (ClampMin = "1"))
+	int32 ResolutionY;
+
+	// 该镜头适用的平台组(如 Mobile、Desktop)，为空时适用于所有平台
+	UPROPERTY(EditAnywhere, config)
+	FName PlatformGroupName;
+
+	FCameraProfile()
+		: Name(TEXT("Default"))
+		, FOV(90.0f)
+		, ResolutionX(1920)
+		, ResolutionY(1080)
+		, PlatformGroupName(NAME_None)
+	{}
+};
+
 UCLASS(config = OptimizationAssistant, defaultconfig)
 class UGlobalCheckSettings : public UObject
 {
@@ -53,13 +115,13 @@ public:
 	UPROPERTY(config, EditAnywhere, meta = (Bitmask, BitmaskEnum = EOptimizationCheckFlags))
 	uint32 OptimizationFlagsBitmask;
 
-	EOptimizationCheckType OptimizationCheckType;
-
-	float CullDistanceErrorScale;
+	// 计算建议裁剪距离时使用的镜头，每个组件会对所有适用于目标平台的镜头分别计算
+	UPROPERTY(config, EditAnywhere, Category = Camera)
+	TArray<FCameraProfile> CameraProfiles;
 
-	float TrianglesErrorScale;
+	EOptimizationCheckType OptimizationCheckType;
 
-	bool IsInNeverCheckDirectory(const FString& InPath);
+	bool IsInNeverCheckDirectory(const FString& InPath) const;
 
 	bool HasAnyFlags(EOptimizationCheckFlags FlagsToCheck)const
 	{
@@ -67,6 +129,26 @@ public:
 	}
 };
 
+USTRUCT()
+struct FThresholdRule
+{
+	GENERATED_BODY()
+
+	// 规则名称，会输出到检查报告中
+	UPROPERTY(EditAnywhere, config)
+	FString Name;
+
+	// 条件表达式，结果为真时报告问题，例如 LOD[i].Triangles > LOD0.Triangles * 0.5 / i
+	UPROPERTY(EditAnywhere, config)
+	FString Condition;
+
+	// 对每一级LOD分别求值，表达式中用 i 表示当前LOD
+	UPROPERTY(EditAnywhere, config)
+	bool bPerLOD;
+
+	FThresholdRule() : bPerLOD(false) {}
+};
+
 UCLASS(config = OptimizationAssistant, defaultconfig)
 class UMeshOptimizationRules : public URecommendMeshSettings
 {
@@ -91,6 +173,26 @@ public:
 	UPROPERTY(EditAnywhere, config)
 	float NeverCullMeshSize;
 
+	// 满足条件的Mesh跳过资源检查，例如 LOD0.Triangles <= 500，为空时不跳过
+	UPROPERTY(EditAnywhere, config, Category = Threshold)
+	FString SkipCondition;
+
+	// 第i级LOD的面数超出限制的条件
+	UPROPERTY(EditAnywhere, config, Category = Threshold)
+	FString LODTrianglesCondition;
+
+	// 第i级LOD的ScreenSize过小的条件
+	UPROPERTY(EditAnywhere, config, Category = Threshold)
+	FString LODScreenSizeCondition;
+
+	// 组件设置的裁剪距离(CullDistance)过大的条件
+	UPROPERTY(EditAnywhere, config, Category = Threshold)
+	FString CullDistanceCondition;
+
+	// 自定义的阈值规则
+	UPROPERTY(EditAnywhere, config, Category = Threshold)
+	TArray<FThresholdRule> ThresholdRules;
+
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)override;
 
 	virtual bool ValidateSettings();
@@ -26,32 +26,45 @@ public:
 	*/
 	static void GetDependentPackages(const TSet<FName>& RootPackages, TSet<FName>& FoundPackages);
 	
+	/** Single camera at 1920x1080, checks use FCameraProfileTable to cover every camera profile. */
 	static float ComputeDrawDistanceFromScreenSize(const UPrimitiveComponent* PrimitiveComponent, float ScreenSize = 0.05f, float FOV = 90.0f);
 	static float ComputeDrawDistanceFromScreenSize(float SphereRadius, float ScreenSize = 0.05f, float FOV = 90.0f);
 
 	static const TArray<const PlatformInfo::FPlatformInfo*>& GetAvailablePlatforms();
 
-	static const PlatformInfo::FPlatformInfo* GetTargetPlatform();
+	/** Platforms selected for the check, all of them are evaluated in the same pass. */
+	static const TArray<const PlatformInfo::FPlatformInfo*>& GetTargetPlatforms();
 
-	static void SetTargetPlatform(const PlatformInfo::FPlatformInfo* InPlatformInfo);
+	/** Unique platform groups of the selected platforms, NAME_None (default values) if nothing is selected. */
+	static TArray<FName> GetTargetPlatformGroupNames();
+
+	static bool IsTargetPlatform(const PlatformInfo::FPlatformInfo* InPlatformInfo);
+
+	static void SetTargetPlatformEnabled(const PlatformInfo::FPlatformInfo* InPlatformInfo, bool bEnabled);
 
 private:
 	static TArray<const PlatformInfo::FPlatformInfo*> AvailablePlatforms;
 
-	static const PlatformInfo::FPlatformInfo* TargetPlatform;
+	static TArray<const PlatformInfo::FPlatformInfo*> TargetPlatforms;
 };
 
 
 namespace OAHelper
 {
+	/** Timestamped path of a report file in Saved/Profiling/OptimizationAssistant, the directory is created if needed. */
+	inline FString MakeReportFilePath(const FString& FileName, const TCHAR* Extension)
+	{
+		const FString PathName = *(FPaths::ProfilingDir() + TEXT("OptimizationAssistant/"));
+		IFileManager::Get().MakeDirectory(*PathName);
+		FString Filename = FString::Printf(TEXT("%s_%s%s"), *FileName, *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")), Extension);
+		return FPaths::Combine(PathName, Filename);
+	}
+
 	struct FScopeOutputArchive
 	{
 		FScopeOutputArchive(const FString& FileName)
 		{
-			const FString PathName = *(FPaths::ProfilingDir() + TEXT("OptimizationAssistant/"));
-			IFileManager::Get().MakeDirectory(*PathName);
-			FString Filename = FString::Printf(TEXT("%s_%s%s"), *FileName, *FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")), TEXT(".txt"));
-			FString FileFullPath = FPaths::Combine(PathName, Filename);
+			FString FileFullPath = MakeReportFilePath(FileName, TEXT(".txt"));
 #if ALLOW_DEBUG_FILES
 			FileAr = IFileManager::Get().CreateDebugFileWriter(*FileFullPath);
 #else
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetMetricsStore.h"
+#include "OptimizationAssistantGlobalSettings.h"
+#include "ThresholdExpression.h"
+#include "CameraProfileTable.h"
+
+struct FCompiledThresholdRule
+{
+	FString Name;
+	bool bPerLOD;
+	FThresholdExpression Condition;
+};
+
+/** Threshold conditions of one mesh type, compiled from UMeshOptimizationRules. */
+struct FMeshThresholdExpressions
+{
+	FThresholdExpression Skip;
+	FThresholdExpression LODTriangles;
+	FThresholdExpression LODScreenSize;
+	FThresholdExpression CullDistance;
+	TArray<FCompiledThresholdRule> CustomRules;
+};
+
+/** Values that differ between the selected target platforms, snapshotted from the FPerPlatformFloat settings. */
+struct FOptimizationPlatformGroup
+{
+	FName PlatformGroupName;
+
+	/** Recommended LOD screen sizes of each asset type for this platform group. */
+	float RecommendLODScreenSizes[(int32)EAssetMetricsType::Max][OA_METRICS_MAX_LODS];
+};
+
+/**
+ * Everything a rule needs from the settings, resolved once at the start of a check run
+ * so the rules never touch the settings objects while assets are evaluated.
+ */
+struct OPTIMIZATIONASSISTANT_API FOptimizationRuleContext
+{
+	FOptimizationRuleContext();
+
+	/** Reads the global check settings, the mesh rules and the selected target platforms. */
+	static FOptimizationRuleContext Create();
+
+	uint32 OptimizationFlagsBitmask;
+
+	float MaxNetCullDistanceSquared;
+
+	/** Rule settings of each asset type, nullptr if the type has none. */
+	UMeshOptimizationRules* MeshRules[(int32)EAssetMetricsType::Max];
+
+	/** Platform groups of the selected target platforms, there is always at least one (NAME_None uses the default values). */
+	TArray<FOptimizationPlatformGroup> PlatformGroups;
+
+	/** Camera profiles of the selected target platforms used for recommended draw distances. */
+	FCameraProfileTable CameraProfiles;
+
+	/** Recommended LOD triangle percents of LOD 0 for each asset type. */
+	float RecommendLODTrianglesPercents[(int32)EAssetMetricsType::Max][OA_METRICS_MAX_LODS];
+
+	FMeshThresholdExpressions MeshThresholds[(int32)EAssetMetricsType::Max];
+
+	bool HasAnyFlags(EOptimizationCheckFlags FlagsToCheck) const
+	{
+		return (OptimizationFlagsBitmask & EMUM_TO_FLAG(FlagsToCheck)) != 0;
+	}
+
+	UMeshOptimizationRules* GetMeshRules(EAssetMetricsType AssetType) const
+	{
+		return MeshRules[(int32)AssetType];
+	}
+
+	const FMeshThresholdExpressions& GetMeshThresholds(EAssetMetricsType AssetType) const
+	{
+		return MeshThresholds[(int32)AssetType];
+	}
+
+	int32 NumPlatformGroups() const { return PlatformGroups.Num(); }
+
+	/** Appended to a report line when it only applies to one of several target platform groups. */
+	FString GetPlatformGroupSuffix(int32 PlatformGroupIndex) const;
+
+	/** Fills the variables of the threshold expressions for LOD LODIndex of the record, as seen on the given platform group. */
+	void SetupThresholdVariables(const FAssetMetricsRecord& Record, int32 LODIndex, FThresholdVariables& OutVariables, int32 PlatformGroupIndex = 0) const;
+};
+
+/**
+ * A check evaluated over the metrics record of an asset. Rules are registered with
+ * FOptimizationRuleRegistry, other modules can add their own rules the same way.
+ */
+class OPTIMIZATIONASSISTANT_API IOptimizationRule
+{
+public:
+	virtual ~IOptimizationRule() {}
+
+	/** Unique name used to register and unregister the rule. */
+	virtual FName GetRuleName() const = 0;
+
+	virtual bool SupportsAssetType(EAssetMetricsType AssetType) const { return true; }
+
+	/** Called once per run, disabled rules are left out of the compiled table. */
+	virtual bool IsEnabled(const FOptimizationRuleContext& Context) const { return true; }
+
+	/** Appends a line to ErrorMessage for every problem found on the asset. */
+	virtual void Evaluate(const FAssetMetricsRecord& Record, const FOptimizationRuleContext& Context, FString& ErrorMessage) const = 0;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OptimizationRule.h"
+
+class OPTIMIZATIONASSISTANT_API FOptimizationRuleRegistry
+{
+public:
+	static FOptimizationRuleRegistry& Get();
+
+	/** Adds a rule, a rule with the same name is replaced. */
+	void RegisterRule(const TSharedRef<IOptimizationRule>& Rule);
+
+	void UnregisterRule(FName RuleName);
+
+	const TArray<TSharedRef<IOptimizationRule>>& GetRules() const { return Rules; }
+
+private:
+	TArray<TSharedRef<IOptimizationRule>> Rules;
+};
+
+/**
+ * Flat table of the rules enabled for one asset type, compiled once per check run.
+ * Evaluating an asset is a single loop over the table without any flag or settings lookups.
+ */
+class OPTIMIZATIONASSISTANT_API FCompiledOptimizationRules
+{
+public:
+	FCompiledOptimizationRules();
+
+	void Compile(const FOptimizationRuleRegistry& Registry, const FOptimizationRuleContext& InContext, EAssetMetricsType InAssetType);
+
+	void Evaluate(const FAssetMetricsRecord& Record, FString& ErrorMessage) const;
+
+	/** True if the record matches the skip condition of its asset type. */
+	bool ShouldSkip(const FAssetMetricsRecord& Record) const;
+
+	int32 Num() const { return Evaluators.Num(); }
+
+	const FOptimizationRuleContext& GetContext() const { return Context; }
+
+private:
+	FOptimizationRuleContext Context;
+
+	EAssetMetricsType AssetType;
+
+	/** Keeps the rules alive while the table is in use, even if they are unregistered meanwhile. */
+	TArray<TSharedRef<IOptimizationRule>> CompiledRules;
+
+	TArray<const IOptimizationRule*> Evaluators;
+};
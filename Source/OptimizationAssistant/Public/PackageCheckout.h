@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ISourceControlProvider;
+
+/** Files of one batched checkout, absolute paths. */
+struct FPackageCheckoutResult
+{
+	FPackageCheckoutResult()
+		: Seconds(0.0)
+	{
+	}
+
+	/** Files made writable by this checkout. */
+	TArray<FString> CheckedOutFiles;
+
+	/** Files already checked out, added or writable. */
+	TArray<FString> WritableFiles;
+
+	/** Files that can not be modified, for example checked out by someone else or not at the head revision. */
+	TArray<FString> FailedFiles;
+
+	double Seconds;
+};
+
+/** Makes the files a fix job is about to modify writable, the whole batch at once. */
+class OPTIMIZATIONASSISTANT_API IPackageCheckoutBackend
+{
+public:
+	virtual ~IPackageCheckoutBackend() {}
+
+	virtual const TCHAR* GetName() const = 0;
+
+	virtual void CheckOut(const TArray<FString>& Filenames, FPackageCheckoutResult& OutResult) = 0;
+};
+
+/**
+ * The editor's source control provider. The state of every file is refreshed with one FUpdateStatus and all
+ * files that can be checked out go into one FCheckOut, so the server sees two requests however large the batch.
+ * The provider is passed in, so the batched path can also be timed against a stub provider.
+ */
+class OPTIMIZATIONASSISTANT_API FSourceControlCheckoutBackend : public IPackageCheckoutBackend
+{
+public:
+	explicit FSourceControlCheckoutBackend(ISourceControlProvider& InProvider)
+		: Provider(InProvider)
+	{
+	}
+
+	virtual const TCHAR* GetName() const override { return TEXT("SourceControl"); }
+
+	virtual void CheckOut(const TArray<FString>& Filenames, FPackageCheckoutResult& OutResult) override;
+
+private:
+	ISourceControlProvider& Provider;
+};
+
+/**
+ * Stand-in for a workspace without source control, a checkout clears the read-only flag of the file.
+ * Also useful to time a fix job without the server round trips.
+ */
+class OPTIMIZATIONASSISTANT_API FLocalFileCheckoutBackend : public IPackageCheckoutBackend
+{
+public:
+	virtual const TCHAR* GetName() const override { return TEXT("LocalFile"); }
+
+	virtual void CheckOut(const TArray<FString>& Filenames, FPackageCheckoutResult& OutResult) override;
+};
+
+class OPTIMIZATIONASSISTANT_API FPackageCheckout
+{
+public:
+	/** The source control backend when a provider is enabled and available, the local file backend otherwise. */
+	static TUniquePtr<IPackageCheckoutBackend> CreateBackend();
+
+	/**
+	 * Checks out the files of PackageNames in one batch. Packages without a file on disk have nothing to check out.
+	 * Returns false and fills OutFailedPackages if any package can not be modified.
+	 */
+	static bool CheckOutPackages(IPackageCheckoutBackend& Backend, const TArray<FName>& PackageNames, TArray<FName>& OutFailedPackages);
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetMetricsStore.h"
+
+/** Scalar variables an expression can read, the caller fills them before evaluating. */
+enum class EThresholdVariable : uint8
+{
+	LODIndex,				// i
+	NumLODs,				// NumLODs
+	Materials,				// Materials
+	MaxTriangles,			// MaxTriangles
+	MaxUVChannels,			// MaxUVChannels
+	MaxMaterials,			// MaxMaterials
+	LODMaxMaterials,		// LODMaxMaterials
+	MemoryMB,				// MemoryMB, resident memory of all LODs
+	MaxMemoryMB,			// MaxMemoryMB
+	RecommendTriangles,		// Recommend.Triangles, recommended triangles of LOD i
+	RecommendScreenSize,	// Recommend.ScreenSize, recommended screen size of LOD i
+	CullDistance,			// CullDistance, draw distance set on a component
+	RecommendCullDistance,	// Recommend.CullDistance
+	Max
+};
+
+struct FThresholdVariables
+{
+	FThresholdVariables()
+		: PlatformGroupName(NAME_None)
+	{
+		FMemory::Memzero(Values);
+	}
+
+	void Set(EThresholdVariable Variable, float Value) { Values[(int32)Variable] = Value; }
+	float Get(EThresholdVariable Variable) const { return Values[(int32)Variable]; }
+
+	float Values[(int32)EThresholdVariable::Max];
+
+	/** Platform group used to read LOD[n].ScreenSize from the record. */
+	FName PlatformGroupName;
+};
+
+enum class EThresholdOpCode : uint8
+{
+	PushConstant,		// Immediate
+	LoadVariable,		// Operand = EThresholdVariable
+	LoadLODField,		// Operand = EAssetMetricsColumn, Immediate = LOD index
+	LoadLODFieldIndexed,// Operand = EAssetMetricsColumn, LOD index popped from the stack
+	Add,
+	Subtract,
+	Multiply,
+	Divide,
+	Negate,
+	Less,
+	LessEqual,
+	Greater,
+	GreaterEqual,
+	Equal,
+	NotEqual,
+	And,
+	Or,
+	Not,
+	Min,
+	Max,
+	Abs,
+};
+
+struct FThresholdInstruction
+{
+	EThresholdOpCode OpCode;
+	uint8 Operand;
+	float Immediate;
+};
+
+/**
+ * Threshold condition written in config, e.g.
+ *   LOD[i].Triangles > LOD0.Triangles * 0.5 / i
+ *   LOD[i].ScreenSize < Recommend.ScreenSize - 0.06
+ * Supports + - * /, comparisons, && || !, min(a, b), max(a, b), abs(a), the variables listed in
+ * EThresholdVariable and the record fields LOD[n].Triangles|Vertices|UVChannels|Sections|MemoryMB|ScreenSize,
+ * where n is a number or any expression. Numbers are decimal with at most one '.' and an optional exponent (1.5e3).
+ * The source is compiled once to a flat stack bytecode.
+ */
+class OPTIMIZATIONASSISTANT_API FThresholdExpression
+{
+public:
+	enum { MaxStackDepth = 32 };
+
+	FThresholdExpression();
+
+	/** An empty source compiles to an expression that is never true. */
+	bool Compile(const FString& InSource, FString& OutError);
+
+	bool IsValid() const { return Instructions.Num() > 0; }
+
+	const FString& GetSource() const { return Source; }
+
+	/** True if the result can change between platform groups (reads LOD screen sizes), such expressions are evaluated once per target platform group. */
+	bool DependsOnPlatform() const { return bDependsOnPlatform; }
+
+	/** Record may be nullptr for expressions that only read variables, record fields then read as 0. */
+	float Evaluate(const FAssetMetricsRecord* Record, const FThresholdVariables& Variables) const;
+
+	bool EvaluateCondition(const FAssetMetricsRecord* Record, const FThresholdVariables& Variables) const
+	{
+		return IsValid() && Evaluate(Record, Variables) != 0.f;
+	}
+
+private:
+	FString Source;
+	TArray<FThresholdInstruction> Instructions;
+	bool bDependsOnPlatform;
+};